@@ -0,0 +1,209 @@
+//
+// Created by wenshen on 2026/1/28.
+//
+
+#ifndef SCCPU_ADDER_H
+#define SCCPU_ADDER_H
+#include "stdint.h"
+#include "common.h"
+#include "gate.h"
+
+/**
+ * 32 位加法器的进位网络, 全部用 2 输入门搭建
+ *
+ *  预处理:  g[i] = a[i] & b[i], p[i] = a[i] ^ b[i]
+ *           cin 折叠进最低位: G[0] = g[0] | (p[0] & cin)
+ *  前缀节点: (G[i], P[i]) <- (G[i] | (P[i] & G[i-d]), P[i] & P[i-d])
+ *  后处理:  c[0] = cin, c[i] = G[i-1], sum[i] = p[i] ^ c[i], cout = G[31]
+ *
+ * 不同的加法器只是前缀节点的摆放不同, 用一张 "层" 表描述:
+ * 每层的节点距离 d 相同, mask 的第 i 位 (逻辑位, 0 = LSB) 为 1 表示位置 i 上有一个节点
+ * 同一层的节点读的都是上一层的 G/P (同一时刻求值)
+ */
+#define ADDER_RIPPLE 0
+#define ADDER_CLA 1 // 4 位一组超前进位, 组间串行
+#define ADDER_KOGGE_STONE 2
+#define ADDER_BRENT_KUNG 3
+#define ADDER_NUM 4
+
+// SCCPU_ADDER 选择 word_alu_ 使用的加法器
+// 默认 ADDER_RIPPLE -> 原来的 one_bit_alu_ 串行链 (packed 模式下是逐级推进的进位链)
+#ifndef SCCPU_ADDER
+#define SCCPU_ADDER ADDER_RIPPLE
+#endif
+
+#if SCCPU_ADDER < 0 || SCCPU_ADDER >= ADDER_NUM
+#error "SCCPU_ADDER must be ADDER_RIPPLE / ADDER_CLA / ADDER_KOGGE_STONE / ADDER_BRENT_KUNG"
+#endif
+
+typedef struct prefix_level {
+    uint8_t dist;
+    uint32_t mask;
+} Prefix_level;
+
+typedef struct prefix_adder {
+    const char *name;
+    int n_levels;
+    const Prefix_level *levels;
+} Prefix_adder;
+
+// 串行进位: 第 i 层只有位置 i 一个节点
+static const Prefix_level RIPPLE_LEVELS_[] = {
+    {1, 1u << 1}, {1, 1u << 2}, {1, 1u << 3}, {1, 1u << 4}, {1, 1u << 5}, {1, 1u << 6}, {1, 1u << 7},
+    {1, 1u << 8}, {1, 1u << 9}, {1, 1u << 10}, {1, 1u << 11}, {1, 1u << 12}, {1, 1u << 13}, {1, 1u << 14},
+    {1, 1u << 15}, {1, 1u << 16}, {1, 1u << 17}, {1, 1u << 18}, {1, 1u << 19}, {1, 1u << 20}, {1, 1u << 21},
+    {1, 1u << 22}, {1, 1u << 23}, {1, 1u << 24}, {1, 1u << 25}, {1, 1u << 26}, {1, 1u << 27}, {1, 1u << 28},
+    {1, 1u << 29}, {1, 1u << 30}, {1, 1u << 31},
+};
+
+// 组内两层求出组内前缀, 组间进位串行传 7 次, 最后三层把组进位补给组内其余位
+static const Prefix_level CLA_LEVELS_[] = {
+    {1, 0xEEEEEEEEu}, {2, 0xCCCCCCCCu},
+    {4, 1u << 7}, {4, 1u << 11}, {4, 1u << 15}, {4, 1u << 19}, {4, 1u << 23}, {4, 1u << 27}, {4, 1u << 31},
+    {1, 0x11111110u}, {2, 0x22222220u}, {3, 0x44444440u},
+};
+
+// log2(32) = 5 层, 每层所有 i >= d 的位置都有节点
+static const Prefix_level KOGGE_STONE_LEVELS_[] = {
+    {1, 0xFFFFFFFEu}, {2, 0xFFFFFFFCu}, {4, 0xFFFFFFF0u}, {8, 0xFFFFFF00u}, {16, 0xFFFF0000u},
+};
+
+// 上扫 5 层 (二叉树归约) + 下扫 4 层 (把前缀分发给其余位置)
+static const Prefix_level BRENT_KUNG_LEVELS_[] = {
+    {1, 0xAAAAAAAAu}, {2, 0x88888888u}, {4, 0x80808080u}, {8, 0x80008000u}, {16, 0x80000000u},
+    {8, 0x00800000u}, {4, 0x08080800u}, {2, 0x22222220u}, {1, 0x55555554u},
+};
+
+#define PREFIX_LEVELS_(arr) (int) (sizeof(arr) / sizeof((arr)[0])), (arr)
+
+static const Prefix_adder PREFIX_ADDERS_[ADDER_NUM] = {
+    {"ripple", PREFIX_LEVELS_(RIPPLE_LEVELS_)},
+    {"cla4", PREFIX_LEVELS_(CLA_LEVELS_)},
+    {"kogge-stone", PREFIX_LEVELS_(KOGGE_STONE_LEVELS_)},
+    {"brent-kung", PREFIX_LEVELS_(BRENT_KUNG_LEVELS_)},
+};
+
+/**
+ * a + b + cin
+ * carry_into_msb / cout 供 word_alu_ 判断溢出
+ */
+static inline void word_prefix_add_(const Prefix_adder *adder, const word a, const word b, const bit cin,
+                                    word sum, bit *carry_into_msb, bit *cout) {
+#if SCCPU_PACKED_WORD
+    // 一层就是一次整字运算: 32 个节点同时求值
+    const uint32_t g = a[0] & b[0], p = a[0] ^ b[0];
+    uint32_t G = g | (p & (uint32_t) cin & 1u);
+    uint32_t P = p;
+    for (int l = 0; l < adder->n_levels; l++) {
+        const uint32_t d = adder->levels[l].dist, m = adder->levels[l].mask;
+        const uint32_t G_j = G << d, P_j = P << d;
+        G = G | (P & G_j & m);
+        P = P & (P_j | ~m);
+    }
+    const uint32_t c = (G << 1) | ((uint32_t) cin & 1u);
+    sum[0] = p ^ c;
+    *carry_into_msb = (bit) ((c >> 31) & 1u);
+    *cout = (bit) ((G >> 31) & 1u);
+#else
+    // 存储下标 = 31 - 逻辑位
+    bit p[WORD_SIZE], G[WORD_SIZE], P[WORD_SIZE];
+    for (int i = 0; i < WORD_SIZE; i++) {
+        G[i] = AND(a[INST_WORD(i)], b[INST_WORD(i)]);
+        p[i] = XOR(a[INST_WORD(i)], b[INST_WORD(i)]);
+        P[i] = p[i];
+    }
+    G[0] = OR(G[0], AND(p[0], cin));
+    for (int l = 0; l < adder->n_levels; l++) {
+        const int d = adder->levels[l].dist;
+        // 只走 mask 里的节点, 从高位往低位求值, 读到的 i - d 还是上一层的值
+        for (uint32_t m = adder->levels[l].mask; m != 0;) {
+            const int i = WORD_SIZE - 1 - __builtin_clz(m);
+            m &= ~(1u << i);
+            G[i] = OR(G[i], AND(P[i], G[i - d]));
+            P[i] = AND(P[i], P[i - d]);
+        }
+    }
+    sum[INST_WORD(0)] = XOR(p[0], cin);
+    for (int i = 1; i < WORD_SIZE; i++) {
+        sum[INST_WORD(i)] = XOR(p[i], G[i - 1]);
+    }
+    *carry_into_msb = G[WORD_SIZE - 2];
+    *cout = G[WORD_SIZE - 1];
+#endif
+}
+
+typedef struct adder_stats {
+    int gates; // 2 输入门个数 (预处理 + 前缀节点 + 求和)
+    int depth; // 最长路径上的门级数 (a/b/cin 为第 0 级)
+    int levels; // 前缀层数 (packed / bit-sliced 下的整字求值步数)
+} Adder_stats;
+
+static inline int adder_max_(const int x, const int y) {
+    return x > y ? x : y;
+}
+
+/**
+ * 按同一张层表统计电路规模
+ * 节点的 P 输出只在后面还会被读到时才算一个门 (反向扫描求出哪些 P 是需要的)
+ */
+static inline Adder_stats adder_stats(const Prefix_adder *adder) {
+    Adder_stats s = {0, 0, adder->n_levels};
+    int dG[WORD_SIZE], dP[WORD_SIZE], dp[WORD_SIZE];
+
+    // g/p: 各 1 个门; cin 折叠: AND + OR
+    s.gates = 2 * WORD_SIZE + 2;
+    for (int i = 0; i < WORD_SIZE; i++) {
+        dG[i] = dP[i] = dp[i] = 1;
+    }
+    dG[0] = adder_max_(dG[0], dp[0] + 1) + 1;
+
+    // need_p_after[l] 的第 i 位: 第 l 层之后位置 i 的 P 还会被读
+    uint32_t need_p = 0;
+    uint32_t need_p_after[WORD_SIZE];
+    for (int l = adder->n_levels - 1; l >= 0; l--) {
+        need_p_after[l] = need_p;
+        const uint32_t m = adder->levels[l].mask;
+        const int d = adder->levels[l].dist;
+        uint32_t before = need_p;
+        for (int i = d; i < WORD_SIZE; i++) {
+            if (!((m >> i) & 1u)) continue;
+            before |= 1u << i; // G 节点要读 P[i]
+            if ((need_p >> i) & 1u) before |= 1u << (i - d);
+        }
+        need_p = before;
+    }
+
+    for (int l = 0; l < adder->n_levels; l++) {
+        const uint32_t m = adder->levels[l].mask;
+        const int d = adder->levels[l].dist;
+        int nG[WORD_SIZE], nP[WORD_SIZE];
+        for (int i = 0; i < WORD_SIZE; i++) {
+            nG[i] = dG[i];
+            nP[i] = dP[i];
+        }
+        for (int i = d; i < WORD_SIZE; i++) {
+            if (!((m >> i) & 1u)) continue;
+            nG[i] = adder_max_(dG[i], adder_max_(dP[i], dG[i - d]) + 1) + 1;
+            s.gates += 2;
+            if ((need_p_after[l] >> i) & 1u) {
+                nP[i] = adder_max_(dP[i], dP[i - d]) + 1;
+                s.gates += 1;
+            }
+        }
+        for (int i = 0; i < WORD_SIZE; i++) {
+            dG[i] = nG[i];
+            dP[i] = nP[i];
+        }
+    }
+
+    // sum: 32 个 XOR
+    s.gates += WORD_SIZE;
+    s.depth = dp[0] + 1;
+    for (int i = 1; i < WORD_SIZE; i++) {
+        s.depth = adder_max_(s.depth, adder_max_(dp[i], dG[i - 1]) + 1);
+    }
+    s.depth = adder_max_(s.depth, dG[WORD_SIZE - 1]);
+    return s;
+}
+
+#endif //SCCPU_ADDER_H
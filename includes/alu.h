@@ -8,6 +8,8 @@
 #include "common.h"
 #include "gate.h"
 #include "mux.h"
+#include "adder.h"
+#include "utils.h"
 
 
 /**
@@ -22,15 +24,15 @@
  * 111     NULL   Arith(1)       0
  */
 typedef bit ops[3];
-static const ops OPS_ADD_ = {1, 0, 0};
-static const  ops OPS_SUB_ = {1, 0, 1};
-static const ops OPS_SLT_ = {1, 1, 0};
-static const ops OPS_NULL_ = {1, 1, 1};
+static const ops OPS_ADD_ = {BIT_1, BIT_0, BIT_0};
+static const  ops OPS_SUB_ = {BIT_1, BIT_0, BIT_1};
+static const ops OPS_SLT_ = {BIT_1, BIT_1, BIT_0};
+static const ops OPS_NULL_ = {BIT_1, BIT_1, BIT_1};
 
-static const ops OPS_AND_ = {0, 0, 0};
-static const ops OPS_OR_ = {0, 0, 1};
-static const ops OPS_XOR_ = {0, 1, 0};
-static const ops OPS_NOR_ = {0, 1, 1};
+static const ops OPS_AND_ = {BIT_0, BIT_0, BIT_0};
+static const ops OPS_OR_ = {BIT_0, BIT_0, BIT_1};
+static const ops OPS_XOR_ = {BIT_0, BIT_1, BIT_0};
+static const ops OPS_NOR_ = {BIT_0, BIT_1, BIT_1};
 
 
 static inline bit full_adder(const bit input1, const bit input2, const bit cin, bit *cout) {
@@ -50,7 +52,7 @@ static inline bit one_bit_alu_(const bit input0, const bit input1, const bit cin
     //  2: SLT 在 bit_alu 也使用的是 SUB
     bit SUB_RET = full_adder(input0, NOT(input1), cin, &sub_cout_v);
     // NULL Is 0
-    bit NULL_RET = 0;
+    bit NULL_RET = BIT_0;
     bit AND_RET = AND(input0, input1);
     bit OR_RET = OR(input0, input1);
     bit XOR_RET = XOR(input0, input1);
@@ -79,7 +81,7 @@ static inline void byte_alu_(const byte input0, const byte input1, byte ret, con
     bit is_op_sub = AND(AND(ops_[0], NOT(ops_[1])), ops_[2]);
     bit is_op_slt = AND(AND(ops_[0], ops_[1]), NOT(ops_[2]));
     bit cin = OR(is_op_sub, is_op_slt);
-    bit carry_into_msb = 0;
+    bit carry_into_msb = BIT_0;
 
     for (int i = BYTE_SIZE - 1; i > 0; --i) {
         ret[i] = one_bit_alu_(input0[i], input1[i], cin, ops_, &cin);
@@ -90,18 +92,136 @@ static inline void byte_alu_(const byte input0, const byte input1, byte ret, con
     bit true_overflow = XOR(carry_into_msb, cin);
     bit less = XOR(ret[0], true_overflow);
     for (int i = 0; i < BYTE_SIZE - 1; ++i) {
-        ret[i] = mux2_1(ret[i], 0, is_op_slt);
+        ret[i] = mux2_1(ret[i], BIT_0, is_op_slt);
     }
     ret[BYTE_SIZE - 1] = mux2_1(ret[BYTE_SIZE - 1], less, is_op_slt);
     *overflow = cin;
 }
 
 
-static inline void word_alu_(const word input0, const word input1, word ret, const ops ops_, bit *overflow) {
+#if SCCPU_ADDER != ADDER_RIPPLE
+/**
+ * 前缀加法器版本 (SCCPU_ADDER 选择网络, 见 adder.h): 对 bit / packed / bit-sliced 三种 word 都适用
+ * 与 one_bit_alu_ 链条在 ret / overflow 上逐位一致; ADD/SUB/SLT 共用一个加法器, 逻辑运算整字求值
+ */
+static inline void word_alu_gate_(const word input0, const word input1, word ret, const ops ops_, bit *overflow) {
+    bit is_op_sub = AND(AND(ops_[0], NOT(ops_[1])), ops_[2]);
+    bit is_op_slt = AND(AND(ops_[0], ops_[1]), NOT(ops_[2]));
+    bit is_op_add = AND(AND(ops_[0], NOT(ops_[1])), NOT(ops_[2]));
+    bit cin = OR(is_op_sub, is_op_slt);
+
+    // SUB/SLT: input1 取反 + cin(1)
+    word input1_n, b, sum;
+    word_not_(input1, input1_n);
+    word_mux_2_1(input1, input1_n, cin, b);
+    bit carry_into_msb_w = BIT_0, cout_w = BIT_0;
+    word_prefix_add_(&PREFIX_ADDERS_[SCCPU_ADDER], input0, b, cin, sum, &carry_into_msb_w, &cout_w);
+
+    word and_w, or_w, xor_w, nor_w;
+    word_and_(input0, input1, and_w);
+    word_or_(input0, input1, or_w);
+    word_xor_(input0, input1, xor_w);
+    word_not_(or_w, nor_w);
+
+    // Multiplexer Of Group (同 one_bit_alu_)
+    word group_0_sel_0, group_0_sel_1, group_0_sel_2, group_0_sel_3;
+    word_mux_2_1(xor_w, sum, ops_[0], group_0_sel_0);
+    word_mux_2_1(nor_w, WORD_ZERO, ops_[0], group_0_sel_1);
+    word_mux_2_1(and_w, sum, ops_[0], group_0_sel_2);
+    word_mux_2_1(or_w, sum, ops_[0], group_0_sel_3);
+
+    word group_1_sel_0, group_1_sel_1;
+    word_mux_2_1(group_0_sel_2, group_0_sel_0, ops_[1], group_1_sel_0);
+    word_mux_2_1(group_0_sel_3, group_0_sel_1, ops_[1], group_1_sel_1);
+    word_mux_2_1(group_1_sel_0, group_1_sel_1, ops_[2], ret);
+
+    //只有 ADD和 SUB 才有进位
+    bit arith = OR(OR(is_op_add, is_op_sub), is_op_slt);
+    bit carry_into_msb = AND(arith, carry_into_msb_w);
+    bit cout = AND(arith, cout_w);
+
+    bit true_overflow = XOR(carry_into_msb, cout);
+    bit less = XOR(WORD_GET(ret, 0), true_overflow);
+    word slt_w;
+    word_fanout_(BIT_0, slt_w);
+    WORD_SET(slt_w, WORD_SIZE - 1, less);
+    word_mux_2_1(ret, slt_w, is_op_slt, ret);
+    *overflow = cout;
+}
+#elif SCCPU_PACKED_WORD
+/**
+ * packed 版本: 与逐位的 one_bit_alu_ 链条在 ret / overflow 上逐位一致
+ * 加法器: g = a&b, p = a^b, 进位链 c[k+1] = g[k] | (p[k] & c[k])
+ * 进位链整字迭代, 每轮推进一级(同一时刻 32 个 full_adder 并行), 稳定即停
+ * 逻辑运算: 32 个门一次求值
+ */
+static inline void word_alu_gate_(const word input0, const word input1, word ret, const ops ops_, bit *overflow) {
     bit is_op_sub = AND(AND(ops_[0], NOT(ops_[1])), ops_[2]);
     bit is_op_slt = AND(AND(ops_[0], ops_[1]), NOT(ops_[2]));
+    bit is_op_add = AND(AND(ops_[0], NOT(ops_[1])), NOT(ops_[2]));
     bit cin = OR(is_op_sub, is_op_slt);
-    bit carry_into_msb = 0;
+
+    // SUB/SLT: input1 取反 + cin(1), 与 one_bit_alu_ 中的 SUB full_adder 相同
+    word input1_n, b;
+    word_not_(input1, input1_n);
+    word_mux_2_1(input1, input1_n, cin, b);
+
+    word g, p, cin_w, carry_in, carry_out, next, sum;
+    word_and_(input0, b, g);
+    word_xor_(input0, b, p);
+    word_fanout_(0, cin_w);
+    WORD_SET(cin_w, WORD_SIZE - 1, cin);
+    carry_in[0] = cin_w[0];
+    for (int i = 0; i < WORD_SIZE; ++i) {
+        word_and_(p, carry_in, carry_out);
+        word_or_(g, carry_out, carry_out);
+        // carry_out 左移一位就是送给上一位的进位, 最低位接 cin
+        next[0] = carry_out[0] << 1;
+        word_or_(next, cin_w, next);
+        if (next[0] == carry_in[0]) break;
+        carry_in[0] = next[0];
+    }
+    word_and_(p, carry_in, carry_out);
+    word_or_(g, carry_out, carry_out);
+    word_xor_(p, carry_in, sum);
+
+    word and_w, or_w, xor_w, nor_w;
+    word_and_(input0, input1, and_w);
+    word_or_(input0, input1, or_w);
+    word_xor_(input0, input1, xor_w);
+    word_not_(or_w, nor_w);
+
+    // Multiplexer Of Group (同 one_bit_alu_, ADD/SUB 共用一个加法器)
+    word group_0_sel_0, group_0_sel_1, group_0_sel_2, group_0_sel_3;
+    word_mux_2_1(xor_w, sum, ops_[0], group_0_sel_0);
+    word_mux_2_1(nor_w, WORD_ZERO, ops_[0], group_0_sel_1);
+    word_mux_2_1(and_w, sum, ops_[0], group_0_sel_2);
+    word_mux_2_1(or_w, sum, ops_[0], group_0_sel_3);
+
+    word group_1_sel_0, group_1_sel_1;
+    word_mux_2_1(group_0_sel_2, group_0_sel_0, ops_[1], group_1_sel_0);
+    word_mux_2_1(group_0_sel_3, group_0_sel_1, ops_[1], group_1_sel_1);
+    word_mux_2_1(group_1_sel_0, group_1_sel_1, ops_[2], ret);
+
+    //只有 ADD和 SUB 才有进位
+    bit arith = OR(OR(is_op_add, is_op_sub), is_op_slt);
+    bit carry_into_msb = AND(arith, WORD_GET(carry_in, 0));
+    bit cout = AND(arith, WORD_GET(carry_out, 0));
+
+    bit true_overflow = XOR(carry_into_msb, cout);
+    bit less = XOR(WORD_GET(ret, 0), true_overflow);
+    word slt_w;
+    word_fanout_(0, slt_w);
+    WORD_SET(slt_w, WORD_SIZE - 1, less);
+    word_mux_2_1(ret, slt_w, is_op_slt, ret);
+    *overflow = cout;
+}
+#else
+static inline void word_alu_gate_(const word input0, const word input1, word ret, const ops ops_, bit *overflow) {
+    bit is_op_sub = AND(AND(ops_[0], NOT(ops_[1])), ops_[2]);
+    bit is_op_slt = AND(AND(ops_[0], ops_[1]), NOT(ops_[2]));
+    bit cin = OR(is_op_sub, is_op_slt);
+    bit carry_into_msb = BIT_0;
 
     for (int i = WORD_SIZE - 1; i > 0; --i) {
         ret[i] = one_bit_alu_(input0[i], input1[i], cin, ops_, &cin);
@@ -112,11 +232,54 @@ static inline void word_alu_(const word input0, const word input1, word ret, con
     bit true_overflow = XOR(carry_into_msb, cin);
     bit less = XOR(ret[0], true_overflow);
     for (int i = 0; i < WORD_SIZE - 1; ++i) {
-        ret[i] = mux2_1(ret[i], 0, is_op_slt);
+        ret[i] = mux2_1(ret[i], BIT_0, is_op_slt);
     }
     ret[WORD_SIZE - 1] = mux2_1(ret[WORD_SIZE - 1], less, is_op_slt);
     *overflow = cin;
 }
+#endif
+
+#if SCCPU_HAS_BEH_MODELS
+// 行为级 ALU: 与门级在 ret / overflow 上逐位一致 (overflow 是加法器的最高位进位, 只有 ADD/SUB/SLT 有)
+static inline void word_alu_beh_(const word input0, const word input1, word ret, const ops ops_, bit *overflow) {
+    const uint32_t a = u32_from_word(input0), b = u32_from_word(input1);
+    const int op = LANE_GET(ops_[0], 0) << 2 | LANE_GET(ops_[1], 0) << 1 | LANE_GET(ops_[2], 0);
+    const uint64_t sub = (uint64_t) a + (uint32_t) ~b + 1u;
+    uint64_t sum = 0;
+    uint32_t r = 0;
+    switch (op) {
+        case 0: r = a & b;
+            break;
+        case 1: r = a | b;
+            break;
+        case 2: r = a ^ b;
+            break;
+        case 3: r = ~(a | b);
+            break;
+        case 4: sum = (uint64_t) a + b;
+            r = (uint32_t) sum;
+            break;
+        case 5: sum = sub;
+            r = (uint32_t) sum;
+            break;
+        case 6: sum = sub;
+            r = (int32_t) a < (int32_t) b;
+            break;
+        default:
+            break;
+    }
+    u32_to_word(r, ret);
+    *overflow = (sum >> 32) ? BIT_1 : BIT_0;
+}
+#endif
+
+static inline void word_alu_(const word input0, const word input1, word ret, const ops ops_, bit *overflow) {
+#if SCCPU_MODEL_ALU == MODEL_BEH
+    word_alu_beh_(input0, input1, ret, ops_, overflow);
+#else
+    word_alu_gate_(input0, input1, ret, ops_, overflow);
+#endif
+}
 
 
 #endif //SCCPU_ALU__H
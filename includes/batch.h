@@ -0,0 +1,433 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_BATCH_H
+#define SCCPU_BATCH_H
+#include "stdio.h"
+#include "stdlib.h"
+#include "pthread.h"
+#include "stdatomic.h"
+#include "time.h"
+#include "cpu_core.h"
+
+/**
+ * 批量运行: 一批作业 (程序镜像 + DM 预装 + 周期预算) 各用一个独立的 Cpu_core, 分给一组主机线程
+ * cpu_step 只读写传进来的 Cpu_core, 作业之间互不相干; 每个线程有自己的 Cpu_core, 作业开始时 init_cpu_c
+ *
+ * 调度: 作业按轮转预先分到每个线程的双端队列, 线程从自己队列的尾部取, 取空了从别的线程队列的头部偷
+ * (作业都是成千上万个周期, 每个队列一把自旋锁就够了); 调用线程是 0 号
+ * 结果: 最终 R0-R3 / PC / cycle_count / DM 的 FNV-1a 摘要 / 墙钟耗时 / 跑它的线程, 可以写成 CSV 或 JSON
+ *
+ * 程序 + DM 预装完全相同的作业共用一个镜像 (batch_add 时去重)
+ * SCCPU_SHARED_IMAGES=1 时作业开始只是把 Cpu_core 的 IM / DM 挂到镜像上, 不拷贝; DM 写过的页才有私有副本
+ * 否则照旧把镜像拷进 Cpu_core
+ *
+ * 清单 (batch_load_manifest) 每行一个作业, # 开始的是注释:
+ *   名字  程序镜像  DM 预装 (没有写 -)  周期数
+ * 镜像文件是空白分隔的 32 位十六进制字 (可带 0x, # 注释), 程序从 IM[0] 开始, DM 预装按大端从地址 0 开始
+ * 相对路径相对于清单所在的目录
+ *
+ * 作业和镜像数组按需在堆上加倍增长, 数量只受内存限制; 用完 batch_free
+ * SCCPU_TRACE 的跟踪环在每个 Cpu_core 里, 各线程各记各的; SCCPU_PIPEVIEW 的时间线也是挂在单个核上的,
+ * 批量作业的核不挂 (init_cpu_c 摘掉), 不写时间线; 阶段线程池是进程内唯一的全局状态, 在编译时拒绝
+ */
+#if SCCPU_LANES != 1 || SCCPU_NETLIST || SCCPU_STAGE_THREADS
+#error "batch.h runs independent Cpu_core instances (SCCPU_LANES=1, no NETLIST / STAGE_THREADS pool)"
+#endif
+
+#define BATCH_MAX_THREADS 64
+#define BATCH_NAME_LEN 64
+
+typedef struct batch_image {
+    uint32_t hash; // im + dm 的摘要, 去重时先比它
+    uint32_t im[IM_SIZE];
+    uint8_t dm[DEFAULT_SIZE];
+#if SCCPU_SHARED_IMAGES
+    Im_image im_img;
+    Dm_image dm_img;
+#endif
+} Batch_image;
+
+typedef struct batch_job {
+    char name[BATCH_NAME_LEN];
+    int image; // Batch.images 的下标
+    uint64_t cycles;
+    // 结果
+    int done;
+    uint32_t r[4];
+    uint32_t pc;
+    uint64_t cycle_count;
+    uint32_t dm_digest;
+    uint64_t wall_ns;
+    int worker;
+    int dm_pages; // SCCPU_SHARED_IMAGES: 结束时复制出来的私有 DM 页数
+} Batch_job;
+
+typedef struct batch_deque {
+    atomic_flag lock;
+    int head, tail; // [head, tail) 是还没跑的作业
+    int *idx; // Batch.dq_idx 里属于这个队列的一段
+} Batch_deque;
+
+typedef struct batch_worker {
+    struct batch *b;
+    int id;
+    pthread_t tid;
+    int jobs; // 跑了几个作业
+    int stolen; // 其中偷来的
+    uint64_t busy_ns;
+    Cpu_core core;
+} Batch_worker;
+
+typedef struct batch {
+    Batch_image *images;
+    int n_images, cap_images;
+    Batch_job *jobs;
+    int n_jobs, cap_jobs;
+    int n_threads;
+    int *dq_idx; // batch_run 分配, 各队列的 idx 指进来
+    Batch_deque dq[BATCH_MAX_THREADS];
+    Batch_worker w[BATCH_MAX_THREADS];
+    uint64_t wall_ns;
+} Batch;
+
+static inline uint64_t batch_now_ns_(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static inline uint32_t batch_fnv1a_(const uint8_t *p, const size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+static inline void batch_init(Batch *b) {
+    b->images = NULL;
+    b->n_images = b->cap_images = 0;
+    b->jobs = NULL;
+    b->n_jobs = b->cap_jobs = 0;
+    b->n_threads = 0;
+    b->dq_idx = NULL;
+    b->wall_ns = 0;
+}
+
+static inline void batch_free(Batch *b) {
+    free(b->images);
+    free(b->jobs);
+    free(b->dq_idx);
+    batch_init(b);
+}
+
+// 保证 *arr 至少能放 need 个 size 字节的元素 (容量加倍); 分配失败返回 -1, 原数组不变
+static inline int batch_reserve_(void **arr, int *cap, const int need, const size_t size) {
+    if (need <= *cap) return 0;
+    int n = *cap ? *cap : 16;
+    while (n < need) n *= 2;
+    void *p = realloc(*arr, (size_t) n * size);
+    if (!p) return -1;
+    *arr = p;
+    *cap = n;
+    return 0;
+}
+
+// 深拷贝作业和镜像 (各自跑、各自记结果); dst 不能是已经持有数组的 Batch; 分配失败返回 -1, dst 为空
+static inline int batch_clone(Batch *dst, const Batch *src) {
+    batch_init(dst);
+    if (batch_reserve_((void **) &dst->images, &dst->cap_images, src->n_images, sizeof(Batch_image)) != 0
+        || batch_reserve_((void **) &dst->jobs, &dst->cap_jobs, src->n_jobs, sizeof(Batch_job)) != 0) {
+        batch_free(dst);
+        return -1;
+    }
+    if (src->n_images) memcpy(dst->images, src->images, (size_t) src->n_images * sizeof(Batch_image));
+    if (src->n_jobs) memcpy(dst->jobs, src->jobs, (size_t) src->n_jobs * sizeof(Batch_job));
+    dst->n_images = src->n_images;
+    dst->n_jobs = src->n_jobs;
+    return 0;
+}
+
+// 追加一个作业; dm 可以为空; 返回作业下标, 内存不够时返回 -1
+// 新镜像先直接填进数组末尾的空位, 与已有的相同就不计入 (不需要临时缓冲区)
+static inline int batch_add(Batch *b, const char *name, const uint32_t *prog, const size_t n_prog,
+                            const uint8_t *dm, const uint64_t cycles) {
+    if (batch_reserve_((void **) &b->jobs, &b->cap_jobs, b->n_jobs + 1, sizeof(Batch_job)) != 0
+        || batch_reserve_((void **) &b->images, &b->cap_images, b->n_images + 1, sizeof(Batch_image)) != 0)
+        return -1;
+    Batch_image *img = &b->images[b->n_images];
+    memset(img->im, 0, sizeof(img->im));
+    memset(img->dm, 0, sizeof(img->dm));
+    memcpy(img->im, prog, (n_prog > IM_SIZE ? IM_SIZE : n_prog) * sizeof(uint32_t));
+    if (dm) memcpy(img->dm, dm, DEFAULT_SIZE);
+    img->hash = batch_fnv1a_((const uint8_t *) img->im, sizeof(img->im)) * 31u ^ batch_fnv1a_(img->dm, sizeof(img->dm));
+    int k = 0;
+    while (k < b->n_images && (b->images[k].hash != img->hash
+                               || memcmp(b->images[k].im, img->im, sizeof(img->im)) != 0
+                               || memcmp(b->images[k].dm, img->dm, sizeof(img->dm)) != 0)) k++;
+    if (k == b->n_images) {
+#if SCCPU_SHARED_IMAGES
+        im_image_load(&img->im_img, img->im, IM_SIZE);
+        memcpy(img->dm_img.memory, img->dm, DEFAULT_SIZE);
+#endif
+        b->n_images++;
+    }
+    Batch_job *j = &b->jobs[b->n_jobs];
+    memset(j, 0, sizeof(Batch_job));
+    snprintf(j->name, sizeof(j->name), "%s", name);
+    j->image = k;
+    j->cycles = cycles;
+    return b->n_jobs++;
+}
+
+// c 是线程自己的 Cpu_core; SCCPU_SHARED_IMAGES 下作业结束就释放私有页, 不留给下一个作业
+static inline void batch_run_job_(const Batch *b, Batch_job *j, Cpu_core *c, const int worker) {
+    const Batch_image *img = &b->images[j->image];
+    uint8_t dm_out[DEFAULT_SIZE];
+    const uint64_t t0 = batch_now_ns_();
+#if SCCPU_SHARED_IMAGES
+    init_cpu_c(c);
+    im_attach(&c->im, &img->im_img);
+    dm_attach(&c->dm, &img->dm_img);
+#else
+    init_cpu_c(c);
+    for (int i = 0; i < IM_SIZE; i++) u32_to_word(img->im[i], c->im.im[i]);
+    memcpy(c->dm.memory, img->dm, DEFAULT_SIZE);
+#endif
+    for (uint64_t cyc = 0; cyc < j->cycles; cyc++) cpu_step(c);
+    j->r[0] = reg32_read_u32_(&c->rf.r0);
+    j->r[1] = reg32_read_u32_(&c->rf.r1);
+    j->r[2] = reg32_read_u32_(&c->rf.r2);
+    j->r[3] = reg32_read_u32_(&c->rf.r3);
+    j->pc = reg32_read_u32_(&c->pc.reg32);
+    j->cycle_count = c->cycle_count;
+    dm_copy_out(&c->dm, dm_out);
+    j->dm_digest = batch_fnv1a_(dm_out, DEFAULT_SIZE);
+#if SCCPU_SHARED_IMAGES
+    j->dm_pages = dm_private_pages(&c->dm);
+    dm_release(&c->dm);
+#endif
+    j->worker = worker;
+    j->wall_ns = batch_now_ns_() - t0;
+    j->done = 1;
+}
+
+static inline void batch_lock_(Batch_deque *d) {
+    while (atomic_flag_test_and_set_explicit(&d->lock, memory_order_acquire)) sched_yield();
+}
+
+static inline void batch_unlock_(Batch_deque *d) {
+    atomic_flag_clear_explicit(&d->lock, memory_order_release);
+}
+
+// 自己的队列从尾部取, 别人的从头部偷; 没有返回 -1
+static inline int batch_take_(Batch_deque *d, const int own) {
+    int j = -1;
+    batch_lock_(d);
+    if (d->head < d->tail) j = own ? d->idx[--d->tail] : d->idx[d->head++];
+    batch_unlock_(d);
+    return j;
+}
+
+static inline void *batch_worker_(void *arg) {
+    Batch_worker *w = arg;
+    Batch *b = w->b;
+    const uint64_t t0 = batch_now_ns_();
+    for (;;) {
+        int j = batch_take_(&b->dq[w->id], 1);
+        for (int k = 1; j < 0 && k < b->n_threads; k++) {
+            j = batch_take_(&b->dq[(w->id + k) % b->n_threads], 0);
+            if (j >= 0) w->stolen++;
+        }
+        if (j < 0) break; // 作业只会减少: 所有队列 (包括没有线程的) 都空了就结束
+        batch_run_job_(b, &b->jobs[j], &w->core, w->id);
+        w->jobs++;
+    }
+    w->busy_ns = batch_now_ns_() - t0;
+    return NULL;
+}
+
+// 用 n_threads 个线程 (含调用线程) 跑完所有作业; 线程创建失败时返回 -1, 没有线程的队列由其余线程偷完, 作业照样全部跑完
+// 队列的下标数组分配失败时返回 -1, 一个作业也不跑
+static inline int batch_run(Batch *b, int n_threads) {
+    if (n_threads < 1) n_threads = 1;
+    if (n_threads > BATCH_MAX_THREADS) n_threads = BATCH_MAX_THREADS;
+    // 轮转分配, 每个队列最多 ceil(n_jobs / n_threads) 个
+    const int per = (b->n_jobs + n_threads - 1) / n_threads;
+    free(b->dq_idx);
+    b->dq_idx = malloc((size_t) (per ? per : 1) * (size_t) n_threads * sizeof(int));
+    if (!b->dq_idx) return -1;
+    b->n_threads = n_threads;
+    for (int t = 0; t < n_threads; t++) {
+        Batch_deque *d = &b->dq[t];
+        atomic_flag_clear(&d->lock);
+        d->head = d->tail = 0;
+        d->idx = b->dq_idx + (size_t) t * (size_t) per;
+        b->w[t].b = b;
+        b->w[t].id = t;
+        b->w[t].jobs = b->w[t].stolen = 0;
+        b->w[t].busy_ns = 0;
+    }
+    for (int j = 0; j < b->n_jobs; j++) {
+        Batch_deque *d = &b->dq[j % n_threads];
+        b->jobs[j].done = 0;
+        d->idx[d->tail++] = j;
+    }
+    int rc = 0, started = 1;
+    const uint64_t t0 = batch_now_ns_();
+    for (; started < n_threads; started++) {
+        if (pthread_create(&b->w[started].tid, NULL, batch_worker_, &b->w[started]) != 0) {
+            rc = -1;
+            break;
+        }
+    }
+    batch_worker_(&b->w[0]);
+    for (int t = 1; t < started; t++) pthread_join(b->w[t].tid, NULL);
+    b->wall_ns = batch_now_ns_() - t0;
+    return rc;
+}
+
+// 读一个十六进制字文件; 返回读到的字数, 打不开 / 格式错 / 超过 max 返回 -1
+static inline int batch_read_hex_(const char *path, uint32_t *out, const int max) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int n = 0, ch;
+    char tok[16];
+    while ((ch = fgetc(f)) != EOF) {
+        if (ch == '#') {
+            while ((ch = fgetc(f)) != EOF && ch != '\n') {}
+            continue;
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == ',') continue;
+        int len = 0;
+        do {
+            if (len + 1 >= (int) sizeof(tok)) {
+                fclose(f);
+                return -1;
+            }
+            tok[len++] = (char) ch;
+        } while ((ch = fgetc(f)) != EOF && ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n' && ch != ','
+                 && ch != '#');
+        if (ch == '#') ungetc(ch, f);
+        tok[len] = 0;
+        char *end;
+        const unsigned long v = strtoul(tok, &end, 16);
+        if (*end != 0 || v > 0xFFFFFFFFul || n >= max) {
+            fclose(f);
+            return -1;
+        }
+        out[n++] = (uint32_t) v;
+    }
+    fclose(f);
+    return n;
+}
+
+static inline void batch_path_(char *out, const size_t size, const char *dir, const char *p) {
+    if (p[0] == '/' || dir[0] == 0) snprintf(out, size, "%s", p);
+    else snprintf(out, size, "%s/%s", dir, p);
+}
+
+// 读清单追加作业; 返回 0, 出错时打印行号并返回 -1
+static inline int batch_load_manifest(Batch *b, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        printf("[BATCH] cannot open manifest %s\n", path);
+        return -1;
+    }
+    char dir[512] = {0};
+    const char *slash = strrchr(path, '/');
+    if (slash) snprintf(dir, sizeof(dir), "%.*s", (int) (slash - path), path);
+    char line[1024], name[BATCH_NAME_LEN], prog_path[512], dm_path[512], full[1100];
+    uint32_t prog[IM_SIZE], dm_words[DEFAULT_SIZE / 4]; // 约 9KB 栈, 可以在多个线程里同时读清单
+    uint8_t dm[DEFAULT_SIZE];
+    unsigned long long cycles;
+    int ln = 0, rc = 0;
+    while (fgets(line, sizeof(line), f)) {
+        ln++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = 0;
+        const int got = sscanf(line, "%63s %511s %511s %llu", name, prog_path, dm_path, &cycles);
+        if (got <= 0) continue;
+        if (got != 4) {
+            printf("[BATCH] %s:%d: expected <name> <program> <dm|-> <cycles>\n", path, ln);
+            rc = -1;
+            break;
+        }
+        memset(prog, 0, sizeof(prog));
+        batch_path_(full, sizeof(full), dir, prog_path);
+        const int n_prog = batch_read_hex_(full, prog, IM_SIZE);
+        if (n_prog < 0) {
+            printf("[BATCH] %s:%d: bad program image %s\n", path, ln, full);
+            rc = -1;
+            break;
+        }
+        memset(dm, 0, sizeof(dm));
+        if (strcmp(dm_path, "-") != 0) {
+            batch_path_(full, sizeof(full), dir, dm_path);
+            const int n_dm = batch_read_hex_(full, dm_words, DEFAULT_SIZE / 4);
+            if (n_dm < 0) {
+                printf("[BATCH] %s:%d: bad DM image %s\n", path, ln, full);
+                rc = -1;
+                break;
+            }
+            for (int i = 0; i < n_dm; i++) {
+                for (int k = 0; k < 4; k++) dm[i * 4 + k] = (uint8_t) (dm_words[i] >> (24 - 8 * k));
+            }
+        }
+        if (batch_add(b, name, prog, (size_t) n_prog, dm, cycles) < 0) {
+            printf("[BATCH] %s:%d: out of memory for job %s\n", path, ln, name);
+            rc = -1;
+            break;
+        }
+    }
+    fclose(f);
+    return rc;
+}
+
+static inline void batch_write_csv(const Batch *b, FILE *out) {
+    fprintf(out, "name,cycles,pc,r0,r1,r2,r3,dm_fnv1a,wall_us,worker\n");
+    for (int i = 0; i < b->n_jobs; i++) {
+        const Batch_job *j = &b->jobs[i];
+        fprintf(out, "%s,%lu,0x%08X,0x%08X,0x%08X,0x%08X,0x%08X,0x%08X,%.1f,%d\n", j->name, j->cycle_count, j->pc,
+                j->r[0], j->r[1], j->r[2], j->r[3], j->dm_digest, (double) j->wall_ns / 1e3, j->worker);
+    }
+}
+
+// 名字按原样输出, 只转义 " 和 \ (清单里的名字不含空白)
+static inline void batch_write_json(const Batch *b, FILE *out) {
+    fprintf(out, "{\"threads\": %d, \"wall_us\": %.1f, \"jobs\": [", b->n_threads, (double) b->wall_ns / 1e3);
+    for (int i = 0; i < b->n_jobs; i++) {
+        const Batch_job *j = &b->jobs[i];
+        fprintf(out, "%s\n  {\"name\": \"", i ? "," : "");
+        for (const char *p = j->name; *p; p++) {
+            if (*p == '"' || *p == '\\') fputc('\\', out);
+            fputc(*p, out);
+        }
+        fprintf(out, "\", \"cycles\": %lu, \"pc\": %u, \"regs\": [%u, %u, %u, %u], \"dm_fnv1a\": \"%08X\", "
+                "\"wall_us\": %.1f, \"worker\": %d}", j->cycle_count, j->pc, j->r[0], j->r[1], j->r[2], j->r[3],
+                j->dm_digest, (double) j->wall_ns / 1e3, j->worker);
+    }
+    fprintf(out, "\n]}\n");
+}
+
+// 每个线程跑了几个作业 (偷了几个) 和忙碌时间
+static inline void batch_report(const Batch *b) {
+    uint64_t cycles = 0;
+    for (int i = 0; i < b->n_jobs; i++) cycles += b->jobs[i].cycle_count;
+    printf("[BATCH] %d jobs, %lu cycles, %d threads, %.3f ms wall (%.1f ns/cycle aggregate)\n", b->n_jobs, cycles,
+           b->n_threads, (double) b->wall_ns / 1e6, cycles ? (double) b->wall_ns / (double) cycles : 0.0);
+#if SCCPU_SHARED_IMAGES
+    int pages = 0;
+    for (int i = 0; i < b->n_jobs; i++) pages += b->jobs[i].dm_pages;
+    printf("        %d shared images, Cpu_core %zu B, %d private DM pages (%d B) copied on write\n", b->n_images,
+           sizeof(Cpu_core), pages, pages * DM_PAGE_SIZE);
+#else
+    printf("        %d distinct images, Cpu_core %zu B (IM + DM copied in per job)\n", b->n_images, sizeof(Cpu_core));
+#endif
+    for (int t = 0; t < b->n_threads; t++) {
+        printf("        thread %2d: %3d jobs (%3d stolen) busy %.3f ms\n", t, b->w[t].jobs, b->w[t].stolen,
+               (double) b->w[t].busy_ns / 1e6);
+    }
+}
+
+#endif //SCCPU_BATCH_H
@@ -0,0 +1,192 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_CHECKPOINT_H
+#define SCCPU_CHECKPOINT_H
+#include "stdio.h"
+#include "netlist_cpu.h"
+
+/**
+ * Cpu_core 的二进制 checkpoint: 存下之后接着跑, 与从没停过的那次逐周期一致
+ *
+ * 内容 (全部按位打包, 与 word 的存储方式 / bit 是 _Bool 无关):
+ *  每个 DFF 的 master / Q 以及 prev_clk  (PC / 流水线寄存器 / regfile, 沿用 NL_CPU_REGS_ 这张表)
+ *  wire_*  (NL_CPU_WIRES_)                (activity 跳过的阶段沿用上个周期的 wire, hazard 读 wire_pc_src)
+ *  IM (每条 32 位), DM (原样字节), cycle_count
+ *
+ * 文件格式 (小端):
+ *  "SCCK" | u32 version | u32 IM_SIZE | u32 DEFAULT_SIZE | u32 寄存器数 | u32 wire 数 | u32 状态位数
+ *  | u64 cycle_count | 状态位 (MSB 先, 补齐到字节) | IM | DM | u32 FNV-1a (前面所有字节)
+ * 任何一项与当前编译配置不一致, 或校验和不对, 都拒绝载入且不改动 c
+ *
+ * activity 的输入快照只是缓存, 不存; 载入后作废 (cpu_activity_invalidate), 下个周期全部阶段重新求值, 结果不变
+ * activity 的 evals / skips 计数清零
+ */
+#if SCCPU_LANES != 1 || SCCPU_NETLIST || SCCPU_SHARED_IMAGES
+#error "checkpoint.h serializes a single Cpu_core (SCCPU_LANES=1, no SCCPU_NETLIST / SCCPU_SHARED_IMAGES)"
+#endif
+
+#define CPU_CKPT_VERSION 1u
+#define CPU_CKPT_HEADER_BYTES 36
+#define CPU_CKPT_MAX_BYTES (CPU_CKPT_HEADER_BYTES + 512 + IM_SIZE * 4 + DEFAULT_SIZE + 4) // 状态位不到 200 字节
+
+enum {
+    CPU_CKPT_OK = 0,
+    CPU_CKPT_ERR_IO,
+    CPU_CKPT_ERR_FORMAT, // magic / version / 配置不一致 / 长度不对
+    CPU_CKPT_ERR_CHECKSUM,
+};
+
+// 按位写 / 读; 位序 MSB 先
+typedef struct cpu_ckpt_bits {
+    uint8_t *p;
+    size_t pos;
+} Cpu_ckpt_bits;
+
+static inline void ckpt_put_bits_(Cpu_ckpt_bits *s, const uint32_t v, const int n) {
+    for (int i = n - 1; i >= 0; i--, s->pos++) {
+        if (v >> i & 1u) s->p[s->pos >> 3] |= (uint8_t) (0x80u >> (s->pos & 7));
+    }
+}
+
+static inline uint32_t ckpt_get_bits_(Cpu_ckpt_bits *s, const int n) {
+    uint32_t v = 0;
+    for (int i = 0; i < n; i++, s->pos++) v = v << 1 | (uint32_t) (s->p[s->pos >> 3] >> (7 - (s->pos & 7)) & 1u);
+    return v;
+}
+
+// nl_cpu_field_get_ 的反向
+static inline void ckpt_field_put_(void *f, const int width, const uint32_t v) {
+    if (width == WORD_SIZE) {
+        u32_to_word(v, f);
+        return;
+    }
+    bit *b = f;
+    for (int i = 0; i < width; i++) b[i] = (bit) (v >> (width - 1 - i) & 1u);
+}
+
+static inline size_t cpu_ckpt_state_bits_(void) {
+    size_t n = 0;
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) n += 2 * (size_t) NL_CPU_REGS_[k].width + 1;
+    for (int k = 0; k < NL_CPU_WIRE_NUM; k++) n += (size_t) NL_CPU_WIRES_[k].width;
+    return n;
+}
+
+// checkpoint 的字节数 (与 c 的内容无关)
+static inline size_t cpu_checkpoint_size(void) {
+    return CPU_CKPT_HEADER_BYTES + (cpu_ckpt_state_bits_() + 7) / 8 + IM_SIZE * 4 + DEFAULT_SIZE + 4;
+}
+
+static inline uint32_t ckpt_fnv1a_(const uint8_t *p, const size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+static inline void ckpt_put_le_(uint8_t *p, const uint64_t v, const int bytes) {
+    for (int i = 0; i < bytes; i++) p[i] = (uint8_t) (v >> (8 * i));
+}
+
+static inline uint64_t ckpt_get_le_(const uint8_t *p, const int bytes) {
+    uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = v << 8 | p[i];
+    return v;
+}
+
+static inline void ckpt_header_(uint8_t *h, const uint64_t cycle_count) {
+    memcpy(h, "SCCK", 4);
+    ckpt_put_le_(h + 4, CPU_CKPT_VERSION, 4);
+    ckpt_put_le_(h + 8, IM_SIZE, 4);
+    ckpt_put_le_(h + 12, DEFAULT_SIZE, 4);
+    ckpt_put_le_(h + 16, NL_CPU_REG_NUM, 4);
+    ckpt_put_le_(h + 20, NL_CPU_WIRE_NUM, 4);
+    ckpt_put_le_(h + 24, cpu_ckpt_state_bits_(), 4);
+    ckpt_put_le_(h + 28, cycle_count, 8);
+}
+
+// 写进 buf (至少 cpu_checkpoint_size() 字节), 返回写入的字节数
+static inline size_t cpu_checkpoint_pack(const Cpu_core *c, uint8_t *buf) {
+    const size_t n = cpu_checkpoint_size();
+    memset(buf, 0, n);
+    ckpt_header_(buf, c->cycle_count);
+    Cpu_ckpt_bits s = {buf + CPU_CKPT_HEADER_BYTES, 0};
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *r = &NL_CPU_REGS_[k];
+        ckpt_put_bits_(&s, nl_cpu_field_get_((const char *) c + r->master, r->width), r->width);
+        ckpt_put_bits_(&s, nl_cpu_field_get_((const char *) c + r->q, r->width), r->width);
+        ckpt_put_bits_(&s, nl_cpu_field_get_((const char *) c + r->prev_clk, 1), 1);
+    }
+    for (int k = 0; k < NL_CPU_WIRE_NUM; k++) {
+        const Nl_cpu_wire *w = &NL_CPU_WIRES_[k];
+        ckpt_put_bits_(&s, nl_cpu_field_get_((const char *) c + w->off, w->width), w->width);
+    }
+    uint8_t *p = s.p + (s.pos + 7) / 8;
+    for (int i = 0; i < IM_SIZE; i++, p += 4) ckpt_put_le_(p, u32_from_word(c->im.im[i]), 4);
+    memcpy(p, c->dm.memory, DEFAULT_SIZE);
+    p += DEFAULT_SIZE;
+    ckpt_put_le_(p, ckpt_fnv1a_(buf, (size_t) (p - buf)), 4);
+    return n;
+}
+
+// 从 buf 恢复; 返回 CPU_CKPT_OK 或错误码 (出错时 c 不变)
+static inline int cpu_checkpoint_unpack(Cpu_core *c, const uint8_t *buf, const size_t len) {
+    const size_t n = cpu_checkpoint_size();
+    uint8_t h[CPU_CKPT_HEADER_BYTES];
+    if (len != n || len < CPU_CKPT_HEADER_BYTES) return CPU_CKPT_ERR_FORMAT;
+    ckpt_header_(h, 0);
+    if (memcmp(buf, h, 28) != 0) return CPU_CKPT_ERR_FORMAT;
+    if (ckpt_get_le_(buf + n - 4, 4) != ckpt_fnv1a_(buf, n - 4)) return CPU_CKPT_ERR_CHECKSUM;
+
+    Cpu_ckpt_bits s = {(uint8_t *) buf + CPU_CKPT_HEADER_BYTES, 0};
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *r = &NL_CPU_REGS_[k];
+        ckpt_field_put_((char *) c + r->master, r->width, ckpt_get_bits_(&s, r->width));
+        ckpt_field_put_((char *) c + r->q, r->width, ckpt_get_bits_(&s, r->width));
+        ckpt_field_put_((char *) c + r->prev_clk, 1, ckpt_get_bits_(&s, 1));
+    }
+    for (int k = 0; k < NL_CPU_WIRE_NUM; k++) {
+        const Nl_cpu_wire *w = &NL_CPU_WIRES_[k];
+        ckpt_field_put_((char *) c + w->off, w->width, ckpt_get_bits_(&s, w->width));
+    }
+    const uint8_t *p = s.p + (s.pos + 7) / 8;
+    for (int i = 0; i < IM_SIZE; i++, p += 4) u32_to_word((uint32_t) ckpt_get_le_(p, 4), c->im.im[i]);
+    init_dm_(&c->dm);
+#if SCCPU_PERF_COUNTERS
+    perf_mmio_attach(c); // init_dm_ 换回了普通的读口
+#endif
+    memcpy(c->dm.memory, p, DEFAULT_SIZE);
+    c->cycle_count = ckpt_get_le_(buf + 28, 8);
+#if SCCPU_ACTIVITY_SKIP
+    memset(&c->activity, 0, sizeof(Stage_activity));
+#endif
+#if SCCPU_PERF_COUNTERS
+    perf_reset(&c->perf); // 计数器不在存档里; 在途的指令按气泡算
+#endif
+    cpu_activity_invalidate(c);
+    return CPU_CKPT_OK;
+}
+
+// 存档缓冲区在栈上 (不到 6KB), 不同线程可以同时存 / 读各自的核
+static inline int cpu_checkpoint_save(const Cpu_core *c, const char *path) {
+    uint8_t buf[CPU_CKPT_MAX_BYTES];
+    const size_t n = cpu_checkpoint_pack(c, buf);
+    FILE *f = fopen(path, "wb");
+    if (!f) return CPU_CKPT_ERR_IO;
+    const int ok = fwrite(buf, 1, n, f) == n;
+    return fclose(f) == 0 && ok ? CPU_CKPT_OK : CPU_CKPT_ERR_IO;
+}
+
+static inline int cpu_checkpoint_load(Cpu_core *c, const char *path) {
+    uint8_t buf[CPU_CKPT_MAX_BYTES];
+    FILE *f = fopen(path, "rb");
+    if (!f) return CPU_CKPT_ERR_IO;
+    // 多读一个字节: 文件比预期长也算格式不对
+    const size_t n = fread(buf, 1, cpu_checkpoint_size() + 1, f);
+    const int err = ferror(f);
+    fclose(f);
+    if (err) return CPU_CKPT_ERR_IO;
+    return cpu_checkpoint_unpack(c, buf, n);
+}
+
+#endif //SCCPU_CHECKPOINT_H
@@ -4,31 +4,162 @@
 
 #ifndef SCCPU_COMMON__H
 #define SCCPU_COMMON__H
+#include "stdint.h"
 #define BYTE_SIZE 8
 #define WORD_SIZE 32
 
+// SCCPU_PACKED_WORD = 1 -> word 以 uint32_t 打包存储, 32 根导线在一次位运算中并行求值
+// 默认 0 -> word 是 bit[32], 每根导线一个 _Bool
+#ifndef SCCPU_PACKED_WORD
+#define SCCPU_PACKED_WORD 0
+#endif
+
+// SCCPU_LANES = 64 / 256 -> bit-sliced: 每个 bit 是一个 lane 掩码, 第 l 位属于第 l 个 CPU 实例
+// 门电路本身就是按位逻辑, 同一份电路代码一次求值 64 (uint64_t) / 256 (AVX2 向量) 个 CPU
+#ifndef SCCPU_LANES
+#define SCCPU_LANES 1
+#endif
+
+#if SCCPU_LANES > 1 && SCCPU_PACKED_WORD
+#error "SCCPU_LANES > 1 requires the bit[32] word backend (SCCPU_PACKED_WORD=0)"
+#endif
+
+// SCCPU_NETLIST = 1 -> 网表捕获: bit 是网表节点编号, NOT/AND/OR 不求值而是往网表里追加门 (见 netlist.h)
+// 节点 0 / 1 是常量, 所以 BIT_0 / BIT_1 依然是 0 / 1
+#ifndef SCCPU_NETLIST
+#define SCCPU_NETLIST 0
+#endif
+
+#if SCCPU_NETLIST && (SCCPU_LANES > 1 || SCCPU_PACKED_WORD)
+#error "SCCPU_NETLIST requires the bit[32] word backend with SCCPU_LANES=1"
+#endif
+
+// SCCPU_SHARED_IMAGES = 1 -> IM / DM 不再按值嵌在 Cpu_core 里: IM 指向共享的只读镜像 (Im_image),
+// DM 按页指向共享的初始镜像 (Dm_image), 第一次写某页时复制一份私有页 (见 im.h / dm.h)
+// 同一个程序的多个实例共用代码和初始数据; 写 IM / DM 经过 im_store / im_load / dm_poke / dm_load (写时复制)
+#ifndef SCCPU_SHARED_IMAGES
+#define SCCPU_SHARED_IMAGES 0
+#endif
+
+#if SCCPU_SHARED_IMAGES && (SCCPU_LANES > 1 || SCCPU_NETLIST)
+#error "SCCPU_SHARED_IMAGES requires SCCPU_LANES=1 without SCCPU_NETLIST"
+#endif
+
+// SCCPU_TRACE = 1 / 2 -> cpu_step 每个周期把 PC / 指令 / R0-R3 (1) 或 cpu_dump 的全部内容 (2) 记进 Cpu_core.trace 环形缓冲,
+// cpu_tick 不再逐周期 printf, 需要时用 trace_dump_last(c, n) 打印最后几个周期; 默认 0: 不记录, cpu_tick 照旧 cpu_dump
+#ifndef SCCPU_TRACE
+#define SCCPU_TRACE 0
+#endif
+
+// SCCPU_PIPEVIEW = 1 -> cpu_step 每个周期推进挂在 Cpu_core 上的时间线 (pipeview_attach 之后才写文件), 默认 0: 不跟踪
+#ifndef SCCPU_PIPEVIEW
+#define SCCPU_PIPEVIEW 0
+#endif
+
+#if SCCPU_PIPEVIEW && (SCCPU_LANES > 1 || SCCPU_NETLIST)
+#error "SCCPU_PIPEVIEW requires SCCPU_LANES=1 without SCCPU_NETLIST"
+#endif
+
+// 模块抽象级别 (见 models.h): 每个模块单独选门级 (MODEL_GATE) 或行为级 (MODEL_BEH) 实现
+// 行为级直接在 uint32_t 上运算, 只在 SCCPU_LANES=1 且不做网表捕获时存在
+// dm_read 原本就是 C 写的黑盒, 默认行为级; 门级版本是地址译码 + word 多路选择树
+#define MODEL_GATE 0
+#define MODEL_BEH 1
+#define SCCPU_HAS_BEH_MODELS (SCCPU_LANES == 1 && !SCCPU_NETLIST)
+#ifndef SCCPU_MODEL_ALU
+#define SCCPU_MODEL_ALU MODEL_GATE
+#endif
+#ifndef SCCPU_MODEL_DECODE
+#define SCCPU_MODEL_DECODE MODEL_GATE
+#endif
+#ifndef SCCPU_MODEL_REGFILE
+#define SCCPU_MODEL_REGFILE MODEL_GATE
+#endif
+#ifndef SCCPU_MODEL_PC
+#define SCCPU_MODEL_PC MODEL_GATE
+#endif
+#ifndef SCCPU_MODEL_DM_READ
+#define SCCPU_MODEL_DM_READ MODEL_BEH
+#endif
+
+#if !SCCPU_HAS_BEH_MODELS && (SCCPU_MODEL_ALU == MODEL_BEH || SCCPU_MODEL_DECODE == MODEL_BEH \
+    || SCCPU_MODEL_REGFILE == MODEL_BEH || SCCPU_MODEL_PC == MODEL_BEH || SCCPU_MODEL_DM_READ == MODEL_GATE)
+#error "SCCPU_MODEL_* switches need SCCPU_LANES=1 without SCCPU_NETLIST"
+#endif
+
+#if SCCPU_NETLIST
+typedef uint32_t bit;
+#define BIT_0 ((bit) 0)
+#define BIT_1 ((bit) 1)
+// 只有常量节点有确定的值
+#define LANE_GET(x, lane) ((int) ((x) == BIT_1))
+#elif SCCPU_LANES == 1
 typedef _Bool bit;
+#define BIT_0 0
+#define BIT_1 1
+#define LANE_GET(x, lane) ((int) (x))
+#elif SCCPU_LANES == 64
+typedef uint64_t bit;
+#define BIT_0 ((bit) 0)
+#define BIT_1 (~(bit) 0)
+#define LANE_GET(x, lane) ((int) (((x) >> (lane)) & 1u))
+#define LANE_PUT(x, lane, v) ((x) = ((x) & ~((bit) 1 << (lane))) | ((bit) ((v) & 1u) << (lane)))
+#elif SCCPU_LANES == 256
+typedef uint64_t bit __attribute__((vector_size(32)));
+#define BIT_0 ((bit){0, 0, 0, 0})
+#define BIT_1 ((bit){~0ull, ~0ull, ~0ull, ~0ull})
+#define LANE_GET(x, lane) ((int) (((x)[(lane) >> 6] >> ((lane) & 63)) & 1u))
+#define LANE_PUT(x, lane, v) ((x)[(lane) >> 6] = ((x)[(lane) >> 6] & ~(1ull << ((lane) & 63))) \
+                                               | ((uint64_t) ((v) & 1u) << ((lane) & 63)))
+#else
+#error "SCCPU_LANES must be 1, 64 or 256"
+#endif
+
 typedef bit byte[BYTE_SIZE];
-typedef bit word[WORD_SIZE];
 
 // word[0]=MSB
 
+#if SCCPU_PACKED_WORD
+// word[0] 是整根总线, 存储下标 i 对应 (31 - i) 号位, 依然保持 word[0]=MSB 的约定
+// 声明成数组是为了让 word 形参依旧按"引用"传递 (输出端口写法不变)
+typedef uint32_t word[1];
+
+#define WORD_GET(w, i) ((bit) (((w)[0] >> (WORD_SIZE - 1 - (i))) & 1u))
+#define WORD_SET(w, i, v) ((w)[0] = ((w)[0] & ~(1u << (WORD_SIZE - 1 - (i)))) \
+                                   | ((uint32_t) ((v) & 1u) << (WORD_SIZE - 1 - (i))))
+
 const static byte BYTE_ONE = {0, 0, 0, 0, 0, 0, 0, 1};
 const static byte BYTE_ZERO = {0};
+const static word WORD_ONE = {0x00000001u};
+const static word NOP = {0x00000000u};
+const static word ALL1 = {0xFFFFFFFFu};
+const static word WORD_ZERO = {0};
+#else
+typedef bit word[WORD_SIZE];
+
+#define WORD_GET(w, i) ((w)[(i)])
+#define WORD_SET(w, i, v) ((w)[(i)] = (v))
+
+const static byte BYTE_ONE = {BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_1};
+const static byte BYTE_ZERO = {BIT_0};
 const static word WORD_ONE = {
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1
-};
-const static word NOP = {
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0,
+    BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0,
+    BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_1
 };
+const static word NOP = {BIT_0};
 const static word ALL1 = {
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+    BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1,
+    BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1,
+    BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1, BIT_1
 };
-const static word WORD_ZERO = {0};
+const static word WORD_ZERO = {BIT_0};
+#endif
 
 
 // 逻辑 bit n (31..0) -> 存储下标 index = 31 - n
-#define INST_BIT(instr, n)  ((instr)[WORD_SIZE - 1 - (n)])
+// packed 模式下 INST_BIT 只能读; 写请使用 WORD_SET(w, INST_WORD(n), v)
 #define INST_WORD(n) (WORD_SIZE - 1 - (n))
+#define INST_BIT(instr, n)  WORD_GET((instr), INST_WORD(n))
 
 #endif //SCCPU_COMMON__H
@@ -0,0 +1,108 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_COMPILED_CPU_H
+#define SCCPU_COMPILED_CPU_H
+#include "netlist_cpu.h"
+
+/**
+ * 编译仿真: sccpu_netlist_codegen 把优化后的 CPU 网表展开成一个直线型 C 函数 (compiled_cpu_gen.h)
+ *
+ * 状态像 Verilator 那样打包成机器字: 每个寄存器一个 uint32_t (逻辑位 0 = LSB, 与 reg32_read_u32_ 相同)
+ * 门是局部变量上的 & | ^, 按层排好; 没有函数调用, 没有逐位循环, 也没有 clk=0 / clk=1 两遍求值
+ * IM / DM 是普通数组, 语义与 im_read / dm_read / dm_write 相同
+ *
+ * Cpu_core 接口: compiled_cpu_load / compiled_cpu_store 在两种表示之间搬运状态, cpu_step_compiled 可以直接替换 cpu_step
+ */
+#if SCCPU_NETLIST || SCCPU_LANES != 1 || SCCPU_PACKED_WORD || SCCPU_SHARED_IMAGES
+#error "compiled simulation packs the default bit[32] Cpu_core (SCCPU_LANES=1, no SCCPU_PACKED_WORD / SCCPU_NETLIST / SCCPU_SHARED_IMAGES)"
+#endif
+
+typedef struct compiled_cpu {
+    uint32_t reg[NL_CPU_REG_NUM]; // 与 NL_CPU_REGS_ 一一对应
+    uint32_t wire_pc_src;
+    uint32_t wire_branch_target;
+    uint32_t im[IM_SIZE];
+    uint8_t dm[DEFAULT_SIZE];
+    uint64_t cycle_count;
+} Compiled_cpu;
+
+static inline uint32_t compiled_im_read_(const Compiled_cpu *s, const uint32_t addr) {
+    return addr / 4 < IM_SIZE ? s->im[addr / 4] : 0;
+}
+
+static inline uint32_t compiled_dm_read_(const Compiled_cpu *s, const uint32_t addr) {
+    if ((addr & 3) != 0 || addr >= DEFAULT_SIZE) return 0;
+    const uint8_t *m = &s->dm[addr];
+    return (uint32_t) m[0] << 24 | (uint32_t) m[1] << 16 | (uint32_t) m[2] << 8 | m[3];
+}
+
+// be 的第 i 位 = byte_enable_mask[i] (i = 0 是最高字节)
+static inline void compiled_dm_write_(Compiled_cpu *s, const uint32_t addr, const uint32_t data, const uint32_t be) {
+    if ((addr & 3) != 0 || addr >= DEFAULT_SIZE) return;
+    for (int i = 0; i < 4; i++) {
+        if ((be >> i) & 1u) s->dm[addr + i] = (uint8_t) (data >> (24 - 8 * i));
+    }
+}
+
+#include "compiled_cpu_gen.h"
+
+// q[0] 是最高位
+static inline uint32_t compiled_pack_(const bit *q, const int width) {
+    uint32_t v = 0;
+    for (int i = 0; i < width; i++) v = v << 1 | (uint32_t) q[i];
+    return v;
+}
+
+static inline void compiled_unpack_(const uint32_t v, bit *q, const int width) {
+    for (int i = 0; i < width; i++) q[i] = (bit) ((v >> (width - 1 - i)) & 1u);
+}
+
+static inline void compiled_cpu_load(Compiled_cpu *s, const Cpu_core *c) {
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *r = &NL_CPU_REGS_[k];
+        s->reg[k] = compiled_pack_(nl_cpu_q_((Cpu_core *) c, r), r->width);
+    }
+    s->wire_pc_src = compiled_pack_(c->wire_pc_src, 2);
+    s->wire_branch_target = u32_from_word(c->wire_branch_target);
+    for (int i = 0; i < IM_SIZE; i++) s->im[i] = u32_from_word(c->im.im[i]);
+    memcpy(s->dm, c->dm.memory, sizeof(s->dm));
+    s->cycle_count = c->cycle_count;
+}
+
+// 只写回 Q; master 在下一个 clk=0 会重新跟随 D, 不需要搬
+static inline void compiled_cpu_store(const Compiled_cpu *s, Cpu_core *c) {
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *r = &NL_CPU_REGS_[k];
+        compiled_unpack_(s->reg[k], nl_cpu_q_(c, r), r->width);
+    }
+    compiled_unpack_(s->wire_pc_src, c->wire_pc_src, 2);
+    u32_to_word(s->wire_branch_target, c->wire_branch_target);
+    memcpy(c->dm.memory, s->dm, sizeof(s->dm));
+    c->cycle_count = s->cycle_count;
+}
+
+static inline void compiled_cpu_init(Compiled_cpu *s) {
+    memset(s, 0, sizeof(Compiled_cpu));
+}
+
+static inline void compiled_cpu_load_program(Compiled_cpu *s, const uint32_t *program_codes, const size_t codes_len) {
+    const size_t len = codes_len > IM_SIZE ? IM_SIZE : codes_len;
+    memcpy(s->im, program_codes, len * sizeof(uint32_t));
+}
+
+static inline void compiled_cpu_tick(Compiled_cpu *s) {
+    compiled_cpu_cycle_(s);
+    s->cycle_count++;
+}
+
+// Cpu_core 上的一个周期: 每次都要搬一遍状态, 长时间运行应直接用 Compiled_cpu
+static inline void cpu_step_compiled(Cpu_core *c) {
+    static Compiled_cpu s;
+    compiled_cpu_load(&s, c);
+    compiled_cpu_tick(&s);
+    compiled_cpu_store(&s, c);
+}
+
+#endif //SCCPU_COMPILED_CPU_H
@@ -0,0 +1,224 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_COSIM_H
+#define SCCPU_COSIM_H
+#include "iss.h"
+
+/**
+ * 锁步对拍: 参考 ISS 在指令从 WB 退休时按 isa.h 执行同一条指令 (iss_exec_arch), 与流水线比较
+ *  退休的 PC      == ISS 的当前 PC (前一条指令算出的 next PC)
+ *  DM 写          这条指令在 MEM 时实际写进 DM 的地址 / 数据 == ISS 的写
+ *  寄存器写       WB 之后 regfile 的 R0-R3 == ISS 的 R0-R3 (多写 / 少写 / 写错都会反映出来)
+ * 第一次不一致就停下, 打印周期、PC、期望 / 实际和 cpu_dump 的各阶段内容 (SCCPU_TRACE 时是跟踪环里最后几个周期)
+ * RTL 已知的偏差 (BEQ 只比最高字节、J 不跳) 不算不一致: 按种类记进 deviations[], 参考模型改走 RTL 的 next PC 继续;
+ * cosim_report_deviations 打印计数, 不一致的报告里也带上
+ *
+ * 流水线寄存器里不带 PC, 对拍器在旁边维护一份影子流水线 (每级一个 PC + 有效位):
+ * 每个周期按 hazard 导线的 write / flush 推进, IF 取进来的是周期开始时的 PC, 冲掉的变成气泡
+ * 从排空的 Cpu_core 开始 (init_cpu_c 之后或 iss_to_cpu / cpu_drain 之后), 用 cosim_step 代替 cpu_step
+ */
+
+#define COSIM_TRACE_CYCLES 8
+
+typedef struct cosim_slot {
+    int valid; // 0 -> 气泡
+    uint32_t pc;
+    int mem_write; // 在 MEM 时实际写了 DM
+    uint32_t mem_addr;
+    uint32_t mem_value;
+} Cosim_slot;
+
+typedef struct cosim {
+    Iss ref;
+    Cosim_slot if_id, id_ex, ex_mem, mem_wb;
+    uint64_t retired; // 退休的指令数 (含 NOP, 不含气泡)
+    uint64_t deviations[ISS_DEV_NUM]; // 按种类数的已知偏差
+    int diverged;
+} Cosim;
+
+// c 必须是排空的; 参考模型从 c 的架构状态开始
+static inline void cosim_init(Cosim *k, const Cpu_core *c) {
+    memset(k, 0, sizeof(Cosim));
+    iss_read_cpu(&k->ref, c);
+}
+
+// 已知偏差的总数
+static inline uint64_t cosim_deviation_count(const Cosim *k) {
+    uint64_t n = 0;
+    for (int d = ISS_DEV_NONE + 1; d < ISS_DEV_NUM; d++) n += k->deviations[d];
+    return n;
+}
+
+static inline void cosim_report_deviations(const Cosim *k) {
+    printf("        known RTL deviations (reference followed the RTL next pc):");
+    for (int d = ISS_DEV_NONE + 1; d < ISS_DEV_NUM; d++) printf(" %s %lu", ISS_DEV_NAMES_[d], k->deviations[d]);
+    printf("\n");
+}
+
+static inline void cosim_report_(const Cosim *k, const Cpu_core *c, const Cosim_slot *s, const char *what) {
+    const uint32_t inst = s->pc / 4 < IM_SIZE ? k->ref.im[s->pc / 4] : 0;
+    printf("[COSIM] divergence at cycle %lu: %s\n", c->cycle_count, what);
+    printf("        retiring pc=0x%08X inst=0x%08X (ISS pc=0x%08X, %lu instructions retired before it)\n", s->pc,
+           inst, k->ref.pc, k->retired);
+    printf("        ISS R0-R3 = %08X %08X %08X %08X\n", k->ref.r[0], k->ref.r[1], k->ref.r[2], k->ref.r[3]);
+    printf("        RTL R0-R3 = %08X %08X %08X %08X\n", reg32_read_u32_(&c->rf.r0), reg32_read_u32_(&c->rf.r1),
+           reg32_read_u32_(&c->rf.r2), reg32_read_u32_(&c->rf.r3));
+    if (cosim_deviation_count(k)) cosim_report_deviations(k);
+#if SCCPU_TRACE
+    trace_dump_last(c, COSIM_TRACE_CYCLES); // 跟踪环里最后几个周期, 最后一个就是当前周期
+#else
+    cpu_dump(c);
+#endif
+}
+
+static inline int cosim_rf_same_(const Cosim *k, const Cpu_core *c) {
+    return reg32_read_u32_(&c->rf.r0) == k->ref.r[0] && reg32_read_u32_(&c->rf.r1) == k->ref.r[1]
+           && reg32_read_u32_(&c->rf.r2) == k->ref.r[2] && reg32_read_u32_(&c->rf.r3) == k->ref.r[3];
+}
+
+// 推进一个周期并检查这个周期退休的指令; 不一致时打印报告并返回 1 (之后不再推进)
+static inline int cosim_step(Cosim *k, Cpu_core *c) {
+    if (k->diverged) return 1;
+    // 周期开始时: IF 取的 PC, MEM 要做的 DM 写 (dm_write 对非对齐 / 越界不写)
+    const uint32_t fetch_pc = reg32_read_u32_(&c->pc.reg32);
+    const uint32_t addr = reg32_read_u32_(&c->ex_mem.alu_result);
+    const int mem_write = LANE_GET(GET_BIT_OF_REGN(&c->ex_mem.mem_single, 0), 0) && (addr & 3) == 0
+                          && addr < DEFAULT_SIZE;
+    const uint32_t mem_value = reg32_read_u32_(&c->ex_mem.write_data);
+
+    cpu_step(c);
+
+    // 影子流水线按本周期的 hazard 导线推进
+    const Cosim_slot retire = k->mem_wb;
+    k->mem_wb = k->ex_mem;
+    k->mem_wb.mem_write = mem_write;
+    k->mem_wb.mem_addr = addr;
+    k->mem_wb.mem_value = mem_value;
+    k->ex_mem = k->id_ex;
+    if (LANE_GET(c->wire_id_ex_ctrl.id_ex_flush, 0)) memset(&k->id_ex, 0, sizeof(Cosim_slot));
+    else if (LANE_GET(c->wire_id_ex_ctrl.id_ex_write, 0)) k->id_ex = k->if_id;
+    if (LANE_GET(c->wire_if_id_ctrl.if_id_flush, 0)) memset(&k->if_id, 0, sizeof(Cosim_slot));
+    else if (LANE_GET(c->wire_if_id_ctrl.if_id_write, 0)) {
+        memset(&k->if_id, 0, sizeof(Cosim_slot));
+        k->if_id.valid = 1;
+        k->if_id.pc = fetch_pc;
+    }
+
+    char what[160];
+    if (!retire.valid) {
+        // 气泡: 不应该写 DM, regfile 不应该变
+        if (!retire.mem_write && cosim_rf_same_(k, c)) return 0;
+        snprintf(what, sizeof(what), "a bubble changed architectural state");
+        k->diverged = 1;
+        cosim_report_(k, c, &retire, what);
+        return 1;
+    }
+    if (retire.pc != k->ref.pc) {
+        snprintf(what, sizeof(what), "next pc: expected 0x%08X, pipeline retired 0x%08X", k->ref.pc, retire.pc);
+        k->diverged = 1;
+        cosim_report_(k, c, &retire, what);
+        return 1;
+    }
+    Iss_effect fx;
+    iss_exec_arch(&k->ref, &fx);
+    if (fx.mem_write != retire.mem_write
+        || (fx.mem_write && (fx.mem_addr != retire.mem_addr || fx.mem_value != retire.mem_value))) {
+        snprintf(what, sizeof(what), "memory write: expected %s[0x%08X]=0x%08X, pipeline %s[0x%08X]=0x%08X",
+                 fx.mem_write ? "" : "none ", fx.mem_addr, fx.mem_value, retire.mem_write ? "" : "none ",
+                 retire.mem_addr, retire.mem_value);
+    } else if (!cosim_rf_same_(k, c)) {
+        if (fx.reg_write) snprintf(what, sizeof(what), "register write: expected R%u=0x%08X", fx.reg_idx, fx.reg_value);
+        else snprintf(what, sizeof(what), "register file changed by an instruction that writes no register");
+    } else {
+        k->retired++;
+        if (fx.deviation != ISS_DEV_NONE) {
+            // 流水线已经在 RTL 的路径上取指了, 参考模型跟过去
+            k->deviations[fx.deviation]++;
+            k->ref.pc = fx.rtl_next_pc;
+        }
+        return 0;
+    }
+    k->diverged = 1;
+    cosim_report_(k, c, &retire, what);
+    return 1;
+}
+
+// 跑 cycles 个周期; 返回 0 表示全部一致
+static inline int cosim_run(Cosim *k, Cpu_core *c, const uint64_t cycles) {
+    for (uint64_t i = 0; i < cycles; i++) {
+        if (cosim_step(k, c)) return 1;
+    }
+    return 0;
+}
+
+/**
+ * 随机负载: n_insts 条随机指令 (ADD/SUB/AND/OR/SLT/未知 funct/ADDI/LW/SW/J/BEQ), 每条后面 gap 个 NOP,
+ * BEQ 只向前跳且不越过结尾的 BEQ R0,R0,-1 自循环; 返回自循环的地址
+ * 当前流水线没有前递, gap >= 3 才是无冒险的程序; gap 更小时对拍器应该报告读到旧值的那条指令
+ */
+static inline uint32_t cosim_random_program(uint32_t *prog, const int n_insts, const int gap, uint64_t *rng) {
+    int n = 0;
+    const int end = n_insts * (gap + 1);
+    for (int k = 0; k < n_insts; k++) {
+        uint32_t x[4];
+        for (int i = 0; i < 4; i++) {
+            *rng ^= *rng << 13;
+            *rng ^= *rng >> 7;
+            *rng ^= *rng << 17;
+            x[i] = (uint32_t) *rng;
+        }
+        const uint8_t a = x[0] & 3, b = x[0] >> 2 & 3, d = x[0] >> 4 & 3;
+        switch (x[1] % 12) {
+            case 0: prog[n] = enc_r(a, b, d, 0, FUNCT_ADD);
+                break;
+            case 1: prog[n] = enc_r(a, b, d, 0, FUNCT_SUB);
+                break;
+            case 2: prog[n] = enc_r(a, b, d, 0, FUNCT_AND);
+                break;
+            case 3: prog[n] = enc_r(a, b, d, 0, FUNCT_OR);
+                break;
+            case 4: prog[n] = enc_r(a, b, d, 0, FUNCT_SLT);
+                break;
+            case 5: prog[n] = enc_r(a, b, d, 0, 0x26);
+                break;
+            case 6:
+            case 7: prog[n] = enc_addi(b, a, (int16_t) (x[2] % 200 - 100));
+                break;
+            case 8: prog[n] = enc_i(OP_LW, a, b, (int16_t) ((x[2] % 64) * 4));
+                break;
+            case 9: prog[n] = enc_i(OP_SW, a, b, (int16_t) ((x[2] % 64) * 4));
+                break;
+            case 10: prog[n] = enc_j(OP_J, x[2] & 0xFF);
+                break;
+            default: {
+                const int room = end - n - 1;
+                prog[n] = enc_beq(a, b, (int16_t) (x[3] % (uint32_t) (room < 8 ? room + 1 : 8)));
+                break;
+            }
+        }
+        n++;
+        for (int i = 0; i < gap; i++) prog[n++] = 0;
+    }
+    prog[n] = enc_beq(0, 0, -1);
+    return (uint32_t) n * 4;
+}
+
+// 随机程序经 im_load 装进 c (init_cpu_c 之后, 共享镜像下写时复制; 写过的核先 cpu_release);
+// fill_dm 时 DM 按程序字的各字节填满 (dm_load); 返回自循环的地址
+static inline uint32_t cosim_load_random(Cpu_core *c, const int n_insts, const int gap, const int fill_dm,
+                                         uint64_t *rng) {
+    uint32_t prog[IM_SIZE] = {0};
+    const uint32_t halt = cosim_random_program(prog, n_insts, gap, rng);
+    init_cpu_c(c);
+    (void) im_load(&c->im, prog, IM_SIZE);
+    if (fill_dm) {
+        uint8_t dm[DEFAULT_SIZE];
+        for (int i = 0; i < DEFAULT_SIZE; i++) dm[i] = (uint8_t) (prog[i % IM_SIZE] >> (i & 24));
+        (void) dm_load(&c->dm, dm, DEFAULT_SIZE);
+    }
+    return halt;
+}
+
+#endif //SCCPU_COSIM_H
@@ -5,6 +5,7 @@
 #ifndef SCCPU_CPU_CORE_H
 #define SCCPU_CPU_CORE_H
 #include "stdio.h"
+#include "stddef.h"
 #include "reg.h"
 #include "pc.h"
 #include "if_id.h"
@@ -16,6 +17,122 @@
 #include "wb.h"
 #include "utils.h"
 
+// SCCPU_TICK_SINGLE_EVAL = 1 -> 每个阶段的组合逻辑只在 clk=0 求值一次, clk=1 只把缓存的 D 端提交
+// 默认 0 -> 每个阶段在 clk=0 / clk=1 各完整调用一次 *_step (参考实现)
+#ifndef SCCPU_TICK_SINGLE_EVAL
+#define SCCPU_TICK_SINGLE_EVAL 0
+#endif
+
+// SCCPU_ACTIVITY_SKIP = 1 -> 在单次求值的基础上按活动性调度: 某阶段的输入寄存器/导线与上次求值时相同,
+// 就沿用上次的 wire_* 输出, 跳过该阶段的组合逻辑和其输出寄存器的 DFF (统计见 cpu_activity_report)
+// 输入快照 Cpu_core.activity (约 1KB) 只在这个模式下存在
+#ifndef SCCPU_ACTIVITY_SKIP
+#define SCCPU_ACTIVITY_SKIP 0
+#endif
+
+// SCCPU_STAGE_THREADS = 1 -> cpu_step 用 cpu_cycle_threaded: 单次求值的各阶段分给 3 个线程 (见 cpu_cycle_threaded)
+#ifndef SCCPU_STAGE_THREADS
+#define SCCPU_STAGE_THREADS 0
+#endif
+#if SCCPU_STAGE_THREADS && (SCCPU_ACTIVITY_SKIP || SCCPU_NETLIST)
+#error "SCCPU_STAGE_THREADS cannot be combined with SCCPU_ACTIVITY_SKIP / SCCPU_NETLIST"
+#endif
+#if SCCPU_STAGE_THREADS
+#include "pthread.h"
+#include "spin_barrier.h"
+#endif
+
+// SCCPU_PERF_COUNTERS = 1 -> cpu_step 之后累加 Cpu_core.perf, LW 能从 DM 后面的计数器区读到 (见 perf.h)
+#ifndef SCCPU_PERF_COUNTERS
+#define SCCPU_PERF_COUNTERS 0
+#endif
+#if SCCPU_PERF_COUNTERS && (SCCPU_LANES > 1 || SCCPU_NETLIST)
+#error "SCCPU_PERF_COUNTERS requires SCCPU_LANES=1 without SCCPU_NETLIST"
+#endif
+
+enum { STAGE_WB, STAGE_MEM, STAGE_EX, STAGE_ID, STAGE_IF, STAGE_NUM };
+
+#if SCCPU_ACTIVITY_SKIP
+// 各阶段上次求值时的输入快照
+// IF 的输入是 PC, 每个周期都会变, 不做快照
+// pc_plus4 每个周期都变, 但在 ID 只是穿过, 在 EX 只进 branch_target 加法器, 单独比较 (只推进这一路)
+typedef struct stage_activity {
+    int valid; // 0 -> 快照无效, 下个周期全部求值
+    Mem_wb_regs wb_in;
+    Ex_mem_regs mem_in;
+    Id_ex_regs ex_in;
+    If_id_regs id_in;
+    Reg324file_ id_rf;
+    Id_ex_write id_ctrl;
+    uint64_t evals[STAGE_NUM];
+    uint64_t skips[STAGE_NUM];
+} Stage_activity;
+#endif
+
+#if SCCPU_PERF_COUNTERS
+// 性能计数器的编号, 也是计数器区里的顺序; PERF_BUBBLES 和 PERF_OP_* 同时是指令的类别
+typedef enum perf_event {
+    PERF_CYCLES, PERF_INSTRUCTIONS, PERF_BUBBLES, PERF_REG_WRITES,
+    PERF_BRANCH_TAKEN, PERF_BRANCH_NOT_TAKEN, PERF_FLUSHES,
+    PERF_OP_NOP, PERF_OP_ADD, PERF_OP_SUB, PERF_OP_AND, PERF_OP_OR, PERF_OP_SLT,
+    PERF_OP_ADDI, PERF_OP_LW, PERF_OP_SW, PERF_OP_BEQ, PERF_OP_J,
+    PERF_NUM
+} Perf_event;
+
+typedef struct perf_counters {
+    uint64_t v[PERF_NUM];
+    uint8_t id_valid; // IF/ID 里是取进来的指令 (冲掉 / 复位后的全 0 译出来和 NOP 一样)
+    uint8_t ex, mem, wb; // 这三级里指令的类别, 到 WB 时计入
+    uint8_t wb_reg_write; // WB 里的指令写不写寄存器 (MEM/WB.wb_single)
+} Perf_counters;
+
+// 清零; 流水线当作全是气泡 (在排空的流水线上调用)
+static inline void perf_reset(Perf_counters *p) {
+    memset(p, 0, sizeof(Perf_counters));
+    p->ex = p->mem = p->wb = PERF_BUBBLES;
+}
+#endif
+
+// 跟踪环的类别 / 事件 / 环本身; 记录和格式化在 trace.h
+typedef enum {
+    TRACE_CAT_IF = 0, // PC, IF/ID.instr
+    TRACE_CAT_ID, // ID/EX: decode_signals | rs | rt | rd, read_data1, read_data2, imm_ext
+    TRACE_CAT_EX, // EX/MEM: mem_single | wb_single | write_reg_idx, alu_result, write_data
+    TRACE_CAT_MEM, // MEM/WB: wb_single | write_reg_idx, mem_read_data, alu_result
+    TRACE_CAT_REGS, // R0-R3
+    TRACE_CAT_HAZARD, // pc_src | hazard 控制线, branch_target
+    TRACE_CAT_NUM
+} Trace_cat;
+
+#define TRACE_MASK(cat) (1u << (cat))
+#define TRACE_CATS_ALL ((1u << TRACE_CAT_NUM) - 1)
+#define TRACE_CATS_SUMMARY (TRACE_MASK(TRACE_CAT_IF) | TRACE_MASK(TRACE_CAT_REGS))
+
+typedef struct trace_ev {
+    uint64_t cycle;
+    uint32_t cat;
+    uint32_t v[4];
+} Trace_ev;
+
+#ifndef SCCPU_TRACE_EVENTS
+#define SCCPU_TRACE_EVENTS 4096
+#endif
+
+#if SCCPU_TRACE_EVENTS & (SCCPU_TRACE_EVENTS - 1)
+#error "SCCPU_TRACE_EVENTS must be a power of two"
+#endif
+
+typedef struct trace_ring {
+    Trace_ev ev[SCCPU_TRACE_EVENTS];
+    uint64_t head; // 写过的事件总数, 下一条写在 head % SCCPU_TRACE_EVENTS
+    uint32_t cats; // 运行时类别掩码
+} Trace_ring;
+
+static inline void trace_init(Trace_ring *t, const uint32_t cats) {
+    t->head = 0;
+    t->cats = cats;
+}
+
 typedef struct cpu_core {
     // ----Register state ---
     Pc32_ pc; // PC
@@ -39,12 +156,67 @@ typedef struct cpu_core {
     If_id_write wire_if_id_ctrl;
     Id_ex_write wire_id_ex_ctrl;
 
+    // 各阶段组合逻辑的输出 (寄存器 D 端), clk=0 时求值
+    Wb_wires wire_wb;
+    Mem_wb_wires wire_mem;
+    Ex_mem_wires wire_ex;
+    Id_ex_wires wire_id;
+    If_id_wires wire_if;
+
+#if SCCPU_ACTIVITY_SKIP
+    Stage_activity activity;
+#endif
+#if SCCPU_DECODE_CACHE
+    Decode_cache decode_cache; // 只有这个核的 ID 阶段访问
+#endif
+#if SCCPU_PERF_COUNTERS
+    Perf_counters perf;
+#endif
+#if SCCPU_TRACE
+    Trace_ring trace; // cpu_step 每个周期记进来 (见 trace.h)
+#endif
+#if SCCPU_PIPEVIEW
+    struct pipeview *pipeview; // cpu_step 每个周期推进的时间线 (pipeview_attach), NULL 不跟踪
+#endif
+
     uint64_t cycle_count;
 } Cpu_core;
 
+#if SCCPU_DECODE_CACHE
+#define CPU_DECODE_CACHE_(c) (&(c)->decode_cache)
+#else
+#define CPU_DECODE_CACHE_(c) NULL
+#endif
+
 static inline
 void cpu_dump(const Cpu_core *c);
 
+#if SCCPU_TRACE
+static inline
+void trace_cycle(Cpu_core *c);
+#define TRACE_CYCLE(c) trace_cycle(c)
+#else
+#define TRACE_CYCLE(c) ((void) 0)
+#endif
+
+#if SCCPU_PERF_COUNTERS
+static inline
+void perf_record(Cpu_core *c);
+static inline
+void perf_mmio_attach(Cpu_core *c);
+#define PERF_CYCLE(c) perf_record(c)
+#else
+#define PERF_CYCLE(c) ((void) 0)
+#endif
+
+#if SCCPU_PIPEVIEW
+static inline
+void pipeview_cycle(const Cpu_core *c);
+#define PIPEVIEW_CYCLE(c) pipeview_cycle(c)
+#else
+#define PIPEVIEW_CYCLE(c) ((void) 0)
+#endif
+
 static inline
 void hazard_unit_evaluate(Cpu_core *c);
 
@@ -61,9 +233,39 @@ void init_cpu_c(Cpu_core *c) {
     memset(&c->wire_pc_src, 0, sizeof(pc_ops));
     memset(&c->wire_if_id_ctrl, 0, sizeof(If_id_write));
     memset(&c->wire_id_ex_ctrl, 0, sizeof(Id_ex_write));
+    memset(&c->wire_wb, 0, sizeof(Wb_wires));
+    memset(&c->wire_mem, 0, sizeof(Mem_wb_wires));
+    memset(&c->wire_ex, 0, sizeof(Ex_mem_wires));
+    memset(&c->wire_id, 0, sizeof(Id_ex_wires));
+    memset(&c->wire_if, 0, sizeof(If_id_wires));
+#if SCCPU_ACTIVITY_SKIP
+    memset(&c->activity, 0, sizeof(Stage_activity));
+#endif
+#if SCCPU_DECODE_CACHE
+    decode_cache_reset(&c->decode_cache);
+#endif
+#if SCCPU_PERF_COUNTERS
+    perf_reset(&c->perf);
+    perf_mmio_attach(c);
+#endif
+#if SCCPU_TRACE
+    trace_init(&c->trace, TRACE_CATS_ALL);
+#endif
+#if SCCPU_PIPEVIEW
+    c->pipeview = NULL;
+#endif
     c->cycle_count = 0;
 }
 
+#if SCCPU_LANES == 1 && !SCCPU_NETLIST
+// 丢掉写进 IM / DM 的内容; SCCPU_SHARED_IMAGES 下释放写时复制出的私有副本, 写过的核重新 init_cpu_c 之前调用
+static inline
+void cpu_release(Cpu_core *c) {
+    im_release(&c->im);
+    dm_release(&c->dm);
+}
+#endif
+
 static inline void hazard_unit_evaluate(Cpu_core *c) {
     // 1. 获取 EX 阶段算出的跳转信号 (Wire)
     const bit branch_taken = AND(c->wire_pc_src[0], NOT(c->wire_pc_src[1]));
@@ -72,35 +274,36 @@ static inline void hazard_unit_evaluate(Cpu_core *c) {
     c->wire_if_id_ctrl.if_id_flush = branch_taken;
     c->wire_id_ex_ctrl.id_ex_flush = branch_taken;
 
-    c->wire_if_id_ctrl.pc_write = 1;
-    c->wire_if_id_ctrl.if_id_write = 1;
-    c->wire_id_ex_ctrl.id_ex_write = 1;
+    c->wire_if_id_ctrl.pc_write = BIT_1;
+    c->wire_if_id_ctrl.if_id_write = BIT_1;
+    c->wire_id_ex_ctrl.id_ex_write = BIT_1;
 }
 
 
+// 两段式参考实现: 每个阶段在 clk=0 和 clk=1 各完整求值一次
 static inline
-void cpu_tick(Cpu_core *c) {
-    bit overflow_ = 0;
+void cpu_cycle_two_pass(Cpu_core *c) {
+    bit overflow_ = BIT_0;
     // ============================================================
     // Phase 0: Combinational Logic Evaluation (CLK = 0)
     // 目标：计算所有 Wires，准备好 D 端的输入,采样(Sampling)
     // 顺序: 为了让“回环”生效，必须先算后端，再算前端
     // ============================================================
-    wb_step(&c->mem_wb, &c->rf, 0);
+    wb_step(&c->mem_wb, &c->rf, BIT_0);
 
     // 2. MEM 阶段
     //write_enabled 掩码暂时全1
-    bit mem_we_mask[4] = {1, 1, 1, 1};
-    mem_wb_regs_step(&c->ex_mem, &c->mem_wb, &c->dm, mem_we_mask, 0);
+    bit mem_we_mask[4] = {BIT_1, BIT_1, BIT_1, BIT_1};
+    mem_wb_regs_step(&c->ex_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_0);
 
     // ex_flush暂无
     ex_mem_regs_step(&c->id_ex, &c->ex_mem, c->wire_pc_src, c->wire_branch_target,
-                     0, &overflow_, 0);
+                     BIT_0, &overflow_, BIT_0);
     hazard_unit_evaluate(c);
 
-    id_ex_regs_step(&c->id_ex, &c->if_id, &c->rf, &c->wire_id_ex_ctrl, 0);
+    id_ex_regs_step(&c->id_ex, &c->if_id, &c->rf, &c->wire_id_ex_ctrl, CPU_DECODE_CACHE_(c), BIT_0);
 
-    If_id_pc_ops if_ops_in;
+    If_id_pc_ops if_ops_in = {0};
     if_ops_in.pc_ops_[0] = c->wire_pc_src[0];
     if_ops_in.pc_ops_[1] = c->wire_pc_src[1];
     connect(c->wire_branch_target, if_ops_in.branch_target_wire);
@@ -108,7 +311,7 @@ void cpu_tick(Cpu_core *c) {
 
     if_id_regs_step(&c->if_id, &c->im, &c->pc,
                     &if_ops_in, &c->wire_if_id_ctrl,
-                    &overflow_, 0);
+                    &overflow_, BIT_0);
 
 
     // ============================================================
@@ -117,91 +320,365 @@ void cpu_tick(Cpu_core *c) {
     // ============================================================
 
     // 1. WB (写回 RegFile)
-    wb_step(&c->mem_wb, &c->rf, 1);
+    wb_step(&c->mem_wb, &c->rf, BIT_1);
 
     // 2. MEM (写 Memory, 更新 MEM/WB)
-    mem_wb_regs_step(&c->ex_mem, &c->mem_wb, &c->dm, mem_we_mask, 1);
+    mem_wb_regs_step(&c->ex_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_1);
 
     // 3. EX (更新 EX/MEM)
-    ex_mem_regs_step(&c->id_ex, &c->ex_mem, c->wire_pc_src, c->wire_branch_target, 0, &overflow_, 1);
+    ex_mem_regs_step(&c->id_ex, &c->ex_mem, c->wire_pc_src, c->wire_branch_target, BIT_0, &overflow_, BIT_1);
 
     // 4. ID (更新 ID/EX)
-    id_ex_regs_step(&c->id_ex, &c->if_id, &c->rf, &c->wire_id_ex_ctrl, 1);
+    id_ex_regs_step(&c->id_ex, &c->if_id, &c->rf, &c->wire_id_ex_ctrl, CPU_DECODE_CACHE_(c), BIT_1);
 
     // 5. IF (更新 IF/ID 和 PC)
-    if_id_regs_step(&c->if_id, &c->im, &c->pc, &if_ops_in, &c->wire_if_id_ctrl, &overflow_, 1);
+    if_id_regs_step(&c->if_id, &c->im, &c->pc, &if_ops_in, &c->wire_if_id_ctrl, &overflow_, BIT_1);
+}
 
-    c->cycle_count++;
+// 单次求值: clk=0 时每个阶段的组合逻辑只求值一次, 结果缓存在 wire_* 并采样进 master
+// clk=1 时 DFF 忽略 D 端, 只需要按同样的顺序提交 (DM 写也用缓存的地址/数据)
+static inline
+void cpu_cycle_single_eval(Cpu_core *c) {
+    bit overflow_ = BIT_0;
+    bit mem_we_mask[4] = {BIT_1, BIT_1, BIT_1, BIT_1};
 
-    // Dump Log
-    cpu_dump(c);
-}
-
-
-static inline
-void cpu_dump(const Cpu_core *c) {
-    printf(
-        "\n================================================CpuCoreDump================================================\n");
-    printf("\n=======Cycle %lu=======\n", c->cycle_count);
-    // IF
-    printf("[IF] PC:0x%08X | Instr:0x%08X \n", reg32_read_u32_(&c->pc.reg32), reg32_read_u32_(&c->if_id.instr));
-    const uint32_t signals = reg32_read_u32_(&c->id_ex.decode_signals);
-    char buffer[1024];
-    dis_asm(signals, buffer);
-    // ID
-    printf(
-        "[ID] Signals:%s\n"
-        "     ReadData1:0x%08X, ReadData2:0x%08X, ImmExt:0x%08X, RsIdx:0x%04X, RtIdx:0x%04X, RdIdx:0x%04X\n",
-        buffer,
-        reg32_read_u32_(&c->id_ex.read_data1),
-        reg32_read_u32_(&c->id_ex.read_data2),
-        reg32_read_u32_(&c->id_ex.imm_ext),
-        reg32_read_u32_(&c->id_ex.rs_idx),
-        reg32_read_u32_(&c->id_ex.rt_idx),
-        reg32_read_u32_(&c->id_ex.rd_idx)
-    );
-    // EX
-    printf(
-        "[EX] MemSingle-Read:%d, MemSingle-Write:%d, WbSingle-RegWrite:%d, WbSingle-DataSrcToReg:%d, AluResult:0x%08X, WriteData:0x%08X, WriteRegIdx:%d%d\n",
-        GET_BIT_OF_REG32(&c->ex_mem.mem_single, 31),
-        GET_BIT_OF_REG32(&c->ex_mem.mem_single, 30),
-        GET_BIT_OF_REG32(&c->ex_mem.wb_single, 31),
-        GET_BIT_OF_REG32(&c->ex_mem.wb_single, 30),
-        reg32_read_u32_(&c->ex_mem.alu_result),
-        reg32_read_u32_(&c->ex_mem.write_data),
-        GET_BIT_OF_REG32(&c->ex_mem.write_reg_idx, 0),
-        GET_BIT_OF_REG32(&c->ex_mem.write_reg_idx, 1)
-    );
-    // MEM
-    printf(
-        "[MEM] WbSingle-RegWrite:%d, WbSingle-DataSrcToReg:%d, Mem-Read-Data:0x%08X, AluResult:0x%08X, WriteRegIdx:%d%d\n",
-        GET_BIT_OF_REG32(&c->mem_wb.wb_single, 31),
-        GET_BIT_OF_REG32(&c->mem_wb.wb_single, 30),
-        reg32_read_u32_(&c->mem_wb.mem_read_data),
-        reg32_read_u32_(&c->mem_wb.alu_result),
-        GET_BIT_OF_REG32(&c->mem_wb.write_reg_idx, 0),
-        GET_BIT_OF_REG32(&c->mem_wb.write_reg_idx, 1)
-    );
+    // ============================================================
+    // Phase 0: Combinational Logic Evaluation (CLK = 0)
+    // ============================================================
+    wb_eval(&c->mem_wb, &c->wire_wb);
+    wb_latch(&c->wire_wb, &c->rf, BIT_0);
 
-    // General-purpose register
-    printf("[General-Purpose-Register Dump]:\n");
-    printf("                                R0:0x%08X\n", reg32_read_u32_(&c->rf.r0));
-    printf("                                R1:0x%08X\n", reg32_read_u32_(&c->rf.r1));
-    printf("                                R2:0x%08X\n", reg32_read_u32_(&c->rf.r2));
-    printf("                                R3:0x%08X\n", reg32_read_u32_(&c->rf.r3));
+    mem_wb_eval(&c->ex_mem, &c->dm, &c->wire_mem);
+    mem_wb_latch(&c->wire_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_0);
 
-    // Wires / Glue Logic
-    printf("[Wires/Glue-Logic]:\n");
-    printf("                                Pc-ops:%d%d\n", c->wire_pc_src[0], c->wire_pc_src[1]);
-    printf("                                Wire_branch_target:0x%08X\n", u32_from_word(c->wire_branch_target));
+    ex_mem_eval(&c->id_ex, &c->wire_ex, c->wire_pc_src, c->wire_branch_target, BIT_0, &overflow_);
+    ex_mem_latch(&c->wire_ex, &c->ex_mem, BIT_0);
+    hazard_unit_evaluate(c);
+
+    id_ex_eval(&c->if_id, &c->rf, &c->wire_id_ex_ctrl, CPU_DECODE_CACHE_(c), &c->wire_id);
+    id_ex_latch(&c->wire_id, &c->id_ex, BIT_0);
+
+    If_id_pc_ops if_ops_in = {0};
+    if_ops_in.pc_ops_[0] = c->wire_pc_src[0];
+    if_ops_in.pc_ops_[1] = c->wire_pc_src[1];
+    connect(c->wire_branch_target, if_ops_in.branch_target_wire);
+    if_id_eval(&c->im, &c->pc, &if_ops_in, &c->wire_if_id_ctrl, &overflow_, &c->wire_if);
+    if_id_latch(&c->wire_if, &c->if_id, &c->pc, BIT_0);
+
+    // ============================================================
+    // Phase 1: Commit (CLK = 1)
+    // ============================================================
+    wb_latch(&c->wire_wb, &c->rf, BIT_1);
+    mem_wb_latch(&c->wire_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_1);
+    ex_mem_latch(&c->wire_ex, &c->ex_mem, BIT_1);
+    id_ex_latch(&c->wire_id, &c->id_ex, BIT_1);
+    if_id_latch(&c->wire_if, &c->if_id, &c->pc, BIT_1);
+}
 
-    // Hazard
-    printf("[Hazard]:\n");
-    printf("                                Wire-if-id-ctrl: Pc-Write:%d, If-id-write:%d, If-id-flush:%d\n",
-           c->wire_if_id_ctrl.pc_write, c->wire_if_id_ctrl.if_id_write, c->wire_if_id_ctrl.if_id_flush);
-    printf("                                Wire-id-ex-ctrl: Id-ex-write:%d, Id-ex-flush:%d\n",
-           c->wire_id_ex_ctrl.id_ex_write, c->wire_id_ex_ctrl.id_ex_flush);
+// 在两次 tick 之间从外部改写了寄存器 / DM / IM 后调用, 让下个周期全部重新求值
+static inline
+void cpu_activity_invalidate(Cpu_core *c) {
+#if SCCPU_ACTIVITY_SKIP
+    c->activity.valid = 0;
+#else
+    (void) c; // 没有快照
+#endif
 }
 
+#if SCCPU_ACTIVITY_SKIP
+// 输入与快照不同 (或快照无效) 时返回 1, 并刷新快照
+static inline
+int activity_changed(const Stage_activity *a, void *snapshot, const void *cur, const size_t n) {
+    if (a->valid && memcmp(snapshot, cur, n) == 0) return 0;
+    memcpy(snapshot, cur, n);
+    return 1;
+}
+
+static inline
+int activity_mark(Stage_activity *a, const int stage, const int dirty) {
+    if (dirty) a->evals[stage]++;
+    else a->skips[stage]++;
+    return dirty;
+}
+
+// 活动性调度: 同 cpu_cycle_single_eval, 但干净的阶段既不求值也不走 latch
+// 阶段输入没变 -> wire_* 不变 -> 输出寄存器上个周期已经提交了同样的 D, 再走一遍 DFF 也不会变
+static inline
+void cpu_cycle_activity(Cpu_core *c) {
+    Stage_activity *a = &c->activity;
+    bit overflow_ = BIT_0;
+    bit mem_we_mask[4] = {BIT_1, BIT_1, BIT_1, BIT_1};
+
+    // ============================================================
+    // Phase 0: Combinational Logic Evaluation (CLK = 0)
+    // ============================================================
+    const int run_wb = activity_mark(a, STAGE_WB, activity_changed(a, &a->wb_in, &c->mem_wb, sizeof(Mem_wb_regs)));
+    if (run_wb) {
+        wb_eval(&c->mem_wb, &c->wire_wb);
+        wb_latch(&c->wire_wb, &c->rf, BIT_0);
+    }
+
+    // 上次求值写过 DM, 同一地址再读可能读到新值, 必须重算
+    const int run_mem = activity_mark(a, STAGE_MEM,
+                                      activity_changed(a, &a->mem_in, &c->ex_mem, sizeof(Ex_mem_regs))
+                                      | bit_any_(c->wire_mem.mem_writer));
+    if (run_mem) {
+        mem_wb_eval(&c->ex_mem, &c->dm, &c->wire_mem);
+        mem_wb_latch(&c->wire_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_0);
+    }
+
+    // 跳过时 wire_pc_src / wire_branch_target 保持上次的值
+    // pc_plus4 是 Id_ex_regs 的最后一个字段, 前面的部分整体比较
+    const int ex_pc = activity_changed(a, &a->ex_in.pc_plus4, &c->id_ex.pc_plus4, sizeof(Reg32_));
+    const int run_ex = activity_mark(a, STAGE_EX,
+                                     activity_changed(a, &a->ex_in, &c->id_ex, offsetof(Id_ex_regs, pc_plus4)));
+    if (run_ex) {
+        ex_mem_eval(&c->id_ex, &c->wire_ex, c->wire_pc_src, c->wire_branch_target, BIT_0, &overflow_);
+        ex_mem_latch(&c->wire_ex, &c->ex_mem, BIT_0);
+    } else if (ex_pc) {
+        ex_branch_target_eval(&c->id_ex, c->wire_branch_target, &overflow_);
+    }
+    hazard_unit_evaluate(c);
+
+    // 几个输入都要比较 (并刷新快照), 不能短路
+    const int id_pc = activity_changed(a, &a->id_in.pc_plus4, &c->if_id.pc_plus4, sizeof(Reg32_));
+    const int run_id = activity_mark(a, STAGE_ID,
+                                     activity_changed(a, &a->id_in.instr, &c->if_id.instr, sizeof(Reg32_))
+                                     | activity_changed(a, &a->id_rf, &c->rf, sizeof(Reg324file_))
+                                     | activity_changed(a, &a->id_ctrl, &c->wire_id_ex_ctrl, sizeof(Id_ex_write)));
+    if (run_id) {
+        id_ex_eval(&c->if_id, &c->rf, &c->wire_id_ex_ctrl, CPU_DECODE_CACHE_(c), &c->wire_id);
+        id_ex_latch(&c->wire_id, &c->id_ex, BIT_0);
+    } else if (id_pc) {
+        id_ex_eval_pc(&c->if_id, &c->wire_id);
+        id_ex_latch_pc(&c->wire_id, &c->id_ex, BIT_0);
+    }
+
+    activity_mark(a, STAGE_IF, 1);
+    If_id_pc_ops if_ops_in = {0};
+    if_ops_in.pc_ops_[0] = c->wire_pc_src[0];
+    if_ops_in.pc_ops_[1] = c->wire_pc_src[1];
+    connect(c->wire_branch_target, if_ops_in.branch_target_wire);
+    if_id_eval(&c->im, &c->pc, &if_ops_in, &c->wire_if_id_ctrl, &overflow_, &c->wire_if);
+    if_id_latch(&c->wire_if, &c->if_id, &c->pc, BIT_0);
+
+    // ============================================================
+    // Phase 1: Commit (CLK = 1)
+    // ============================================================
+    if (run_wb) wb_latch(&c->wire_wb, &c->rf, BIT_1);
+    if (run_mem) mem_wb_latch(&c->wire_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_1);
+    if (run_ex) ex_mem_latch(&c->wire_ex, &c->ex_mem, BIT_1);
+    if (run_id) id_ex_latch(&c->wire_id, &c->id_ex, BIT_1);
+    else if (id_pc) id_ex_latch_pc(&c->wire_id, &c->id_ex, BIT_1);
+    if_id_latch(&c->wire_if, &c->if_id, &c->pc, BIT_1);
+
+    a->valid = 1;
+}
+#endif
+
+#if SCCPU_STAGE_THREADS
+/**
+ * 阶段并行: cpu_cycle_single_eval 的组合求值分给 3 个线程, 之后各线程提交自己的阶段 (clk=0 和 clk=1 的 latch)
+ * 求值时每个阶段只读流水线寄存器 / regfile 的 Q, 不写任何寄存器, 阶段之间互不相干;
+ * 唯一的跨阶段导线是 EX 算出的 wire_pc_src / wire_branch_target, 经 hazard 送到 ID (flush) 和 IF
+ *  线程 0 (调用者): WB, MEM, 等 EX, ID
+ *  线程 1: EX, hazard, 发布本周期号
+ *  线程 2: 等 EX, IF
+ * 每个周期三次自旋屏障 (开始 / 求值完 / 提交完)
+ * 线程池在第一次调用时启动, cpu_stage_threads_stop 回收; 同一时刻只能有一个线程调用 cpu_cycle_threaded
+ * 线程池是文件内的静态变量, 只在 SCCPU_STAGE_THREADS 下存在 (其他配置不依赖 pthread)
+ */
+#define CPU_STAGE_THREADS 3
+
+typedef struct cpu_stage_pool {
+    int started; // 1: 线程池在跑; -1: 线程没起全, 退回单线程
+    int workers; // 实际起来的工作线程 (1..workers)
+    int quit;
+    Cpu_core *c;
+    unsigned long cycle;
+    atomic_ulong ex_done; // EX + hazard 已经求值完的周期号
+    Spin_barrier barrier;
+    unsigned sense[CPU_STAGE_THREADS];
+    pthread_t tid[CPU_STAGE_THREADS];
+} Cpu_stage_pool;
+
+static Cpu_stage_pool cpu_stage_pool_;
+
+static inline
+void cpu_stage_eval_(Cpu_core *c, const int t, const unsigned long cycle) {
+    bit overflow_ = BIT_0;
+    If_id_pc_ops if_ops_in = {0};
+    switch (t) {
+        case 0:
+            wb_eval(&c->mem_wb, &c->wire_wb);
+            mem_wb_eval(&c->ex_mem, &c->dm, &c->wire_mem);
+            spin_wait_until(&cpu_stage_pool_.ex_done, cycle);
+            id_ex_eval(&c->if_id, &c->rf, &c->wire_id_ex_ctrl, CPU_DECODE_CACHE_(c), &c->wire_id);
+            break;
+        case 1:
+            ex_mem_eval(&c->id_ex, &c->wire_ex, c->wire_pc_src, c->wire_branch_target, BIT_0, &overflow_);
+            hazard_unit_evaluate(c);
+            atomic_store_explicit(&cpu_stage_pool_.ex_done, cycle, memory_order_release);
+            break;
+        default:
+            spin_wait_until(&cpu_stage_pool_.ex_done, cycle);
+            if_ops_in.pc_ops_[0] = c->wire_pc_src[0];
+            if_ops_in.pc_ops_[1] = c->wire_pc_src[1];
+            connect(c->wire_branch_target, if_ops_in.branch_target_wire);
+            if_id_eval(&c->im, &c->pc, &if_ops_in, &c->wire_if_id_ctrl, &overflow_, &c->wire_if);
+            break;
+    }
+}
+
+// clk=0 的 latch 也放在这里: 闭式 / 门级 DFF 在 clk=0 也会写回 (不变的) Q, 求值阶段其他线程正在读这些 Q;
+// Q 在 clk=0 不变, 挪到求值之后结果与 cpu_cycle_single_eval 相同
+static inline
+void cpu_stage_commit_(Cpu_core *c, const int t) {
+    bit mem_we_mask[4] = {BIT_1, BIT_1, BIT_1, BIT_1};
+    switch (t) {
+        case 0:
+            wb_latch(&c->wire_wb, &c->rf, BIT_0);
+            mem_wb_latch(&c->wire_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_0);
+            id_ex_latch(&c->wire_id, &c->id_ex, BIT_0);
+            wb_latch(&c->wire_wb, &c->rf, BIT_1);
+            mem_wb_latch(&c->wire_mem, &c->mem_wb, &c->dm, mem_we_mask, BIT_1);
+            id_ex_latch(&c->wire_id, &c->id_ex, BIT_1);
+            break;
+        case 1:
+            ex_mem_latch(&c->wire_ex, &c->ex_mem, BIT_0);
+            ex_mem_latch(&c->wire_ex, &c->ex_mem, BIT_1);
+            break;
+        default:
+            if_id_latch(&c->wire_if, &c->if_id, &c->pc, BIT_0);
+            if_id_latch(&c->wire_if, &c->if_id, &c->pc, BIT_1);
+            break;
+    }
+}
+
+static inline
+void *cpu_stage_worker_(void *arg) {
+    Cpu_stage_pool *P = &cpu_stage_pool_;
+    const int t = (int) (intptr_t) arg;
+    for (;;) {
+        spin_barrier_wait(&P->barrier, &P->sense[t]);
+        if (P->quit) break;
+        cpu_stage_eval_(P->c, t, P->cycle);
+        spin_barrier_wait(&P->barrier, &P->sense[t]);
+        cpu_stage_commit_(P->c, t);
+        spin_barrier_wait(&P->barrier, &P->sense[t]);
+    }
+    return NULL;
+}
+
+// 让起来的 workers 个工作线程退出: 没起来的由调用者替它们到达开始屏障
+static inline
+void cpu_stage_threads_join_(Cpu_stage_pool *P) {
+    P->quit = 1;
+    for (int t = 1 + P->workers; t < CPU_STAGE_THREADS; t++) spin_barrier_arrive(&P->barrier);
+    spin_barrier_wait(&P->barrier, &P->sense[0]);
+    for (int t = 1; t <= P->workers; t++) pthread_join(P->tid[t], NULL);
+    P->workers = 0;
+    P->quit = 0;
+}
+
+static inline
+void cpu_stage_threads_stop(void) {
+    Cpu_stage_pool *P = &cpu_stage_pool_;
+    if (P->started > 0) cpu_stage_threads_join_(P);
+    P->started = 0;
+}
+
+static inline
+void cpu_cycle_threaded(Cpu_core *c) {
+    Cpu_stage_pool *P = &cpu_stage_pool_;
+    if (P->started == 0) {
+        spin_barrier_init(&P->barrier, CPU_STAGE_THREADS);
+        memset(P->sense, 0, sizeof(P->sense));
+        P->workers = 0;
+        for (int t = 1; t < CPU_STAGE_THREADS; t++) {
+            if (pthread_create(&P->tid[t], NULL, cpu_stage_worker_, (void *) (intptr_t) t) != 0) break;
+            P->workers++;
+        }
+        P->started = 1;
+        // 线程没起全: 已经起来的回收掉, 退回单线程 (cpu_stage_threads_stop 之后再试)
+        if (P->workers + 1 < CPU_STAGE_THREADS) {
+            cpu_stage_threads_join_(P);
+            P->started = -1;
+        }
+    }
+    if (P->started < 0) {
+        cpu_cycle_single_eval(c);
+        return;
+    }
+    P->c = c;
+    P->cycle++;
+    spin_barrier_wait(&P->barrier, &P->sense[0]);
+    cpu_stage_eval_(c, 0, P->cycle);
+    spin_barrier_wait(&P->barrier, &P->sense[0]);
+    cpu_stage_commit_(c, 0);
+    spin_barrier_wait(&P->barrier, &P->sense[0]);
+}
+
+#endif
+
+#if SCCPU_ACTIVITY_SKIP
+static inline
+void cpu_activity_report(const Cpu_core *c) {
+    static const char *names[STAGE_NUM] = {"WB", "MEM", "EX", "ID", "IF"};
+    uint64_t evals = 0, skips = 0;
+    printf("[Activity] stage evaluations (evaluated / skipped):\n");
+    for (int i = 0; i < STAGE_NUM; i++) {
+        printf("           %-3s %8lu / %-8lu\n", names[i], c->activity.evals[i], c->activity.skips[i]);
+        evals += c->activity.evals[i];
+        skips += c->activity.skips[i];
+    }
+    printf("           skipped %lu of %lu stage evaluations\n", skips, evals + skips);
+}
+#endif
+
+// 按编译配置推进一个周期的流水线, 不计 cycle_count 也不调用计数器 / 跟踪钩子 (rewind 重放用)
+static inline
+void cpu_cycle(Cpu_core *c) {
+#if SCCPU_STAGE_THREADS
+    cpu_cycle_threaded(c);
+#elif SCCPU_ACTIVITY_SKIP
+    cpu_cycle_activity(c);
+#elif SCCPU_TICK_SINGLE_EVAL
+    cpu_cycle_single_eval(c);
+#else
+    cpu_cycle_two_pass(c);
+#endif
+}
+
+// 推进一个周期, 不打印 (对拍 / 计时用); SCCPU_PERF_COUNTERS 时累加计数器,
+// SCCPU_TRACE 时顺便记进跟踪环, SCCPU_PIPEVIEW 时写进流水线时间线
+static inline
+void cpu_step(Cpu_core *c) {
+    cpu_cycle(c);
+    c->cycle_count++;
+    PERF_CYCLE(c);
+    TRACE_CYCLE(c);
+    PIPEVIEW_CYCLE(c);
+}
+
+static inline
+void cpu_tick(Cpu_core *c) {
+    cpu_step(c);
+
+    // Dump Log
+#if !SCCPU_TRACE
+    cpu_dump(c); // 开了 SCCPU_TRACE 时 cpu_step 已经记进环里, 需要时再 trace_dump_last(c, n)
+#endif
+}
+
+
+// cpu_dump / 跟踪环在 trace.h, 要用到上面的 Cpu_core
+#include "trace.h"
+#if SCCPU_PERF_COUNTERS
+#include "perf.h"
+#endif
+#if SCCPU_PIPEVIEW
+#include "pipeview.h"
+#endif
 
 #endif //SCCPU_CPU_CORE_H
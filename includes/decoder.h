@@ -6,6 +6,17 @@
 #define SCCPU_DECODER__H
 #include "alu.h"
 #include "isa.h"
+#include "utils.h"
+
+// SCCPU_DECODE_CACHE = 1 -> id_ex 使用 decode_cached: 以 opcode / funct 为 tag 的直接映射表, 未命中时才走门级 decode()
+// decode() 对同一个指令字是纯函数, 门级实现依旧是唯一的定义
+#ifndef SCCPU_DECODE_CACHE
+#define SCCPU_DECODE_CACHE 0
+#endif
+
+#if SCCPU_DECODE_CACHE && (SCCPU_LANES > 1 || SCCPU_NETLIST)
+#error "SCCPU_DECODE_CACHE needs a single concrete instruction word (SCCPU_LANES=1, no SCCPU_NETLIST)"
+#endif
 
 // info see @isa_.h
 
@@ -64,7 +75,7 @@ typedef struct {
 }  Control_signals;
 
 
-static inline Control_signals decode(word instruction) {
+static inline Control_signals decode_gate_(word instruction) {
     Control_signals cs = {0};
     //op_codes
     const bit op_r_type = opcode6_r_type(instruction);
@@ -152,5 +163,116 @@ static inline Control_signals decode(word instruction) {
     return cs;
 }
 
+#if SCCPU_HAS_BEH_MODELS
+// 行为级译码: 按 opcode / funct 查表, 与 decode_gate_ 的 11 根控制线逐位一致
+static inline Control_signals decode_beh_(word instruction) {
+    Control_signals cs = {0};
+    const uint32_t inst = u32_from_word(instruction);
+    const uint32_t op = inst >> 26, funct = inst & 0x3F;
+    const int r_type = op == OP_R_TYPE, lw = op == OP_LW, sw = op == OP_SW, addi = op == OP_ADDI;
+    const bit *o = NULL;
+    if (r_type) {
+        switch (funct) {
+            case FUNCT_ADD: o = OPS_ADD_;
+                break;
+            case FUNCT_SUB: o = OPS_SUB_;
+                break;
+            case FUNCT_AND: o = OPS_AND_;
+                break;
+            case FUNCT_OR: o = OPS_OR_;
+                break;
+            case FUNCT_SLT: o = OPS_SLT_;
+                break;
+            default:
+                break;
+        }
+    }
+    if (lw || sw || addi) o = OPS_ADD_;
+    if (op == OP_BEQ) o = OPS_SUB_;
+    if (o) memcpy(cs.ops_, o, sizeof(ops));
+    cs.reg_dst = r_type;
+    cs.alu_src = lw || sw || addi;
+    cs.data_src_to_reg = lw;
+    cs.reg_write = (r_type || lw || addi) && inst != 0;
+    cs.mem_read = lw;
+    cs.mem_write = sw;
+    cs.branch = op == OP_BEQ;
+    cs.jump = op == OP_J;
+    return cs;
+}
+#endif
+
+static inline Control_signals decode(word instruction) {
+#if SCCPU_MODEL_DECODE == MODEL_BEH
+    return decode_beh_(instruction);
+#else
+    return decode_gate_(instruction);
+#endif
+}
+
+/**
+ * 译码缓存: 直接映射表, 每个 Cpu_core 一份 (Cpu_core.decode_cache), 只被自己的 ID 阶段访问,
+ * 多个核 / 多个线程之间不共享; id_ex_eval 的 decode_cache 参数为 NULL 时直接调用 decode()
+ * 控制信号只取决于 opcode / funct, 再加上 reg_write 看的 "整字为 0" (NOP), tag 只拼这 12 位和一个 NOP 位,
+ * bit[32] 后端上比一次门级 decode 便宜 (整字 32 位拼起来反而比 decode 慢)
+ */
+#define DECODE_CACHE_SIZE 256
+
+typedef struct decode_cache_entry {
+    uint32_t tag; // decode_cache_key
+    uint8_t valid;
+    Control_signals cs;
+} Decode_cache_entry;
+
+typedef struct decode_cache {
+    Decode_cache_entry entries[DECODE_CACHE_SIZE];
+    uint64_t hits;
+    uint64_t misses;
+} Decode_cache;
+
+#if SCCPU_LANES == 1
+static inline void decode_cache_reset(Decode_cache *dc) {
+    memset(dc, 0, sizeof(Decode_cache));
+}
+
+// 指令字 -> tag: opcode << 6 | funct; 两者都为 0 时中间 20 位不全为 0 (不是 NOP) 记成 1 << 12
+static inline uint32_t decode_cache_key(const word instruction) {
+#if SCCPU_PACKED_WORD
+    const uint32_t inst = u32_from_word(instruction);
+    const uint32_t v = (inst >> 26) << 6 | (inst & 0x3Fu);
+    return v || !inst ? v : 1u << 12;
+#else
+    uint32_t v = 0;
+    for (int i = 0; i < 6; i++) v = v << 1 | (uint32_t) LANE_GET(WORD_GET(instruction, i), 0);
+    for (int i = WORD_SIZE - 6; i < WORD_SIZE; i++) v = v << 1 | (uint32_t) LANE_GET(WORD_GET(instruction, i), 0);
+    if (v) return v;
+    for (int i = 6; i < WORD_SIZE - 6; i++) if (LANE_GET(WORD_GET(instruction, i), 0)) return 1u << 12;
+    return 0;
+#endif
+}
+
+static inline Control_signals decode_cached(Decode_cache *dc, word instruction) {
+    const uint32_t v = decode_cache_key(instruction);
+    // opcode 在 [11:6], funct 在 [5:0], 折叠后取低 8 位做下标
+    const uint32_t idx = (v ^ (v >> 4)) & (DECODE_CACHE_SIZE - 1);
+    Decode_cache_entry *e = &dc->entries[idx];
+    if (e->valid && e->tag == v) {
+        dc->hits++;
+        return e->cs;
+    }
+    dc->misses++;
+    e->cs = decode(instruction);
+    e->tag = v;
+    e->valid = 1;
+    return e->cs;
+}
+
+static inline void decode_cache_report(const Decode_cache *dc) {
+    const uint64_t total = dc->hits + dc->misses;
+    printf("[DecodeCache] hits:%lu misses:%lu hit-rate:%.1f%%\n", dc->hits, dc->misses,
+           total ? 100.0 * (double) dc->hits / (double) total : 0.0);
+}
+#endif
+
 
 #endif //SCCPU_DECODER__H
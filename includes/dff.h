@@ -6,13 +6,26 @@
 #define SCCPU_DFF__H
 #include "common.h"
 #include "gate.h"
+#include "mux.h"
+
+// SCCPU_DFF_CLOSED_FORM = 1 -> 主从触发器直接按收敛后的结果求值, 没有函数指针也没有迭代
+// 默认 0 -> 两个 d_latch 的 NOR 交叉耦合逐步收敛 (用于验证)
+#ifndef SCCPU_DFF_CLOSED_FORM
+#define SCCPU_DFF_CLOSED_FORM 0
+#endif
+
+// d_latch 的收敛循环要看到真实电平, 网表捕获只能用闭式 DFF
+#if SCCPU_NETLIST && !SCCPU_DFF_CLOSED_FORM
+#error "SCCPU_NETLIST requires SCCPU_DFF_CLOSED_FORM=1"
+#endif
 
 static inline bit d_latch(const bit d, const bit enable, bit OUT_Q, bit OUT_Q_BRA) {
     const bit S = AND(d, enable);
     const bit R = AND(NOT(d), enable);
     // OUT_Q 指的是上一次的结果 也可以是初始结果 也就是Q输出0
-    bit stab = 0;
-    while (!stab) {
+    // lane 模式下要等所有 lane 都稳定
+    bit stab = BIT_0;
+    while (!bit_all_(stab)) {
         const bit NEXT_Q = NOR(R, OUT_Q_BRA);
         const bit NEXT_OUT_Q_BRA = NOR(S, OUT_Q);
         stab = AND(NOT(XOR(NEXT_Q, OUT_Q)), NOT(XOR(NEXT_OUT_Q_BRA, OUT_Q_BRA)));
@@ -30,30 +43,73 @@ static inline bit d_latch(const bit d, const bit enable, bit OUT_Q, bit OUT_Q_BR
 
 typedef bit (*D_LATCH)(bit d, bit enable, bit OUT_Q, bit OUT_Q_BRA);
 
+#if SCCPU_DFF_CLOSED_FORM
+typedef struct dff {
+    bit master_Q;
+    bit Q;
+} dff_;
+#else
 typedef struct dff {
     D_LATCH master;
     D_LATCH slave;
     bit master_Q;
     bit Q;
 } dff_;
+#endif
 
 typedef struct dff_beh {
     dff_ dff;
     bit prev_clk;
 } dff_b_;
 
+// 只有状态位的主从触发器: 寄存器以 SoA 形式保存 master/Q 时逐位调用
+// 门级: 两个 d_latch 交叉耦合逐步收敛 (网表捕获下不能调用)
+static inline void dff_bit_update_gate_(bit *master_Q, bit *Q, const bit clk, const bit d) {
+    *master_Q = d_latch(d, NOT(clk), *master_Q, NOT(*master_Q));
+    *Q = d_latch(*master_Q, clk, *Q, NOT(*Q));
+}
+
+// 行为级 (闭式): clk=0 master 透明跟随 d, slave 保持; clk=1 master 保持, slave 透明跟随 master
+static inline void dff_bit_update_beh_(bit *master_Q, bit *Q, const bit clk, const bit d) {
+    *master_Q = mux2_1(d, *master_Q, clk);
+    *Q = mux2_1(*Q, *master_Q, clk);
+}
+
+// dff 的抽象级别就是 SCCPU_DFF_CLOSED_FORM (它还决定 dff_ 里要不要 D_LATCH 指针)
+static inline void dff_bit_update(bit *master_Q, bit *Q, const bit clk, const bit d) {
+#if SCCPU_DFF_CLOSED_FORM
+    dff_bit_update_beh_(master_Q, Q, clk, d);
+#else
+    dff_bit_update_gate_(master_Q, Q, clk, d);
+#endif
+}
+
+#if SCCPU_DFF_CLOSED_FORM
+static inline void init_dff(dff_ *dff) {
+    *dff = (dff_){BIT_0, BIT_0};
+}
+
+static inline void init_dff_deh(dff_b_ *_dff_b) {
+    *_dff_b = (dff_b_){{BIT_0, BIT_0}, BIT_0};
+}
+
+static inline void dff_update(dff_ *dff_, const bit clk, const bit d) {
+    dff_bit_update(&dff_->master_Q, &dff_->Q, clk, d);
+}
+#else
 static inline void init_dff(dff_ *dff) {
-    *dff = (dff_){d_latch, d_latch, 0, 0};
+    *dff = (dff_){d_latch, d_latch, BIT_0, BIT_0};
 }
 
 static inline void init_dff_deh(dff_b_ *_dff_b) {
-    *_dff_b = (dff_b_){{d_latch, d_latch, 0, 0}, 0};
+    *_dff_b = (dff_b_){{d_latch, d_latch, BIT_0, BIT_0}, BIT_0};
 }
 
 static inline void dff_update(dff_ *dff_, const bit clk, const bit d) {
-    dff_->master_Q = dff_->master(d, NOT(clk), dff_->master_Q, !dff_->master_Q);
-    dff_->Q = dff_->slave(dff_->master_Q, clk, dff_->Q, !dff_->Q);
+    dff_->master_Q = dff_->master(d, NOT(clk), dff_->master_Q, NOT(dff_->master_Q));
+    dff_->Q = dff_->slave(dff_->master_Q, clk, dff_->Q, NOT(dff_->Q));
 }
+#endif
 
 static inline bit dff_deh_step(dff_b_ *_dff_b, const bit clk, const bit d) {
     dff_update(&_dff_b->dff, AND(NOT(_dff_b->prev_clk), clk), d);
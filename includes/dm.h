@@ -5,6 +5,7 @@
 #define SCCPU_DM_H
 #include "string.h"
 #include "stdint.h"
+#include "stdlib.h"
 #include "common.h"
 #include "utils.h"
 
@@ -16,37 +17,188 @@
 typedef struct dm_ Dm_;
 
 // word is array type
-typedef bit (*dm_read_fn)(Dm_ *dm, word address, word ret);
+typedef bit (*dm_read_fn)(Dm_ *dm, const word address, word ret);
 
-typedef bit (*dm_write_fn)(Dm_ *dm, word address, word data, const bit byte_enable_mask[4], const bit we,
+typedef bit (*dm_write_fn)(Dm_ *dm, const word address, const word data, const bit byte_enable_mask[4], const bit we,
                            const bit clk);
 
+#if SCCPU_LANES > 1
+// bit-sliced: 每个 lane 一块独立的 4KB, 读写按 lane 拆开访问 (内存是黑盒, 不参与 bit-slice)
+struct dm_ {
+    uint8_t memory[SCCPU_LANES][DEFAULT_SIZE];
+    dm_read_fn m_read;
+    dm_write_fn m_write;
+};
+
+static inline
+bit dm_read(Dm_ *dm, const word address, word ret) {
+    memset(ret, 0, sizeof(word));
+    bit err = BIT_0;
+    for (int lane = 0; lane < SCCPU_LANES; lane++) {
+        const uint32_t idx = u32_from_word_lane(address, lane);
+        if ((idx & 3) != 0 || idx >= DEFAULT_SIZE) {
+            LANE_PUT(err, lane, 1);
+            continue;
+        }
+        const uint8_t *m = &dm->memory[lane][idx];
+        word_put_lane_u32(ret, lane, (uint32_t) m[0] << 24 | (uint32_t) m[1] << 16 | (uint32_t) m[2] << 8 | m[3]);
+    }
+    return err;
+}
+
+static inline
+bit dm_write(Dm_ *dm, const word address, const word data, const bit byte_enable_mask[4], const bit we,
+             const bit clk) {
+    const bit en = AND(we, clk);
+    bit err = BIT_0;
+    for (int lane = 0; lane < SCCPU_LANES; lane++) {
+        if (!LANE_GET(en, lane)) continue;
+        const uint32_t idx = u32_from_word_lane(address, lane);
+        if ((idx & 3) != 0 || idx >= DEFAULT_SIZE) {
+            LANE_PUT(err, lane, 1);
+            continue;
+        }
+        const uint32_t v = u32_from_word_lane(data, lane);
+        for (int i = 0; i < 4; i++) {
+            if (LANE_GET(byte_enable_mask[i], lane))
+                dm->memory[lane][idx + i] = (uint8_t) (v >> (24 - 8 * i));
+        }
+    }
+    return err;
+}
+
+static inline
+void dm_lane_load(Dm_ *dm, const int lane, const uint8_t *image, const size_t len) {
+    memcpy(dm->memory[lane], image, len > DEFAULT_SIZE ? DEFAULT_SIZE : len);
+}
+#elif SCCPU_NETLIST
+// 网表捕获: DM 只留下读 / 写端口; 写端口的使能是 we & clk, clk=0 那次捕获出的端口在常量传播后恒不使能
+struct dm_ {
+    uint8_t memory[DEFAULT_SIZE];
+    dm_read_fn m_read;
+    dm_write_fn m_write;
+};
+
+static inline
+bit dm_read(Dm_ *dm, const word address, word ret) {
+    (void) dm;
+    nl_mem_read_(NL_MEM_DM, address, ret);
+    return BIT_0;
+}
+
+static inline
+bit dm_write(Dm_ *dm, const word address, const word data, const bit byte_enable_mask[4], const bit we,
+             const bit clk) {
+    (void) dm;
+    nl_mem_write_(NL_MEM_DM, address, data, byte_enable_mask, AND(we, clk));
+    return BIT_0;
+}
+#elif SCCPU_SHARED_IMAGES
+/**
+ * 写时复制: 每页指向共享的初始镜像 (Dm_image) 或自己的私有副本, 第一次写某页时才复制这一页
+ * 对齐的字访问不会跨页; 私有页用 malloc 分配, dm_release 释放
+ * init_dm_ 不释放 (结构体可能还没初始化过), 已经写过的 Dm_ 重新开始前先 dm_release 或直接 dm_attach
+ */
+#define DM_PAGE_SIZE 256
+#define DM_PAGES (DEFAULT_SIZE / DM_PAGE_SIZE)
+
+typedef struct dm_image {
+    uint8_t memory[DEFAULT_SIZE];
+} Dm_image;
+
+struct dm_ {
+    const uint8_t *page[DM_PAGES]; // 每页当前的内容
+    uint8_t *own[DM_PAGES]; // 写过的页的私有副本, NULL -> 仍在共享镜像里
+    dm_read_fn m_read;
+    dm_write_fn m_write;
+};
+
+static const Dm_image DM_EMPTY_IMAGE_;
+
+#define DM_BYTE_(dm, a) ((dm)->page[(a) / DM_PAGE_SIZE][(a) % DM_PAGE_SIZE])
+
+// 要写 a 所在的页: 还在共享就先复制; 分配失败返回 NULL
+static inline uint8_t *dm_byte_w_(Dm_ *dm, const uint32_t a) {
+    const uint32_t p = a / DM_PAGE_SIZE;
+    if (!dm->own[p]) {
+        uint8_t *copy = malloc(DM_PAGE_SIZE);
+        if (!copy) return NULL;
+        memcpy(copy, dm->page[p], DM_PAGE_SIZE);
+        dm->own[p] = copy;
+        dm->page[p] = copy;
+    }
+    return &dm->own[p][a % DM_PAGE_SIZE];
+}
+
+static inline void dm_release(Dm_ *dm) {
+    for (int p = 0; p < DM_PAGES; p++) {
+        free(dm->own[p]);
+        dm->own[p] = NULL;
+        dm->page[p] = &DM_EMPTY_IMAGE_.memory[p * DM_PAGE_SIZE];
+    }
+}
+
+// 丢掉私有页, 从 img 重新开始
+static inline void dm_attach(Dm_ *dm, const Dm_image *img) {
+    dm_release(dm);
+    for (int p = 0; p < DM_PAGES; p++) dm->page[p] = &img->memory[p * DM_PAGE_SIZE];
+}
+
+static inline int dm_private_pages(const Dm_ *dm) {
+    int n = 0;
+    for (int p = 0; p < DM_PAGES; p++) n += dm->own[p] != NULL;
+    return n;
+}
+#else
 struct dm_ {
     uint8_t memory[DEFAULT_SIZE]; // 4KB
     dm_read_fn m_read;
     dm_write_fn m_write;
 };
 
+#define DM_BYTE_(dm, a) ((dm)->memory[a])
+
+// 与共享镜像时一致: 回到全 0
+static inline void dm_release(Dm_ *dm) {
+    memset(dm->memory, 0, sizeof(dm->memory));
+}
+
+static inline uint8_t *dm_byte_w_(Dm_ *dm, const uint32_t a) {
+    return &dm->memory[a];
+}
+#endif
+
+#if SCCPU_LANES == 1 && !SCCPU_NETLIST
+
 static inline
-bit dm_read(Dm_ *dm, word address, word ret) {
+bit dm_read(Dm_ *dm, const word address, word ret) {
     memset(ret, 0, sizeof(word));
     const uint32_t idx = u32_from_word(address);
     if ((idx & 3) != 0) return 1;
     if (idx >= DEFAULT_SIZE) return 1;
     const size_t len = (idx + 4 > DEFAULT_SIZE) ? (DEFAULT_SIZE - idx) : 4;
+#if SCCPU_PACKED_WORD
+    // 大端: memory[idx] 是最高字节
+    uint32_t v = 0;
+    for (size_t i = 0; i < len; i++) {
+        v |= (uint32_t) DM_BYTE_(dm, idx + i) << (24 - 8 * i);
+    }
+    ret[0] = v;
+#else
     size_t s = 0;
     for (size_t i = 0; i < len; i++) {
-        const uint8_t u = dm->memory[idx + i];
+        const uint8_t u = DM_BYTE_(dm, idx + i);
         for (int j = 7; j >= 0; j--) {
             // 需要倒读
             ret[s++] = GET_BIT_UINT8(u, j);
         }
     }
+#endif
     return 0;
 }
 
 static inline
-bit dm_write(Dm_ *dm, word address, word data, const bit byte_enable_mask[4], const bit we,
+bit dm_write(Dm_ *dm, const word address, const word data, const bit byte_enable_mask[4], const bit we,
              const bit clk) {
     if (we & clk) {
         const uint32_t idx = u32_from_word(address);
@@ -55,18 +207,85 @@ bit dm_write(Dm_ *dm, word address, word data, const bit byte_enable_mask[4], co
         uint8_t d_4int8[4] = {0};
         u32_from_4byte(data, d_4int8);
         const size_t len = (idx + 4 > DEFAULT_SIZE) ? (DEFAULT_SIZE - idx) : 4;
+        uint8_t *m = dm_byte_w_(dm, idx); // 对齐的 4 字节在同一页
+        if (!m) return 1;
         for (size_t i = 0; i < len; i++) {
             if (byte_enable_mask[i])
-                dm->memory[idx + i] = d_4int8[i];
+                m[i] = d_4int8[i];
         }
     }
     return 0;
 }
 
+/**
+ * 门级读口: 存储单元的每个字接到一棵 word 2 选 1 树上, 地址 bit 2..11 逐级选择 (bit 2 在叶子一层)
+ * 非对齐 (bit 0/1) 或越界 (bit 12..31 任何一位为 1) 时输出清零并返回 1, 与 dm_read 一致
+ */
+static inline
+bit dm_read_gate_(Dm_ *dm, const word address, word ret) {
+    word rows[DEFAULT_SIZE / 4];
+    for (int r = 0; r < DEFAULT_SIZE / 4; r++) {
+        const uint8_t *m = &DM_BYTE_(dm, r * 4);
+#if SCCPU_PACKED_WORD
+        rows[r][0] = (uint32_t) m[0] << 24 | (uint32_t) m[1] << 16 | (uint32_t) m[2] << 8 | m[3];
+#else
+        for (int i = 0; i < WORD_SIZE; i++) rows[r][i] = GET_BIT_UINT8(m[i / 8], 7 - i % 8);
+#endif
+    }
+    int n = DEFAULT_SIZE / 4;
+    for (int a = 2; n > 1; a++, n /= 2) {
+        const bit sel = INST_BIT(address, a);
+        for (int r = 0; r < n / 2; r++) word_mux_2_1(rows[2 * r], rows[2 * r + 1], sel, rows[r]);
+    }
+    bit err = OR(INST_BIT(address, 0), INST_BIT(address, 1));
+    for (int a = 12; a < WORD_SIZE; a++) err = OR(err, INST_BIT(address, a));
+    word_mux_2_1(rows[0], WORD_ZERO, err, ret);
+    return err;
+}
+
+// 当前 DM 内容的一份拷贝 (两种存储方式通用)
+static inline void dm_copy_out(const Dm_ *dm, uint8_t *out) {
+#if SCCPU_SHARED_IMAGES
+    for (int p = 0; p < DM_PAGES; p++) memcpy(out + p * DM_PAGE_SIZE, dm->page[p], DM_PAGE_SIZE);
+#else
+    memcpy(out, dm->memory, DEFAULT_SIZE);
+#endif
+}
+
+// 直接写一个字节 (预装数据用, 两种存储方式通用, 共享镜像时写时复制); 越界或分配失败返回 -1
+static inline int dm_poke(Dm_ *dm, const uint32_t addr, const uint8_t v) {
+    if (addr >= DEFAULT_SIZE) return -1;
+    uint8_t *m = dm_byte_w_(dm, addr);
+    if (!m) return -1;
+    *m = v;
+    return 0;
+}
+
+// 从地址 0 起预装 len 字节, 与原内容相同的字节不写 (共享镜像时不复制没变的页)
+static inline int dm_load(Dm_ *dm, const uint8_t *image, const size_t len) {
+    const size_t n = len > DEFAULT_SIZE ? DEFAULT_SIZE : len;
+    for (size_t a = 0; a < n; a++) {
+        if (DM_BYTE_(dm, a) != image[a] && dm_poke(dm, (uint32_t) a, image[a]) != 0) return -1;
+    }
+    return 0;
+}
+#endif
+
 static inline
 void init_dm_(Dm_ *dm) {
-    memset(dm->memory, 0, DEFAULT_SIZE);
+#if SCCPU_SHARED_IMAGES
+    for (int p = 0; p < DM_PAGES; p++) {
+        dm->page[p] = &DM_EMPTY_IMAGE_.memory[p * DM_PAGE_SIZE];
+        dm->own[p] = NULL;
+    }
+#else
+    memset(dm->memory, 0, sizeof(dm->memory));
+#endif
+#if SCCPU_MODEL_DM_READ == MODEL_GATE
+    dm->m_read = dm_read_gate_;
+#else
     dm->m_read = dm_read;
+#endif
     dm->m_write = dm_write;
 }
 
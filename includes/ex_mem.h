@@ -10,8 +10,8 @@
 #include "utils.h"
 
 typedef struct ex_mem_regs {
-    Reg32_ mem_single; // mem_read, mem_write
-    Reg32_ wb_single; // reg_write, data_src_to_reg
+    Reg2_ mem_single; // mem_read(bit1), mem_write(bit0)
+    Reg2_ wb_single; // reg_write(bit1), data_src_to_reg(bit0)
     // result by ALU
     // ALU 并不关注结果是数据还是地址 它是由去向决定身份  MEM_READ = 1 表明是内存地址值
     Reg32_ alu_result;
@@ -19,17 +19,17 @@ typedef struct ex_mem_regs {
     // Data2
     Reg32_ write_data;
     // 目的地 reg_idx_
-    Reg32_ write_reg_idx;
+    Reg2_ write_reg_idx;
 } Ex_mem_regs;
 
 
 static inline void
 init_ex_eme_regs(Ex_mem_regs *regs) {
-    init_reg32(&regs->mem_single);
-    init_reg32(&regs->wb_single);
+    init_reg2(&regs->mem_single);
+    init_reg2(&regs->wb_single);
     init_reg32(&regs->alu_result);
     init_reg32(&regs->write_data);
-    init_reg32(&regs->write_reg_idx);
+    init_reg2(&regs->write_reg_idx);
 }
 
 
@@ -63,14 +63,35 @@ hazard(If_id_pc_ops *ops,
 }
 
 
+// EX 的组合逻辑输出 (EX/MEM 各寄存器的 D 端); pc_src / branch_target 仍是直连导线
+typedef struct ex_mem_wires {
+    bit mem_single[2];
+    bit wb_single[2];
+    word alu_result;
+    word write_data;
+    bit write_reg_idx[2];
+} Ex_mem_wires;
+
+// branch_target = pc_plus4 + (imm_ext << 2), 只依赖 pc_plus4 和 imm_ext
 static inline
-void ex_mem_regs_step(const Id_ex_regs *id_ex_regs,
-                 Ex_mem_regs *ex_mem_regs,
+void ex_branch_target_eval(const Id_ex_regs *id_ex_regs, word branch_target, bit *overflow) {
+    // id_ex_regs.pc_plus4 已经是 + 4
+    word pc_push4_w = {0}, imm_ext_w = {0};
+    read_reg32(&id_ex_regs->pc_plus4, pc_push4_w);
+    read_reg32(&id_ex_regs->imm_ext, imm_ext_w);
+    // 算出 branch_target 注意 branch_target 并不是一个寄存器 而是一个32位的导线 立即性
+    word imm_ext_lshift2_w = {0};
+    word_lshift2(imm_ext_w, imm_ext_lshift2_w);
+    word_alu_(pc_push4_w, imm_ext_lshift2_w, branch_target, OPS_ADD_, overflow);
+}
+
+static inline
+void ex_mem_eval(const Id_ex_regs *id_ex_regs,
+                 Ex_mem_wires *w,
                  pc_ops pc_src, // The head pointer of the array
                  word branch_target, // The head pointer of the array
                  const bit ex_flush,
-                 bit *overflow,
-                 const bit clk) {
+                 bit *overflow) {
     // get alu_src ->  IMM by ALU_SRC is 1  else RT
     bit alu_src = GET_ALU_SRC_OF_SIGNALS(&id_ex_regs->decode_signals);
 
@@ -87,21 +108,15 @@ void ex_mem_regs_step(const Id_ex_regs *id_ex_regs,
     word alu_result_w = {0};
     word_alu_(input0_w, input1_w, alu_result_w, alu_ops, overflow);
 
-    word mem_single_w = {0}, wb_single_w = {0};
-    mem_single_w[INST_WORD(31)] = GET_MEM_READ_OF_SIGNALS(&id_ex_regs->decode_signals);
-    mem_single_w[INST_WORD(30)] = GET_MEM_WRITE_OF_SIGNALS(&id_ex_regs->decode_signals);
+    bit mem_single_w[2] = {BIT_0}, wb_single_w[2] = {BIT_0};
+    mem_single_w[0] = GET_MEM_READ_OF_SIGNALS(&id_ex_regs->decode_signals);
+    mem_single_w[1] = GET_MEM_WRITE_OF_SIGNALS(&id_ex_regs->decode_signals);
 
-    // wb：reg_write 放 bit31，mem_to_reg 放 bit30
-    wb_single_w[INST_WORD(31)] = GET_REG_WRITE_OF_SIGNALS(&id_ex_regs->decode_signals);
-    wb_single_w[INST_WORD(30)] = GET_DATA_SRC_TO_REG_OF_SIGNALS(&id_ex_regs->decode_signals);
+    // wb：reg_write 放 bit1，mem_to_reg 放 bit0
+    wb_single_w[0] = GET_REG_WRITE_OF_SIGNALS(&id_ex_regs->decode_signals);
+    wb_single_w[1] = GET_DATA_SRC_TO_REG_OF_SIGNALS(&id_ex_regs->decode_signals);
 
-    // id_ex_regs.pc_plus4 已经是 + 4
-    word pc_push4_w = {0};
-    read_reg32(&id_ex_regs->pc_plus4, pc_push4_w);
-    // 算出 branch_target 注意 branch_target 并不是一个寄存器 而是一个32位的导线 立即性
-    word imm_ext_lshift2_w = {0};
-    word_lshift2(imm_ext_w, imm_ext_lshift2_w);
-    word_alu_(pc_push4_w, imm_ext_lshift2_w, branch_target, OPS_ADD_, overflow);
+    ex_branch_target_eval(id_ex_regs, branch_target, overflow);
 
     word ret_src = {0};
     // R1 - R2
@@ -112,32 +127,44 @@ void ex_mem_regs_step(const Id_ex_regs *id_ex_regs,
     // flush 会丢弃指令 当然也会丢弃当条 ?
     pc_src[0] = AND(AND(branch_signal, is_zero), NOT(ex_flush));
     // pc_src[1] default zero
-    pc_src[1] = 0;
+    pc_src[1] = BIT_0;
 
     bit reg_dst = GET_REG_DST_OF_SIGNALS(&id_ex_regs->decode_signals);
-    word write_final_reg_idx = {0};
-    word rt_idx_w = {0}, rd_idx_w = {0};
-    read_reg32(&id_ex_regs->rt_idx, rt_idx_w);
-    read_reg32(&id_ex_regs->rd_idx, rd_idx_w);
-    word_mux_2_1(rt_idx_w, rd_idx_w, reg_dst, write_final_reg_idx);
-
-    word mem_single_in = {0};
-    word_mux_2_1(mem_single_w, WORD_ZERO, ex_flush, mem_single_in);
-    word wb_single_in = {0};
-    word_mux_2_1(wb_single_w, WORD_ZERO, ex_flush, wb_single_in);
-    word alu_result_in = {0};
-    word_mux_2_1(alu_result_w, WORD_ZERO, ex_flush, alu_result_in);
-    word write_data_in = {0};
-    word_mux_2_1(data2_w, WORD_ZERO, ex_flush, write_data_in);
-    word write_reg_idx_in = {0};
-    word_mux_2_1(write_final_reg_idx, WORD_ZERO, ex_flush, write_reg_idx_in);
+    bit rt_idx_w[2] = {BIT_0}, rd_idx_w[2] = {BIT_0};
+    read_reg2(&id_ex_regs->rt_idx, rt_idx_w);
+    read_reg2(&id_ex_regs->rd_idx, rd_idx_w);
+
+    for (int i = 0; i < 2; i++) {
+        w->mem_single[i] = mux2_1(mem_single_w[i], BIT_0, ex_flush);
+        w->wb_single[i] = mux2_1(wb_single_w[i], BIT_0, ex_flush);
+        w->write_reg_idx[i] = mux2_1(mux2_1(rt_idx_w[i], rd_idx_w[i], reg_dst), BIT_0, ex_flush);
+    }
+    word_mux_2_1(alu_result_w, WORD_ZERO, ex_flush, w->alu_result);
+    word_mux_2_1(data2_w, WORD_ZERO, ex_flush, w->write_data);
+}
 
+static inline
+void ex_mem_latch(const Ex_mem_wires *w, Ex_mem_regs *ex_mem_regs, const bit clk) {
     word out = {0};
-    reg32_step(&ex_mem_regs->mem_single, 1, mem_single_in, out, clk);
-    reg32_step(&ex_mem_regs->wb_single, 1, wb_single_in, out, clk);
-    reg32_step(&ex_mem_regs->alu_result, 1, alu_result_in, out, clk);
-    reg32_step(&ex_mem_regs->write_data, 1, write_data_in, out, clk);
-    reg32_step(&ex_mem_regs->write_reg_idx, 1, write_reg_idx_in, out, clk);
+    bit out_n[2];
+    reg2_step(&ex_mem_regs->mem_single, BIT_1, w->mem_single, out_n, clk);
+    reg2_step(&ex_mem_regs->wb_single, BIT_1, w->wb_single, out_n, clk);
+    reg32_step(&ex_mem_regs->alu_result, BIT_1, w->alu_result, out, clk);
+    reg32_step(&ex_mem_regs->write_data, BIT_1, w->write_data, out, clk);
+    reg2_step(&ex_mem_regs->write_reg_idx, BIT_1, w->write_reg_idx, out_n, clk);
+}
+
+static inline
+void ex_mem_regs_step(const Id_ex_regs *id_ex_regs,
+                 Ex_mem_regs *ex_mem_regs,
+                 pc_ops pc_src, // The head pointer of the array
+                 word branch_target, // The head pointer of the array
+                 const bit ex_flush,
+                 bit *overflow,
+                 const bit clk) {
+    Ex_mem_wires w;
+    ex_mem_eval(id_ex_regs, &w, pc_src, branch_target, ex_flush, overflow);
+    ex_mem_latch(&w, ex_mem_regs, clk);
 }
 
 #endif //SCCPU_EX_MEM_H
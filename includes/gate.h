@@ -5,11 +5,33 @@
 #ifndef SCCPU_GATE__H
 #define SCCPU_GATE__H
 #include "common.h"
+#if SCCPU_NETLIST
+#include "netlist.h"
+#endif
 
+#if SCCPU_NETLIST
+static inline bit NOT(const bit input) {
+    return nl_gate_(NL_NOT, input, 0);
+}
+#elif SCCPU_LANES > 1
+static inline bit NOT(const bit input) {
+    return ~input;
+}
+#else
 static inline bit NOT(const bit input) {
     return !input;
 }
+#endif
+
+#if SCCPU_NETLIST
+static inline bit AND(const bit input1, const bit input2) {
+    return nl_gate_(NL_AND, input1, input2);
+}
 
+static inline bit OR(const bit input1, const bit input2) {
+    return nl_gate_(NL_OR, input1, input2);
+}
+#else
 static inline bit AND(const bit input1, const bit input2) {
     return input1 & input2;
 }
@@ -17,6 +39,7 @@ static inline bit AND(const bit input1, const bit input2) {
 static inline bit OR(const bit input1, const bit input2) {
     return input1 | input2;
 }
+#endif
 
 static inline bit NAND(const bit input1, const bit input2) {
     return NOT(AND(input1, input2));
@@ -35,5 +58,85 @@ static inline bit XNOR(const bit input1, const bit input2) {
     return NOT(XOR(input1, input2));
 }
 
+// 所有 lane 都为 1 (lane = 1 时就是 input 本身)
+static inline int bit_all_(const bit input) {
+#if SCCPU_LANES == 256
+    return (input[0] & input[1] & input[2] & input[3]) == ~0ull;
+#elif SCCPU_LANES == 64
+    return input == BIT_1;
+#else
+    return input;
+#endif
+}
+
+// 任一 lane 为 1
+static inline int bit_any_(const bit input) {
+#if SCCPU_LANES == 256
+    return (input[0] | input[1] | input[2] | input[3]) != 0;
+#elif SCCPU_LANES == 64
+    return input != BIT_0;
+#else
+    return input;
+#endif
+}
+
+/*********************************************Word***************************************************************/
+// 32 个门并排摆放, 每根导线各自独立求值
+// packed 模式下 32 个门就是一次整字位运算
+
+#if SCCPU_PACKED_WORD
+static inline void word_not_(const word input, word output) {
+    output[0] = ~input[0];
+}
+
+static inline void word_and_(const word input1, const word input2, word output) {
+    output[0] = input1[0] & input2[0];
+}
+
+static inline void word_or_(const word input1, const word input2, word output) {
+    output[0] = input1[0] | input2[0];
+}
+
+static inline void word_xor_(const word input1, const word input2, word output) {
+    output[0] = input1[0] ^ input2[0];
+}
+
+// 1 根导线扇出到 32 根
+static inline void word_fanout_(const bit input, word output) {
+    output[0] = (uint32_t) 0 - (uint32_t) input;
+}
+
+// 32 输入 OR
+static inline bit word_any_(const word input) {
+    return input[0] != 0;
+}
+#else
+static inline void word_not_(const word input, word output) {
+    for (int i = 0; i < WORD_SIZE; i++) output[i] = NOT(input[i]);
+}
+
+static inline void word_and_(const word input1, const word input2, word output) {
+    for (int i = 0; i < WORD_SIZE; i++) output[i] = AND(input1[i], input2[i]);
+}
+
+static inline void word_or_(const word input1, const word input2, word output) {
+    for (int i = 0; i < WORD_SIZE; i++) output[i] = OR(input1[i], input2[i]);
+}
+
+static inline void word_xor_(const word input1, const word input2, word output) {
+    for (int i = 0; i < WORD_SIZE; i++) output[i] = XOR(input1[i], input2[i]);
+}
+
+static inline void word_fanout_(const bit input, word output) {
+    for (int i = 0; i < WORD_SIZE; i++) output[i] = input;
+}
+
+static inline bit word_any_(const word input) {
+    bit any1 = BIT_0;
+    for (int i = 0; i < WORD_SIZE; i++) any1 = OR(any1, input[i]);
+    return any1;
+}
+#endif
+
 
 #endif //SCCPU_GATE__H
@@ -26,17 +26,17 @@ typedef struct id_ex_regs {
     //     bit jump;
     //     ops ops_;
     // }  control_signals;
-    //  reg_dst 在最高位(0)
-    Reg32_ decode_signals;
+    //  reg_dst 在最高位(0), 共 11 根线
+    Reg11_ decode_signals;
 
     // Data Values
     Reg32_ read_data1; // RS
     Reg32_ read_data2; // RT
     Reg32_ imm_ext; // I
-    // Indexes
-    Reg32_ rs_idx;
-    Reg32_ rt_idx;
-    Reg32_ rd_idx;
+    // Indexes (R0..R3 只需要两位)
+    Reg2_ rs_idx;
+    Reg2_ rt_idx;
+    Reg2_ rd_idx;
     // Pc-info
     Reg32_ pc_plus4;
 } Id_ex_regs;
@@ -50,31 +50,49 @@ typedef struct id_ex_write {
 
 static inline void
 init_id_ex_regs(Id_ex_regs *regs) {
-    init_reg32(&regs->decode_signals);
+    init_reg11(&regs->decode_signals);
     init_reg32(&regs->read_data1);
     init_reg32(&regs->read_data2);
     init_reg32(&regs->imm_ext);
-    init_reg32(&regs->rs_idx);
-    init_reg32(&regs->rt_idx);
-    init_reg32(&regs->rd_idx);
+    init_reg2(&regs->rs_idx);
+    init_reg2(&regs->rt_idx);
+    init_reg2(&regs->rd_idx);
     init_reg32(&regs->pc_plus4);
 }
 
 
+// ID 的组合逻辑输出 (ID/EX 各寄存器的 D 端)
+typedef struct id_ex_wires {
+    bit load; // id_ex_write | id_ex_flush
+    bit decode_signals[11];
+    word read_data1;
+    word read_data2;
+    word imm_ext;
+    bit rs_idx[2];
+    bit rt_idx[2];
+    bit rd_idx[2];
+    word pc_plus4;
+} Id_ex_wires;
+
+// decode_cache: 所在核的译码缓存 (SCCPU_DECODE_CACHE), NULL -> 直接 decode()
 static inline void
-id_ex_regs_step(Id_ex_regs *id_ex_regs,
-                const If_id_regs *if_id_regs,
-                const Reg324file_ *reg324_file,
-                const Id_ex_write *id_ex_write,
-                const bit clk) {
+id_ex_eval(const If_id_regs *if_id_regs,
+           const Reg324file_ *reg324_file,
+           const Id_ex_write *id_ex_write,
+           Decode_cache *decode_cache,
+           Id_ex_wires *w) {
     // read data of if_id_regs
     word instr = {0};
-    word pc_plus4 = {0};
     read_reg32(&if_id_regs->instr, instr);
-    read_reg32(&if_id_regs->pc_plus4, pc_plus4);
+    read_reg32(&if_id_regs->pc_plus4, w->pc_plus4);
 
     //signals 源至 instr(if_id_regs->instr {)
+#if SCCPU_DECODE_CACHE
+    const Control_signals signals = decode_cache ? decode_cached(decode_cache, instr) : decode(instr);
+#else
+    (void) decode_cache;
     const Control_signals signals = decode(instr);
+#endif
 
     // Read out 0 to 3 reg
     word r0v = {0};
@@ -104,13 +122,6 @@ id_ex_regs_step(Id_ex_regs *id_ex_regs,
     rd_ops[1] = INST_BIT(instr, 11);
 
     // Data
-    word rs = {0};
-    word rt = {0};
-    word imm_ext = {0};
-    word rs_index = {0};
-    word rt_index = {0};
-    word rd_index = {0};
-
     // Mux 4 to 1
     word tmp_mux_0 = {0};
     word tmp_mux_1 = {0};
@@ -118,81 +129,108 @@ id_ex_regs_step(Id_ex_regs *id_ex_regs,
     // RS
     word_mux_2_1(r0v, r2v, rs_ops[0], tmp_mux_0);
     word_mux_2_1(r1v, r3v, rs_ops[0], tmp_mux_1);
-    word_mux_2_1(tmp_mux_0, tmp_mux_1, rs_ops[1], rs);
+    word_mux_2_1(tmp_mux_0, tmp_mux_1, rs_ops[1], w->read_data1);
 
-    word_mux_2_1(rs, WORD_ZERO, id_ex_write->id_ex_flush, rs);
+    word_mux_2_1(w->read_data1, WORD_ZERO, id_ex_write->id_ex_flush, w->read_data1);
 
     // RT
     word_mux_2_1(r0v, r2v, rt_ops[0], tmp_mux_0);
     word_mux_2_1(r1v, r3v, rt_ops[0], tmp_mux_1);
-    word_mux_2_1(tmp_mux_0, tmp_mux_1, rt_ops[1], rt);
+    word_mux_2_1(tmp_mux_0, tmp_mux_1, rt_ops[1], w->read_data2);
 
-    word_mux_2_1(rt, WORD_ZERO, id_ex_write->id_ex_flush, rt);
+    word_mux_2_1(w->read_data2, WORD_ZERO, id_ex_write->id_ex_flush, w->read_data2);
 
     // IMM-EXT
     // [31:26]  [25:21]  [20:16]  [15:0]
     //  Opcode    RS       RT       Immediate
     //  6bits     5bits    5bits     16bits
     // Ext-Fill  id_ex_flush is 1 set 0
+    memset(w->imm_ext, 0, sizeof(word));
     for (int i = 31; i > 15; i--)
-        imm_ext[INST_WORD(i)] = AND(INST_BIT(instr, 15), NOT(id_ex_write->id_ex_flush));
+        WORD_SET(w->imm_ext, INST_WORD(i), AND(INST_BIT(instr, 15), NOT(id_ex_write->id_ex_flush)));
     for (int i = 15; i >= 0; i--)
-        imm_ext[INST_WORD(i)] = AND(INST_BIT(instr, i), NOT(id_ex_write->id_ex_flush));
-
+        WORD_SET(w->imm_ext, INST_WORD(i), AND(INST_BIT(instr, i), NOT(id_ex_write->id_ex_flush)));
 
     // index
-    rs_index[INST_WORD(0)] = AND(rs_ops[1], NOT(id_ex_write->id_ex_flush));
-    rs_index[INST_WORD(1)] = AND(rs_ops[0], NOT(id_ex_write->id_ex_flush));
+    w->rs_idx[0] = AND(rs_ops[0], NOT(id_ex_write->id_ex_flush));
+    w->rs_idx[1] = AND(rs_ops[1], NOT(id_ex_write->id_ex_flush));
 
-    rt_index[INST_WORD(0)] = AND(rt_ops[1], NOT(id_ex_write->id_ex_flush));
-    rt_index[INST_WORD(1)] = AND(rt_ops[0], NOT(id_ex_write->id_ex_flush));
+    w->rt_idx[0] = AND(rt_ops[0], NOT(id_ex_write->id_ex_flush));
+    w->rt_idx[1] = AND(rt_ops[1], NOT(id_ex_write->id_ex_flush));
 
-    rd_index[INST_WORD(0)] = AND(rd_ops[1], NOT(id_ex_write->id_ex_flush));
-    rd_index[INST_WORD(1)] = AND(rd_ops[0], NOT(id_ex_write->id_ex_flush));
+    w->rd_idx[0] = AND(rd_ops[0], NOT(id_ex_write->id_ex_flush));
+    w->rd_idx[1] = AND(rd_ops[1], NOT(id_ex_write->id_ex_flush));
 
-    // CALL_STEP
+    //decode_signals
+    w->decode_signals[0] = AND(signals.reg_dst, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[1] = AND(signals.alu_src, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[2] = AND(signals.data_src_to_reg, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[3] = AND(signals.reg_write, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[4] = AND(signals.mem_read, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[5] = AND(signals.mem_write, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[6] = AND(signals.branch, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[7] = AND(signals.jump, NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[8] = AND(signals.ops_[0], NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[9] = AND(signals.ops_[1], NOT(id_ex_write->id_ex_flush));
+    w->decode_signals[10] = AND(signals.ops_[2], NOT(id_ex_write->id_ex_flush));
+
+    w->load = OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush);
+}
+
+static inline void
+id_ex_latch(const Id_ex_wires *w, Id_ex_regs *id_ex_regs, const bit clk) {
     word out = {0};
+    bit out_n[11];
+    reg11_step(&id_ex_regs->decode_signals, w->load, w->decode_signals, out_n, clk);
+    reg32_step(&id_ex_regs->read_data1, w->load, w->read_data1, out, clk);
+    reg32_step(&id_ex_regs->read_data2, w->load, w->read_data2, out, clk);
+    reg32_step(&id_ex_regs->imm_ext, w->load, w->imm_ext, out, clk);
+    reg2_step(&id_ex_regs->rs_idx, w->load, w->rs_idx, out_n, clk);
+    reg2_step(&id_ex_regs->rt_idx, w->load, w->rt_idx, out_n, clk);
+    reg2_step(&id_ex_regs->rd_idx, w->load, w->rd_idx, out_n, clk);
+
+    reg32_step(&id_ex_regs->pc_plus4, w->load, w->pc_plus4, out, clk);
+}
 
-    //decode_signals
-    word decode_signals_word = {0};
-    decode_signals_word[INST_WORD(31)] = AND(signals.reg_dst, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(30)] = AND(signals.alu_src, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(29)] = AND(signals.data_src_to_reg, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(28)] = AND(signals.reg_write, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(27)] = AND(signals.mem_read, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(26)] = AND(signals.mem_write, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(25)] = AND(signals.branch, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(24)] = AND(signals.jump, NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(23)] = AND(signals.ops_[0], NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(22)] = AND(signals.ops_[1], NOT(id_ex_write->id_ex_flush));
-    decode_signals_word[INST_WORD(21)] = AND(signals.ops_[2], NOT(id_ex_write->id_ex_flush));
-
-    reg32_step(&id_ex_regs->decode_signals, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), decode_signals_word, out, clk);
-    reg32_step(&id_ex_regs->read_data1, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), rs, out, clk);
-    reg32_step(&id_ex_regs->read_data2, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), rt, out, clk);
-    reg32_step(&id_ex_regs->imm_ext, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), imm_ext, out, clk);
-    reg32_step(&id_ex_regs->rs_idx, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), rs_index, out, clk);
-    reg32_step(&id_ex_regs->rt_idx, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), rt_index, out, clk);
-    reg32_step(&id_ex_regs->rd_idx, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), rd_index, out, clk);
-
-    reg32_step(&id_ex_regs->pc_plus4, OR(id_ex_write->id_ex_write, id_ex_write->id_ex_flush), pc_plus4, out, clk);
+// pc_plus4 只是穿过 ID (不受 flush 影响), 活动性调度在其余输入不变时单独推进这一路
+static inline void
+id_ex_eval_pc(const If_id_regs *if_id_regs, Id_ex_wires *w) {
+    read_reg32(&if_id_regs->pc_plus4, w->pc_plus4);
+}
+
+static inline void
+id_ex_latch_pc(const Id_ex_wires *w, Id_ex_regs *id_ex_regs, const bit clk) {
+    word out = {0};
+    reg32_step(&id_ex_regs->pc_plus4, w->load, w->pc_plus4, out, clk);
+}
+
+static inline void
+id_ex_regs_step(Id_ex_regs *id_ex_regs,
+                const If_id_regs *if_id_regs,
+                const Reg324file_ *reg324_file,
+                const Id_ex_write *id_ex_write,
+                Decode_cache *decode_cache,
+                const bit clk) {
+    Id_ex_wires w;
+    id_ex_eval(if_id_regs, reg324_file, id_ex_write, decode_cache, &w);
+    id_ex_latch(&w, id_ex_regs, clk);
 }
 
 /*********************************************Macro***************************************************************/
 
-#define  GET_REG_DST_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(31)].dff.Q)
-#define  GET_ALU_SRC_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(30)].dff.Q)
-#define  GET_DATA_SRC_TO_REG_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(29)].dff.Q)
-#define  GET_REG_WRITE_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(28)].dff.Q)
-#define  GET_MEM_READ_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(27)].dff.Q)
-#define  GET_MEM_WRITE_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(26)].dff.Q)
-#define  GET_BRANCH_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(25)].dff.Q)
-#define  GET_JUMP_OF_SIGNALS(r_ptr) ((r_ptr)->dffs[INST_WORD(24)].dff.Q)
+#define  GET_REG_DST_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 10)
+#define  GET_ALU_SRC_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 9)
+#define  GET_DATA_SRC_TO_REG_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 8)
+#define  GET_REG_WRITE_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 7)
+#define  GET_MEM_READ_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 6)
+#define  GET_MEM_WRITE_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 5)
+#define  GET_BRANCH_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 4)
+#define  GET_JUMP_OF_SIGNALS(r_ptr) GET_BIT_OF_REGN((r_ptr), 3)
 
 #define  GET_OPS_OF_SIGNALS(r_ptr, ret_ops) do { \
-(ret_ops)[0] = (r_ptr)->dffs[INST_WORD(23)].dff.Q; \
-(ret_ops)[1] = (r_ptr)->dffs[INST_WORD(22)].dff.Q; \
-(ret_ops)[2] = (r_ptr)->dffs[INST_WORD(21)].dff.Q; \
+(ret_ops)[0] = GET_BIT_OF_REGN((r_ptr), 2); \
+(ret_ops)[1] = GET_BIT_OF_REGN((r_ptr), 1); \
+(ret_ops)[2] = GET_BIT_OF_REGN((r_ptr), 0); \
 } while(0)
 
 
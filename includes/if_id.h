@@ -10,10 +10,10 @@
 #include "pc.h"
 
 typedef bit pc_ops[2];
-const static pc_ops PLUSH_4 = {0, 0};
-const static pc_ops BRANCH_TARGET = {1, 0};
-const static pc_ops JUMP_TARGET = {0, 1};
-const static pc_ops EXCEPTION_VECTOR = {1, 1};
+const static pc_ops PLUSH_4 = {BIT_0, BIT_0};
+const static pc_ops BRANCH_TARGET = {BIT_1, BIT_0};
+const static pc_ops JUMP_TARGET = {BIT_0, BIT_1};
+const static pc_ops EXCEPTION_VECTOR = {BIT_1, BIT_1};
 
 typedef struct if_id_regs {
     Reg32_ instr;
@@ -139,16 +139,22 @@ init_if_id_regs(If_id_regs *regs) {
  *   符合“准备/提交”二段式模型。
  */
 
+// IF 的组合逻辑输出: PC 与 IF/ID 各寄存器的 D 端
+typedef struct if_id_wires {
+    bit pc_load;
+    word pc_next;
+    bit if_id_load;
+    word instr;
+    word pc_plus4;
+} If_id_wires;
+
 static inline void
-if_id_regs_step(
-    If_id_regs *if_id_regs,
-    const Im_t *imt,
-    Pc32_ *pc,
-    const If_id_pc_ops *pc_ops,
-    const If_id_write *write_,
-    bit *overflow,
-    const bit clk
-) {
+if_id_eval(const Im_t *imt,
+           const Pc32_ *pc,
+           const If_id_pc_ops *pc_ops,
+           const If_id_write *write_,
+           bit *overflow,
+           If_id_wires *w) {
     // IF_Comb
     word old_pc = {0};
     read_reg32(&pc->reg32, old_pc);
@@ -156,36 +162,50 @@ if_id_regs_step(
     word instr_wire = {0};
     // 在硬件中 计算是并行的
     // pc_plus4_wire = pc + 4 , pc_next_wire = mux(....)
-    word pc_plus4_wire = {0};
-    word pc_next_wire = {0};
 
     im_read(imt, old_pc, instr_wire);
-    word_alu_(old_pc, WORD_4_BYTE, pc_plus4_wire, OPS_ADD_, overflow);
+    word_alu_(old_pc, WORD_4_BYTE, w->pc_plus4, OPS_ADD_, overflow);
 
     bit sel_btw = AND(pc_ops->pc_ops_[0], NOT(pc_ops->pc_ops_[1])); // 10
     bit sel_jtw = AND(NOT(pc_ops->pc_ops_[0]), pc_ops->pc_ops_[1]); //01
     bit sel_ev = AND(pc_ops->pc_ops_[0], pc_ops->pc_ops_[1]); // 11
 
-    word_mux_2_1(pc_plus4_wire, pc_ops->branch_target_wire, sel_btw, pc_next_wire);
-    word_mux_2_1(pc_next_wire, pc_ops->jump_target_wire, sel_jtw, pc_next_wire);
-    word_mux_2_1(pc_next_wire, pc_ops->exception_vector_wire, sel_ev, pc_next_wire);
+    word_mux_2_1(w->pc_plus4, pc_ops->branch_target_wire, sel_btw, w->pc_next);
+    word_mux_2_1(w->pc_next, pc_ops->jump_target_wire, sel_jtw, w->pc_next);
+    word_mux_2_1(w->pc_next, pc_ops->exception_vector_wire, sel_ev, w->pc_next);
+    w->pc_load = write_->pc_write;
 
+    // NOP 会把指令刷成 0 (DeCode已做无害化支持)
+    // pc_plus4_wire 不需要 刷成0
+    // 例如 pc -> 0x100  pc_plus_4_wire 依然是 0x104
+    word_mux_2_1(instr_wire, NOP, write_->if_id_flush, w->instr);
+    w->if_id_load = OR(write_->if_id_write, write_->if_id_flush);
+}
 
-    //ID
+static inline void
+if_id_latch(const If_id_wires *w, If_id_regs *if_id_regs, Pc32_ *pc, const bit clk) {
     //out is ignored
     word out = {0};
     // pc
-    reg32_step(&pc->reg32, write_->pc_write, pc_next_wire, out, clk);
+    reg32_step(&pc->reg32, w->pc_load, w->pc_next, out, clk);
 
-    // NOP -> 32 Zero
-    word instr_ops = {0};
-    // NOP 会把指令刷成 0 (DeCode已做无害化支持)
-    // pc_plus4_wire 不需要 刷成0
-    // 例如 pc -> 0x100  pc_plus_4_wire 依然是 0x104
-    word_mux_2_1(instr_wire, NOP, write_->if_id_flush, instr_ops);
+    reg32_step(&if_id_regs->instr, w->if_id_load, w->instr, out, clk);
+    reg32_step(&if_id_regs->pc_plus4, w->if_id_load, w->pc_plus4, out, clk);
+}
 
-    reg32_step(&if_id_regs->instr, OR(write_->if_id_write, write_->if_id_flush), instr_ops, out, clk);
-    reg32_step(&if_id_regs->pc_plus4, OR(write_->if_id_write, write_->if_id_flush), pc_plus4_wire, out, clk);
+static inline void
+if_id_regs_step(
+    If_id_regs *if_id_regs,
+    const Im_t *imt,
+    Pc32_ *pc,
+    const If_id_pc_ops *pc_ops,
+    const If_id_write *write_,
+    bit *overflow,
+    const bit clk
+) {
+    If_id_wires w;
+    if_id_eval(imt, pc, pc_ops, write_, overflow, &w);
+    if_id_latch(&w, if_id_regs, pc, clk);
 }
 
 
@@ -7,12 +7,64 @@
 #define IM_SIZE 256
 #include "common.h"
 #include "string.h"
+#include "stdlib.h"
 #include "utils.h"
 // IM 模块允许使用 "高级语法"
 // 它本质是指令的储存柜
 // 就像我们使用 bool 是表示 bit 而非 dff
 // 关注核心 简化边缘
 
+#if SCCPU_SHARED_IMAGES
+/**
+ * 共享的只读镜像: 程序用 im_image_load 装一次, 之后任意多个 Im_t 用 im_attach 挂上去
+ * im_store / im_load 写时复制: 第一次写时把挂着的镜像整份复制成私有的, 镜像和其他核看不到; im_release 释放
+ * init_imt 不释放 (结构体可能还没初始化过), 写过的 Im_t 重新开始前先 im_release 或直接 im_attach
+ */
+typedef struct im_image {
+    word im[IM_SIZE];
+} Im_image;
+
+typedef struct {
+    const word *im; // 指向某个 Im_image 或自己的私有副本, im_read 的写法不变
+    Im_image *own; // 写过之后的私有副本, NULL -> 仍在共享镜像里
+} Im_t;
+
+static const Im_image IM_EMPTY_IMAGE_; // 全 NOP
+
+static inline void init_imt(Im_t *imt) {
+    imt->im = IM_EMPTY_IMAGE_.im;
+    imt->own = NULL;
+}
+
+static inline void im_image_load(Im_image *img, const uint32_t *program_codes, const size_t codes_len) {
+    const size_t len = codes_len > IM_SIZE ? IM_SIZE : codes_len;
+    memset(img, 0, sizeof(Im_image));
+    for (size_t i = 0; i < len; i++) u32_to_word(program_codes[i], img->im[i]);
+}
+
+static inline void im_release(Im_t *imt) {
+    free(imt->own);
+    init_imt(imt);
+}
+
+// 丢掉私有副本, 挂到 img 上
+static inline void im_attach(Im_t *imt, const Im_image *img) {
+    im_release(imt);
+    imt->im = img->im;
+}
+
+// 要写第 idx 条: 还挂在共享镜像上就先复制; 分配失败返回 NULL
+static inline word *im_word_w_(Im_t *imt, const uint32_t idx) {
+    if (!imt->own) {
+        Im_image *copy = malloc(sizeof(Im_image));
+        if (!copy) return NULL;
+        memcpy(copy->im, imt->im, sizeof(Im_image));
+        imt->own = copy;
+        imt->im = copy->im;
+    }
+    return &imt->own->im[idx];
+}
+#else
 typedef struct {
     word im[IM_SIZE];
 } Im_t;
@@ -28,9 +80,77 @@ static inline void im_load_program(Im_t *imt, const word *program_codes, const s
     }
 }
 
+static inline void im_release(Im_t *imt) {
+    init_imt(imt);
+}
+
+static inline word *im_word_w_(Im_t *imt, const uint32_t idx) {
+    return &imt->im[idx];
+}
+#endif
+
+#if SCCPU_LANES == 1 && !SCCPU_NETLIST
+// 写第 idx 条指令 (两种存储方式通用, 共享镜像时写时复制); 越界或分配失败返回 -1
+static inline int im_store(Im_t *imt, const uint32_t idx, const uint32_t code) {
+    if (idx >= IM_SIZE) return -1;
+    word *w = im_word_w_(imt, idx);
+    if (!w) return -1;
+    u32_to_word(code, *w);
+    return 0;
+}
+
+// 从第 0 条起写入程序, 多出 IM_SIZE 的丢掉; 后面的表项不动
+static inline int im_load(Im_t *imt, const uint32_t *program_codes, const size_t codes_len) {
+    const size_t len = codes_len > IM_SIZE ? IM_SIZE : codes_len;
+    for (size_t i = 0; i < len; i++) {
+        if (im_store(imt, (uint32_t) i, program_codes[i]) != 0) return -1;
+    }
+    return 0;
+}
+#endif
+
+#if SCCPU_LANES > 1
+// 每条 IM 表项的 bit 也是 lane 掩码: 第 l 个 lane 的程序存放在各 bit 的第 l 位
+static inline void im_lane_load_program(Im_t *imt, const int lane, const uint32_t *program_codes,
+                                        const size_t codes_len) {
+    const size_t len = codes_len > IM_SIZE ? IM_SIZE : codes_len;
+    for (size_t i = 0; i < len; i++) {
+        word_put_lane_u32(imt->im[i], lane, program_codes[i]);
+    }
+}
+
+static inline void im_read(const Im_t *imt, word pc, word instruction_out) {
+    // 所有 lane 的 PC 相同 (每根导线全 0 或全 1): 整行读出即可
+    int same_pc = 1;
+    for (int i = 0; i < WORD_SIZE; i++) {
+        same_pc &= bit_all_(pc[i]) | bit_all_(NOT(pc[i]));
+    }
+    if (same_pc && u32_from_word(pc) / 4 < IM_SIZE) {
+        memcpy(instruction_out, imt->im[u32_from_word(pc) / 4], sizeof(word));
+        return;
+    }
+    for (int lane = 0; lane < SCCPU_LANES; lane++) {
+        const uint32_t idx = u32_from_word_lane(pc, lane) / 4;
+        // 越界的 lane 读到 NOP
+        const bit *row = idx < IM_SIZE ? imt->im[idx] : NOP;
+        for (int i = 0; i < WORD_SIZE; i++) {
+            LANE_PUT(instruction_out[i], lane, LANE_GET(row[i], lane));
+        }
+    }
+}
+#elif SCCPU_NETLIST
+// 网表捕获: IM 只留下一个读端口, 指令由仿真时的存储器回调提供
+static inline void im_read(const Im_t *imt, word pc, word instruction_out) {
+    (void) imt;
+    nl_mem_read_(NL_MEM_IM, pc, instruction_out);
+}
+#else
 static inline void im_read(const Im_t *imt, word pc, word instruction_out) {
-    memcpy(instruction_out, imt->im[u32_from_word(pc) / 4], sizeof(word));
+    // 越界读到 NOP, 与 lane 模式 / ISS 一致
+    const uint32_t idx = u32_from_word(pc) / 4;
+    memcpy(instruction_out, idx < IM_SIZE ? imt->im[idx] : NOP, sizeof(word));
 }
+#endif
 
 
 #endif //SCCPU_IM__H
@@ -213,11 +213,7 @@ static inline bit func6_slt(word instruction) {
 
 // any1 = OR(instruction[0..31]); nop = NOT(any1)
 static inline bit nop_(const word instruction) {
-    bit any1 = 0;
-    for (int i = 0; i < WORD_SIZE; ++i) {
-        any1 = OR(any1, instruction[i]);
-    }
-    return NOT(any1);
+    return NOT(word_any_(instruction));
 }
 
 
@@ -0,0 +1,230 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_ISS_H
+#define SCCPU_ISS_H
+#include "cpu_core.h"
+
+/**
+ * 功能级指令集模拟器 (ISS): 与 isa.h 同一套指令, 寄存器 / 内存都是普通的 uint32_t / uint8_t, 一次执行一条指令
+ * 用来快进长程序, 只把感兴趣的区间放到门级流水线上跑:
+ *  iss_run        快进 N 条指令
+ *  iss_to_cpu     把 R0-R3 / PC / IM / DM 装进一个排空的 Cpu_core (流水线寄存器全是气泡), 下个周期从 PC 取指
+ *  cpu_drain      停止取指 (IM 临时换成全 NOP) 跑 CPU_DRAIN_CYCLES 个周期, 在途指令全部写回, PC 落在下一条要执行的指令
+ *  iss_from_cpu   cpu_drain 之后把架构状态读回 ISS
+ *
+ * iss_exec / iss_run 的语义跟着 RTL 走 (状态搬运要求两边走同一条路径), 而不是 isa.h 注释里的完整 MIPS:
+ *  寄存器号只取低 2 位; 未知 funct 的 R 型按 AND 写 rd (decode 的 ops 全 0), 全 0 指令是 NOP
+ *  J 目前只译码不跳转 (EX 的 pc_src[1] 恒 0), 当作 NOP; 未知 opcode 也是 NOP
+ *  BEQ 的 is_zero 是 word_is_zero, 只看 rs - rt 的最高 8 位 (word[0..7]), 高字节为 0 就跳
+ *  LW / SW 非对齐或越界: 读出 0 / 不写; 取指越过 IM 当作 NOP
+ * iss_exec_arch 按 isa.h 执行 J 和 BEQ (对拍的参考), 与 RTL 不同的 next PC 记成已知偏差 (Iss_deviation)
+ * 流水线没有前递和阻塞, 写寄存器的指令后面至少隔 3 条才能读到新值 (main.c 里的 NOP);
+ * 不满足这个间隔的程序在 RTL 上读到的是旧值, 与 ISS 不一致
+ */
+#if SCCPU_LANES != 1 || SCCPU_NETLIST
+#error "iss.h transfers state into a single Cpu_core (SCCPU_LANES=1, no SCCPU_NETLIST)"
+#endif
+
+#define CPU_DRAIN_CYCLES 4 // IF/ID 里最年轻的指令还要走 ID / EX / MEM / WB
+
+typedef struct iss {
+    uint32_t r[4];
+    uint32_t pc;
+    uint32_t im[IM_SIZE];
+    uint8_t dm[DEFAULT_SIZE]; // 大端, 与 Dm_.memory 相同
+    uint64_t instret; // 已执行的指令数 (含 NOP)
+} Iss;
+
+static inline void iss_init(Iss *s) {
+    memset(s, 0, sizeof(Iss));
+}
+
+static inline void iss_load_program(Iss *s, const uint32_t *program_codes, const size_t codes_len) {
+    const size_t len = codes_len > IM_SIZE ? IM_SIZE : codes_len;
+    memcpy(s->im, program_codes, len * sizeof(uint32_t));
+}
+
+static inline uint32_t iss_dm_read_(const Iss *s, const uint32_t addr) {
+    if ((addr & 3) != 0 || addr >= DEFAULT_SIZE) return 0;
+    const uint8_t *m = &s->dm[addr];
+    return (uint32_t) m[0] << 24 | (uint32_t) m[1] << 16 | (uint32_t) m[2] << 8 | m[3];
+}
+
+static inline void iss_dm_write_(Iss *s, const uint32_t addr, const uint32_t v) {
+    if ((addr & 3) != 0 || addr >= DEFAULT_SIZE) return;
+    for (int i = 0; i < 4; i++) s->dm[addr + i] = (uint8_t) (v >> (24 - 8 * i));
+}
+
+// RTL 与 isa.h 的已知偏差, 只影响 next PC
+typedef enum iss_deviation {
+    ISS_DEV_NONE = 0,
+    ISS_DEV_BEQ_TOP_BYTE, // rs != rt 但 rs - rt 的最高字节为 0, RTL 照样跳
+    ISS_DEV_J_IGNORED, // J 没有接到 IF, RTL 顺序执行
+    ISS_DEV_NUM
+} Iss_deviation;
+
+static const char *const ISS_DEV_NAMES_[ISS_DEV_NUM] = {"none", "beq_top_byte", "j_ignored"};
+
+// 一条指令对架构状态的影响 (对拍用); mem_write 只记真正写进 DM 的 (对齐且不越界)
+typedef struct iss_effect {
+    int reg_write;
+    uint32_t reg_idx;
+    uint32_t reg_value;
+    int mem_write;
+    uint32_t mem_addr;
+    uint32_t mem_value;
+    Iss_deviation deviation; // 只有 iss_exec_arch 会记
+    uint32_t rtl_next_pc; // RTL 上这条指令之后取指的 PC
+} Iss_effect;
+
+// 同 word_is_zero: 只看 rs - rt 的最高字节
+static inline int iss_beq_taken_rtl_(const uint32_t a, const uint32_t b) {
+    return (a - b) >> 24 == 0;
+}
+
+// 执行一条指令; arch 为 0 时跟着 RTL, 否则 J / BEQ 按 isa.h; fx 非空时记下它的影响
+static inline void iss_exec_(Iss *s, Iss_effect *fx, const int arch) {
+    const uint32_t inst = s->pc / 4 < IM_SIZE ? s->im[s->pc / 4] : 0;
+    const uint32_t op = inst >> 26;
+    const uint32_t rs = inst >> 21 & 3, rt = inst >> 16 & 3, rd = inst >> 11 & 3;
+    const uint32_t imm = (uint32_t) (int32_t) (int16_t) (inst & 0xFFFF);
+    const uint32_t a = s->r[rs], b = s->r[rt];
+    uint32_t next = s->pc + 4, rtl_next = s->pc + 4;
+    int dst = -1;
+    if (fx) memset(fx, 0, sizeof(Iss_effect));
+    switch (op) {
+        case OP_R_TYPE:
+            if (inst == 0) break;
+            dst = (int) rd;
+            switch (inst & 0x3F) {
+                case FUNCT_ADD: s->r[rd] = a + b;
+                    break;
+                case FUNCT_SUB: s->r[rd] = a - b;
+                    break;
+                case FUNCT_OR: s->r[rd] = a | b;
+                    break;
+                case FUNCT_SLT: s->r[rd] = (int32_t) a < (int32_t) b;
+                    break;
+                default: s->r[rd] = a & b; // FUNCT_AND 以及未知 funct
+                    break;
+            }
+            break;
+        case OP_ADDI: s->r[rt] = a + imm;
+            dst = (int) rt;
+            break;
+        case OP_LW: s->r[rt] = iss_dm_read_(s, a + imm);
+            dst = (int) rt;
+            break;
+        case OP_SW: iss_dm_write_(s, a + imm, b);
+            if (fx && ((a + imm) & 3) == 0 && a + imm < DEFAULT_SIZE) {
+                fx->mem_write = 1;
+                fx->mem_addr = a + imm;
+                fx->mem_value = b;
+            }
+            break;
+        case OP_BEQ:
+            if (iss_beq_taken_rtl_(a, b)) rtl_next += imm << 2;
+            next = arch ? (a == b ? next + (imm << 2) : next) : rtl_next;
+            break;
+        case OP_J:
+            if (arch) next = ((s->pc + 4) & 0xF0000000u) | (inst & 0x03FFFFFFu) << 2;
+            break;
+        default: // 未知 opcode
+            break;
+    }
+    if (fx && dst >= 0) {
+        fx->reg_write = 1;
+        fx->reg_idx = (uint32_t) dst;
+        fx->reg_value = s->r[dst];
+    }
+    if (fx) {
+        fx->rtl_next_pc = rtl_next;
+        if (next != rtl_next) fx->deviation = op == OP_J ? ISS_DEV_J_IGNORED : ISS_DEV_BEQ_TOP_BYTE;
+    }
+    s->pc = next;
+    s->instret++;
+}
+
+// 跟着 RTL 执行一条 (快进 / 状态搬运)
+static inline void iss_exec(Iss *s, Iss_effect *fx) {
+    iss_exec_(s, fx, 0);
+}
+
+// 按 isa.h 执行一条 (对拍的参考); next PC 与 RTL 不同时 fx->deviation 记下是哪种偏差
+static inline void iss_exec_arch(Iss *s, Iss_effect *fx) {
+    iss_exec_(s, fx, 1);
+}
+
+static inline void iss_step(Iss *s) {
+    iss_exec(s, NULL);
+}
+
+// 快进 n 条指令
+static inline void iss_run(Iss *s, const uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) iss_step(s);
+}
+
+// master 与 Q 同时写入, 两种 DFF 实现下一个周期都从这个值出发
+static inline void iss_reg32_put_(Reg32_ *r, const uint32_t v) {
+    u32_to_word(v, r->q);
+    u32_to_word(v, r->master_q);
+}
+
+// 装进排空的流水线: 流水线寄存器复位成气泡, 下一个周期从 s->pc 取指; cycle_count 不动
+static inline void iss_to_cpu(const Iss *s, Cpu_core *c) {
+    init_if_id_regs(&c->if_id);
+    init_id_ex_regs(&c->id_ex);
+    init_ex_eme_regs(&c->ex_mem);
+    init_mem_wb_regs(&c->mem_wb);
+    iss_reg32_put_(&c->rf.r0, s->r[0]);
+    iss_reg32_put_(&c->rf.r1, s->r[1]);
+    iss_reg32_put_(&c->rf.r2, s->r[2]);
+    iss_reg32_put_(&c->rf.r3, s->r[3]);
+    iss_reg32_put_(&c->pc.reg32, s->pc);
+    // SCCPU_SHARED_IMAGES 下写时复制, 挂着的镜像不变
+    (void) im_load(&c->im, s->im, IM_SIZE);
+    (void) dm_load(&c->dm, s->dm, sizeof(s->dm));
+    memset(&c->wire_pc_src, 0, sizeof(pc_ops));
+    memset(c->wire_branch_target, 0, sizeof(word));
+    cpu_activity_invalidate(c);
+}
+
+/**
+ * 排空流水线: IM 换成全 NOP 跑 CPU_DRAIN_CYCLES 个周期, 再换回来
+ * 下一条要执行的指令起初是 PC 里待取的那条; 在途的分支在 EX 生效时改成分支目标 (它后面取进来的都是 NOP, 被冲掉也无妨)
+ * 结束时 PC 改回这条指令, 流水线里只剩气泡, 可以接着 cpu_step
+ * 换下来的 IM 放在栈上 (bit[32] 后端约 8KB), 不同线程可以同时排空各自的核
+ */
+static inline void cpu_drain(Cpu_core *c) {
+    uint32_t resume = reg32_read_u32_(&c->pc.reg32);
+    const Im_t saved = c->im;
+    init_imt(&c->im);
+    for (int i = 0; i < CPU_DRAIN_CYCLES; i++) {
+        cpu_step(c);
+        if (LANE_GET(c->wire_pc_src[0], 0)) resume = u32_from_word(c->wire_branch_target);
+    }
+    c->im = saved;
+    iss_reg32_put_(&c->pc.reg32, resume);
+    cpu_activity_invalidate(c);
+}
+
+// 直接读出排空状态下的 c (不推进周期)
+static inline void iss_read_cpu(Iss *s, const Cpu_core *c) {
+    s->r[0] = reg32_read_u32_(&c->rf.r0);
+    s->r[1] = reg32_read_u32_(&c->rf.r1);
+    s->r[2] = reg32_read_u32_(&c->rf.r2);
+    s->r[3] = reg32_read_u32_(&c->rf.r3);
+    s->pc = reg32_read_u32_(&c->pc.reg32);
+    for (int i = 0; i < IM_SIZE; i++) s->im[i] = u32_from_word(c->im.im[i]);
+    dm_copy_out(&c->dm, s->dm);
+}
+
+// 排空 c 并读出架构状态; instret 不动 (流水线不按指令计数)
+static inline void iss_from_cpu(Iss *s, Cpu_core *c) {
+    cpu_drain(c);
+    iss_read_cpu(s, c);
+}
+
+#endif //SCCPU_ISS_H
@@ -0,0 +1,56 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_LANES_H
+#define SCCPU_LANES_H
+#include "cpu_core.h"
+
+// bit-sliced 构建 (SCCPU_LANES = 64 / 256) 下按 lane 装载/读取单个 CPU 实例
+// 电路部分 (cpu_tick) 完全不变, 一次 tick 推进所有 lane
+#if SCCPU_LANES > 1
+
+static inline
+void cpu_lane_load_program(Cpu_core *c, const int lane, const uint32_t *program_codes, const size_t codes_len) {
+    im_lane_load_program(&c->im, lane, program_codes, codes_len);
+}
+
+static inline
+void cpu_lane_load_dm(Cpu_core *c, const int lane, const uint8_t *image, const size_t len) {
+    dm_lane_load(&c->dm, lane, image, len);
+}
+
+static inline
+uint32_t cpu_lane_read_reg32(const Reg32_ *r, const int lane) {
+    word w = {0};
+    read_reg32(r, w);
+    return u32_from_word_lane(w, lane);
+}
+
+// idx: 0..3 -> R0..R3
+static inline
+uint32_t cpu_lane_read_reg(const Cpu_core *c, const int lane, const int idx) {
+    switch (idx & 3) {
+        case 0: return cpu_lane_read_reg32(&c->rf.r0, lane);
+        case 1: return cpu_lane_read_reg32(&c->rf.r1, lane);
+        case 2: return cpu_lane_read_reg32(&c->rf.r2, lane);
+        default: return cpu_lane_read_reg32(&c->rf.r3, lane);
+    }
+}
+
+static inline
+uint32_t cpu_lane_read_pc(const Cpu_core *c, const int lane) {
+    return cpu_lane_read_reg32(&c->pc.reg32, lane);
+}
+
+// 大端, 与 dm_read 一致; 非对齐/越界返回 0
+static inline
+uint32_t cpu_lane_read_dm_u32(const Cpu_core *c, const int lane, const uint32_t addr) {
+    if ((addr & 3) != 0 || addr >= DEFAULT_SIZE) return 0;
+    const uint8_t *m = &c->dm.memory[lane][addr];
+    return (uint32_t) m[0] << 24 | (uint32_t) m[1] << 16 | (uint32_t) m[2] << 8 | m[3];
+}
+
+#endif
+
+#endif //SCCPU_LANES_H
@@ -0,0 +1,286 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_MODELS_H
+#define SCCPU_MODELS_H
+#include "cpu_core.h"
+
+/**
+ * 模块抽象级别登记表 + 等价性自检
+ *
+ * 每个模块有门级 (xxx_gate_) 和行为级 (xxx_beh_) 两个实现, 原来的名字按 SCCPU_MODEL_* 选其中一个 (见 common.h)
+ * 关心门级细节的模块留在门级, 其余换成行为级跑得快; 换之前用 model_check_all 把两个实现放在一起对拍:
+ *  word_alu_       8 个 op x 边界值两两组合 + 随机操作数, 比较 ret / overflow
+ *  decode          opcode x funct 穷举 (其余位随机) + 随机指令字, 比较 11 根控制线
+ *  reg324file_step 随机读写序列, 比较 rd1 / rd2 和 4 个寄存器的 master / Q
+ *  dff             (master, Q, clk, d) 穷举
+ *  pc32_word_step  随机 reset / branch 序列 (含 PC + 4 溢出), 比较 pc_out / overflow / 寄存器
+ *  dm_read         随机内容, 对齐 / 非对齐 / 越界地址, 比较 ret 和错误位
+ * 两个实现总是同时编译, 对拍与当前选了哪个无关
+ */
+#if !SCCPU_HAS_BEH_MODELS
+#error "models.h needs SCCPU_LANES=1 without SCCPU_NETLIST"
+#endif
+
+typedef struct model_entry {
+    const char *module;
+    const char *macro;
+    int level; // MODEL_GATE / MODEL_BEH
+} Model_entry;
+
+static const Model_entry MODELS_[] = {
+    {"word_alu_", "SCCPU_MODEL_ALU", SCCPU_MODEL_ALU},
+    {"decode", "SCCPU_MODEL_DECODE", SCCPU_MODEL_DECODE},
+    {"reg324file_step", "SCCPU_MODEL_REGFILE", SCCPU_MODEL_REGFILE},
+    {"dff", "SCCPU_DFF_CLOSED_FORM", SCCPU_DFF_CLOSED_FORM ? MODEL_BEH : MODEL_GATE},
+    {"pc32_word_step", "SCCPU_MODEL_PC", SCCPU_MODEL_PC},
+    {"dm_read", "SCCPU_MODEL_DM_READ", SCCPU_MODEL_DM_READ},
+};
+
+#define MODEL_NUM ((int) (sizeof(MODELS_) / sizeof(MODELS_[0])))
+#define MODEL_MAX_REPORT 4 // 每个模块最多打印几条不一致
+
+static inline void model_report(void) {
+    printf("[Models] module abstraction levels:\n");
+    for (int i = 0; i < MODEL_NUM; i++) {
+        printf("         %-16s %-5s (%s)\n", MODELS_[i].module, MODELS_[i].level == MODEL_BEH ? "beh" : "gate",
+               MODELS_[i].macro);
+    }
+}
+
+typedef struct model_check {
+    const char *module;
+    uint64_t cases;
+    uint64_t mismatches;
+} Model_check;
+
+static uint64_t model_rng_state_ = 0x2545F4914F6CDD1Dull;
+
+static inline uint32_t model_rng_(void) {
+    model_rng_state_ ^= model_rng_state_ << 13;
+    model_rng_state_ ^= model_rng_state_ >> 7;
+    model_rng_state_ ^= model_rng_state_ << 17;
+    return (uint32_t) model_rng_state_;
+}
+
+static inline int model_mismatch_(Model_check *r, const int same) {
+    r->cases++;
+    if (same) return 0;
+    r->mismatches++;
+    return r->mismatches <= MODEL_MAX_REPORT;
+}
+
+static inline void model_alu_case_(Model_check *r, const uint32_t a, const uint32_t b, const int op) {
+    word wa, wb, rg, rb;
+    ops o;
+    bit ovg = BIT_0, ovb = BIT_0;
+    u32_to_word(a, wa);
+    u32_to_word(b, wb);
+    o[0] = (op >> 2) & 1 ? BIT_1 : BIT_0;
+    o[1] = (op >> 1) & 1 ? BIT_1 : BIT_0;
+    o[2] = op & 1 ? BIT_1 : BIT_0;
+    word_alu_gate_(wa, wb, rg, o, &ovg);
+    word_alu_beh_(wa, wb, rb, o, &ovb);
+    const uint32_t g = u32_from_word(rg), h = u32_from_word(rb);
+    if (model_mismatch_(r, g == h && LANE_GET(ovg, 0) == LANE_GET(ovb, 0))) {
+        printf("[MODEL] word_alu_ op=%d a=0x%08X b=0x%08X: gate=0x%08X/%d beh=0x%08X/%d\n", op, a, b, g,
+               LANE_GET(ovg, 0), h, LANE_GET(ovb, 0));
+    }
+}
+
+static inline Model_check model_check_alu(const int samples) {
+    static const uint32_t edges[] = {
+        0, 1, 2, 4, 0x7FFFFFFFu, 0x80000000u, 0x80000001u, 0xFFFFFFFCu, 0xFFFFFFFEu, 0xFFFFFFFFu, 0x55555555u,
+        0xAAAAAAAAu
+    };
+    const int n_edges = (int) (sizeof(edges) / sizeof(edges[0]));
+    Model_check r = {"word_alu_", 0, 0};
+    for (int op = 0; op < 8; op++) {
+        for (int i = 0; i < n_edges; i++) {
+            for (int j = 0; j < n_edges; j++) model_alu_case_(&r, edges[i], edges[j], op);
+        }
+    }
+    for (int k = 0; k < samples; k++) model_alu_case_(&r, model_rng_(), model_rng_(), (int) (model_rng_() & 7));
+    return r;
+}
+
+// 11 根控制线按 id_ex.decode_signals 的顺序打包
+static inline uint32_t model_cs_bits_(const Control_signals cs) {
+    const bit v[11] = {
+        cs.reg_dst, cs.alu_src, cs.data_src_to_reg, cs.reg_write, cs.mem_read, cs.mem_write, cs.branch, cs.jump,
+        cs.ops_[0], cs.ops_[1], cs.ops_[2]
+    };
+    uint32_t bits = 0;
+    for (int i = 0; i < 11; i++) bits = bits << 1 | (uint32_t) LANE_GET(v[i], 0);
+    return bits;
+}
+
+static inline void model_decode_case_(Model_check *r, const uint32_t inst) {
+    word w;
+    u32_to_word(inst, w);
+    const uint32_t g = model_cs_bits_(decode_gate_(w)), b = model_cs_bits_(decode_beh_(w));
+    if (model_mismatch_(r, g == b)) {
+        printf("[MODEL] decode inst=0x%08X: gate=0x%03X beh=0x%03X\n", inst, g, b);
+    }
+}
+
+static inline Model_check model_check_decode(const int samples) {
+    Model_check r = {"decode", 0, 0};
+    model_decode_case_(&r, 0);
+    for (uint32_t op = 0; op < 64; op++) {
+        for (uint32_t funct = 0; funct < 64; funct++) {
+            model_decode_case_(&r, op << 26 | funct);
+            model_decode_case_(&r, op << 26 | (model_rng_() & 0x03FFFFC0u) | funct);
+        }
+    }
+    for (int k = 0; k < samples; k++) model_decode_case_(&r, model_rng_());
+    return r;
+}
+
+// 逐字段比较 (packed 下 prev_clk 后面有填充字节, 不能整体 memcmp)
+static inline int model_reg32_same_(const Reg32_ *a, const Reg32_ *b) {
+    return memcmp(a->master_q, b->master_q, sizeof(word)) == 0 && memcmp(a->q, b->q, sizeof(word)) == 0
+           && LANE_GET(a->prev_clk, 0) == LANE_GET(b->prev_clk, 0);
+}
+
+static inline Model_check model_check_regfile(const int samples) {
+    Model_check r = {"reg324file_step", 0, 0};
+    Reg324file_ g, b;
+    init_reg32file(&g);
+    init_reg32file(&b);
+    for (int k = 0; k < samples; k++) {
+        bit a1[2], a2[2], a3[2];
+        const uint32_t x = model_rng_();
+        for (int i = 0; i < 2; i++) {
+            a1[i] = (x >> i) & 1 ? BIT_1 : BIT_0;
+            a2[i] = (x >> (2 + i)) & 1 ? BIT_1 : BIT_0;
+            a3[i] = (x >> (4 + i)) & 1 ? BIT_1 : BIT_0;
+        }
+        Regfile_in in = {(x >> 6) & 1 ? BIT_1 : BIT_0, a1, a2, a3, {0}};
+        u32_to_word(model_rng_(), in.wd3);
+        // 大多数周期按 0 -> 1 走, 偶尔重复同一电平 (不应该产生边沿)
+        const bit clk = (k & 1) ^ ((x >> 7) % 8 == 0) ? BIT_1 : BIT_0;
+        word g1, g2, b1, b2;
+        reg324file_step_gate_(&g, &in, g1, g2, clk);
+        reg324file_step_beh_(&b, &in, b1, b2, clk);
+        const int same = memcmp(g1, b1, sizeof(word)) == 0 && memcmp(g2, b2, sizeof(word)) == 0
+                         && model_reg32_same_(&g.r0, &b.r0) && model_reg32_same_(&g.r1, &b.r1)
+                         && model_reg32_same_(&g.r2, &b.r2) && model_reg32_same_(&g.r3, &b.r3);
+        if (model_mismatch_(&r, same)) {
+            printf("[MODEL] reg324file_step step %d (ctrl=0x%02X clk=%d): gate rd=0x%08X/0x%08X beh rd=0x%08X/0x%08X\n",
+                   k, x & 0xFF, LANE_GET(clk, 0), u32_from_word(g1), u32_from_word(g2), u32_from_word(b1),
+                   u32_from_word(b2));
+        }
+        if (!same) b = g; // 从同一状态继续, 不让一次不一致连累后面所有步
+    }
+    return r;
+}
+
+static inline Model_check model_check_dff(const int samples) {
+    Model_check r = {"dff", 0, 0};
+    (void) samples;
+    for (int v = 0; v < 16; v++) {
+        bit gm = v & 1 ? BIT_1 : BIT_0, gq = v & 2 ? BIT_1 : BIT_0;
+        bit bm = gm, bq = gq;
+        const bit clk = v & 4 ? BIT_1 : BIT_0, d = v & 8 ? BIT_1 : BIT_0;
+        dff_bit_update_gate_(&gm, &gq, clk, d);
+        dff_bit_update_beh_(&bm, &bq, clk, d);
+        if (model_mismatch_(&r, LANE_GET(gm, 0) == LANE_GET(bm, 0) && LANE_GET(gq, 0) == LANE_GET(bq, 0))) {
+            printf("[MODEL] dff master=%d Q=%d clk=%d d=%d: gate=%d/%d beh=%d/%d\n", v & 1, (v >> 1) & 1,
+                   (v >> 2) & 1, (v >> 3) & 1, LANE_GET(gm, 0), LANE_GET(gq, 0), LANE_GET(bm, 0), LANE_GET(bq, 0));
+        }
+    }
+    return r;
+}
+
+static inline Model_check model_check_pc(const int samples) {
+    Model_check r = {"pc32_word_step", 0, 0};
+    Pc32_ g, b;
+    init_pc32(&g);
+    init_pc32(&b);
+    for (int k = 0; k < samples; k++) {
+        const uint32_t x = model_rng_();
+        // 偶尔把 PC 放到 0xFFFFFFFC 附近, 让 PC + 4 进位
+        if (x % 64 == 0) {
+            u32_to_word(0xFFFFFFF8u + (x >> 8 & 4), g.reg32.q);
+            memcpy(b.reg32.q, g.reg32.q, sizeof(word));
+        }
+        const bit reset = (x >> 8) % 16 == 0 ? BIT_1 : BIT_0;
+        const bit taken = (x >> 12) & 1 ? BIT_1 : BIT_0;
+        const bit clk = k & 1 ? BIT_1 : BIT_0;
+        word init, target, go, bo;
+        u32_to_word(model_rng_() & ~3u, init);
+        u32_to_word(model_rng_() & ~3u, target);
+        bit ovg = BIT_0, ovb = BIT_0;
+        pc32_word_step_gate_(&g, reset, init, taken, target, go, &ovg, clk);
+        pc32_word_step_beh_(&b, reset, init, taken, target, bo, &ovb, clk);
+        const int same = memcmp(go, bo, sizeof(word)) == 0 && LANE_GET(ovg, 0) == LANE_GET(ovb, 0)
+                         && model_reg32_same_(&g.reg32, &b.reg32);
+        if (model_mismatch_(&r, same)) {
+            printf("[MODEL] pc32_word_step step %d (reset=%d taken=%d clk=%d): gate=0x%08X/%d beh=0x%08X/%d\n", k,
+                   LANE_GET(reset, 0), LANE_GET(taken, 0), LANE_GET(clk, 0), u32_from_word(go), LANE_GET(ovg, 0),
+                   u32_from_word(bo), LANE_GET(ovb, 0));
+        }
+        if (!same) b = g;
+    }
+    return r;
+}
+
+static inline Model_check model_check_dm_read(const int samples) {
+    static Dm_ dm;
+    Model_check r = {"dm_read", 0, 0};
+    init_dm_(&dm);
+#if SCCPU_SHARED_IMAGES
+    static Dm_image img;
+    for (int i = 0; i < DEFAULT_SIZE; i++) img.memory[i] = (uint8_t) model_rng_();
+    dm_attach(&dm, &img);
+#else
+    for (int i = 0; i < DEFAULT_SIZE; i++) dm.memory[i] = (uint8_t) model_rng_();
+#endif
+    for (int k = 0; k < samples; k++) {
+        const uint32_t x = model_rng_();
+        uint32_t addr;
+        switch (k & 3) {
+            case 0: addr = x % DEFAULT_SIZE & ~3u; // 对齐, 在范围内
+                break;
+            case 1: addr = x % DEFAULT_SIZE; // 多半非对齐
+                break;
+            case 2: addr = DEFAULT_SIZE + (x % 64) * 4; // 刚好越界
+                break;
+            default: addr = x;
+                break;
+        }
+        word a, rg, rb;
+        u32_to_word(addr, a);
+        const bit eg = dm_read_gate_(&dm, a, rg), eb = dm_read(&dm, a, rb);
+        const uint32_t g = u32_from_word(rg), b = u32_from_word(rb);
+        if (model_mismatch_(&r, g == b && LANE_GET(eg, 0) == LANE_GET(eb, 0))) {
+            printf("[MODEL] dm_read addr=0x%08X: gate=0x%08X/%d beh=0x%08X/%d\n", addr, g, LANE_GET(eg, 0), b,
+                   LANE_GET(eb, 0));
+        }
+    }
+    return r;
+}
+
+// 所有模块对拍一遍, 打印每个模块的用例数和不一致数; 返回不一致总数
+static inline uint64_t model_check_all(const int samples) {
+    const Model_check results[] = {
+        model_check_alu(samples),
+        model_check_decode(samples),
+        model_check_regfile(samples),
+        model_check_dff(samples),
+        model_check_pc(samples),
+        model_check_dm_read(samples / 8), // 门级读口每次都要走完整棵 1024 路选择树
+    };
+    uint64_t total = 0;
+    printf("[Models] gate vs behavioral equivalence:\n");
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+        printf("         %-16s %8lu cases %6lu mismatches\n", results[i].module, results[i].cases,
+               results[i].mismatches);
+        total += results[i].mismatches;
+    }
+    return total;
+}
+
+#endif //SCCPU_MODELS_H
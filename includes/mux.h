@@ -15,8 +15,19 @@ static inline void byte_mux_2_1(const byte input0, const byte input1, const bit
 }
 
 // sel 1  -> input1  else input0
+#if SCCPU_PACKED_WORD
+static inline void word_mux_2_1(const word input0, const word input1, const bit sel, word output) {
+    word sel_w, nsel_w, a, b;
+    word_fanout_(sel, sel_w);
+    word_not_(sel_w, nsel_w);
+    word_and_(nsel_w, input0, a);
+    word_and_(sel_w, input1, b);
+    word_or_(a, b, output);
+}
+#else
 static inline void word_mux_2_1(const word input0, const word input1, const bit sel, word output) {
     for (int i = 0; i < WORD_SIZE; i++) output[i] = mux2_1(input0[i], input1[i], sel);
 }
+#endif
 
 #endif //SCCPU_MUX__H
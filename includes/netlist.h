@@ -0,0 +1,574 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_NETLIST_H
+#define SCCPU_NETLIST_H
+#include "stdint.h"
+#include "stdio.h"
+#include "string.h"
+#include "common.h"
+
+/**
+ * 门级网表 (SCCPU_NETLIST = 1 时由 gate.h 的 NOT/AND/OR 记录)
+ *
+ * 捕获模式下 bit 就是节点编号: 门电路代码一行不改, 每调用一次 NOT/AND/OR 就往网表里追加一个门
+ * 节点 0 / 1 固定是常量 0 / 1 (与 BIT_0 / BIT_1 相同), 所以 u32_to_word / WORD_ZERO 这类常量自然变成常量节点
+ *
+ *  NL_INPUT  : 模块的原始输入 (只在单独捕获某个模块时使用)
+ *  NL_DFF    : 触发器, a = D 端, b = 初值; 节点本身就是 Q
+ *  NL_MEM_RD : 存储器读端口的一根输出线, a = 端口号, b = 存储下标 (word[0] = MSB)
+ *  NL_NOT / NL_AND / NL_OR : 2 输入门 (NOT 只用 a)
+ *
+ * 捕获时门按调用顺序追加, 门的输入一定是已有的节点, 所以节点编号本身就是一个拓扑序
+ * (DFF 的 D 端是唯一的回边). 各个 pass 结束时都会重新编号, 保持这个性质
+ */
+#define NL_MAX_NODES (1u << 18)
+#define NL_MAX_PORTS 16
+#define NL_MAX_NAMES 2048
+#define NL_MAX_LEVELS 4096
+#define NL_NONE 0xFFFFFFFFu
+
+enum { NL_CONST0, NL_CONST1, NL_INPUT, NL_DFF, NL_MEM_RD, NL_NOT, NL_AND, NL_OR, NL_OP_NUM };
+
+enum { NL_MEM_IM, NL_MEM_DM };
+
+typedef struct nl_node {
+    uint8_t op;
+    uint32_t a;
+    uint32_t b;
+} Nl_node;
+
+// IM / DM 是黑盒, 在网表里只留下端口
+// 读端口: addr 是输入, data 是 NL_MEM_RD 输出节点; 写端口: addr / data / we / be 都是输入, 在时钟沿提交
+typedef struct nl_port {
+    uint8_t mem;
+    uint8_t write;
+    uint32_t addr[WORD_SIZE];
+    uint32_t data[WORD_SIZE];
+    uint32_t we;
+    uint32_t be[4];
+} Nl_port;
+
+// 命名导线: 寄存器的每个 DFF / 对外可见的组合导线
+// index 是在原数组中的存储下标 (q[0] 是最高位), width 是原数组的宽度
+// root = 1 的名字是可观测输出, 死门删除时从它们出发
+typedef struct nl_name {
+    const char *name;
+    uint16_t index;
+    uint16_t width;
+    uint8_t root;
+    uint32_t node;
+} Nl_name;
+
+typedef struct netlist {
+    uint32_t n_nodes;
+    Nl_node nodes[NL_MAX_NODES];
+    uint32_t n_ports;
+    Nl_port ports[NL_MAX_PORTS];
+    uint32_t n_names;
+    Nl_name names[NL_MAX_NAMES];
+    // nl_levelize 之后有效: 第 l 层的节点编号是 [level_start[l], level_start[l + 1])
+    uint32_t n_levels;
+    uint32_t level_start[NL_MAX_LEVELS + 1];
+    int overflow;
+} Netlist;
+
+// 捕获目标: gate.h 的门只有一个全局网表可写
+static Netlist netlist_;
+
+static inline void nl_reset(Netlist *nl) {
+    nl->n_nodes = 2;
+    nl->nodes[0] = (Nl_node){NL_CONST0, 0, 0};
+    nl->nodes[1] = (Nl_node){NL_CONST1, 0, 0};
+    nl->n_ports = 0;
+    nl->n_names = 0;
+    nl->n_levels = 0;
+    nl->overflow = 0;
+}
+
+static inline uint32_t nl_add_(Netlist *nl, const uint8_t op, const uint32_t a, const uint32_t b) {
+    if (nl->n_nodes >= NL_MAX_NODES) {
+        nl->overflow = 1;
+        return 0;
+    }
+    nl->nodes[nl->n_nodes] = (Nl_node){op, a, b};
+    return nl->n_nodes++;
+}
+
+/*********************************************Capture***************************************************************/
+// 不做任何化简, 原样记录; 化简交给后面的 pass
+
+static inline uint32_t nl_gate_(const uint8_t op, const uint32_t a, const uint32_t b) {
+    return nl_add_(&netlist_, op, a, b);
+}
+
+static inline uint32_t nl_input_(void) {
+    return nl_add_(&netlist_, NL_INPUT, 0, 0);
+}
+
+static inline uint32_t nl_dff_(const uint32_t init) {
+    return nl_add_(&netlist_, NL_DFF, 0, init);
+}
+
+static inline void nl_dff_connect_(const uint32_t dff, const uint32_t d) {
+    netlist_.nodes[dff].a = d;
+}
+
+static inline void nl_name_(const uint32_t node, const char *name, const int index, const int width, const int root) {
+    if (netlist_.n_names >= NL_MAX_NAMES) {
+        netlist_.overflow = 1;
+        return;
+    }
+    netlist_.names[netlist_.n_names++] = (Nl_name){name, (uint16_t) index, (uint16_t) width, (uint8_t) root, node};
+}
+
+static inline Nl_port *nl_port_(const int mem, const int write) {
+    if (netlist_.n_ports >= NL_MAX_PORTS) {
+        netlist_.overflow = 1;
+        return NULL;
+    }
+    Nl_port *p = &netlist_.ports[netlist_.n_ports++];
+    memset(p, 0, sizeof(Nl_port));
+    p->mem = (uint8_t) mem;
+    p->write = (uint8_t) write;
+    return p;
+}
+
+static inline void nl_mem_read_(const int mem, const uint32_t addr[WORD_SIZE], uint32_t data[WORD_SIZE]) {
+    Nl_port *p = nl_port_(mem, 0);
+    if (p == NULL) return;
+    const uint32_t port = netlist_.n_ports - 1;
+    for (int i = 0; i < WORD_SIZE; i++) {
+        p->addr[i] = addr[i];
+        p->data[i] = data[i] = nl_add_(&netlist_, NL_MEM_RD, port, (uint32_t) i);
+    }
+}
+
+static inline void nl_mem_write_(const int mem, const uint32_t addr[WORD_SIZE], const uint32_t data[WORD_SIZE],
+                                 const uint32_t be[4], const uint32_t we) {
+    Nl_port *p = nl_port_(mem, 1);
+    if (p == NULL) return;
+    memcpy(p->addr, addr, sizeof(p->addr));
+    memcpy(p->data, data, sizeof(p->data));
+    memcpy(p->be, be, sizeof(p->be));
+    p->we = we;
+}
+
+/*********************************************Passes***************************************************************/
+
+static uint32_t nl_map_[NL_MAX_NODES];
+static uint32_t nl_work_[NL_MAX_NODES];
+static uint8_t nl_live_[NL_MAX_NODES];
+
+static inline int nl_is_gate_(const uint8_t op) {
+    return op == NL_NOT || op == NL_AND || op == NL_OR;
+}
+
+// 按 order (旧编号, 新的顺序) 重新编号, 不在 order 里的节点被删掉
+// order 必须以常量 0 / 1 开头, 并保持门的输入在门之前
+static inline void nl_renumber_(Netlist *nl, const uint32_t *order, const uint32_t n) {
+    static Nl_node tmp[NL_MAX_NODES];
+    for (uint32_t i = 0; i < nl->n_nodes; i++) nl_map_[i] = NL_NONE;
+    for (uint32_t i = 0; i < n; i++) nl_map_[order[i]] = i;
+    for (uint32_t i = 0; i < n; i++) {
+        Nl_node x = nl->nodes[order[i]];
+        if (nl_is_gate_(x.op) || x.op == NL_DFF) x.a = nl_map_[x.a];
+        if (x.op == NL_AND || x.op == NL_OR) x.b = nl_map_[x.b];
+        tmp[i] = x;
+    }
+    memcpy(nl->nodes, tmp, n * sizeof(Nl_node));
+    nl->n_nodes = n;
+
+    // 端口: 读端口的输出全被删掉就删掉整个端口
+    uint32_t port_map[NL_MAX_PORTS], np = 0;
+    for (uint32_t p = 0; p < nl->n_ports; p++) {
+        Nl_port *port = &nl->ports[p];
+        int keep = port->write;
+        for (int i = 0; i < WORD_SIZE; i++) {
+            if (!port->write) {
+                port->data[i] = port->data[i] == NL_NONE ? NL_NONE : nl_map_[port->data[i]];
+                keep |= port->data[i] != NL_NONE;
+            }
+        }
+        if (port->write && (port->we == NL_NONE || nl_map_[port->we] == NL_NONE)) keep = 0;
+        port_map[p] = NL_NONE;
+        if (!keep) continue;
+        for (int i = 0; i < WORD_SIZE; i++) {
+            port->addr[i] = nl_map_[port->addr[i]];
+            if (port->write) port->data[i] = nl_map_[port->data[i]];
+        }
+        if (port->write) {
+            port->we = nl_map_[port->we];
+            for (int i = 0; i < 4; i++) port->be[i] = nl_map_[port->be[i]];
+        }
+        port_map[p] = np;
+        nl->ports[np++] = *port;
+    }
+    nl->n_ports = np;
+    for (uint32_t i = 0; i < n; i++) {
+        if (nl->nodes[i].op == NL_MEM_RD) nl->nodes[i].a = port_map[nl->nodes[i].a];
+    }
+
+    // 名字: 节点被删掉的名字一起删掉
+    uint32_t nn = 0;
+    for (uint32_t i = 0; i < nl->n_names; i++) {
+        Nl_name x = nl->names[i];
+        x.node = nl_map_[x.node];
+        if (x.node != NL_NONE) nl->names[nn++] = x;
+    }
+    nl->n_names = nn;
+    nl->n_levels = 0;
+}
+
+static inline uint32_t nl_find_(uint32_t n) {
+    while (nl_work_[n] != n) n = nl_work_[n] = nl_work_[nl_work_[n]];
+    return n;
+}
+
+// 把所有引用替换成 nl_work_ 中的代表节点, 然后删掉被替换的节点
+static inline void nl_apply_replace_(Netlist *nl) {
+    static uint32_t order[NL_MAX_NODES];
+    for (uint32_t i = 0; i < nl->n_nodes; i++) {
+        Nl_node *x = &nl->nodes[i];
+        if (nl_is_gate_(x->op) || x->op == NL_DFF) x->a = nl_find_(x->a);
+        if (x->op == NL_AND || x->op == NL_OR) x->b = nl_find_(x->b);
+    }
+    for (uint32_t p = 0; p < nl->n_ports; p++) {
+        Nl_port *port = &nl->ports[p];
+        for (int i = 0; i < WORD_SIZE; i++) {
+            port->addr[i] = nl_find_(port->addr[i]);
+            if (port->write) port->data[i] = nl_find_(port->data[i]);
+        }
+        if (port->write) {
+            port->we = nl_find_(port->we);
+            for (int i = 0; i < 4; i++) port->be[i] = nl_find_(port->be[i]);
+        }
+    }
+    for (uint32_t i = 0; i < nl->n_names; i++) nl->names[i].node = nl_find_(nl->names[i].node);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < nl->n_nodes; i++) {
+        if (nl_work_[i] == i) order[n++] = i;
+    }
+    nl_renumber_(nl, order, n);
+}
+
+static inline int nl_is_not_of_(const Netlist *nl, const uint32_t x, const uint32_t y) {
+    return nl->nodes[x].op == NL_NOT && nl->nodes[x].a == y;
+}
+
+/**
+ * 常量传播: 门的输入是常量 / 相同 / 互补时直接化简, 并把 "D 端就是自己或者等于初值常量" 的 DFF 换成常量
+ * (这类寄存器永远不会被写, 比如从没被选中的控制位)
+ * 返回被删掉的节点数
+ */
+static inline int nl_const_prop(Netlist *nl) {
+    const uint32_t before = nl->n_nodes;
+    for (uint32_t i = 0; i < nl->n_nodes; i++) nl_work_[i] = i;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (uint32_t i = 2; i < nl->n_nodes; i++) {
+            if (nl_work_[i] != i) continue;
+            Nl_node *x = &nl->nodes[i];
+            if (!nl_is_gate_(x->op)) continue;
+            const uint32_t a = nl_find_(x->a);
+            const uint32_t b = x->op == NL_NOT ? 0 : nl_find_(x->b);
+            x->a = a;
+            if (x->op != NL_NOT) x->b = b;
+            uint32_t r = i;
+            if (x->op == NL_NOT) {
+                if (a <= 1) r = a ^ 1u;
+                else if (nl->nodes[a].op == NL_NOT) r = nl_find_(nl->nodes[a].a);
+            } else if (x->op == NL_AND) {
+                if (a == 0 || b == 0) r = 0;
+                else if (a == 1) r = b;
+                else if (b == 1 || a == b) r = a;
+                else if (nl_is_not_of_(nl, a, b) || nl_is_not_of_(nl, b, a)) r = 0;
+            } else {
+                if (a == 1 || b == 1) r = 1;
+                else if (a == 0) r = b;
+                else if (b == 0 || a == b) r = a;
+                else if (nl_is_not_of_(nl, a, b) || nl_is_not_of_(nl, b, a)) r = 1;
+            }
+            if (r != i) {
+                nl_work_[i] = r;
+                changed = 1;
+            }
+        }
+        for (uint32_t i = 2; i < nl->n_nodes; i++) {
+            const Nl_node *x = &nl->nodes[i];
+            if (x->op != NL_DFF || nl_work_[i] != i) continue;
+            const uint32_t d = nl_find_(x->a);
+            if (d == i || d == x->b) {
+                nl_work_[i] = x->b;
+                changed = 1;
+            }
+        }
+    }
+    nl_apply_replace_(nl);
+    return (int) (before - nl->n_nodes);
+}
+
+/**
+ * 公共子表达式合并: (op, a, b) 相同的门只留一个 (AND/OR 的两个输入不分顺序)
+ * 节点编号是拓扑序, 一次正向扫描就够了
+ */
+static inline int nl_cse(Netlist *nl) {
+    static uint32_t table[NL_MAX_NODES * 2];
+    const uint32_t mask = NL_MAX_NODES * 2 - 1;
+    const uint32_t before = nl->n_nodes;
+    for (uint32_t i = 0; i <= mask; i++) table[i] = NL_NONE;
+    for (uint32_t i = 0; i < nl->n_nodes; i++) nl_work_[i] = i;
+    for (uint32_t i = 2; i < nl->n_nodes; i++) {
+        Nl_node *x = &nl->nodes[i];
+        if (!nl_is_gate_(x->op)) continue;
+        x->a = nl_find_(x->a);
+        if (x->op != NL_NOT) {
+            x->b = nl_find_(x->b);
+            if (x->a > x->b) {
+                const uint32_t t = x->a;
+                x->a = x->b;
+                x->b = t;
+            }
+        }
+        uint32_t h = (x->a * 0x9E3779B1u) ^ (x->b * 0x85EBCA77u) ^ x->op;
+        for (h &= mask;; h = (h + 1) & mask) {
+            const uint32_t e = table[h];
+            if (e == NL_NONE) {
+                table[h] = i;
+                break;
+            }
+            const Nl_node *y = &nl->nodes[e];
+            if (y->op == x->op && y->a == x->a && (x->op == NL_NOT || y->b == x->b)) {
+                nl_work_[i] = e;
+                break;
+            }
+        }
+    }
+    nl_apply_replace_(nl);
+    return (int) (before - nl->n_nodes);
+}
+
+/**
+ * 死门删除: 从可观测输出反向标记
+ * 输出 = 写端口 + root 名字 (keep_named = 1 时所有名字都算, 用于需要完整流水线寄存器状态的场合)
+ * 原始输入是模块的接口, 即使没人读也保留 (各 pass 之后输入依然是紧跟常量的 2, 3, ... 号节点)
+ */
+static inline int nl_dce(Netlist *nl, const int keep_named) {
+    static uint32_t order[NL_MAX_NODES];
+    const uint32_t before = nl->n_nodes;
+    uint32_t top = 0;
+    memset(nl_live_, 0, nl->n_nodes);
+    uint8_t port_live[NL_MAX_PORTS] = {0};
+#define NL_MARK_(n) do { const uint32_t n__ = (n); if (!nl_live_[n__]) { nl_live_[n__] = 1; nl_work_[top++] = n__; } } while (0)
+    NL_MARK_(0);
+    NL_MARK_(1);
+    for (uint32_t i = 2; i < nl->n_nodes; i++) {
+        if (nl->nodes[i].op == NL_INPUT) NL_MARK_(i);
+    }
+    for (uint32_t i = 0; i < nl->n_names; i++) {
+        if (keep_named || nl->names[i].root) NL_MARK_(nl->names[i].node);
+    }
+    for (uint32_t p = 0; p < nl->n_ports; p++) {
+        const Nl_port *port = &nl->ports[p];
+        if (!port->write || port->we == 0) continue;
+        port_live[p] = 1;
+        for (int i = 0; i < WORD_SIZE; i++) {
+            NL_MARK_(port->addr[i]);
+            NL_MARK_(port->data[i]);
+        }
+        NL_MARK_(port->we);
+        for (int i = 0; i < 4; i++) NL_MARK_(port->be[i]);
+    }
+    while (top > 0) {
+        const Nl_node *x = &nl->nodes[nl_work_[--top]];
+        if (nl_is_gate_(x->op) || x->op == NL_DFF) NL_MARK_(x->a);
+        if (x->op == NL_AND || x->op == NL_OR) NL_MARK_(x->b);
+        if (x->op == NL_MEM_RD && !port_live[x->a]) {
+            port_live[x->a] = 1;
+            for (int i = 0; i < WORD_SIZE; i++) NL_MARK_(nl->ports[x->a].addr[i]);
+        }
+    }
+#undef NL_MARK_
+    // 不可观测的写端口 (we 恒为 0) 一起删掉
+    for (uint32_t p = 0; p < nl->n_ports; p++) {
+        if (nl->ports[p].write && !port_live[p]) nl->ports[p].we = NL_NONE;
+    }
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < nl->n_nodes; i++) {
+        if (nl_live_[i]) order[n++] = i;
+    }
+    nl_renumber_(nl, order, n);
+    return (int) (before - nl->n_nodes);
+}
+
+/**
+ * 分层: 常量 / 输入 / DFF 在第 0 层, 门在所有输入的下一层, 读端口在地址的下一层
+ * 按层重新编号, 同一层的节点互不依赖 (可以按任意顺序 / 并行求值)
+ */
+static inline void nl_levelize(Netlist *nl) {
+    static uint32_t order[NL_MAX_NODES];
+    static uint16_t level[NL_MAX_NODES];
+    uint16_t port_level[NL_MAX_PORTS] = {0};
+    uint8_t port_done[NL_MAX_PORTS] = {0};
+    uint32_t count[NL_MAX_LEVELS + 1] = {0};
+    uint32_t max_level = 0;
+    for (uint32_t i = 0; i < nl->n_nodes; i++) {
+        const Nl_node *x = &nl->nodes[i];
+        uint32_t l = 0;
+        if (x->op == NL_NOT) l = level[x->a] + 1u;
+        else if (x->op == NL_AND || x->op == NL_OR) l = (level[x->a] > level[x->b] ? level[x->a] : level[x->b]) + 1u;
+        else if (x->op == NL_MEM_RD) {
+            if (!port_done[x->a]) {
+                uint32_t m = 0;
+                for (int k = 0; k < WORD_SIZE; k++) {
+                    if (level[nl->ports[x->a].addr[k]] > m) m = level[nl->ports[x->a].addr[k]];
+                }
+                port_level[x->a] = (uint16_t) (m + 1u);
+                port_done[x->a] = 1;
+            }
+            l = port_level[x->a];
+        }
+        if (l >= NL_MAX_LEVELS) {
+            nl->overflow = 1;
+            l = NL_MAX_LEVELS - 1;
+        }
+        level[i] = (uint16_t) l;
+        count[l]++;
+        if (l > max_level) max_level = l;
+    }
+    uint32_t start[NL_MAX_LEVELS + 1];
+    start[0] = 0;
+    for (uint32_t l = 0; l <= max_level; l++) start[l + 1] = start[l] + count[l];
+    memcpy(nl->level_start, start, (max_level + 2) * sizeof(uint32_t));
+    // 计数排序 (稳定): 第 0 层仍然以常量 0 / 1 开头
+    for (uint32_t i = 0; i < nl->n_nodes; i++) order[start[level[i]]++] = i;
+    nl_renumber_(nl, order, nl->n_nodes);
+    nl->n_levels = max_level + 1;
+}
+
+// 依次跑 常量传播 -> 公共子表达式 -> 死门删除, 直到不再变化, 最后分层
+static inline void nl_optimize(Netlist *nl, const int keep_named) {
+    int removed = 1;
+    while (removed > 0) {
+        removed = nl_const_prop(nl);
+        removed += nl_cse(nl);
+        removed += nl_dce(nl, keep_named);
+    }
+    nl_levelize(nl);
+}
+
+/*********************************************Stats***************************************************************/
+
+typedef struct nl_stats {
+    uint32_t nodes;
+    uint32_t ops[NL_OP_NUM];
+    uint32_t gates; // NOT + AND + OR
+    uint32_t ports;
+    uint32_t levels; // nl_levelize 之后有效
+    uint32_t max_width; // 最宽一层的门数
+} Nl_stats;
+
+static inline Nl_stats nl_stats(const Netlist *nl) {
+    Nl_stats s;
+    memset(&s, 0, sizeof(s));
+    s.nodes = nl->n_nodes;
+    for (uint32_t i = 0; i < nl->n_nodes; i++) s.ops[nl->nodes[i].op]++;
+    s.gates = s.ops[NL_NOT] + s.ops[NL_AND] + s.ops[NL_OR];
+    s.ports = nl->n_ports;
+    s.levels = nl->n_levels;
+    for (uint32_t l = 1; l < nl->n_levels; l++) {
+        const uint32_t w = nl->level_start[l + 1] - nl->level_start[l];
+        if (w > s.max_width) s.max_width = w;
+    }
+    return s;
+}
+
+static inline void nl_print_stats(const char *title, const Netlist *nl) {
+    const Nl_stats s = nl_stats(nl);
+    printf("%-28s gates:%7u (NOT %6u AND %6u OR %6u) dff:%4u ports:%2u", title, s.gates, s.ops[NL_NOT],
+           s.ops[NL_AND], s.ops[NL_OR], s.ops[NL_DFF], s.ports);
+    if (s.levels) printf(" levels:%4u max-width:%5u", s.levels, s.max_width);
+    printf("\n");
+}
+
+/*********************************************Eval***************************************************************/
+// 参考求值器: 每个节点一个字节 (0 / 1), 按编号顺序求值; 存储器由调用方通过回调提供
+
+typedef uint32_t (*nl_mem_read_fn)(void *ctx, int mem, uint32_t addr);
+
+typedef void (*nl_mem_write_fn)(void *ctx, int mem, uint32_t addr, uint32_t data, const uint8_t be[4]);
+
+static inline uint32_t nl_word_value_(const uint8_t *val, const uint32_t nodes[WORD_SIZE]) {
+    uint32_t v = 0;
+    for (int i = 0; i < WORD_SIZE; i++) v = v << 1 | val[nodes[i]];
+    return v;
+}
+
+// 组合逻辑: DFF / 输入保持 val 中已有的值
+static inline void nl_eval(const Netlist *nl, uint8_t *val, const nl_mem_read_fn rd, void *ctx) {
+    uint32_t port_val[NL_MAX_PORTS];
+    uint8_t port_done[NL_MAX_PORTS] = {0};
+    val[0] = 0;
+    val[1] = 1;
+    for (uint32_t i = 2; i < nl->n_nodes; i++) {
+        const Nl_node *x = &nl->nodes[i];
+        switch (x->op) {
+            case NL_NOT: val[i] = val[x->a] ^ 1u;
+                break;
+            case NL_AND: val[i] = val[x->a] & val[x->b];
+                break;
+            case NL_OR: val[i] = val[x->a] | val[x->b];
+                break;
+            case NL_MEM_RD:
+                if (!port_done[x->a]) {
+                    const Nl_port *p = &nl->ports[x->a];
+                    port_val[x->a] = rd ? rd(ctx, p->mem, nl_word_value_(val, p->addr)) : 0;
+                    port_done[x->a] = 1;
+                }
+                val[i] = (uint8_t) ((port_val[x->a] >> (WORD_SIZE - 1 - x->b)) & 1u);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// 时钟沿: 所有 DFF 同时采样 D, 写端口按捕获顺序提交
+static inline void nl_commit(const Netlist *nl, uint8_t *val, const nl_mem_write_fn wr, void *ctx) {
+    static uint8_t next[NL_MAX_NODES];
+    for (uint32_t i = 2; i < nl->n_nodes; i++) {
+        if (nl->nodes[i].op == NL_DFF) next[i] = val[nl->nodes[i].a];
+    }
+    for (uint32_t p = 0; p < nl->n_ports; p++) {
+        const Nl_port *port = &nl->ports[p];
+        if (!port->write || !val[port->we] || wr == NULL) continue;
+        const uint8_t be[4] = {val[port->be[0]], val[port->be[1]], val[port->be[2]], val[port->be[3]]};
+        wr(ctx, port->mem, nl_word_value_(val, port->addr), nl_word_value_(val, port->data), be);
+    }
+    for (uint32_t i = 2; i < nl->n_nodes; i++) {
+        if (nl->nodes[i].op == NL_DFF) val[i] = next[i];
+    }
+}
+
+// DFF 回到初值
+static inline void nl_reset_state(const Netlist *nl, uint8_t *val) {
+    memset(val, 0, nl->n_nodes);
+    val[1] = 1;
+    for (uint32_t i = 2; i < nl->n_nodes; i++) {
+        if (nl->nodes[i].op == NL_DFF) val[i] = (uint8_t) nl->nodes[i].b;
+    }
+}
+
+// 按名字读出一个寄存器 / 导线 (q[0] 是最高位); 找不到返回 0
+static inline uint32_t nl_read_named(const Netlist *nl, const uint8_t *val, const char *name) {
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < nl->n_names; i++) {
+        const Nl_name *x = &nl->names[i];
+        if (strcmp(x->name, name) == 0) v |= (uint32_t) val[x->node] << (x->width - 1 - x->index);
+    }
+    return v;
+}
+
+#endif //SCCPU_NETLIST_H
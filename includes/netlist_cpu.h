@@ -0,0 +1,224 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_NETLIST_CPU_H
+#define SCCPU_NETLIST_CPU_H
+#include "cpu_core.h"
+
+// 流水线寄存器 / regfile / PC 的 q 数组 (偏移按当前模式的 bit 计算, 网表捕获、编译仿真、checkpoint 和 VCD 共用这张表)
+typedef struct nl_cpu_reg {
+    const char *name;
+    size_t q; // Cpu_core 中 q 数组的偏移
+    size_t master; // master_q 数组的偏移
+    size_t prev_clk;
+    int width; // WORD_SIZE -> Reg32_ (q 是 word), 否则 RegN_ (q 是 bit[N])
+    int root; // 架构状态 (PC / regfile)
+    int stage; // 写这个寄存器的阶段 (STAGE_*): PC 归 IF, regfile 归 WB
+} Nl_cpu_reg;
+
+#define NL_CPU_REG_(field, width, root, stage) \
+    {#field, offsetof(Cpu_core, field.q), offsetof(Cpu_core, field.master_q), offsetof(Cpu_core, field.prev_clk), \
+     (width), (root), (stage)}
+
+static const Nl_cpu_reg NL_CPU_REGS_[] = {
+    NL_CPU_REG_(pc.reg32, WORD_SIZE, 1, STAGE_IF),
+    NL_CPU_REG_(if_id.instr, WORD_SIZE, 0, STAGE_IF),
+    NL_CPU_REG_(if_id.pc_plus4, WORD_SIZE, 0, STAGE_IF),
+    NL_CPU_REG_(id_ex.decode_signals, 11, 0, STAGE_ID),
+    NL_CPU_REG_(id_ex.read_data1, WORD_SIZE, 0, STAGE_ID),
+    NL_CPU_REG_(id_ex.read_data2, WORD_SIZE, 0, STAGE_ID),
+    NL_CPU_REG_(id_ex.imm_ext, WORD_SIZE, 0, STAGE_ID),
+    NL_CPU_REG_(id_ex.rs_idx, 2, 0, STAGE_ID),
+    NL_CPU_REG_(id_ex.rt_idx, 2, 0, STAGE_ID),
+    NL_CPU_REG_(id_ex.rd_idx, 2, 0, STAGE_ID),
+    NL_CPU_REG_(id_ex.pc_plus4, WORD_SIZE, 0, STAGE_ID),
+    NL_CPU_REG_(ex_mem.mem_single, 2, 0, STAGE_EX),
+    NL_CPU_REG_(ex_mem.wb_single, 2, 0, STAGE_EX),
+    NL_CPU_REG_(ex_mem.alu_result, WORD_SIZE, 0, STAGE_EX),
+    NL_CPU_REG_(ex_mem.write_data, WORD_SIZE, 0, STAGE_EX),
+    NL_CPU_REG_(ex_mem.write_reg_idx, 2, 0, STAGE_EX),
+    NL_CPU_REG_(mem_wb.wb_single, 2, 0, STAGE_MEM),
+    NL_CPU_REG_(mem_wb.mem_read_data, WORD_SIZE, 0, STAGE_MEM),
+    NL_CPU_REG_(mem_wb.alu_result, WORD_SIZE, 0, STAGE_MEM),
+    NL_CPU_REG_(mem_wb.write_reg_idx, 2, 0, STAGE_MEM),
+    NL_CPU_REG_(rf.r0, WORD_SIZE, 1, STAGE_WB),
+    NL_CPU_REG_(rf.r1, WORD_SIZE, 1, STAGE_WB),
+    NL_CPU_REG_(rf.r2, WORD_SIZE, 1, STAGE_WB),
+    NL_CPU_REG_(rf.r3, WORD_SIZE, 1, STAGE_WB),
+};
+
+#define NL_CPU_REG_NUM ((int) (sizeof(NL_CPU_REGS_) / sizeof(NL_CPU_REGS_[0])))
+
+static inline bit *nl_cpu_q_(Cpu_core *c, const Nl_cpu_reg *r) {
+    return (bit *) ((char *) c + r->q);
+}
+
+// Cpu_core 里的 wire_* (每个周期重算的组合逻辑输出), checkpoint 和 VCD 共用这张表
+typedef struct nl_cpu_wire {
+    const char *name;
+    size_t off;
+    int width; // WORD_SIZE -> word, 否则 bit[width]
+} Nl_cpu_wire;
+
+#define NL_CPU_WIRE_(field, width) {#field, offsetof(Cpu_core, field), (width)}
+
+static const Nl_cpu_wire NL_CPU_WIRES_[] = {
+    NL_CPU_WIRE_(wire_pc_src, 2),
+    NL_CPU_WIRE_(wire_branch_target, WORD_SIZE),
+    NL_CPU_WIRE_(wire_if_id_ctrl.pc_write, 1),
+    NL_CPU_WIRE_(wire_if_id_ctrl.if_id_write, 1),
+    NL_CPU_WIRE_(wire_if_id_ctrl.if_id_flush, 1),
+    NL_CPU_WIRE_(wire_id_ex_ctrl.id_ex_write, 1),
+    NL_CPU_WIRE_(wire_id_ex_ctrl.id_ex_flush, 1),
+    NL_CPU_WIRE_(wire_wb.we, 4),
+    NL_CPU_WIRE_(wire_wb.wdata, WORD_SIZE),
+    NL_CPU_WIRE_(wire_mem.mem_writer, 1),
+    NL_CPU_WIRE_(wire_mem.alu_result, WORD_SIZE),
+    NL_CPU_WIRE_(wire_mem.write_data, WORD_SIZE),
+    NL_CPU_WIRE_(wire_mem.read_ret, WORD_SIZE),
+    NL_CPU_WIRE_(wire_mem.wb_single, 2),
+    NL_CPU_WIRE_(wire_mem.write_reg_idx, 2),
+    NL_CPU_WIRE_(wire_ex.mem_single, 2),
+    NL_CPU_WIRE_(wire_ex.wb_single, 2),
+    NL_CPU_WIRE_(wire_ex.alu_result, WORD_SIZE),
+    NL_CPU_WIRE_(wire_ex.write_data, WORD_SIZE),
+    NL_CPU_WIRE_(wire_ex.write_reg_idx, 2),
+    NL_CPU_WIRE_(wire_id.load, 1),
+    NL_CPU_WIRE_(wire_id.decode_signals, 11),
+    NL_CPU_WIRE_(wire_id.read_data1, WORD_SIZE),
+    NL_CPU_WIRE_(wire_id.read_data2, WORD_SIZE),
+    NL_CPU_WIRE_(wire_id.imm_ext, WORD_SIZE),
+    NL_CPU_WIRE_(wire_id.rs_idx, 2),
+    NL_CPU_WIRE_(wire_id.rt_idx, 2),
+    NL_CPU_WIRE_(wire_id.rd_idx, 2),
+    NL_CPU_WIRE_(wire_id.pc_plus4, WORD_SIZE),
+    NL_CPU_WIRE_(wire_if.pc_load, 1),
+    NL_CPU_WIRE_(wire_if.pc_next, WORD_SIZE),
+    NL_CPU_WIRE_(wire_if.if_id_load, 1),
+    NL_CPU_WIRE_(wire_if.instr, WORD_SIZE),
+    NL_CPU_WIRE_(wire_if.pc_plus4, WORD_SIZE),
+};
+
+#define NL_CPU_WIRE_NUM ((int) (sizeof(NL_CPU_WIRES_) / sizeof(NL_CPU_WIRES_[0])))
+// 前 7 项 (wire_pc_src / wire_branch_target / 冒险控制) 每种周期模式都写回 Cpu_core;
+// 后面各阶段的 wire_* 只有单次求值 / 活动性 / 阶段并行写, cpu_cycle_two_pass 用的是局部导线
+#define NL_CPU_GLUE_WIRE_NUM 7
+
+// 按上面两张表的宽度读一个字段: width == WORD_SIZE 是 word, 其余是 bit 数组 (下标 0 是最高位)
+static inline uint32_t nl_cpu_field_get_(const void *f, const int width) {
+    if (width == WORD_SIZE) return u32_from_word(f);
+    const bit *b = f;
+    uint32_t v = 0;
+    for (int i = 0; i < width; i++) v = v << 1 | (uint32_t) LANE_GET(b[i], 0);
+    return v;
+}
+
+#if SCCPU_NETLIST
+/**
+ * 把整个 CPU 捕获成一张网表
+ *
+ * 1. 所有流水线寄存器 / regfile / PC 的每个 Q 换成一个新的 DFF 节点
+ * 2. 原样跑一个周期 (cycle 可以是 cpu_cycle_two_pass 或 cpu_cycle_single_eval): 每个阶段的门都被记录下来
+ *    clk 是常量, 跑完之后每个寄存器的 q 正好是 "这个周期结束时 Q 的表达式", 也就是 DFF 的 D 端
+ * 3. 把 D 端接回 DFF
+ *
+ * 捕获出来的网表是原样的: clk 相关的选择器 / two-pass 的第二遍求值都在里面, 交给 nl_optimize 去掉
+ */
+static inline void nl_capture_cpu(void (*cycle)(Cpu_core *)) {
+    static Cpu_core c, before;
+    nl_reset(&netlist_);
+    init_cpu_c(&c);
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *r = &NL_CPU_REGS_[k];
+        bit *q = nl_cpu_q_(&c, r);
+        for (int i = 0; i < r->width; i++) {
+            q[i] = nl_dff_(BIT_0);
+            nl_name_(q[i], r->name, i, r->width, r->root);
+        }
+    }
+    before = c;
+    cycle(&c);
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *r = &NL_CPU_REGS_[k];
+        const bit *dff = nl_cpu_q_(&before, r), *d = nl_cpu_q_(&c, r);
+        for (int i = 0; i < r->width; i++) nl_dff_connect_(dff[i], d[i]);
+    }
+    // EX -> IF 的直连导线
+    nl_name_(c.wire_pc_src[0], "wire_pc_src", 0, 2, 0);
+    nl_name_(c.wire_pc_src[1], "wire_pc_src", 1, 2, 0);
+    for (int i = 0; i < WORD_SIZE; i++) nl_name_(c.wire_branch_target[i], "wire_branch_target", i, WORD_SIZE, 0);
+}
+
+/*********************************************Sim***************************************************************/
+// 用 nl_eval / nl_commit 跑捕获出来的 CPU; IM / DM 是普通数组, 语义与 im_read / dm_read / dm_write 相同
+
+typedef struct nl_cpu_sim {
+    const Netlist *nl;
+    uint8_t val[NL_MAX_NODES];
+    uint32_t im[IM_SIZE];
+    uint8_t dm[DEFAULT_SIZE];
+    uint64_t cycle_count;
+} Nl_cpu_sim;
+
+static inline uint32_t nl_cpu_mem_read_(void *ctx, const int mem, const uint32_t addr) {
+    const Nl_cpu_sim *s = ctx;
+    if (mem == NL_MEM_IM) return addr / 4 < IM_SIZE ? s->im[addr / 4] : 0;
+    if ((addr & 3) != 0 || addr >= DEFAULT_SIZE) return 0;
+    const uint8_t *m = &s->dm[addr];
+    return (uint32_t) m[0] << 24 | (uint32_t) m[1] << 16 | (uint32_t) m[2] << 8 | m[3];
+}
+
+static inline void nl_cpu_mem_write_(void *ctx, const int mem, const uint32_t addr, const uint32_t data,
+                                     const uint8_t be[4]) {
+    Nl_cpu_sim *s = ctx;
+    if (mem != NL_MEM_DM || (addr & 3) != 0 || addr >= DEFAULT_SIZE) return;
+    for (int i = 0; i < 4; i++) {
+        if (be[i]) s->dm[addr + i] = (uint8_t) (data >> (24 - 8 * i));
+    }
+}
+
+static inline void nl_cpu_sim_init(Nl_cpu_sim *s, const Netlist *nl) {
+    s->nl = nl;
+    nl_reset_state(nl, s->val);
+    memset(s->im, 0, sizeof(s->im));
+    memset(s->dm, 0, sizeof(s->dm));
+    s->cycle_count = 0;
+}
+
+static inline void nl_cpu_sim_load_program(Nl_cpu_sim *s, const uint32_t *program_codes, const size_t codes_len) {
+    const size_t len = codes_len > IM_SIZE ? IM_SIZE : codes_len;
+    memcpy(s->im, program_codes, len * sizeof(uint32_t));
+}
+
+static inline void nl_cpu_sim_tick(Nl_cpu_sim *s) {
+    nl_eval(s->nl, s->val, nl_cpu_mem_read_, s);
+    nl_commit(s->nl, s->val, nl_cpu_mem_write_, s);
+    s->cycle_count++;
+}
+
+// name 与 NL_CPU_REGS_ 相同, 例如 "rf.r3" / "ex_mem.alu_result"
+static inline uint32_t nl_cpu_sim_reg(const Nl_cpu_sim *s, const char *name) {
+    return nl_read_named(s->nl, s->val, name);
+}
+
+/**
+ * 按流水线阶段分区 (给 netlist_par.h 用): 每个 DFF 归写它的阶段, DM 写端口归 MEM
+ * 一个阶段的锥只读流水线寄存器 / regfile / PC 的 Q, 同一个周期内阶段之间没有依赖
+ * 返回分区数 STAGE_NUM, 分区编号就是 STAGE_*
+ */
+static inline int nl_cpu_stage_partition(const Netlist *nl, uint8_t *part_of_node, uint8_t *part_of_port) {
+    memset(part_of_node, STAGE_IF, nl->n_nodes);
+    for (uint32_t i = 0; i < nl->n_names; i++) {
+        const Nl_name *x = &nl->names[i];
+        if (nl->nodes[x->node].op != NL_DFF) continue;
+        for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+            if (strcmp(NL_CPU_REGS_[k].name, x->name) == 0) part_of_node[x->node] = (uint8_t) NL_CPU_REGS_[k].stage;
+        }
+    }
+    for (uint32_t p = 0; p < nl->n_ports; p++) part_of_port[p] = STAGE_MEM;
+    return STAGE_NUM;
+}
+#endif
+
+#endif //SCCPU_NETLIST_CPU_H
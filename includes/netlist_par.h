@@ -0,0 +1,329 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_NETLIST_PAR_H
+#define SCCPU_NETLIST_PAR_H
+#include "pthread.h"
+#include "stddef.h"
+#include "time.h"
+#include "netlist.h"
+#include "spin_barrier.h"
+
+/**
+ * 分区并行求值
+ *
+ * 调用方把每个 DFF / 写端口划给一个分区 (例如按流水线阶段: 每个阶段只写自己的流水线寄存器)
+ * 分区的锥 = 从它的 DFF 的 D 端 / 写端口反向走到 DFF Q 为止的所有门和读端口
+ * 锥之间共享的逻辑各算一遍, 一个周期内分区之间不需要任何同步
+ *
+ * 分区按锥的大小 (LPT) 分给固定数目的线程, 同一个线程上的几个锥取并集, 共享的门只算一次
+ * 每个周期两个阶段, 各一个屏障:
+ *  求值: 每个线程把用到的 Q 拷进私有的 val, 按拓扑序算自己的锥, 记下自己 DFF 的下一个状态和写端口
+ *  提交: 每个线程提交自己的 DFF 和写端口 (所有读端口都已经在求值阶段读完)
+ * 读端口的回调会被多个线程同时调用, 必须是只读的
+ */
+#define NL_PAR_MAX_PARTS 16
+#define NL_PAR_MAX_THREADS 8
+#define NL_PAR_POOL (NL_MAX_NODES * 4)
+
+typedef struct nl_par_write {
+    uint8_t we;
+    uint8_t be[4];
+    uint32_t addr;
+    uint32_t data;
+} Nl_par_write;
+
+typedef struct nl_par_thread {
+    struct nl_par *par;
+    int id;
+    pthread_t tid;
+    unsigned sense;
+    // pool 中的区间: 锥 (拓扑序), 锥读到的 DFF, 自己提交的 DFF
+    uint32_t cone, n_cone;
+    uint32_t leaf, n_leaf;
+    uint32_t own, n_own;
+    uint32_t n_wport;
+    uint32_t wport[NL_MAX_PORTS];
+    uint32_t gates;
+    uint64_t busy_ns;
+} Nl_par_thread;
+
+typedef struct nl_par {
+    const Netlist *nl;
+    nl_mem_read_fn rd;
+    nl_mem_write_fn wr;
+    void *ctx;
+    int n_parts;
+    int n_threads;
+    int part_thread[NL_PAR_MAX_PARTS];
+    uint32_t part_gates[NL_PAR_MAX_PARTS]; // 各分区锥的门数
+    Nl_par_thread th[NL_PAR_MAX_THREADS];
+    Spin_barrier barrier;
+    int cycles;
+    int running; // 线程池已启动
+    int quit;
+    int overflow;
+    uint32_t pool_used;
+    uint32_t pool[NL_PAR_POOL];
+    uint8_t state[NL_MAX_NODES]; // DFF 的 Q (nl_read_named 可以直接读)
+    uint8_t next[NL_MAX_NODES];
+    uint8_t val[NL_PAR_MAX_THREADS][NL_MAX_NODES];
+    Nl_par_write pending[NL_MAX_PORTS];
+} Nl_par;
+
+static inline uint64_t nl_par_now_ns_(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static inline uint32_t nl_par_alloc_(Nl_par *P, const uint32_t n) {
+    if (P->pool_used + n > NL_PAR_POOL) {
+        P->overflow = 1;
+        return 0;
+    }
+    P->pool_used += n;
+    return P->pool_used - n;
+}
+
+// 从 mark 中已标记的根出发反向标记整个锥 (到 DFF 为止); 读端口把地址锥也带上
+static inline void nl_par_mark_cone_(const Netlist *nl, uint8_t *mark) {
+    uint8_t port_seen[NL_MAX_PORTS] = {0};
+    for (uint32_t i = nl->n_nodes; i-- > 2;) {
+        if (!mark[i]) continue;
+        const Nl_node *x = &nl->nodes[i];
+        if (nl_is_gate_(x->op)) mark[x->a] = 1;
+        if (x->op == NL_AND || x->op == NL_OR) mark[x->b] = 1;
+        if (x->op == NL_MEM_RD && !port_seen[x->a]) {
+            port_seen[x->a] = 1;
+            for (int k = 0; k < WORD_SIZE; k++) mark[nl->ports[x->a].addr[k]] = 1;
+        }
+    }
+}
+
+static inline void nl_par_mark_port_(const Nl_port *p, uint8_t *mark) {
+    for (int k = 0; k < WORD_SIZE; k++) {
+        mark[p->addr[k]] = 1;
+        mark[p->data[k]] = 1;
+    }
+    mark[p->we] = 1;
+    for (int k = 0; k < 4; k++) mark[p->be[k]] = 1;
+}
+
+static inline void nl_par_eval_(Nl_par *P, Nl_par_thread *t) {
+    const Netlist *nl = P->nl;
+    uint8_t *val = P->val[t->id];
+    uint32_t port_val[NL_MAX_PORTS];
+    uint8_t port_done[NL_MAX_PORTS] = {0};
+    const uint32_t *leaf = &P->pool[t->leaf], *cone = &P->pool[t->cone], *own = &P->pool[t->own];
+    for (uint32_t k = 0; k < t->n_leaf; k++) val[leaf[k]] = P->state[leaf[k]];
+    for (uint32_t k = 0; k < t->n_cone; k++) {
+        const uint32_t i = cone[k];
+        const Nl_node *x = &nl->nodes[i];
+        switch (x->op) {
+            case NL_NOT: val[i] = val[x->a] ^ 1u;
+                break;
+            case NL_AND: val[i] = val[x->a] & val[x->b];
+                break;
+            case NL_OR: val[i] = val[x->a] | val[x->b];
+                break;
+            case NL_MEM_RD:
+                if (!port_done[x->a]) {
+                    const Nl_port *p = &nl->ports[x->a];
+                    port_val[x->a] = P->rd ? P->rd(P->ctx, p->mem, nl_word_value_(val, p->addr)) : 0;
+                    port_done[x->a] = 1;
+                }
+                val[i] = (uint8_t) ((port_val[x->a] >> (WORD_SIZE - 1 - x->b)) & 1u);
+                break;
+            default:
+                break;
+        }
+    }
+    for (uint32_t k = 0; k < t->n_own; k++) P->next[own[k]] = val[nl->nodes[own[k]].a];
+    for (uint32_t k = 0; k < t->n_wport; k++) {
+        const Nl_port *p = &nl->ports[t->wport[k]];
+        Nl_par_write *w = &P->pending[t->wport[k]];
+        w->we = val[p->we];
+        if (!w->we) continue;
+        w->addr = nl_word_value_(val, p->addr);
+        w->data = nl_word_value_(val, p->data);
+        for (int b = 0; b < 4; b++) w->be[b] = val[p->be[b]];
+    }
+}
+
+static inline void nl_par_commit_(Nl_par *P, const Nl_par_thread *t) {
+    const uint32_t *own = &P->pool[t->own];
+    for (uint32_t k = 0; k < t->n_own; k++) P->state[own[k]] = P->next[own[k]];
+    for (uint32_t k = 0; k < t->n_wport; k++) {
+        const Nl_par_write *w = &P->pending[t->wport[k]];
+        if (w->we && P->wr) P->wr(P->ctx, P->nl->ports[t->wport[k]].mem, w->addr, w->data, w->be);
+    }
+}
+
+static inline void nl_par_cycles_(Nl_par *P, Nl_par_thread *t, const int cycles) {
+    for (int c = 0; c < cycles; c++) {
+        const uint64_t t0 = nl_par_now_ns_();
+        nl_par_eval_(P, t);
+        t->busy_ns += nl_par_now_ns_() - t0;
+        spin_barrier_wait(&P->barrier, &t->sense);
+        const uint64_t t1 = nl_par_now_ns_();
+        nl_par_commit_(P, t);
+        t->busy_ns += nl_par_now_ns_() - t1;
+        spin_barrier_wait(&P->barrier, &t->sense);
+    }
+}
+
+static inline void *nl_par_worker_(void *arg) {
+    Nl_par_thread *t = arg;
+    Nl_par *P = t->par;
+    for (;;) {
+        spin_barrier_wait(&P->barrier, &t->sense);
+        if (P->quit) break;
+        nl_par_cycles_(P, t, P->cycles);
+    }
+    return NULL;
+}
+
+/**
+ * part_of_node[i]: DFF i 归哪个分区; part_of_port[p]: 写端口 p 归哪个分区 (其余节点 / 读端口不看)
+ * 线程 0 是调用 nl_par_run 的线程, 其余 n_threads - 1 个线程在这里创建
+ * DFF 回到初值; 返回 0 表示成功
+ */
+static inline int nl_par_init(Nl_par *P, const Netlist *nl, const int n_parts, const uint8_t *part_of_node,
+                              const uint8_t *part_of_port, int n_threads, const nl_mem_read_fn rd,
+                              const nl_mem_write_fn wr, void *ctx) {
+    static uint8_t mark[NL_MAX_NODES];
+    if (n_parts < 1 || n_parts > NL_PAR_MAX_PARTS) return 1;
+    if (n_threads > n_parts) n_threads = n_parts;
+    if (n_threads < 1 || n_threads > NL_PAR_MAX_THREADS) return 1;
+    memset(P, 0, offsetof(Nl_par, pool));
+    P->nl = nl;
+    P->rd = rd;
+    P->wr = wr;
+    P->ctx = ctx;
+    P->n_parts = n_parts;
+    P->n_threads = n_threads;
+
+    // 1. 每个分区单独的锥, 按门数从大到小分给当前负载最小的线程
+    uint32_t load[NL_PAR_MAX_THREADS] = {0};
+    int order[NL_PAR_MAX_PARTS];
+    for (int p = 0; p < n_parts; p++) {
+        memset(mark, 0, nl->n_nodes);
+        for (uint32_t i = 2; i < nl->n_nodes; i++) {
+            if (nl->nodes[i].op == NL_DFF && part_of_node[i] == p) mark[nl->nodes[i].a] = 1;
+        }
+        for (uint32_t q = 0; q < nl->n_ports; q++) {
+            if (nl->ports[q].write && part_of_port[q] == p) nl_par_mark_port_(&nl->ports[q], mark);
+        }
+        nl_par_mark_cone_(nl, mark);
+        for (uint32_t i = 2; i < nl->n_nodes; i++) P->part_gates[p] += mark[i] && nl_is_gate_(nl->nodes[i].op);
+        order[p] = p;
+    }
+    for (int i = 1; i < n_parts; i++) {
+        for (int j = i; j > 0 && P->part_gates[order[j]] > P->part_gates[order[j - 1]]; j--) {
+            const int tmp = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = tmp;
+        }
+    }
+    for (int i = 0; i < n_parts; i++) {
+        int best = 0;
+        for (int t = 1; t < n_threads; t++) {
+            if (load[t] < load[best]) best = t;
+        }
+        P->part_thread[order[i]] = best;
+        load[best] += P->part_gates[order[i]];
+    }
+
+    // 2. 每个线程: 自己所有分区的锥取并集
+    for (int t = 0; t < n_threads; t++) {
+        Nl_par_thread *th = &P->th[t];
+        th->par = P;
+        th->id = t;
+        memset(mark, 0, nl->n_nodes);
+        uint32_t n_own = 0;
+        for (uint32_t i = 2; i < nl->n_nodes; i++) {
+            if (nl->nodes[i].op == NL_DFF && P->part_thread[part_of_node[i]] == t) {
+                mark[nl->nodes[i].a] = 1;
+                n_own++;
+            }
+        }
+        for (uint32_t q = 0; q < nl->n_ports; q++) {
+            if (!nl->ports[q].write || P->part_thread[part_of_port[q]] != t) continue;
+            nl_par_mark_port_(&nl->ports[q], mark);
+            th->wport[th->n_wport++] = q;
+        }
+        nl_par_mark_cone_(nl, mark);
+        uint32_t n_cone = 0, n_leaf = 0;
+        for (uint32_t i = 2; i < nl->n_nodes; i++) {
+            if (!mark[i]) continue;
+            if (nl->nodes[i].op == NL_DFF) n_leaf++;
+            else if (nl->nodes[i].op != NL_INPUT) n_cone++;
+        }
+        th->cone = nl_par_alloc_(P, n_cone);
+        th->leaf = nl_par_alloc_(P, n_leaf);
+        th->own = nl_par_alloc_(P, n_own);
+        if (P->overflow) return 1;
+        for (uint32_t i = 2; i < nl->n_nodes; i++) {
+            const uint8_t op = nl->nodes[i].op;
+            if (op == NL_DFF && P->part_thread[part_of_node[i]] == t) P->pool[th->own + th->n_own++] = i;
+            if (!mark[i]) continue;
+            if (op == NL_DFF) P->pool[th->leaf + th->n_leaf++] = i;
+            else if (op != NL_INPUT) {
+                P->pool[th->cone + th->n_cone++] = i;
+                th->gates += nl_is_gate_(op);
+            }
+        }
+        P->val[t][0] = 0;
+        P->val[t][1] = 1;
+    }
+    nl_reset_state(nl, P->state);
+
+    // 3. 线程池
+    spin_barrier_init(&P->barrier, (unsigned) n_threads);
+    for (int t = 1; t < n_threads; t++) {
+        if (pthread_create(&P->th[t].tid, NULL, nl_par_worker_, &P->th[t]) != 0) return 1;
+    }
+    P->running = 1;
+    return 0;
+}
+
+// 所有线程一起跑 cycles 个周期 (调用线程是线程 0)
+static inline void nl_par_run(Nl_par *P, const int cycles) {
+    Nl_par_thread *t = &P->th[0];
+    P->cycles = cycles;
+    if (P->n_threads > 1) spin_barrier_wait(&P->barrier, &t->sense);
+    nl_par_cycles_(P, t, cycles);
+}
+
+static inline void nl_par_stop(Nl_par *P) {
+    if (!P->running || P->n_threads <= 1) return;
+    P->quit = 1;
+    spin_barrier_wait(&P->barrier, &P->th[0].sense);
+    for (int t = 1; t < P->n_threads; t++) pthread_join(P->th[t].tid, NULL);
+    P->running = 0;
+}
+
+typedef struct nl_par_stats {
+    uint32_t gates; // 整张网表的门数
+    uint32_t thread_gates; // 各线程锥的门数之和 (锥之间重复的门算多次)
+    uint32_t max_thread_gates;
+    double duplication; // thread_gates / gates
+    double ideal_speedup; // gates / max_thread_gates: 不计同步开销时的上限
+} Nl_par_stats;
+
+static inline Nl_par_stats nl_par_stats(const Nl_par *P) {
+    Nl_par_stats s;
+    memset(&s, 0, sizeof(s));
+    s.gates = nl_stats(P->nl).gates;
+    for (int t = 0; t < P->n_threads; t++) {
+        s.thread_gates += P->th[t].gates;
+        if (P->th[t].gates > s.max_thread_gates) s.max_thread_gates = P->th[t].gates;
+    }
+    s.duplication = s.gates ? (double) s.thread_gates / s.gates : 0;
+    s.ideal_speedup = s.max_thread_gates ? (double) s.gates / s.max_thread_gates : 0;
+    return s;
+}
+
+#endif //SCCPU_NETLIST_PAR_H
@@ -8,10 +8,17 @@
 #include "alu.h"
 #include "reg.h"
 
+#if SCCPU_PACKED_WORD
+const static word
+WORD_4_BYTE = {0x00000004u};
+#else
 const static bit
 WORD_4_BYTE[32] = {
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0
+    BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0,
+    BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0,
+    BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_0, BIT_1, BIT_0, BIT_0
 };
+#endif
 
 typedef struct pc32 {
     Reg32_ reg32;
@@ -29,9 +36,9 @@ static inline void init_pc32(Pc32_ *pc32) {
  * clk -> tow stage clk Signal
  */
 static inline void
-pc32_word_step(Pc32_ *pc, const bit reset, const word init, const bit branch_taken, const word branch_target,
-               word pc_out_,
-               bit *overflow, const bit clk) {
+pc32_word_step_gate_(Pc32_ *pc, const bit reset, const word init, const bit branch_taken, const word branch_target,
+                     word pc_out_,
+                     bit *overflow, const bit clk) {
     word pc_o_v, pc_n_v;
     read_reg32(&pc->reg32, pc_o_v);
     // ALU Add
@@ -41,7 +48,35 @@ pc32_word_step(Pc32_ *pc, const bit reset, const word init, const bit branch_tak
     // Reset Mux
     word_mux_2_1(pc_n_v, init, reset, pc_n_v);
     //
-    reg32_step(&pc->reg32, 1, pc_n_v, pc_out_, clk);
+    reg32_step(&pc->reg32, BIT_1, pc_n_v, pc_out_, clk);
+}
+
+#if SCCPU_HAS_BEH_MODELS
+// 行为级 PC: overflow 是 PC + 4 的进位
+static inline void
+pc32_word_step_beh_(Pc32_ *pc, const bit reset, const word init, const bit branch_taken, const word branch_target,
+                    word pc_out_,
+                    bit *overflow, const bit clk) {
+    const uint64_t plus4 = (uint64_t) u32_from_word(pc->reg32.q) + 4u;
+    word next;
+    if (LANE_GET(reset, 0)) memcpy(next, init, sizeof(word));
+    else if (LANE_GET(branch_taken, 0)) memcpy(next, branch_target, sizeof(word));
+    else u32_to_word((uint32_t) plus4, next);
+    *overflow = (plus4 >> 32) ? BIT_1 : BIT_0;
+    reg32_step_beh_(&pc->reg32, 1, next, LANE_GET(clk, 0));
+    memcpy(pc_out_, pc->reg32.q, sizeof(word));
+}
+#endif
+
+static inline void
+pc32_word_step(Pc32_ *pc, const bit reset, const word init, const bit branch_taken, const word branch_target,
+               word pc_out_,
+               bit *overflow, const bit clk) {
+#if SCCPU_MODEL_PC == MODEL_BEH
+    pc32_word_step_beh_(pc, reset, init, branch_taken, branch_target, pc_out_, overflow, clk);
+#else
+    pc32_word_step_gate_(pc, reset, init, branch_taken, branch_target, pc_out_, overflow, clk);
+#endif
 }
 
 
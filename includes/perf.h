@@ -0,0 +1,135 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_PERF_H
+#define SCCPU_PERF_H
+#include "stdio.h"
+#include "cpu_core.h"
+
+/**
+ * 性能计数器: 每个周期在 cpu_step 之后按流水线里已有的信号累加 Cpu_core.perf
+ *  ID/EX.decode_signals  指令的类别 (PERF_OP_*), 在它进 EX 之前读; 全 0 的是气泡 (冲掉的、复位时的、未知 opcode),
+ *                        NOP (全 0 指令) 被译成 reg_dst = 1, 与气泡分得开; 未知 funct 的 R 型按 AND 算
+ *  wire_pc_src           EX 里的 BEQ 成立 / 不成立; if_id_flush 是一次冲刷 (冲掉 IF 和 ID 里的两条)
+ *  MEM/WB.wb_single      WB 里的指令写不写寄存器
+ * IF/ID 没有有效位, 冲掉或复位后是全 0 指令, 译出来和 NOP 一样; 这里按 if_id_flush / if_id_write 另记一位, 进 EX 时算气泡
+ * 类别跟着 EX -> MEM -> WB 走, 到 WB 的那个周期才计入 instructions (含 NOP, 不含气泡) 和 PERF_OP_*,
+ * 所以 cycles = instructions + bubbles
+ *
+ * 计数器区紧接在 DM 后面: PERF_MMIO_BASE + 8 * k 是第 k 个计数器的低 32 位, + 4 是高 32 位,
+ * 例如 LW R1, 0x1008(R0) 读 instructions; 读到的是这条 LW 在 MEM 的那个周期开始时的值, SW 写这片区域无效
+ * ISS 没有这片区域 (读到 0), 读计数器的程序不能拿去对拍
+ */
+#if !SCCPU_PERF_COUNTERS || SCCPU_LANES != 1 || SCCPU_NETLIST
+#error "perf.h counts events into Cpu_core.perf (SCCPU_PERF_COUNTERS=1, SCCPU_LANES=1, no SCCPU_NETLIST)"
+#endif
+
+#define PERF_MMIO_BASE DEFAULT_SIZE
+#define PERF_MMIO_SIZE (PERF_NUM * 8)
+
+static const char *const PERF_NAMES_[PERF_NUM] = {
+    "cycles", "instructions", "bubbles", "reg_writes",
+    "branch_taken", "branch_not_taken", "flushes",
+    "nop", "add", "sub", "and", "or", "slt",
+    "addi", "lw", "sw", "beq", "j"
+};
+
+static inline uint64_t perf_get(const Cpu_core *c, const Perf_event e) {
+    return c->perf.v[e];
+}
+
+// cycles / instructions; 还没有指令退休时返回 0
+static inline double perf_cpi(const Cpu_core *c) {
+    const uint64_t n = c->perf.v[PERF_INSTRUCTIONS];
+    return n ? (double) c->perf.v[PERF_CYCLES] / (double) n : 0.0;
+}
+
+// ID/EX 里 (下个周期进 EX) 的指令的类别; 下标同 id_ex_eval: 0 reg_dst 1 alu_src 3 reg_write 4 mem_read
+// 5 mem_write 6 branch 7 jump 8..10 ALU ops
+static inline uint8_t perf_classify_(const Cpu_core *c) {
+    const bit *s = c->id_ex.decode_signals.q;
+    if (LANE_GET(s[7], 0)) return PERF_OP_J;
+    if (LANE_GET(s[6], 0)) return PERF_OP_BEQ;
+    if (LANE_GET(s[4], 0)) return PERF_OP_LW;
+    if (LANE_GET(s[5], 0)) return PERF_OP_SW;
+    if (LANE_GET(s[0], 0)) {
+        if (!LANE_GET(s[3], 0)) return PERF_OP_NOP;
+        // ops: ADD 100, SUB 101, SLT 110, AND 000, OR 001
+        static const uint8_t by_ops[8] = {
+            PERF_OP_AND, PERF_OP_OR, PERF_OP_AND, PERF_OP_AND, PERF_OP_ADD, PERF_OP_SUB, PERF_OP_SLT, PERF_OP_AND
+        };
+        return by_ops[LANE_GET(s[8], 0) << 2 | LANE_GET(s[9], 0) << 1 | LANE_GET(s[10], 0)];
+    }
+    if (LANE_GET(s[1], 0) && LANE_GET(s[3], 0)) return PERF_OP_ADDI;
+    return PERF_BUBBLES;
+}
+
+// 在 cpu_step 之后调用 (SCCPU_PERF_COUNTERS 时 cpu_step 自己调用)
+static inline void perf_record(Cpu_core *c) {
+    Perf_counters *p = &c->perf;
+    p->v[PERF_CYCLES]++;
+    // 这个周期在 WB 的退休
+    p->v[p->wb]++;
+    if (p->wb != PERF_BUBBLES) {
+        p->v[PERF_INSTRUCTIONS]++;
+        p->v[PERF_REG_WRITES] += p->wb_reg_write;
+    }
+    // 这个周期在 EX 的 BEQ 成立没有 (与 hazard_unit_evaluate 同一个条件)
+    if (p->ex == PERF_OP_BEQ) {
+        const int taken = LANE_GET(c->wire_pc_src[0], 0) && !LANE_GET(c->wire_pc_src[1], 0);
+        p->v[taken ? PERF_BRANCH_TAKEN : PERF_BRANCH_NOT_TAKEN]++;
+    }
+    p->v[PERF_FLUSHES] += LANE_GET(c->wire_if_id_ctrl.if_id_flush, 0);
+    p->wb = p->mem;
+    p->wb_reg_write = (uint8_t) LANE_GET(GET_BIT_OF_REGN(&c->mem_wb.wb_single, 1), 0);
+    p->mem = p->ex;
+    p->ex = p->id_valid ? perf_classify_(c) : PERF_BUBBLES;
+    if (LANE_GET(c->wire_if_id_ctrl.if_id_flush, 0)) p->id_valid = 0;
+    else if (LANE_GET(c->wire_if_id_ctrl.if_id_write, 0)) p->id_valid = 1;
+}
+
+// DM 读口: 计数器区返回计数器, 其余地址照旧; dm 就是某个 Cpu_core 的 dm
+static inline bit perf_dm_read_(Dm_ *dm, const word address, word ret) {
+    const uint32_t a = u32_from_word(address);
+    if (a < PERF_MMIO_BASE || a >= PERF_MMIO_BASE + PERF_MMIO_SIZE || (a & 3) != 0) {
+#if SCCPU_MODEL_DM_READ == MODEL_GATE
+        return dm_read_gate_(dm, address, ret);
+#else
+        return dm_read(dm, address, ret);
+#endif
+    }
+    const Cpu_core *c = (const Cpu_core *) ((const char *) dm - offsetof(Cpu_core, dm));
+    const uint64_t v = c->perf.v[(a - PERF_MMIO_BASE) / 8];
+    u32_to_word((uint32_t) (a & 4 ? v >> 32 : v), ret);
+    return BIT_0;
+}
+
+// 让 LW 能读计数器区 (SCCPU_PERF_COUNTERS 时 init_cpu_c 自己调用)
+static inline void perf_mmio_attach(Cpu_core *c) {
+    c->dm.m_read = perf_dm_read_;
+}
+
+// 运行小结: CPI, 每千条指令的事件数, 指令构成
+static inline void perf_report(const Cpu_core *c, FILE *f) {
+    const Perf_counters *p = &c->perf;
+    const uint64_t n = p->v[PERF_INSTRUCTIONS], useful = n - p->v[PERF_OP_NOP];
+    const double k = n ? 1000.0 / (double) n : 0.0;
+    fprintf(f, "[Perf] %lu cycles, %lu instructions retired (%lu without NOPs)\n", p->v[PERF_CYCLES], n, useful);
+    fprintf(f, "       CPI %.3f, CPI without NOPs %.3f\n", perf_cpi(c),
+            useful ? (double) p->v[PERF_CYCLES] / (double) useful : 0.0);
+    fprintf(f, "       per 1000 instructions:\n");
+    for (int e = PERF_BUBBLES; e < PERF_OP_NOP; e++) {
+        fprintf(f, "         %-17s %10.1f  (%lu)\n", PERF_NAMES_[e], (double) p->v[e] * k, p->v[e]);
+    }
+    fprintf(f, "         %-17s %10.1f  (%lu)\n", "nop", (double) p->v[PERF_OP_NOP] * k, p->v[PERF_OP_NOP]);
+    fprintf(f, "         %-17s %10.1f  (%lu)\n", "loads", (double) p->v[PERF_OP_LW] * k, p->v[PERF_OP_LW]);
+    fprintf(f, "         %-17s %10.1f  (%lu)\n", "stores", (double) p->v[PERF_OP_SW] * k, p->v[PERF_OP_SW]);
+    fprintf(f, "       mix:");
+    for (int e = PERF_OP_NOP; e < PERF_NUM; e++) {
+        fprintf(f, " %s %.1f%%", PERF_NAMES_[e], n ? 100.0 * (double) p->v[e] / (double) n : 0.0);
+    }
+    fprintf(f, "\n");
+}
+
+#endif //SCCPU_PERF_H
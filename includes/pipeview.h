@@ -0,0 +1,204 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_PIPEVIEW_H
+#define SCCPU_PIPEVIEW_H
+#include "stdio.h"
+#include "cpu_core.h"
+
+/**
+ * 流水线占用时间线: 每条指令在 IF 取进来时分配一个序号, 跟着 IF/ID -> ID/EX -> EX/MEM -> MEM/WB 走,
+ * 逐周期写出它进入 / 离开每一级的周期, 格式是 Konata (Kanata 0004) 的日志, 用 Konata 打开就能看到
+ * 每条指令的阶段条、被冲掉的指令 (R ... 1) 和气泡 (两条指令之间空着的周期)
+ *
+ * 流水线寄存器里不带序号, 与对拍器一样在旁边维护一份影子流水线, 每个周期按 hazard 导线推进:
+ *  id_ex_flush  ID 里的指令被冲掉;  if_id_flush  本周期取进来的指令被冲掉
+ *  id_ex_write / if_id_write = 0  停顿: 上一级的指令留在原地; 寄存器保持时留下的重复副本不再跟踪
+ *  IF 停顿时下个周期还从同一个 PC 取, 仍是同一条指令 (PC 变了就算冲掉)
+ * 一个周期的阶段在 Konata 里占 [t, t + 1), 所以离开 (E / R) 在下一个周期写出
+ */
+#if SCCPU_LANES != 1 || SCCPU_NETLIST
+#error "pipeview.h follows a single Cpu_core (SCCPU_LANES=1, no SCCPU_NETLIST)"
+#endif
+
+typedef enum pipeview_stage {
+    PV_IF, PV_ID, PV_EX, PV_MEM, PV_WB, PV_STAGE_NUM, PV_NONE = -1
+} Pipeview_stage;
+
+static const char *const PV_STAGE_NAMES_[PV_STAGE_NUM] = {"IF", "ID", "EX", "MEM", "WB"};
+
+typedef struct pipeview_slot {
+    uint64_t id; // 序号 + 1, 0 -> 气泡
+    int stage; // 已经写出 S 的阶段
+    uint32_t pc;
+    uint32_t inst;
+} Pipeview_slot;
+
+typedef struct pipeview {
+    FILE *f;
+    Pipeview_slot fetch; // 停顿时留在 IF 的指令
+    Pipeview_slot if_id, id_ex, ex_mem, mem_wb;
+    Pipeview_slot done[4]; // 上个周期结束时退休 / 冲掉的, 下个周期写 R
+    int done_flush[4];
+    int n_done;
+    uint32_t fetch_pc; // 下个周期 IF 取的 PC
+    uint64_t cycle; // 已经写到的周期
+    uint64_t fetched, retired, flushed;
+    uint64_t nops; // 退休的指令里的 NOP (没有前递时软件补的气泡)
+} Pipeview;
+
+// 反汇编成一行标签; 寄存器号与 RTL 一样只取低 2 位
+static inline void pipeview_label_(char *out, const size_t n, const uint32_t pc, const uint32_t inst) {
+    const uint32_t rs = inst >> 21 & 3, rt = inst >> 16 & 3, rd = inst >> 11 & 3;
+    const int imm = (int16_t) (inst & 0xFFFF);
+    const int k = snprintf(out, n, "%08X: ", pc);
+    out += k;
+    const size_t m = n > (size_t) k ? n - (size_t) k : 0;
+    switch (inst >> 26) {
+        case OP_R_TYPE: {
+            static const char *names[64] = {
+                [FUNCT_ADD] = "add", [FUNCT_SUB] = "sub", [FUNCT_AND] = "and", [FUNCT_OR] = "or", [FUNCT_SLT] = "slt"
+            };
+            if (inst == 0) snprintf(out, m, "nop");
+            else if (names[inst & 0x3F]) snprintf(out, m, "%s r%u, r%u, r%u", names[inst & 0x3F], rd, rs, rt);
+            else snprintf(out, m, "r-type 0x%08X", inst);
+            break;
+        }
+        case OP_ADDI: snprintf(out, m, "addi r%u, r%u, %d", rt, rs, imm);
+            break;
+        case OP_LW: snprintf(out, m, "lw r%u, %d(r%u)", rt, imm, rs);
+            break;
+        case OP_SW: snprintf(out, m, "sw r%u, %d(r%u)", rt, imm, rs);
+            break;
+        case OP_BEQ: snprintf(out, m, "beq r%u, r%u, %d", rs, rt, imm);
+            break;
+        case OP_J: snprintf(out, m, "j 0x%07X", inst & 0x3FFFFFF);
+            break;
+        default: snprintf(out, m, "0x%08X", inst);
+            break;
+    }
+}
+
+// 离开流水线: 写最后一级的 E 和 R (冲掉的类型是 1)
+static inline void pipeview_leave_(Pipeview *p, const Pipeview_slot *s, const int flush) {
+    fprintf(p->f, "E\t%lu\t0\t%s\n", s->id - 1, PV_STAGE_NAMES_[s->stage]);
+    fprintf(p->f, "R\t%lu\t%lu\t%d\n", s->id - 1, flush ? p->flushed++ : p->retired++, flush);
+    p->nops += !flush && s->inst == 0;
+}
+
+// 本周期结束时离开的, 到下个周期再写
+static inline void pipeview_done_(Pipeview *p, const Pipeview_slot *s, const int flush) {
+    if (!s->id) return;
+    p->done[p->n_done] = *s;
+    p->done_flush[p->n_done++] = flush;
+}
+
+static inline void pipeview_write_done_(Pipeview *p) {
+    for (int i = 0; i < p->n_done; i++) pipeview_leave_(p, &p->done[i], p->done_flush[i]);
+    p->n_done = 0;
+}
+
+// 指令这个周期在 stage: 换了阶段才写 (停顿时不写)
+static inline void pipeview_enter_(Pipeview *p, Pipeview_slot *s, const int stage) {
+    if (!s->id || s->stage == stage) return;
+    if (s->stage != PV_NONE) fprintf(p->f, "E\t%lu\t0\t%s\n", s->id - 1, PV_STAGE_NAMES_[s->stage]);
+    fprintf(p->f, "S\t%lu\t0\t%s\n", s->id - 1, PV_STAGE_NAMES_[stage]);
+    s->stage = stage;
+}
+
+// 从 c 的当前状态开始 (排空的流水线: init_cpu_c 或 iss_to_cpu 之后); 失败返回 -1
+static inline int pipeview_open(Pipeview *p, const char *path, const Cpu_core *c) {
+    memset(p, 0, sizeof(Pipeview));
+    p->f = fopen(path, "w");
+    if (!p->f) return -1;
+    p->fetch_pc = reg32_read_u32_(&c->pc.reg32);
+    p->cycle = c->cycle_count;
+    fprintf(p->f, "Kanata\t0004\nC=\t%lu\n", p->cycle);
+    return 0;
+}
+
+// 在 cpu_step 之后调用: 写出刚跑完的这个周期每一级是哪条指令, 再按 hazard 导线推进影子流水线
+static inline void pipeview_record(Pipeview *p, const Cpu_core *c) {
+    const uint64_t t = c->cycle_count - 1;
+    if (t > p->cycle) fprintf(p->f, "C\t%lu\n", t - p->cycle);
+    p->cycle = t;
+    pipeview_write_done_(p);
+
+    // IF: 停顿中的指令 PC 没变就还是它, 否则取一条新的
+    Pipeview_slot fetch = p->fetch;
+    if (fetch.id && fetch.pc != p->fetch_pc) {
+        pipeview_leave_(p, &fetch, 1);
+        fetch.id = 0;
+    }
+    if (!fetch.id) {
+        char label[64];
+        word pc, inst;
+        fetch.id = ++p->fetched;
+        fetch.stage = PV_NONE;
+        fetch.pc = p->fetch_pc;
+        fetch.inst = 0; // 越过 IM 取到的是 NOP
+        if (fetch.pc / 4 < IM_SIZE) {
+            u32_to_word(fetch.pc, pc);
+            im_read(&c->im, pc, inst);
+            fetch.inst = u32_from_word(inst);
+        }
+        pipeview_label_(label, sizeof(label), fetch.pc, fetch.inst);
+        fprintf(p->f, "I\t%lu\t%lu\t0\nL\t%lu\t0\t%s\n", fetch.id - 1, fetch.id - 1, fetch.id - 1, label);
+    }
+    pipeview_enter_(p, &fetch, PV_IF);
+    pipeview_enter_(p, &p->if_id, PV_ID);
+    pipeview_enter_(p, &p->id_ex, PV_EX);
+    pipeview_enter_(p, &p->ex_mem, PV_MEM);
+    pipeview_enter_(p, &p->mem_wb, PV_WB);
+
+    // 周期结束: 按本周期的 hazard 导线推进
+    const int if_flush = LANE_GET(c->wire_if_id_ctrl.if_id_flush, 0);
+    const int if_write = LANE_GET(c->wire_if_id_ctrl.if_id_write, 0);
+    const int id_flush = LANE_GET(c->wire_id_ex_ctrl.id_ex_flush, 0);
+    const int id_write = LANE_GET(c->wire_id_ex_ctrl.id_ex_write, 0);
+    const Pipeview_slot decoded = p->if_id;
+    pipeview_done_(p, &p->mem_wb, 0);
+    p->mem_wb = p->ex_mem;
+    p->ex_mem = p->id_ex;
+    memset(&p->id_ex, 0, sizeof(Pipeview_slot));
+    if (id_flush) pipeview_done_(p, &decoded, 1);
+    else if (id_write) p->id_ex = decoded;
+    const int moved = id_flush || id_write; // ID 里的指令已经走了 (或被冲掉)
+    memset(&p->fetch, 0, sizeof(Pipeview_slot));
+    if (if_flush) {
+        pipeview_done_(p, &fetch, 1);
+        memset(&p->if_id, 0, sizeof(Pipeview_slot));
+    } else if (if_write) {
+        p->if_id = fetch;
+    } else {
+        p->fetch = fetch;
+        if (moved) memset(&p->if_id, 0, sizeof(Pipeview_slot));
+    }
+    if (!moved && decoded.id && p->if_id.id != decoded.id) pipeview_done_(p, &decoded, 1);
+    p->fetch_pc = reg32_read_u32_(&c->pc.reg32);
+}
+
+// 写出在途指令离开最后一级的时间并关闭; 还在流水线里的指令不写 R; 有写错误返回 -1
+static inline int pipeview_close(Pipeview *p) {
+    fprintf(p->f, "C\t1\n");
+    pipeview_write_done_(p);
+    const int bad = ferror(p->f);
+    const int closed = fclose(p->f);
+    p->f = NULL;
+    return closed != 0 || bad ? -1 : 0;
+}
+
+#if SCCPU_PIPEVIEW
+// 把打开的时间线挂到 c 上, 之后 cpu_step 每个周期推进它; 每个核挂自己的一份, init_cpu_c 摘掉
+static inline void pipeview_attach(Cpu_core *c, Pipeview *p) {
+    c->pipeview = p;
+}
+
+// 没挂或已关闭时什么都不做
+static inline void pipeview_cycle(const Cpu_core *c) {
+    if (c->pipeview && c->pipeview->f) pipeview_record(c->pipeview, c);
+}
+#endif
+
+#endif //SCCPU_PIPEVIEW_H
@@ -5,12 +5,16 @@
 #ifndef SCCPU_REG__H
 #define SCCPU_REG__H
 
+#include "string.h"
 #include "common.h"
 #include "mux.h"
 #include "dff.h"
 
+// SoA: 32 个 DFF 的 master/Q 连续存放, 共用一个时钟边沿检测 (同一个寄存器的 DFF 共享 clk)
 typedef struct reg32_ {
-    dff_b_ dffs[WORD_SIZE];
+    word master_q;
+    word q;
+    bit prev_clk;
 } Reg32_;
 
 typedef struct reg324file_ {
@@ -23,8 +27,9 @@ typedef struct reg324file_ {
 
 static inline void
 init_reg32(Reg32_ *reg) {
-    for (int i = 0; i < WORD_SIZE; i++)
-        init_dff_deh(&reg->dffs[i]);
+    memcpy(reg->master_q, WORD_ZERO, sizeof(word));
+    memcpy(reg->q, WORD_ZERO, sizeof(word));
+    reg->prev_clk = BIT_0;
 }
 
 static inline void
@@ -38,18 +43,30 @@ init_reg32file(Reg324file_ *reg324) {
 // 从寄存器内部状态读出当前 Q 到 byte 数组
 static inline void
 read_reg32(const Reg32_ *r, word out) {
-    for (int i = 0; i < WORD_SIZE; ++i) {
-        out[i] = r->dffs[i].dff.Q;
-    }
+    memcpy(out, r->q, sizeof(word));
 }
 
 static inline
 void reg32_step(Reg32_ *reg, const bit load, const word d_in, word p_out, const bit clk) {
+    const bit edge = AND(NOT(reg->prev_clk), clk);
+    reg->prev_clk = clk;
+    // select
+    word r;
+    word_mux_2_1(reg->q, d_in, load, r);
+#if SCCPU_DFF_CLOSED_FORM
+    // 与 dff_bit_update 相同, 整字求值
+    word_mux_2_1(r, reg->master_q, edge, reg->master_q);
+    word_mux_2_1(reg->q, reg->master_q, edge, reg->q);
+#else
     for (int i = 0; i < WORD_SIZE; ++i) {
-        // select
-        bit r = mux2_1(reg->dffs[i].dff.Q, d_in[i], load);
-        p_out[i] = dff_deh_step(&reg->dffs[i], clk, r);
+        bit m = WORD_GET(reg->master_q, i);
+        bit q = WORD_GET(reg->q, i);
+        dff_bit_update(&m, &q, edge, WORD_GET(r, i));
+        WORD_SET(reg->master_q, i, m);
+        WORD_SET(reg->q, i, q);
     }
+#endif
+    memcpy(p_out, reg->q, sizeof(word));
 }
 
 typedef struct regfile_in {
@@ -73,7 +90,7 @@ typedef struct regfile_in {
  * RD2 (Read Data 1): 32-bit, 从 A2 地址读出的数据。
  */
 static inline void
-reg324file_step(Reg324file_ *reg324, const Regfile_in *in, word rd1, word rd2, const bit clk) {
+reg324file_step_gate_(Reg324file_ *reg324, const Regfile_in *in, word rd1, word rd2, const bit clk) {
     // Electric currents are parallel
     const bit *a3_ = in->a3;
 
@@ -112,13 +129,93 @@ reg324file_step(Reg324file_ *reg324, const Regfile_in *in, word rd1, word rd2, c
     word sa2v;
     word_mux_2_1(sv1_a2, sv2_a2, in->a2[1], sa2v);
 
-    for (int i = 0; i < WORD_SIZE; i++)rd1[i] = sa1v[i];
-    for (int i = 0; i < WORD_SIZE; i++)rd2[i] = sa2v[i];
+    for (int i = 0; i < WORD_SIZE; i++) WORD_SET(rd1, i, WORD_GET(sa1v, i));
+    for (int i = 0; i < WORD_SIZE; i++) WORD_SET(rd2, i, WORD_GET(sa2v, i));
+}
+
+#if SCCPU_HAS_BEH_MODELS
+// 行为级寄存器: 上升沿 Q <- master, 否则 master 跟随 (load ? d : Q); 与 reg32_step 的主从收敛结果相同
+static inline void
+reg32_step_beh_(Reg32_ *reg, const int load, const word d_in, const int clk) {
+    const int edge = !LANE_GET(reg->prev_clk, 0) && clk;
+    reg->prev_clk = clk ? BIT_1 : BIT_0;
+    if (edge) memcpy(reg->q, reg->master_q, sizeof(word));
+    else memcpy(reg->master_q, load ? d_in : reg->q, sizeof(word));
+}
+
+static inline void
+reg324file_step_beh_(Reg324file_ *reg324, const Regfile_in *in, word rd1, word rd2, const bit clk) {
+    Reg32_ *regs[4] = {&reg324->r0, &reg324->r1, &reg324->r2, &reg324->r3};
+    const int a1 = LANE_GET(in->a1[0], 0) << 1 | LANE_GET(in->a1[1], 0);
+    const int a2 = LANE_GET(in->a2[0], 0) << 1 | LANE_GET(in->a2[1], 0);
+    const int a3 = LANE_GET(in->a3[0], 0) << 1 | LANE_GET(in->a3[1], 0);
+    for (int k = 0; k < 4; k++) reg32_step_beh_(regs[k], LANE_GET(in->we3, 0) && a3 == k, in->wd3, LANE_GET(clk, 0));
+    memcpy(rd1, regs[a1]->q, sizeof(word));
+    memcpy(rd2, regs[a2]->q, sizeof(word));
 }
+#endif
+
+static inline void
+reg324file_step(Reg324file_ *reg324, const Regfile_in *in, word rd1, word rd2, const bit clk) {
+#if SCCPU_MODEL_REGFILE == MODEL_BEH
+    reg324file_step_beh_(reg324, in, rd1, rd2, clk);
+#else
+    reg324file_step_gate_(reg324, in, rd1, rd2, clk);
+#endif
+}
+
+
+/*********************************************RegN***************************************************************/
+// 位宽参数化的寄存器, 给流水线里只需要几根线的字段 (控制信号 / 寄存器编号) 使用
+// 与 word 一样 q[0] 是最高位, 数值右对齐: q[N-1] 是 bit 0
+#define DEFINE_REGN(N) \
+typedef struct reg##N##_ { \
+    bit master_q[N]; \
+    bit q[N]; \
+    bit prev_clk; \
+} Reg##N##_; \
+\
+static inline void \
+init_reg##N(Reg##N##_ *reg) { \
+    for (int i = 0; i < (N); i++) { \
+        reg->master_q[i] = BIT_0; \
+        reg->q[i] = BIT_0; \
+    } \
+    reg->prev_clk = BIT_0; \
+} \
+\
+static inline void \
+read_reg##N(const Reg##N##_ *r, bit out[N]) { \
+    memcpy(out, r->q, sizeof(r->q)); \
+} \
+\
+static inline \
+void reg##N##_step(Reg##N##_ *reg, const bit load, const bit d_in[N], bit p_out[N], const bit clk) { \
+    const bit edge = AND(NOT(reg->prev_clk), clk); \
+    reg->prev_clk = clk; \
+    for (int i = 0; i < (N); ++i) { \
+        dff_bit_update(&reg->master_q[i], &reg->q[i], edge, mux2_1(reg->q[i], d_in[i], load)); \
+    } \
+    memcpy(p_out, reg->q, sizeof(reg->q)); \
+} \
+\
+static inline \
+uint32_t reg##N##_read_u32_(const Reg##N##_ *r) { \
+    uint32_t v = 0; \
+    for (int i = 0; i < (N); i++) v = v << 1 | (uint32_t) LANE_GET(r->q[i], 0); \
+    return v; \
+}
+
+// 控制信号 (id_ex.decode_signals)
+DEFINE_REGN(11)
+// mem_single / wb_single / 寄存器编号
+DEFINE_REGN(2)
 
 
 /*********************************************Macro***************************************************************/
-#define GET_BIT_OF_REG32(r_ptr,n) ((r_ptr)->dffs[INST_WORD((n))].dff.Q)
+#define GET_BIT_OF_REG32(r_ptr,n) WORD_GET((r_ptr)->q, INST_WORD((n)))
+// n: 逻辑 bit (0 = LSB)
+#define GET_BIT_OF_REGN(r_ptr,n) ((r_ptr)->q[sizeof((r_ptr)->q) / sizeof(bit) - 1 - (n)])
 
 
 #endif //SCCPU_REG__H
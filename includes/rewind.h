@@ -0,0 +1,138 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_REWIND_H
+#define SCCPU_REWIND_H
+#include "cpu_core.h"
+
+/**
+ * 反向执行: 每 K 个周期在环形缓冲里存一份快照, "后退 N 个周期" = 恢复不晚于目标的最近一份快照, 再重放到目标
+ * CPU 是确定性的 (没有外部输入), 重放得到的就是原来那个周期的状态
+ *
+ * 快照不逐个走 DFF, 直接 memcpy Cpu_core 里连续的几段:
+ *  pc .. rf         所有 DFF (master / Q / prev_clk), 按当前后端的存储方式原样拷贝
+ *  wire_pc_src .. wire_if
+ *  DM 的字节, cycle_count
+ * IM 不存: CPU 不会写 IM; 运行中改了 IM 要重新 rewind_init
+ * 恢复后 activity 的输入快照作废, 下个周期全部阶段重新求值
+ *
+ * 内存固定为 REWIND_SLOTS 份快照 (rewind_bytes); rewind_init 按希望能后退的周期数 horizon 选 K,
+ * 使 (REWIND_SLOTS - 1) * K >= horizon. 更早的快照被覆盖, 最坏情况下一次后退要重放 K - 1 个周期
+ * 用 rewind_step 代替 cpu_step 推进
+ *
+ * 重放用 cpu_cycle, 不再调用 cpu_step 的钩子: 跟踪环里不会出现重放的周期 (后退之后再往前跑的周期照常记录)
+ * SCCPU_PERF_COUNTERS 时 Cpu_core.perf 跟着快照存取, 重放时照常累加 (LW 能读到计数器, 重放要读到同样的值),
+ * 回到某个周期后的计数与正向跑到那里时相同
+ * SCCPU_PIPEVIEW 的影子流水线在快照之外, 后退之后对不上, 编译时拒绝
+ */
+#if SCCPU_NETLIST || SCCPU_SHARED_IMAGES || SCCPU_PIPEVIEW
+#error "rewind.h replays cycles and copies DM by value (no SCCPU_NETLIST / SCCPU_SHARED_IMAGES / SCCPU_PIPEVIEW)"
+#endif
+
+#ifndef REWIND_SLOTS
+#define REWIND_SLOTS 64
+#endif
+
+#define REWIND_REGS_BEGIN_ offsetof(Cpu_core, pc)
+#define REWIND_REGS_END_ offsetof(Cpu_core, dm)
+#define REWIND_WIRES_BEGIN_ offsetof(Cpu_core, wire_pc_src)
+#define REWIND_WIRES_END_ (offsetof(Cpu_core, wire_if) + sizeof(If_id_wires))
+
+typedef struct rewind_snap {
+    uint64_t cycle;
+    uint8_t regs[REWIND_REGS_END_ - REWIND_REGS_BEGIN_];
+    uint8_t wires[REWIND_WIRES_END_ - REWIND_WIRES_BEGIN_];
+    uint8_t dm[sizeof(((Dm_ *) 0)->memory)];
+#if SCCPU_PERF_COUNTERS
+    Perf_counters perf;
+#endif
+} Rewind_snap;
+
+typedef struct rewind {
+    Rewind_snap slots[REWIND_SLOTS];
+    int head; // 最新一份的下标
+    int count;
+    uint64_t interval; // K
+    uint64_t replayed; // 累计重放的周期数
+} Rewind;
+
+static inline void rewind_snap_take_(Rewind_snap *s, const Cpu_core *c) {
+    s->cycle = c->cycle_count;
+    memcpy(s->regs, (const char *) c + REWIND_REGS_BEGIN_, sizeof(s->regs));
+    memcpy(s->wires, (const char *) c + REWIND_WIRES_BEGIN_, sizeof(s->wires));
+    memcpy(s->dm, c->dm.memory, sizeof(s->dm));
+#if SCCPU_PERF_COUNTERS
+    s->perf = c->perf;
+#endif
+}
+
+static inline void rewind_snap_restore_(const Rewind_snap *s, Cpu_core *c) {
+    memcpy((char *) c + REWIND_REGS_BEGIN_, s->regs, sizeof(s->regs));
+    memcpy((char *) c + REWIND_WIRES_BEGIN_, s->wires, sizeof(s->wires));
+    memcpy(c->dm.memory, s->dm, sizeof(s->dm));
+#if SCCPU_PERF_COUNTERS
+    c->perf = s->perf;
+#endif
+    c->cycle_count = s->cycle;
+    cpu_activity_invalidate(c);
+}
+
+// 能后退 horizon 个周期; 当前状态作为第一份快照
+static inline void rewind_init(Rewind *r, const Cpu_core *c, const uint64_t horizon) {
+    r->interval = (horizon + REWIND_SLOTS - 2) / (REWIND_SLOTS - 1);
+    if (r->interval == 0) r->interval = 1;
+    r->head = 0;
+    r->count = 1;
+    r->replayed = 0;
+    rewind_snap_take_(&r->slots[0], c);
+}
+
+static inline size_t rewind_bytes(void) {
+    return sizeof(Rewind);
+}
+
+// 最早可以回到的周期
+static inline uint64_t rewind_oldest(const Rewind *r) {
+    return r->slots[(r->head - r->count + 1 + REWIND_SLOTS) % REWIND_SLOTS].cycle;
+}
+
+// 推进一个周期; 距上一份快照满 K 个周期时存一份
+static inline void rewind_step(Rewind *r, Cpu_core *c) {
+    cpu_step(c);
+    if (c->cycle_count - r->slots[r->head].cycle < r->interval) return;
+    r->head = (r->head + 1) % REWIND_SLOTS;
+    if (r->count < REWIND_SLOTS) r->count++;
+    rewind_snap_take_(&r->slots[r->head], c);
+}
+
+/**
+ * 回到第 cycle 个周期: 恢复不晚于它的最近快照并重放
+ * 比它新的快照丢弃 (回去之后调用者可能改动状态, 之后的历史不再可信)
+ * 返回重放的周期数; cycle 比最早的快照还早或比当前还晚时返回 -1, c 不变
+ */
+static inline int64_t rewind_to(Rewind *r, Cpu_core *c, const uint64_t cycle) {
+    if (cycle > c->cycle_count || cycle < rewind_oldest(r)) return -1;
+    if (cycle == c->cycle_count) return 0;
+    while (r->slots[r->head].cycle > cycle) {
+        r->head = (r->head - 1 + REWIND_SLOTS) % REWIND_SLOTS;
+        r->count--;
+    }
+    rewind_snap_restore_(&r->slots[r->head], c);
+    const uint64_t n = cycle - c->cycle_count;
+    for (uint64_t i = 0; i < n; i++) {
+        cpu_cycle(c);
+        c->cycle_count++;
+        PERF_CYCLE(c);
+    }
+    r->replayed += n;
+    return (int64_t) n;
+}
+
+// 后退 n 个周期
+static inline int64_t rewind_back(Rewind *r, Cpu_core *c, const uint64_t n) {
+    if (n > c->cycle_count) return -1;
+    return rewind_to(r, c, c->cycle_count - n);
+}
+
+#endif //SCCPU_REWIND_H
@@ -0,0 +1,57 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_SPIN_BARRIER_H
+#define SCCPU_SPIN_BARRIER_H
+#include "sched.h"
+#include "stdatomic.h"
+
+// 自旋这么多次还没等到就让出 CPU (线程数多于核数时不至于空转一个时间片)
+#define SPIN_BARRIER_SPINS 1024
+
+typedef struct spin_barrier {
+    atomic_uint count;
+    atomic_uint sense;
+    unsigned n;
+} Spin_barrier;
+
+static inline void spin_barrier_init(Spin_barrier *b, const unsigned n) {
+    atomic_store(&b->count, 0);
+    atomic_store(&b->sense, 0);
+    b->n = n;
+}
+
+// 翻转式屏障: 最后一个到达的线程清零计数并翻转 sense; local_sense 是每个线程自己的
+static inline void spin_barrier_wait(Spin_barrier *b, unsigned *local_sense) {
+    const unsigned s = *local_sense ^ 1u;
+    *local_sense = s;
+    if (atomic_fetch_add_explicit(&b->count, 1, memory_order_acq_rel) + 1 == b->n) {
+        atomic_store_explicit(&b->count, 0, memory_order_relaxed);
+        atomic_store_explicit(&b->sense, s, memory_order_release);
+        return;
+    }
+    for (int spins = 0; atomic_load_explicit(&b->sense, memory_order_acquire) != s;) {
+        if (++spins >= SPIN_BARRIER_SPINS) {
+            spins = 0;
+            sched_yield();
+        }
+    }
+}
+
+// 替一个不会再来的参与者到达, 不等待; 它不能是本轮最后一个 (调用者自己随后还要 spin_barrier_wait)
+static inline void spin_barrier_arrive(Spin_barrier *b) {
+    atomic_fetch_add_explicit(&b->count, 1, memory_order_acq_rel);
+}
+
+// 等 flag 变成 want (单个生产者发布, 例如 EX 算完的周期号)
+static inline void spin_wait_until(atomic_ulong *flag, const unsigned long want) {
+    for (int spins = 0; atomic_load_explicit(flag, memory_order_acquire) != want;) {
+        if (++spins >= SPIN_BARRIER_SPINS) {
+            spins = 0;
+            sched_yield();
+        }
+    }
+}
+
+#endif //SCCPU_SPIN_BARRIER_H
@@ -0,0 +1,180 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_TRACE_H
+#define SCCPU_TRACE_H
+#include "stdio.h"
+#include "cpu_core.h"
+
+/**
+ * 结构化跟踪: 每个周期按类别 (IF / ID / EX / MEM / 寄存器堆 / hazard 导线) 记下 cpu_dump 会打印的那些值,
+ * 每个类别一条定长的二进制事件, 写进固定大小的环形缓冲; 只有需要时 (比如出错时的最后 N 个周期) 才格式化成文本
+ * 文本格式就是 cpu_dump 的格式, cpu_dump 本身也是 "采一个周期的全部类别 + 格式化"
+ *
+ * SCCPU_TRACE 决定 cpu_step 是否自动记录以及记录哪些类别 (见 common.h), 为 0 时 TRACE_CYCLE 什么都不生成;
+ * 自动记录写进各自 Cpu_core 的 trace 字段, 多个核 (batch 的各个线程) 互不干扰;
+ * trace_record 等函数在任何配置下都能对自己的 Trace_ring 直接调用
+ * 类别 / 事件 / Trace_ring 的定义在 cpu_core.h (Cpu_core 要内嵌一个环)
+ */
+// 采一个类别的值
+static inline void trace_capture_(const Cpu_core *c, const Trace_cat cat, Trace_ev *e) {
+    e->cycle = c->cycle_count;
+    e->cat = cat;
+    e->v[0] = e->v[1] = e->v[2] = e->v[3] = 0;
+    switch (cat) {
+        case TRACE_CAT_IF:
+            e->v[0] = reg32_read_u32_(&c->pc.reg32);
+            e->v[1] = reg32_read_u32_(&c->if_id.instr);
+            break;
+        case TRACE_CAT_ID:
+            e->v[0] = reg11_read_u32_(&c->id_ex.decode_signals) | reg2_read_u32_(&c->id_ex.rs_idx) << 11
+                      | reg2_read_u32_(&c->id_ex.rt_idx) << 13 | reg2_read_u32_(&c->id_ex.rd_idx) << 15;
+            e->v[1] = reg32_read_u32_(&c->id_ex.read_data1);
+            e->v[2] = reg32_read_u32_(&c->id_ex.read_data2);
+            e->v[3] = reg32_read_u32_(&c->id_ex.imm_ext);
+            break;
+        case TRACE_CAT_EX:
+            for (int i = 0; i < 2; i++) {
+                e->v[0] |= (uint32_t) LANE_GET(GET_BIT_OF_REGN(&c->ex_mem.mem_single, i), 0) << i
+                        | (uint32_t) LANE_GET(GET_BIT_OF_REGN(&c->ex_mem.wb_single, i), 0) << (2 + i)
+                        | (uint32_t) LANE_GET(GET_BIT_OF_REGN(&c->ex_mem.write_reg_idx, i), 0) << (4 + i);
+            }
+            e->v[1] = reg32_read_u32_(&c->ex_mem.alu_result);
+            e->v[2] = reg32_read_u32_(&c->ex_mem.write_data);
+            break;
+        case TRACE_CAT_MEM:
+            for (int i = 0; i < 2; i++) {
+                e->v[0] |= (uint32_t) LANE_GET(GET_BIT_OF_REGN(&c->mem_wb.wb_single, i), 0) << i
+                        | (uint32_t) LANE_GET(GET_BIT_OF_REGN(&c->mem_wb.write_reg_idx, i), 0) << (2 + i);
+            }
+            e->v[1] = reg32_read_u32_(&c->mem_wb.mem_read_data);
+            e->v[2] = reg32_read_u32_(&c->mem_wb.alu_result);
+            break;
+        case TRACE_CAT_REGS:
+            e->v[0] = reg32_read_u32_(&c->rf.r0);
+            e->v[1] = reg32_read_u32_(&c->rf.r1);
+            e->v[2] = reg32_read_u32_(&c->rf.r2);
+            e->v[3] = reg32_read_u32_(&c->rf.r3);
+            break;
+        case TRACE_CAT_HAZARD:
+            e->v[0] = (uint32_t) LANE_GET(c->wire_pc_src[0], 0) | (uint32_t) LANE_GET(c->wire_pc_src[1], 0) << 1
+                      | (uint32_t) LANE_GET(c->wire_if_id_ctrl.pc_write, 0) << 2
+                      | (uint32_t) LANE_GET(c->wire_if_id_ctrl.if_id_write, 0) << 3
+                      | (uint32_t) LANE_GET(c->wire_if_id_ctrl.if_id_flush, 0) << 4
+                      | (uint32_t) LANE_GET(c->wire_id_ex_ctrl.id_ex_write, 0) << 5
+                      | (uint32_t) LANE_GET(c->wire_id_ex_ctrl.id_ex_flush, 0) << 6;
+            e->v[1] = u32_from_word(c->wire_branch_target);
+            break;
+        default:
+            break;
+    }
+}
+
+#define TRACE_B_(x, i) ((int) (((x) >> (i)) & 1u))
+
+// 一个周期的事件按 cpu_dump 的格式打印; 缺的类别不打印; 返回写出的字符数
+static inline int trace_print_cycle_(FILE *f, const uint64_t cycle, const Trace_ev *ev, const int n) {
+    const Trace_ev *by_cat[TRACE_CAT_NUM] = {0};
+    for (int i = 0; i < n; i++) by_cat[ev[i].cat] = &ev[i];
+    int w = fprintf(f,
+                    "\n================================================CpuCoreDump================================================\n");
+    w += fprintf(f, "\n=======Cycle %lu=======\n", cycle);
+    const Trace_ev *e;
+    if ((e = by_cat[TRACE_CAT_IF])) w += fprintf(f, "[IF] PC:0x%08X | Instr:0x%08X \n", e->v[0], e->v[1]);
+    if ((e = by_cat[TRACE_CAT_ID])) {
+        // decode_signals 按原来 32 位寄存器的布局 (bit31..bit21) 打印
+        char buffer[1024];
+        dis_asm((e->v[0] & 0x7FFu) << (WORD_SIZE - 11), buffer);
+        w += fprintf(f,
+                "[ID] Signals:%s\n"
+                "     ReadData1:0x%08X, ReadData2:0x%08X, ImmExt:0x%08X, RsIdx:0x%04X, RtIdx:0x%04X, RdIdx:0x%04X\n",
+                buffer, e->v[1], e->v[2], e->v[3], e->v[0] >> 11 & 3u, e->v[0] >> 13 & 3u, e->v[0] >> 15 & 3u);
+    }
+    if ((e = by_cat[TRACE_CAT_EX])) {
+        w += fprintf(f,
+                "[EX] MemSingle-Read:%d, MemSingle-Write:%d, WbSingle-RegWrite:%d, WbSingle-DataSrcToReg:%d, AluResult:0x%08X, WriteData:0x%08X, WriteRegIdx:%d%d\n",
+                TRACE_B_(e->v[0], 1), TRACE_B_(e->v[0], 0), TRACE_B_(e->v[0], 3), TRACE_B_(e->v[0], 2), e->v[1],
+                e->v[2], TRACE_B_(e->v[0], 4), TRACE_B_(e->v[0], 5));
+    }
+    if ((e = by_cat[TRACE_CAT_MEM])) {
+        w += fprintf(f,
+                "[MEM] WbSingle-RegWrite:%d, WbSingle-DataSrcToReg:%d, Mem-Read-Data:0x%08X, AluResult:0x%08X, WriteRegIdx:%d%d\n",
+                TRACE_B_(e->v[0], 1), TRACE_B_(e->v[0], 0), e->v[1], e->v[2], TRACE_B_(e->v[0], 2),
+                TRACE_B_(e->v[0], 3));
+    }
+    if ((e = by_cat[TRACE_CAT_REGS])) {
+        w += fprintf(f, "[General-Purpose-Register Dump]:\n");
+        for (int r = 0; r < 4; r++) w += fprintf(f, "                                R%d:0x%08X\n", r, e->v[r]);
+    }
+    if ((e = by_cat[TRACE_CAT_HAZARD])) {
+        w += fprintf(f, "[Wires/Glue-Logic]:\n");
+        w += fprintf(f, "                                Pc-ops:%d%d\n", TRACE_B_(e->v[0], 0), TRACE_B_(e->v[0], 1));
+        w += fprintf(f, "                                Wire_branch_target:0x%08X\n", e->v[1]);
+        w += fprintf(f, "[Hazard]:\n");
+        w += fprintf(f, "                                Wire-if-id-ctrl: Pc-Write:%d, If-id-write:%d, If-id-flush:%d\n",
+                TRACE_B_(e->v[0], 2), TRACE_B_(e->v[0], 3), TRACE_B_(e->v[0], 4));
+        w += fprintf(f, "                                Wire-id-ex-ctrl: Id-ex-write:%d, Id-ex-flush:%d\n",
+                TRACE_B_(e->v[0], 5), TRACE_B_(e->v[0], 6));
+    }
+    return w;
+}
+
+// 记下当前周期 cats 里的类别 (再与 t->cats 相与)
+static inline void trace_record(Trace_ring *t, const Cpu_core *c, const uint32_t cats) {
+    const uint32_t m = cats & t->cats;
+    for (int k = 0; k < TRACE_CAT_NUM; k++) {
+        if (m & TRACE_MASK(k)) trace_capture_(c, (Trace_cat) k, &t->ev[t->head++ & (SCCPU_TRACE_EVENTS - 1)]);
+    }
+}
+
+// 环里还留着的事件数
+static inline uint64_t trace_count(const Trace_ring *t) {
+    return t->head < SCCPU_TRACE_EVENTS ? t->head : SCCPU_TRACE_EVENTS;
+}
+
+// 格式化最后 n_cycles 个周期 (只算环里还有的); 返回打印的周期数
+static inline int trace_print_last(const Trace_ring *t, FILE *f, const int n_cycles) {
+    const uint64_t first = t->head - trace_count(t);
+    uint64_t i = t->head;
+    int cycles = 0;
+    // 往回找到第 n_cycles 个不同的周期的开头
+    while (i > first && cycles < n_cycles) {
+        const uint64_t cyc = t->ev[(i - 1) & (SCCPU_TRACE_EVENTS - 1)].cycle;
+        while (i > first && t->ev[(i - 1) & (SCCPU_TRACE_EVENTS - 1)].cycle == cyc) i--;
+        cycles++;
+    }
+    // 最老的那个周期可能被覆盖了一部分, 照样打印剩下的类别
+    Trace_ev group[TRACE_CAT_NUM];
+    while (i < t->head) {
+        int n = 0;
+        const uint64_t cyc = t->ev[i & (SCCPU_TRACE_EVENTS - 1)].cycle;
+        while (i < t->head && t->ev[i & (SCCPU_TRACE_EVENTS - 1)].cycle == cyc && n < TRACE_CAT_NUM) {
+            group[n++] = t->ev[i++ & (SCCPU_TRACE_EVENTS - 1)];
+        }
+        trace_print_cycle_(f, cyc, group, n);
+    }
+    return cycles;
+}
+
+static inline
+void cpu_dump(const Cpu_core *c) {
+    // lane 模式下打印的是 lane 0
+    Trace_ev ev[TRACE_CAT_NUM];
+    for (int k = 0; k < TRACE_CAT_NUM; k++) trace_capture_(c, (Trace_cat) k, &ev[k]);
+    trace_print_cycle_(stdout, c->cycle_count, ev, TRACE_CAT_NUM);
+}
+
+#if SCCPU_TRACE
+// cpu_step 每个周期记进这个核自己的环
+static inline void trace_cycle(Cpu_core *c) {
+    trace_record(&c->trace, c, SCCPU_TRACE >= 2 ? TRACE_CATS_ALL : TRACE_CATS_SUMMARY);
+}
+
+// 出错时打印 c 的最后 n 个周期
+static inline void trace_dump_last(const Cpu_core *c, const int n_cycles) {
+    trace_print_last(&c->trace, stdout, n_cycles);
+}
+#endif
+
+#endif //SCCPU_TRACE_H
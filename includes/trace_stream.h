@@ -0,0 +1,261 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_TRACE_STREAM_H
+#define SCCPU_TRACE_STREAM_H
+#include "stdio.h"
+#include "pthread.h"
+#include "trace.h"
+
+/**
+ * 流式跟踪: 每个周期的全部 (或选定类别的) 跟踪值写到文件, 供百万周期级的运行事后查看
+ * 文件: 8 字节头 "SCTS" + 版本 + 类别掩码 + 2 字节保留, 之后每个周期一条记录:
+ *   varint(周期号 - 上一条的周期号)  varint(变化掩码)  每个变化的字段: varint(zigzag(新值 - 旧值))
+ * 字段 k = cat * 4 + i 是 Trace_ev.v[i]; 没变的字段不写, 旧值从全 0 开始
+ * 模拟线程只往当前缓冲里编码; 缓冲满了交给后台写线程 fwrite, 换另一块接着写 (双缓冲)
+ * 只有两块都满 (磁盘跟不上) 时才等, 次数记在 waits
+ */
+#define TRACE_STREAM_VERSION 1u
+#define TRACE_STREAM_FIELDS (TRACE_CAT_NUM * 4)
+#define TRACE_STREAM_MAX_REC (10 + 5 + TRACE_STREAM_FIELDS * 5) // 一条记录的最大字节数
+
+#ifndef SCCPU_TRACE_STREAM_BUF
+#define SCCPU_TRACE_STREAM_BUF (1 << 16)
+#endif
+
+// 每个类别用到 v[] 的前几个
+static const int TRACE_CAT_FIELDS_[TRACE_CAT_NUM] = {2, 4, 3, 3, 4, 2};
+
+static const char *const TRACE_FIELD_NAMES_[TRACE_STREAM_FIELDS] = {
+    "if_pc", "if_instr", NULL, NULL,
+    "id_ctrl", "id_rd1", "id_rd2", "id_imm",
+    "ex_ctrl", "ex_alu", "ex_wdata", NULL,
+    "mem_ctrl", "mem_rdata", "mem_alu", NULL,
+    "r0", "r1", "r2", "r3",
+    "hz_ctrl", "hz_branch_target", NULL, NULL
+};
+
+typedef struct trace_stream {
+    FILE *f;
+    uint32_t cats;
+    uint8_t buf[2][SCCPU_TRACE_STREAM_BUF];
+    size_t len[2];
+    int cur; // 模拟线程正在填的缓冲
+    int pending; // 交给写线程还没写完的缓冲, -1 -> 没有
+    int stop;
+    int io_error;
+    pthread_t tid;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    uint32_t prev[TRACE_STREAM_FIELDS];
+    uint64_t prev_cycle;
+    uint64_t cycles; // 写了几条记录
+    uint64_t bytes; // 文件大小 (含头)
+    uint64_t waits; // 模拟线程等写线程的次数
+} Trace_stream;
+
+static inline uint8_t *trace_put_varint_(uint8_t *p, uint64_t x) {
+    while (x >= 0x80) {
+        *p++ = (uint8_t) (x | 0x80);
+        x >>= 7;
+    }
+    *p++ = (uint8_t) x;
+    return p;
+}
+
+static inline uint32_t trace_zigzag_(const uint32_t delta) {
+    return delta << 1 ^ (uint32_t) -(int32_t) (delta >> 31);
+}
+
+static inline uint32_t trace_unzigzag_(const uint32_t z) {
+    return z >> 1 ^ (uint32_t) -(int32_t) (z & 1);
+}
+
+static inline void *trace_stream_writer_(void *arg) {
+    Trace_stream *s = arg;
+    pthread_mutex_lock(&s->mu);
+    for (;;) {
+        while (s->pending < 0 && !s->stop) pthread_cond_wait(&s->cv, &s->mu);
+        if (s->pending < 0) break;
+        const int b = s->pending;
+        pthread_mutex_unlock(&s->mu);
+        const int bad = fwrite(s->buf[b], 1, s->len[b], s->f) != s->len[b];
+        pthread_mutex_lock(&s->mu);
+        s->io_error |= bad;
+        s->pending = -1;
+        pthread_cond_broadcast(&s->cv);
+    }
+    pthread_mutex_unlock(&s->mu);
+    return NULL;
+}
+
+// 当前缓冲交给写线程, 换另一块
+static inline void trace_stream_swap_(Trace_stream *s) {
+    pthread_mutex_lock(&s->mu);
+    if (s->pending >= 0) s->waits++;
+    while (s->pending >= 0) pthread_cond_wait(&s->cv, &s->mu);
+    s->pending = s->cur;
+    pthread_cond_broadcast(&s->cv);
+    pthread_mutex_unlock(&s->mu);
+    s->cur ^= 1;
+    s->len[s->cur] = 0;
+}
+
+// 打开文件写头并启动写线程; 只记录 cats 里的类别 (不能为空); 失败返回 -1
+static inline int trace_stream_open(Trace_stream *s, const char *path, const uint32_t cats) {
+    if (!(cats & TRACE_CATS_ALL)) return -1;
+    memset(s->len, 0, sizeof(s->len));
+    memset(s->prev, 0, sizeof(s->prev));
+    s->cats = cats & TRACE_CATS_ALL;
+    s->cur = 0;
+    s->pending = -1;
+    s->stop = s->io_error = 0;
+    s->prev_cycle = s->cycles = s->waits = 0;
+    s->f = fopen(path, "wb");
+    if (!s->f) return -1;
+    const uint8_t head[8] = {'S', 'C', 'T', 'S', TRACE_STREAM_VERSION, (uint8_t) s->cats, 0, 0};
+    memcpy(s->buf[0], head, sizeof(head));
+    s->len[0] = s->bytes = sizeof(head);
+    pthread_mutex_init(&s->mu, NULL);
+    pthread_cond_init(&s->cv, NULL);
+    if (pthread_create(&s->tid, NULL, trace_stream_writer_, s) != 0) {
+        pthread_mutex_destroy(&s->mu);
+        pthread_cond_destroy(&s->cv);
+        fclose(s->f);
+        return -1;
+    }
+    return 0;
+}
+
+// 记录当前周期 (在 cpu_step 之后调用)
+static inline void trace_stream_cycle(Trace_stream *s, const Cpu_core *c) {
+    if (s->len[s->cur] + TRACE_STREAM_MAX_REC > SCCPU_TRACE_STREAM_BUF) trace_stream_swap_(s);
+    uint32_t vals[TRACE_STREAM_FIELDS], mask = 0;
+    Trace_ev e;
+    for (int k = 0; k < TRACE_CAT_NUM; k++) {
+        if (!(s->cats & TRACE_MASK(k))) continue;
+        trace_capture_(c, (Trace_cat) k, &e);
+        for (int i = 0; i < TRACE_CAT_FIELDS_[k]; i++) {
+            vals[k * 4 + i] = e.v[i];
+            if (e.v[i] != s->prev[k * 4 + i]) mask |= 1u << (k * 4 + i);
+        }
+    }
+    uint8_t *start = s->buf[s->cur] + s->len[s->cur];
+    uint8_t *p = trace_put_varint_(start, c->cycle_count - s->prev_cycle);
+    p = trace_put_varint_(p, mask);
+    for (int k = 0; k < TRACE_STREAM_FIELDS; k++) {
+        if (!(mask >> k & 1u)) continue;
+        p = trace_put_varint_(p, trace_zigzag_(vals[k] - s->prev[k]));
+        s->prev[k] = vals[k];
+    }
+    s->prev_cycle = c->cycle_count;
+    s->len[s->cur] += (size_t) (p - start);
+    s->bytes += (uint64_t) (p - start);
+    s->cycles++;
+}
+
+// 写完剩下的, 停掉写线程并关闭文件; 有写错误返回 -1
+static inline int trace_stream_close(Trace_stream *s) {
+    if (s->len[s->cur] > 0) trace_stream_swap_(s);
+    pthread_mutex_lock(&s->mu);
+    s->stop = 1;
+    pthread_cond_broadcast(&s->cv);
+    pthread_mutex_unlock(&s->mu);
+    pthread_join(s->tid, NULL);
+    pthread_mutex_destroy(&s->mu);
+    pthread_cond_destroy(&s->cv);
+    const int bad = fclose(s->f) != 0;
+    return s->io_error || bad ? -1 : 0;
+}
+
+typedef struct trace_stream_reader {
+    FILE *f;
+    uint32_t cats;
+    uint32_t prev[TRACE_STREAM_FIELDS];
+    uint64_t cycle;
+    uint64_t bytes; // 已读的字节数 (含头)
+} Trace_stream_reader;
+
+// 读一个 varint; 在它之前文件就结束了返回 1, 读到一半结束或格式错返回 -1
+static inline int trace_get_varint_(Trace_stream_reader *r, uint64_t *x) {
+    *x = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int ch = fgetc(r->f);
+        if (ch == EOF) return shift == 0 ? 1 : -1;
+        r->bytes++;
+        *x |= (uint64_t) (ch & 0x7F) << shift;
+        if (!(ch & 0x80)) return 0;
+    }
+    return -1;
+}
+
+// 打开并检查文件头; 打不开 / 不是跟踪流 / 版本不对返回 -1
+static inline int trace_stream_read_open(Trace_stream_reader *r, const char *path) {
+    uint8_t head[8];
+    memset(r, 0, sizeof(Trace_stream_reader));
+    r->f = fopen(path, "rb");
+    if (!r->f) return -1;
+    if (fread(head, 1, sizeof(head), r->f) != sizeof(head) || memcmp(head, "SCTS", 4) != 0
+        || head[4] != TRACE_STREAM_VERSION || !head[5] || (head[5] & ~TRACE_CATS_ALL)) {
+        fclose(r->f);
+        r->f = NULL;
+        return -1;
+    }
+    r->cats = head[5];
+    r->bytes = sizeof(head);
+    return 0;
+}
+
+// 解出下一个周期的事件 (每个记录的类别一条), 返回事件数; 读完返回 0, 截断 / 格式错返回 -1
+static inline int trace_stream_read(Trace_stream_reader *r, Trace_ev ev[TRACE_CAT_NUM]) {
+    uint64_t dc, mask, z;
+    const int end = trace_get_varint_(r, &dc);
+    if (end != 0) return end > 0 ? 0 : -1;
+    if (trace_get_varint_(r, &mask) != 0) return -1;
+    uint64_t allowed = 0;
+    for (int k = 0; k < TRACE_CAT_NUM; k++) {
+        if (r->cats & TRACE_MASK(k)) allowed |= ((1ull << TRACE_CAT_FIELDS_[k]) - 1) << (k * 4);
+    }
+    if (mask & ~allowed) return -1;
+    for (int k = 0; k < TRACE_STREAM_FIELDS; k++) {
+        if (!(mask >> k & 1u)) continue;
+        if (trace_get_varint_(r, &z) != 0 || z > UINT32_MAX) return -1;
+        r->prev[k] += trace_unzigzag_((uint32_t) z);
+    }
+    r->cycle += dc;
+    int n = 0;
+    for (int k = 0; k < TRACE_CAT_NUM; k++) {
+        if (!(r->cats & TRACE_MASK(k))) continue;
+        ev[n].cycle = r->cycle;
+        ev[n].cat = (uint32_t) k;
+        for (int i = 0; i < 4; i++) ev[n].v[i] = r->prev[k * 4 + i];
+        n++;
+    }
+    return n;
+}
+
+static inline void trace_stream_read_close(Trace_stream_reader *r) {
+    if (r->f) fclose(r->f);
+    r->f = NULL;
+}
+
+// CSV: 表头
+static inline void trace_csv_header(FILE *f, const uint32_t cats) {
+    fprintf(f, "cycle");
+    for (int k = 0; k < TRACE_STREAM_FIELDS; k++) {
+        if (cats & TRACE_MASK(k / 4) && TRACE_FIELD_NAMES_[k]) fprintf(f, ",%s", TRACE_FIELD_NAMES_[k]);
+    }
+    fprintf(f, "\n");
+}
+
+// CSV: 一个周期一行, 字段都是十六进制
+static inline void trace_csv_row(FILE *f, const Trace_ev *ev, const int n) {
+    fprintf(f, "%lu", ev[0].cycle);
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < TRACE_CAT_FIELDS_[ev[j].cat]; i++) fprintf(f, ",0x%08X", ev[j].v[i]);
+    }
+    fprintf(f, "\n");
+}
+
+#endif //SCCPU_TRACE_STREAM_H
@@ -14,18 +14,22 @@
 static inline void word_lshift2(const word in, word out) {
     // out = in << 2（按你 word[0]=MSB 的约定）
     // 逻辑 bit n(31..0) -> 存储 index = 31-n
+#if SCCPU_PACKED_WORD
+    out[0] = in[0] << 2;
+#else
     for (int n = 31; n >= 2; --n) {
         out[INST_WORD(n)] = in[INST_WORD(n - 2)];
     }
-    out[INST_WORD(1)] = 0;
-    out[INST_WORD(0)] = 0;
+    out[INST_WORD(1)] = BIT_0;
+    out[INST_WORD(0)] = BIT_0;
+#endif
 }
 
 static inline
 uint8_t u8_from_byte(const byte b) {
     uint8_t v = 0;
     for (int i = 0; i < BYTE_SIZE; i++) {
-        if (b[i]) {
+        if (LANE_GET(b[i], 0)) {
             v |= (uint8_t) (1u << (BYTE_SIZE - 1 - i));
         }
     }
@@ -35,43 +39,77 @@ uint8_t u8_from_byte(const byte b) {
 
 static inline
 void u32_from_4byte(const word w, uint8_t *ret) {
+#if SCCPU_PACKED_WORD
+    for (int i = 0; i < 4; i++) {
+        ret[i] = (uint8_t) (w[0] >> (24 - 8 * i));
+    }
+#else
     for (int i = 0; i < 4; i++) {
         int v = 0;
         for (int j = 0; j < BYTE_SIZE; j++) {
-            if (w[i * BYTE_SIZE + j]) {
+            if (LANE_GET(w[i * BYTE_SIZE + j], 0)) {
                 v |= (uint8_t) (1u << (BYTE_SIZE - 1 - j));
             }
         }
         ret[i] = v;
     }
+#endif
 }
 
 
 static inline
 void connect(const word src, word dest) {
+#if SCCPU_PACKED_WORD
+    dest[0] = src[0];
+#else
     for (int i = 0; i < WORD_SIZE; i++) {
         dest[i] = src[i];
     }
+#endif
 }
 
 static inline
 uint32_t u32_from_word(const word b) {
+#if SCCPU_PACKED_WORD
+    return b[0];
+#else
     uint32_t v = 0;
     for (int i = 0; i < WORD_SIZE; i++) {
-        if (b[i]) {
+        if (LANE_GET(b[i], 0)) {
             v |= (uint32_t) (1u << (WORD_SIZE - 1 - i));
         }
     }
     return v;
+#endif
+}
+
+#if SCCPU_LANES > 1
+// bit-sliced: 一根 32 位总线上同时跑着 SCCPU_LANES 个 CPU 的值
+// u32_from_word 读的是 lane 0, 下面两个函数按 lane 取/放
+static inline
+uint32_t u32_from_word_lane(const word b, const int lane) {
+    uint32_t v = 0;
+    for (int i = 0; i < WORD_SIZE; i++) {
+        v |= (uint32_t) LANE_GET(b[i], lane) << (WORD_SIZE - 1 - i);
+    }
+    return v;
+}
+
+static inline
+void word_put_lane_u32(word w, const int lane, const uint32_t v) {
+    for (int i = 0; i < WORD_SIZE; i++) {
+        LANE_PUT(w[i], lane, v >> (WORD_SIZE - 1 - i));
+    }
 }
+#endif
 
 static inline
 bit word_is_zero(const word b) {
-    bit mask = 0;
+    bit mask = BIT_0;
     for (int i = 0; i < BYTE_SIZE; i++) {
-        mask |= b[i];
+        mask = OR(mask, WORD_GET(b, i));
     }
-    return !mask;
+    return NOT(mask);
 }
 
 static inline
@@ -157,20 +195,28 @@ static inline uint32_t enc_j(uint8_t opcode, uint32_t address) {
 // --------------------- Helpers: u32 <-> word ---------------------
 // word: MSB first: word[0]=bit31 ... word[31]=bit0
 static void u32_to_word(uint32_t v, word w) {
-    for (int i = 0; i < 32; i++) w[i] = (v >> (31 - i)) & 1u;
+#if SCCPU_PACKED_WORD
+    w[0] = v;
+#else
+    for (int i = 0; i < 32; i++) w[i] = ((v >> (31 - i)) & 1u) ? BIT_1 : BIT_0;
+#endif
 }
 static uint32_t word_to_u32(const word w) {
+#if SCCPU_PACKED_WORD
+    return w[0];
+#else
     uint32_t v = 0;
-    for (int i = 0; i < 32; i++) if (w[i]) v |= (1u << (31 - i));
+    for (int i = 0; i < 32; i++) if (LANE_GET(w[i], 0)) v |= (1u << (31 - i));
     return v;
+#endif
 }
 
 static void mask_from_u4(uint32_t m, bit be[4]) {
     // be[0] controls highest byte, be[3] controls lowest byte
-    be[0] = (m >> 3) & 1u;
-    be[1] = (m >> 2) & 1u;
-    be[2] = (m >> 1) & 1u;
-    be[3] = (m >> 0) & 1u;
+    be[0] = ((m >> 3) & 1u) ? BIT_1 : BIT_0;
+    be[1] = ((m >> 2) & 1u) ? BIT_1 : BIT_0;
+    be[2] = ((m >> 1) & 1u) ? BIT_1 : BIT_0;
+    be[3] = ((m >> 0) & 1u) ? BIT_1 : BIT_0;
 }
 
 static inline void dis_asm(const uint32_t inst, char *buffer) {
@@ -0,0 +1,145 @@
+//
+// Created by wenshen on 2026/10/17.
+//
+
+#ifndef SCCPU_VCD_H
+#define SCCPU_VCD_H
+#include "stdio.h"
+#include "netlist_cpu.h"
+
+/**
+ * VCD 波形: NL_CPU_REGS_ 里每个寄存器的 Q 和 NL_CPU_WIRES_ 里每根 wire_* 都是一个具名信号, 可以用 GTKWave 打开
+ * 层次: cpu.pc / cpu.if_id / cpu.id_ex / cpu.ex_mem / cpu.mem_wb / cpu.rf 是寄存器,
+ *       cpu.wires.<pc_src, branch_target, if_id_ctrl, id_ex_ctrl, wb, mem, ex, id, if> 是导线 (去掉 wire_ 前缀)
+ * 时间单位是周期 (#n = cycle_count 为 n 时的值); 每次 vcd_sample 只写变了的信号, 整个周期都没变就连 #n 也不写
+ * 只导出当前周期模式真正驱动的导线: 默认的两遍求值不写各阶段的 wire_*, 只有 pc_src / branch_target / 两组冒险控制
+ */
+#if SCCPU_LANES != 1 || SCCPU_NETLIST
+#error "vcd.h samples a single Cpu_core (SCCPU_LANES=1, no SCCPU_NETLIST)"
+#endif
+
+#if SCCPU_TICK_SINGLE_EVAL || SCCPU_ACTIVITY_SKIP || SCCPU_STAGE_THREADS
+#define VCD_WIRES NL_CPU_WIRE_NUM
+#else
+#define VCD_WIRES NL_CPU_GLUE_WIRE_NUM
+#endif
+#define VCD_SIGNALS (NL_CPU_REG_NUM + VCD_WIRES)
+
+typedef struct vcd {
+    FILE *f;
+    uint32_t last[VCD_SIGNALS]; // 上次写出的值
+    int started; // 已经写过 $dumpvars
+    uint64_t last_cycle;
+    uint64_t samples;
+    uint64_t changes; // 写出的值变化数 (含 $dumpvars 里的初值)
+} Vcd;
+
+// 第 k 个信号: Cpu_core 里的偏移, 宽度, 完整名字 ("if_id.instr" / "wire_if_id_ctrl.pc_write")
+static inline const void *vcd_field_(const Cpu_core *c, const int k, int *width, const char **name) {
+    if (k < NL_CPU_REG_NUM) {
+        *width = NL_CPU_REGS_[k].width;
+        *name = NL_CPU_REGS_[k].name;
+        return (const char *) c + NL_CPU_REGS_[k].q;
+    }
+    const Nl_cpu_wire *w = &NL_CPU_WIRES_[k - NL_CPU_REG_NUM];
+    *width = w->width;
+    *name = w->name;
+    return (const char *) c + w->off;
+}
+
+// 信号标识: '!'..'~' 的 94 进制
+static inline void vcd_id_(char *out, int k) {
+    do {
+        *out++ = (char) ('!' + k % 94);
+        k /= 94;
+    } while (k);
+    *out = 0;
+}
+
+// 一行 "0!" 或 "b101 id"; 拼好了一次 fwrite, 比 fprintf 快得多
+static inline void vcd_put_value_(FILE *f, const int k, const int width, const uint32_t v) {
+    char line[WORD_SIZE + 8];
+    int n = 0;
+    if (width == 1) {
+        line[n++] = (char) ('0' + (v & 1u));
+    } else {
+        line[n++] = 'b';
+        for (int i = width - 1; i >= 0; i--) {
+            if (n > 1 || v >> i & 1u || i == 0) line[n++] = (char) ('0' + (v >> i & 1u)); // 高位的 0 省略
+        }
+        line[n++] = ' ';
+    }
+    vcd_id_(line + n, k);
+    n += (int) strlen(line + n);
+    line[n++] = '\n';
+    fwrite(line, 1, (size_t) n, f);
+}
+
+// 写文件头和变量定义; 失败返回 -1
+static inline int vcd_open(Vcd *v, const char *path) {
+    memset(v, 0, sizeof(Vcd));
+    v->f = fopen(path, "w");
+    if (!v->f) return -1;
+    FILE *f = v->f;
+    fprintf(f, "$version sccpu $end\n$timescale 1ns $end\n$scope module cpu $end\n");
+    char scope[64] = ""; // 当前打开的最内层作用域, "" -> 直接在 cpu 或 cpu.wires 下
+    int in_wires = 0; // 寄存器都排在导线前面
+    for (int k = 0; k < VCD_SIGNALS; k++) {
+        static Cpu_core any;
+        int width;
+        const char *name;
+        vcd_field_(&any, k, &width, &name);
+        const int wire = k >= NL_CPU_REG_NUM;
+        if (wire && strncmp(name, "wire_", 5) == 0) name += 5;
+        const char *dot = strchr(name, '.');
+        char cur[64];
+        snprintf(cur, sizeof(cur), "%.*s", dot ? (int) (dot - name) : 0, name);
+        if (wire != in_wires || strcmp(cur, scope) != 0) {
+            if (scope[0]) fprintf(f, "$upscope $end\n");
+            if (wire && !in_wires) fprintf(f, "$scope module wires $end\n");
+            if (cur[0]) fprintf(f, "$scope module %s $end\n", cur);
+            in_wires = wire;
+            snprintf(scope, sizeof(scope), "%s", cur);
+        }
+        char id[4];
+        vcd_id_(id, k);
+        fprintf(f, "$var %s %d %s %s $end\n", wire ? "wire" : "reg", width, id, dot ? dot + 1 : name);
+    }
+    if (scope[0]) fprintf(f, "$upscope $end\n");
+    if (in_wires) fprintf(f, "$upscope $end\n");
+    fprintf(f, "$upscope $end\n$enddefinitions $end\n");
+    return 0;
+}
+
+// 在 cpu_step 之后调用: 第一次写全部初值, 之后只写变了的信号
+static inline void vcd_sample(Vcd *v, const Cpu_core *c) {
+    int stamped = 0;
+    if (!v->started) fprintf(v->f, "#%lu\n$dumpvars\n", c->cycle_count);
+    for (int k = 0; k < VCD_SIGNALS; k++) {
+        int width;
+        const char *name;
+        const void *field = vcd_field_(c, k, &width, &name);
+        const uint32_t x = nl_cpu_field_get_(field, width);
+        if (v->started && x == v->last[k]) continue;
+        if (v->started && !stamped) {
+            fprintf(v->f, "#%lu\n", c->cycle_count);
+            stamped = 1;
+        }
+        vcd_put_value_(v->f, k, width, x);
+        v->last[k] = x;
+        v->changes++;
+    }
+    if (!v->started) fprintf(v->f, "$end\n");
+    v->started = 1;
+    v->last_cycle = c->cycle_count;
+    v->samples++;
+}
+
+// 写结束时间 (最后一段值在波形里有宽度) 并关闭; 有写错误返回 -1
+static inline int vcd_close(Vcd *v) {
+    if (v->started) fprintf(v->f, "#%lu\n", v->last_cycle + 1);
+    const int bad = ferror(v->f);
+    return fclose(v->f) != 0 || bad ? -1 : 0;
+}
+
+#endif //SCCPU_VCD_H
@@ -48,11 +48,11 @@ int main(void) {
         0, 0, 0
     };
 
-    for (int i = 0; i < sizeof(program) / sizeof(uint32_t); i++) {
-        word w;
-        u32_to_word(program[i], w);
-        memcpy(cpu.im.im[i], w, sizeof(word));
-    }
+    im_load(&cpu.im, program, sizeof(program) / sizeof(uint32_t));
+#if SCCPU_PIPEVIEW
+    static Pipeview pv;
+    if (pipeview_open(&pv, "sccpu.kanata", &cpu) == 0) pipeview_attach(&cpu, &pv);
+#endif
     // 4. 启动时钟 (跑 20 个周期看看)
     for (int cycle = 0; cycle < 20; cycle++) {
         cpu_tick(&cpu);
@@ -60,6 +60,28 @@ int main(void) {
     // 5. 最终检查
     uint32_t r3_val = reg32_read_u32_(&cpu.rf.r3);
     printf("\nFinal Result: R3 = %d (Expected 30)\n", r3_val);
+#if SCCPU_TRACE
+    trace_dump_last(&cpu, 3);
+#endif
+#if SCCPU_PIPEVIEW
+    if (cpu.pipeview) {
+        pipeview_close(&pv);
+        printf("pipeline timeline: sccpu.kanata (%lu fetched, %lu retired, %lu flushed)\n", pv.fetched, pv.retired,
+               pv.flushed);
+    }
+#endif
+#if SCCPU_PERF_COUNTERS
+    perf_report(&cpu, stdout);
+#endif
+#if SCCPU_ACTIVITY_SKIP
+    cpu_activity_report(&cpu);
+#endif
+#if SCCPU_DECODE_CACHE
+    decode_cache_report(&cpu.decode_cache);
+#endif
+#if SCCPU_STAGE_THREADS
+    cpu_stage_threads_stop();
+#endif
 
 
     return 0;
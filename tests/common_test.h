@@ -17,14 +17,15 @@
 #include "../includes/im.h"
 
 // 约定：word[0] 是 MSB，word[31] 是 LSB（与你 INST_BIT/INST_WORD 宏一致）
+// 只通过 WORD_GET / WORD_SET 访问, packed 后端下 word 是 uint32_t[1]
 static inline void word_zero(word w) {
-    for (int i = 0; i < WORD_SIZE; i++) w[i] = 0;
+    for (int i = 0; i < WORD_SIZE; i++) WORD_SET(w, i, BIT_0);
 }
 
 static inline uint32_t u32_from_word_test(const word w) {
     uint32_t v = 0;
     for (int i = 0; i < WORD_SIZE; i++) {
-        if (w[i]) v |= (1u << (WORD_SIZE - 1 - i));
+        if (WORD_GET(w, i)) v |= (1u << (WORD_SIZE - 1 - i));
     }
     return v;
 }
@@ -32,14 +33,14 @@ static inline uint32_t u32_from_word_test(const word w) {
 static inline void word_from_u32(uint32_t v, word w) {
     for (int i = 0; i < WORD_SIZE; ++i) {
         int bit_index = (WORD_SIZE - 1 - i); // i=0->bit31, i=31->bit0
-        w[i] = (v >> bit_index) & 1u;
+        WORD_SET(w, i, (v >> bit_index) & 1u ? BIT_1 : BIT_0);
     }
 }
 
 static inline uint32_t u32_from_word_local(const word w) {
     uint32_t v = 0;
     for (int i = 0; i < WORD_SIZE; ++i) {
-        if (w[i]) {
+        if (WORD_GET(w, i)) {
             v |= (1u << (WORD_SIZE - 1 - i));
         }
     }
@@ -47,7 +48,7 @@ static inline uint32_t u32_from_word_local(const word w) {
 }
 
 static inline void zero_word(word w) {
-    for (int i = 0; i < WORD_SIZE; ++i) w[i] = 0;
+    for (int i = 0; i < WORD_SIZE; ++i) WORD_SET(w, i, BIT_0);
 }
 
 static inline void reg32_write_u32(Reg32_ *r, uint32_t v) {
@@ -64,6 +65,22 @@ static inline uint32_t reg32_read_u32(const Reg32_ *r) {
     return u32_from_word_local(w);
 }
 
+// RegN_ 的数值右对齐: q[N-1] 是 bit 0
+static inline void reg2_write_u32(Reg2_ *r, uint32_t v) {
+    bit din[2] = {(v >> 1) & 1u, v & 1u};
+    bit out[2];
+    reg2_step(r, 1, din, out, 0);
+    reg2_step(r, 1, din, out, 1);
+}
+
+static inline void reg11_write_u32(Reg11_ *r, uint32_t v) {
+    bit din[11];
+    bit out[11];
+    for (int i = 0; i < 11; ++i) din[i] = (v >> (10 - i)) & 1u;
+    reg11_step(r, 1, din, out, 0);
+    reg11_step(r, 1, din, out, 1);
+}
+
 static inline void print_word_hex(const word w) {
     printf("0x%08X", (unsigned) u32_from_word_local(w));
 }
@@ -86,9 +103,12 @@ static inline void read_ifid_pc4_u32(If_id_regs *r, uint32_t *out) {
     *out = u32_from_word_local(w);
 }
 
+#if SCCPU_LANES == 1 && !SCCPU_NETLIST
+// 经 im_store 写入, SCCPU_SHARED_IMAGES 下写时复制
 static inline void im_set_u32(Im_t *im, uint32_t index, uint32_t inst) {
-    word_from_u32(inst, im->im[index]);
+    (void) im_store(im, index, inst);
 }
+#endif
 
 
 static inline bit BITN(const word w, int n) {
@@ -0,0 +1,42 @@
+//
+// Created by wenshen on 2026/10/17.
+// lanes_ref.c
+// test_lanes.c 的标量参考, 必须在 SCCPU_LANES=1 下编译 (见 lanes_ref.h)
+#include "lanes_ref.h"
+#include "../includes/cosim.h"
+#include "../includes/netlist_cpu.h"
+
+static Cpu_core lanes_ref_cpu_[LANES_REF_MAX];
+
+// gap 0..3 轮换: 有冒险的程序两边读到的旧值也应该一样
+void lanes_ref_load(const int k, uint64_t seed, uint32_t *prog, const size_t n_prog, uint8_t *dm, const size_t n_dm) {
+    Cpu_core *c = &lanes_ref_cpu_[k];
+    const int gap = k % 4;
+    memset(prog, 0, n_prog * sizeof(uint32_t));
+    cosim_random_program(prog, (int) (n_prog - 1) / (gap + 1), gap, &seed);
+    for (size_t i = 0; i < n_dm; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        dm[i] = (uint8_t) seed;
+    }
+    init_cpu_c(c);
+    for (size_t i = 0; i < n_prog && i < IM_SIZE; i++) u32_to_word(prog[i], c->im.im[i]);
+    memcpy(c->dm.memory, dm, n_dm > DEFAULT_SIZE ? DEFAULT_SIZE : n_dm);
+}
+
+void lanes_ref_step(const int k) {
+    cpu_step(&lanes_ref_cpu_[k]);
+}
+
+int lanes_ref_regs(const int k, uint32_t *out) {
+    for (int r = 0; r < NL_CPU_REG_NUM; r++) {
+        const Nl_cpu_reg *reg = &NL_CPU_REGS_[r];
+        out[r] = nl_cpu_field_get_((const char *) &lanes_ref_cpu_[k] + reg->q, reg->width);
+    }
+    return NL_CPU_REG_NUM;
+}
+
+void lanes_ref_dm(const int k, uint8_t *out, const size_t n) {
+    memcpy(out, lanes_ref_cpu_[k].dm.memory, n > DEFAULT_SIZE ? DEFAULT_SIZE : n);
+}
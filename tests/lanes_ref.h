@@ -0,0 +1,23 @@
+//
+// Created by wenshen on 2026/10/17.
+// lanes_ref.h
+// bit-sliced 测试的标量参考: lanes_ref.c 在 SCCPU_LANES=1 下编译, 每个 lane 一个普通的 Cpu_core;
+// 两个编译单元里 bit / word 的类型不同, 接口只用 uint32_t / uint8_t 传值
+#ifndef SCCPU_LANES_REF_H
+#define SCCPU_LANES_REF_H
+#include "stdint.h"
+#include "stddef.h"
+
+#define LANES_REF_MAX 256
+
+// 第 k 个标量 CPU: 复位后装入按 seed 生成的随机程序和随机 DM, 程序 / DM 同时写到 prog / dm 供 lane 装载
+void lanes_ref_load(int k, uint64_t seed, uint32_t *prog, size_t n_prog, uint8_t *dm, size_t n_dm);
+
+void lanes_ref_step(int k);
+
+// NL_CPU_REGS_ 顺序的各寄存器值 (两边是同一张表), 返回个数
+int lanes_ref_regs(int k, uint32_t *out);
+
+void lanes_ref_dm(int k, uint8_t *out, size_t n);
+
+#endif //SCCPU_LANES_REF_H
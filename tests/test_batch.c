@@ -0,0 +1,144 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_batch.c
+// 线程池跑出的结果与逐个串行运行相同; 清单 / 镜像文件解析
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/cosim.h"
+#include "../includes/batch.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#define BATCH_TEST_FILE(x) "sccpu_test_batch_" x
+
+static uint64_t batch_rng_state = 0xBB67AE8584CAA73Bull;
+
+// 周期预算长短不一 (包括 0), 线程之间要靠偷作业才能均衡
+static int test_batch_matches_serial(void) {
+    printf("=== test_batch_matches_serial ===\n");
+    static Batch par, ser;
+    static uint32_t prog[IM_SIZE];
+    static uint8_t dm[DEFAULT_SIZE];
+    batch_init(&par);
+    for (int k = 0; k < 24; k++) {
+        char name[16];
+        memset(prog, 0, sizeof(prog));
+        cosim_random_program(prog, 40, 3, &batch_rng_state);
+        for (int i = 0; i < DEFAULT_SIZE; i++) dm[i] = (uint8_t) (batch_rng_state >> (i & 56));
+        snprintf(name, sizeof(name), "job%d", k);
+        batch_add(&par, name, prog, IM_SIZE, k % 3 ? dm : NULL, (uint64_t) (k % 4 == 1 ? 0 : 50 + 37 * k));
+    }
+    if (batch_clone(&ser, &par) != 0) FAIL("batch_clone failed");
+    if (batch_run(&par, 4) != 0) FAIL("could not start the pool");
+    batch_run(&ser, 1);
+    int jobs = 0;
+    for (int t = 0; t < par.n_threads; t++) jobs += par.w[t].jobs;
+    if (jobs != par.n_jobs) FAIL("jobs run != jobs submitted");
+    for (int i = 0; i < par.n_jobs; i++) {
+        const Batch_job *x = &par.jobs[i], *y = &ser.jobs[i];
+        if (!x->done || memcmp(x->r, y->r, sizeof(x->r)) != 0 || x->pc != y->pc || x->cycle_count != y->cycle_count
+            || x->dm_digest != y->dm_digest) {
+            printf("[FAIL] job %s differs between 4 threads and 1 thread\n", x->name);
+            return 1;
+        }
+    }
+    batch_free(&par);
+    batch_free(&ser);
+    PASS("24 jobs on a 4-thread work-stealing pool match a serial run");
+    return 0;
+}
+
+static void batch_write_file(const char *path, const char *text) {
+    FILE *f = fopen(path, "w");
+    if (f) {
+        fputs(text, f);
+        fclose(f);
+    }
+}
+
+// main.c 的程序写成镜像文件, DM 预装 R0 基址处的数据, 通过清单跑
+static int test_batch_manifest(void) {
+    printf("=== test_batch_manifest ===\n");
+    static Batch b;
+    char text[1024];
+    int n = 0;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 8), 0, 0, 0
+    };
+    n += snprintf(text + n, sizeof(text) - n, "# main.c program\n");
+    for (size_t i = 0; i < sizeof(program) / sizeof(program[0]); i++) {
+        n += snprintf(text + n, sizeof(text) - n, "0x%08X%s", program[i], i % 4 == 3 ? "\n" : " ");
+    }
+    batch_write_file(BATCH_TEST_FILE("main.hex"), text);
+    batch_write_file(BATCH_TEST_FILE("dm.hex"), "0 0 DEADBEEF # DM[8]\n");
+    batch_write_file(BATCH_TEST_FILE("jobs.txt"),
+                     "# name program dm cycles\n"
+                     "plain  sccpu_test_batch_main.hex -      30\n"
+                     "preload sccpu_test_batch_main.hex sccpu_test_batch_dm.hex 30   # LW R2 reads DM[8]\n");
+    batch_init(&b);
+    if (batch_load_manifest(&b, BATCH_TEST_FILE("jobs.txt")) != 0 || b.n_jobs != 2) FAIL("manifest not loaded");
+    batch_run(&b, 2);
+    if (strcmp(b.jobs[0].name, "plain") != 0 || b.jobs[0].r[3] != 30 || b.jobs[0].r[2] != 0)
+        FAIL("plain job: R3 != 30 or R2 != DM[8] = 0");
+    if (b.jobs[1].r[3] != 30 || b.jobs[1].r[2] != 0xDEADBEEF) FAIL("preload job: R2 != DM[8] = 0xDEADBEEF");
+    if (b.jobs[0].dm_digest == b.jobs[1].dm_digest || b.jobs[0].cycle_count != 30) FAIL("digest / cycles");
+
+    batch_write_file(BATCH_TEST_FILE("bad.txt"), "plain sccpu_test_batch_main.hex -\n");
+    if (batch_load_manifest(&b, BATCH_TEST_FILE("bad.txt")) == 0) FAIL("manifest line without cycles accepted");
+    batch_write_file(BATCH_TEST_FILE("bad.txt"), "x sccpu_test_batch_dm.hex sccpu_test_batch_nothere.hex 10\n");
+    if (batch_load_manifest(&b, BATCH_TEST_FILE("bad.txt")) == 0) FAIL("missing DM image accepted");
+    batch_write_file(BATCH_TEST_FILE("junk.hex"), "12 zz\n");
+    batch_write_file(BATCH_TEST_FILE("bad.txt"), "x sccpu_test_batch_junk.hex - 10\n");
+    if (batch_load_manifest(&b, BATCH_TEST_FILE("bad.txt")) == 0) FAIL("non-hex program image accepted");
+    remove(BATCH_TEST_FILE("main.hex"));
+    remove(BATCH_TEST_FILE("dm.hex"));
+    remove(BATCH_TEST_FILE("jobs.txt"));
+    remove(BATCH_TEST_FILE("bad.txt"));
+    remove(BATCH_TEST_FILE("junk.hex"));
+    batch_free(&b);
+    PASS("manifest with program / DM images runs the main.c program; malformed entries are rejected");
+    return 0;
+}
+
+// 作业数组按需增长: 几千个短作业 (少数几个镜像) 全部跑完, 结果与各自的镜像一致
+static int test_batch_many_jobs(void) {
+    printf("=== test_batch_many_jobs ===\n");
+    static Batch b;
+    static uint32_t prog[4][IM_SIZE];
+    const int n = 3000;
+    for (int p = 0; p < 4; p++) cosim_random_program(prog[p], 12, 1, &batch_rng_state);
+    batch_init(&b);
+    for (int k = 0; k < n; k++) {
+        char name[16];
+        snprintf(name, sizeof(name), "job%d", k);
+        if (batch_add(&b, name, prog[k % 4], IM_SIZE, NULL, 8) != k) FAIL("batch_add failed");
+    }
+    if (b.n_jobs != n || b.n_images != 4) FAIL("3000 jobs over 4 programs not deduplicated into 4 images");
+    if (batch_run(&b, 4) != 0) FAIL("could not start the pool");
+    int jobs = 0;
+    for (int t = 0; t < b.n_threads; t++) jobs += b.w[t].jobs;
+    if (jobs != n) FAIL("jobs run != jobs submitted");
+    for (int k = 4; k < n; k++) {
+        const Batch_job *x = &b.jobs[k], *y = &b.jobs[k % 4];
+        if (!x->done || memcmp(x->r, y->r, sizeof(x->r)) != 0 || x->pc != y->pc || x->dm_digest != y->dm_digest)
+            FAIL("job differs from the first job with the same image");
+    }
+    batch_free(&b);
+    PASS("3000 jobs grow the job array and all run");
+    return 0;
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_batch_matches_serial();
+//     rc |= test_batch_manifest();
+//     rc |= test_batch_many_jobs();
+//     if (rc == 0) printf("ALL BATCH TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -0,0 +1,107 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_checkpoint.c
+// checkpoint 恢复后逐周期与原来的运行一致; 坏文件被拒绝且不改动 Cpu_core
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/cosim.h"
+#include "../includes/checkpoint.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#define CKPT_TEST_PATH "sccpu_test_checkpoint.bin"
+
+static uint64_t ckpt_rng_state = 0x9E3779B97F4A7C15ull;
+
+// 每个周期都存档一次 (包括分支在 EX 生效、冲刷进行中的周期) -> 恢复到一个跑着别的程序的 Cpu_core
+// -> 两边再跑 40 个周期, 整个状态逐周期相同
+static int test_checkpoint_continues_exactly(void) {
+    printf("=== test_checkpoint_continues_exactly ===\n");
+    static Cpu_core a, b, run;
+    static uint8_t ka[CPU_CKPT_MAX_BYTES], kb[CPU_CKPT_MAX_BYTES], snap[CPU_CKPT_MAX_BYTES];
+    const size_t n = cpu_checkpoint_size();
+    for (int p = 0; p < 4; p++) {
+        cosim_load_random(&run, 60, 1, 1, &ckpt_rng_state);
+        cosim_load_random(&b, 60, 1, 1, &ckpt_rng_state);
+        for (int warm = 0; warm < 80; warm++) {
+            cpu_step(&run);
+            a = run;
+            for (int cyc = 0; cyc < 7 + warm % 5; cyc++) cpu_step(&b);
+            cpu_checkpoint_pack(&a, snap);
+            if (cpu_checkpoint_unpack(&b, snap, n) != CPU_CKPT_OK) FAIL("unpack of a fresh checkpoint failed");
+            for (int cyc = 0; cyc < 40; cyc++) {
+                cpu_step(&a);
+                cpu_step(&b);
+                cpu_checkpoint_pack(&a, ka);
+                cpu_checkpoint_pack(&b, kb);
+                if (memcmp(ka, kb, n) != 0) {
+                    printf("[FAIL] program %d: restored run diverged %d cycles after restoring at cycle %d\n", p,
+                           cyc + 1, warm + 1);
+                    return 1;
+                }
+            }
+        }
+    }
+    PASS("runs restored at every one of 80 cycles stay cycle-identical (4 programs, restored over a different run)");
+    return 0;
+}
+
+static int test_checkpoint_file_round_trip(void) {
+    printf("=== test_checkpoint_file_round_trip ===\n");
+    static Cpu_core a, b;
+    static uint8_t ka[CPU_CKPT_MAX_BYTES], kb[CPU_CKPT_MAX_BYTES];
+    cosim_load_random(&a, 60, 1, 1, &ckpt_rng_state);
+    for (int cyc = 0; cyc < 50; cyc++) cpu_step(&a);
+    if (cpu_checkpoint_save(&a, CKPT_TEST_PATH) != CPU_CKPT_OK) FAIL("save failed");
+    init_cpu_c(&b);
+    if (cpu_checkpoint_load(&b, CKPT_TEST_PATH) != CPU_CKPT_OK) FAIL("load failed");
+    remove(CKPT_TEST_PATH);
+    cpu_checkpoint_pack(&a, ka);
+    cpu_checkpoint_pack(&b, kb);
+    if (memcmp(ka, kb, cpu_checkpoint_size()) != 0 || b.cycle_count != 50) FAIL("loaded state differs from saved state");
+    if (cpu_checkpoint_load(&b, CKPT_TEST_PATH) != CPU_CKPT_ERR_IO) FAIL("missing file not reported as IO error");
+    PASS("save -> load restores the same state and cycle_count");
+    return 0;
+}
+
+// 坏的 magic / version / 长度 / 内容都拒绝, 且 c 不变
+static int test_checkpoint_rejects_bad_input(void) {
+    printf("=== test_checkpoint_rejects_bad_input ===\n");
+    static Cpu_core a, b;
+    static uint8_t good[CPU_CKPT_MAX_BYTES], bad[CPU_CKPT_MAX_BYTES], before[CPU_CKPT_MAX_BYTES],
+            after[CPU_CKPT_MAX_BYTES];
+    const size_t n = cpu_checkpoint_size();
+    cosim_load_random(&a, 60, 1, 1, &ckpt_rng_state);
+    cosim_load_random(&b, 60, 1, 1, &ckpt_rng_state);
+    for (int cyc = 0; cyc < 20; cyc++) cpu_step(&a);
+    cpu_checkpoint_pack(&a, good);
+    cpu_checkpoint_pack(&b, before);
+
+    memcpy(bad, good, n);
+    bad[0] = 'X';
+    if (cpu_checkpoint_unpack(&b, bad, n) != CPU_CKPT_ERR_FORMAT) FAIL("bad magic accepted");
+    memcpy(bad, good, n);
+    bad[4]++;
+    if (cpu_checkpoint_unpack(&b, bad, n) != CPU_CKPT_ERR_FORMAT) FAIL("wrong version accepted");
+    if (cpu_checkpoint_unpack(&b, good, n - 1) != CPU_CKPT_ERR_FORMAT) FAIL("truncated checkpoint accepted");
+    for (size_t i = CPU_CKPT_HEADER_BYTES; i < n; i += 97) {
+        memcpy(bad, good, n);
+        bad[i] ^= 0x10;
+        if (cpu_checkpoint_unpack(&b, bad, n) != CPU_CKPT_ERR_CHECKSUM) FAIL("corrupted payload accepted");
+    }
+    cpu_checkpoint_pack(&b, after);
+    if (memcmp(before, after, n) != 0) FAIL("rejected checkpoint modified the core");
+    PASS("bad magic / version / length / checksum are rejected without touching the core");
+    return 0;
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_checkpoint_continues_exactly();
+//     rc |= test_checkpoint_file_round_trip();
+//     rc |= test_checkpoint_rejects_bad_input();
+//     if (rc == 0) printf("ALL CHECKPOINT TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -0,0 +1,133 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_cosim.c
+// 锁步对拍: 无冒险的随机程序全程一致; 读到旧值 / 状态被篡改时在出错的那条指令上停下; RTL 的已知偏差只计数
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/cosim.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+static uint64_t cosim_rng_state = 0x3C6EF372FE94F82Bull;
+
+static void cosim_load(Cpu_core *c, const int gap) {
+    static uint32_t prog[IM_SIZE];
+    memset(prog, 0, sizeof(prog));
+    cosim_random_program(prog, (IM_SIZE - 1) / (gap + 1), gap, &cosim_rng_state);
+    cpu_release(c); // c 是 static, 上一轮写时复制的私有副本
+    init_cpu_c(c);
+    im_load(&c->im, prog, IM_SIZE);
+    for (int i = 0; i < 64; i++) dm_poke(&c->dm, (uint32_t) (i * 4 + 3), (uint8_t) (cosim_rng_state >> i % 56));
+}
+
+static int test_cosim_clean_on_hazard_free_programs(void) {
+    printf("=== test_cosim_clean_on_hazard_free_programs ===\n");
+    static Cpu_core cpu;
+    static Cosim k;
+    uint64_t retired = 0;
+    for (int p = 0; p < 12; p++) {
+        cosim_load(&cpu, 3);
+        cosim_init(&k, &cpu);
+        if (cosim_run(&k, &cpu, 400)) FAIL("lockstep diverged on a hazard-free program");
+        retired += k.retired;
+    }
+    if (retired < 12 * 200) FAIL("too few instructions retired");
+    if (k.deviations[ISS_DEV_J_IGNORED] == 0) FAIL("random J instructions were not flagged as known deviations");
+    PASS("12 hazard-free random programs retire in lockstep with the ISS");
+    return 0;
+}
+
+static int test_cosim_main_program(void) {
+    printf("=== test_cosim_main_program ===\n");
+    static Cpu_core cpu;
+    static Cosim k;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 100), 0, 0, 0
+    };
+    init_cpu_c(&cpu);
+    im_load(&cpu.im, program, sizeof(program) / sizeof(program[0]));
+    cosim_init(&k, &cpu);
+    if (cosim_run(&k, &cpu, 24)) FAIL("main.c program diverged");
+    if (k.ref.r[3] != 30 || k.ref.r[2] != 30 || k.retired != 20) FAIL("main.c program: R3 / R2 / retired");
+    PASS("main.c program checks itself: 20 instructions, R3 = R2 = 30");
+    return 0;
+}
+
+// BEQ 只比最高字节、J 不跳: 参考模型记下偏差并跟着 RTL 的 next PC, 不算不一致
+static int test_cosim_flags_known_deviations(void) {
+    printf("=== test_cosim_flags_known_deviations ===\n");
+    static Cpu_core cpu;
+    static Cosim k;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 1), 0, 0, 0,
+        enc_beq(1, 0, 7), 0, 0, 0, // R1 != R0, 差的最高字节为 0: RTL 跳到 0x30
+        enc_addi(3, 0, 5), 0, 0, 0, // 只有 isa.h 的路径会执行
+        enc_j(OP_J, 0x30), 0, 0, 0, // RTL 顺序执行
+        enc_addi(2, 0, 7), 0, 0, 0
+    };
+    cpu_release(&cpu);
+    init_cpu_c(&cpu);
+    im_load(&cpu.im, program, sizeof(program) / sizeof(program[0]));
+    cosim_init(&k, &cpu);
+    if (cosim_run(&k, &cpu, 30)) FAIL("known deviations must not stop lockstep");
+    if (k.deviations[ISS_DEV_BEQ_TOP_BYTE] != 1 || k.deviations[ISS_DEV_J_IGNORED] != 1)
+        FAIL("beq_top_byte / j_ignored not counted once each");
+    if (k.ref.r[2] != 7 || k.ref.r[3] != 0) FAIL("reference did not follow the RTL path");
+    cosim_report_deviations(&k);
+    PASS("BEQ top-byte compare and ignored J are flagged and the reference follows the RTL path");
+    return 0;
+}
+
+// 没有前递: 间隔 0 的程序很快就会读到旧值
+static int test_cosim_detects_stale_read(void) {
+    printf("=== test_cosim_detects_stale_read ===\n");
+    static Cpu_core cpu;
+    static Cosim k;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 10),
+        enc_addi(2, 1, 1), // R1 还没写回, 读到 0
+        0, 0, 0, 0
+    };
+    init_cpu_c(&cpu);
+    im_load(&cpu.im, program, sizeof(program) / sizeof(program[0]));
+    cosim_init(&k, &cpu);
+    if (!cosim_run(&k, &cpu, 12)) FAIL("stale read not detected");
+    if (k.retired != 1 || k.ref.pc != 8 || k.ref.r[2] != 11) FAIL("wrong instruction reported");
+    PASS("read-after-write hazard is reported on the reading instruction (pc 0x4)");
+    return 0;
+}
+
+// 运行中篡改 regfile: 下一个退休点就停下
+static int test_cosim_detects_corruption(void) {
+    printf("=== test_cosim_detects_corruption ===\n");
+    static Cpu_core cpu;
+    static Cosim k;
+    cosim_load(&cpu, 3);
+    cosim_init(&k, &cpu);
+    if (cosim_run(&k, &cpu, 50)) FAIL("diverged before the fault");
+    const uint64_t before = k.retired;
+    iss_reg32_put_(&cpu.rf.r2, reg32_read_u32_(&cpu.rf.r2) ^ 0x100);
+    cpu_activity_invalidate(&cpu);
+    if (!cosim_step(&k, &cpu)) FAIL("register corruption not detected");
+    if (k.retired != before || !k.diverged) FAIL("retired count advanced past the divergence");
+    if (!cosim_step(&k, &cpu)) FAIL("cosim_step kept running after a divergence");
+    PASS("register file corruption stops lockstep on the next cycle");
+    return 0;
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_cosim_clean_on_hazard_free_programs();
+//     rc |= test_cosim_main_program();
+//     rc |= test_cosim_flags_known_deviations();
+//     rc |= test_cosim_detects_stale_read();
+//     rc |= test_cosim_detects_corruption();
+//     if (rc == 0) printf("ALL COSIM TESTS PASSED ✅\n");
+//     return rc;
+// }
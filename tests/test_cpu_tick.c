@@ -0,0 +1,219 @@
+//
+// Created by wenshen on 2026/1/27.
+// test_cpu_tick.c
+// cpu_cycle_single_eval / cpu_cycle_activity / cpu_cycle_threaded 必须与两段式参考实现 cpu_cycle_two_pass 逐周期一致
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/cpu_core.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+
+static uint64_t tick_rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t tick_rng(void) {
+    tick_rng_state ^= tick_rng_state << 13;
+    tick_rng_state ^= tick_rng_state >> 7;
+    tick_rng_state ^= tick_rng_state << 17;
+    return (uint32_t) tick_rng_state;
+}
+
+// 只用 4 个寄存器 (rf 只有 r0..r3)
+static uint32_t rand_inst(void) {
+    const uint8_t a = tick_rng() & 3, b = tick_rng() & 3, d = tick_rng() & 3;
+    switch (tick_rng() % 10) {
+        case 0: return 0;
+        case 1: return enc_r(a, b, d, 0, FUNCT_ADD);
+        case 2: return enc_r(a, b, d, 0, FUNCT_SUB);
+        case 3: return enc_r(a, b, d, 0, FUNCT_AND);
+        case 4: return enc_r(a, b, d, 0, FUNCT_OR);
+        case 5: return enc_r(a, b, d, 0, FUNCT_SLT);
+        case 6: return enc_addi(a, b, (int16_t) (tick_rng() % 200 - 100));
+        case 7: return enc_i(OP_LW, b, a, (int16_t) ((tick_rng() % 64) * 4));
+        case 8: return enc_i(OP_SW, b, a, (int16_t) ((tick_rng() % 64) * 4));
+        default: return enc_beq(a, b, (int16_t) (tick_rng() % 6));
+    }
+}
+
+static int same_dm(const Cpu_core *a, const Cpu_core *b) {
+    static uint8_t ma[DEFAULT_SIZE], mb[DEFAULT_SIZE];
+    dm_copy_out(&a->dm, ma);
+    dm_copy_out(&b->dm, mb);
+    return memcmp(ma, mb, DEFAULT_SIZE) == 0;
+}
+
+// 架构 + 流水线寄存器状态 (wire_* 是两种实现各自的中间量, 不参与比较)
+static int same_state(const Cpu_core *a, const Cpu_core *b) {
+    return memcmp(&a->pc, &b->pc, sizeof(a->pc)) == 0
+           && memcmp(&a->if_id, &b->if_id, sizeof(a->if_id)) == 0
+           && memcmp(&a->id_ex, &b->id_ex, sizeof(a->id_ex)) == 0
+           && memcmp(&a->ex_mem, &b->ex_mem, sizeof(a->ex_mem)) == 0
+           && memcmp(&a->mem_wb, &b->mem_wb, sizeof(a->mem_wb)) == 0
+           && memcmp(&a->rf, &b->rf, sizeof(a->rf)) == 0
+           && same_dm(a, b);
+}
+
+// 同一个随机程序 / DM 装进两个核; 一半的程序插满 NOP (nop_heavy), 让活动性调度的跳过真正发生
+// SCCPU_SHARED_IMAGES 下两个核各自写时复制, 不能直接结构体赋值 (会共用私有副本)
+static void tick_load_pair(Cpu_core *ref, Cpu_core *fast, const int nop_heavy) {
+    uint32_t prog[200];
+    static uint8_t dm[DEFAULT_SIZE];
+    for (int i = 0; i < 200; i++) {
+        prog[i] = nop_heavy && (tick_rng() % 3) ? 0 : rand_inst();
+    }
+    for (int i = 0; i < 64; i++) {
+        dm[i * 4 + 3] = (uint8_t) tick_rng();
+    }
+    cpu_release(ref);
+    cpu_release(fast);
+    init_cpu_c(ref);
+    init_cpu_c(fast);
+    im_load(&ref->im, prog, 200);
+    im_load(&fast->im, prog, 200);
+    dm_load(&ref->dm, dm, sizeof(dm));
+    dm_load(&fast->dm, dm, sizeof(dm));
+}
+
+static int test_single_eval_matches_two_pass(void) {
+    printf("=== test_single_eval_matches_two_pass ===\n");
+    static Cpu_core ref, fast;
+
+    for (int p = 0; p < 32; p++) {
+        tick_load_pair(&ref, &fast, 0);
+
+        for (int cyc = 0; cyc < 160; cyc++) {
+            cpu_cycle_two_pass(&ref);
+            cpu_cycle_single_eval(&fast);
+            if (!same_state(&ref, &fast)) {
+                printf("[FAIL] program %d diverged at cycle %d (pc ref=0x%08X fast=0x%08X)\n",
+                       p, cyc, reg32_read_u32_(&ref.pc.reg32), reg32_read_u32_(&fast.pc.reg32));
+                return 1;
+            }
+        }
+    }
+    PASS("single-eval tick matches two-pass tick on 32 random programs");
+    return 0;
+}
+
+static int test_activity_matches_two_pass(void) {
+    printf("=== test_activity_matches_two_pass ===\n");
+#if !SCCPU_ACTIVITY_SKIP
+    printf("[SKIP] Cpu_core.activity only exists with SCCPU_ACTIVITY_SKIP=1\n");
+    return 0;
+#else
+    static Cpu_core ref, fast;
+
+    for (int p = 0; p < 32; p++) {
+        tick_load_pair(&ref, &fast, p & 1);
+
+        for (int cyc = 0; cyc < 160; cyc++) {
+            cpu_cycle_two_pass(&ref);
+            cpu_cycle_activity(&fast);
+            if (!same_state(&ref, &fast)) {
+                printf("[FAIL] program %d diverged at cycle %d (pc ref=0x%08X fast=0x%08X)\n",
+                       p, cyc, reg32_read_u32_(&ref.pc.reg32), reg32_read_u32_(&fast.pc.reg32));
+                return 1;
+            }
+        }
+    }
+    PASS("activity-skipping tick matches two-pass tick on 32 random programs");
+    return 0;
+#endif
+}
+
+static int test_single_eval_main_program(void) {
+    printf("=== test_single_eval_main_program ===\n");
+    static Cpu_core c;
+    init_cpu_c(&c);
+    const uint32_t prog[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 100),
+    };
+    im_load(&c.im, prog, sizeof(prog) / sizeof(prog[0]));
+    for (int cyc = 0; cyc < 24; cyc++) {
+        cpu_cycle_single_eval(&c);
+    }
+    if (reg32_read_u32_(&c.rf.r3) != 30 || reg32_read_u32_(&c.rf.r2) != 30 || DM_BYTE_(&c.dm, 103) != 30) {
+        printf("[FAIL] r1=%u r2=%u r3=%u dm[100]=%u\n", reg32_read_u32_(&c.rf.r1), reg32_read_u32_(&c.rf.r2),
+               reg32_read_u32_(&c.rf.r3), DM_BYTE_(&c.dm, 103));
+        return 1;
+    }
+    PASS("single-eval tick runs ADDI/ADD/SW/LW program");
+    return 0;
+}
+
+static int test_activity_skips_nop_tail(void) {
+    printf("=== test_activity_skips_nop_tail ===\n");
+#if !SCCPU_ACTIVITY_SKIP
+    printf("[SKIP] Cpu_core.activity only exists with SCCPU_ACTIVITY_SKIP=1\n");
+    return 0;
+#else
+    static Cpu_core c;
+    init_cpu_c(&c);
+    im_store(&c.im, 0, enc_addi(1, 0, 7));
+    for (int cyc = 0; cyc < 40; cyc++) {
+        cpu_cycle_activity(&c);
+    }
+    const Stage_activity *a = &c.activity;
+    if (reg32_read_u32_(&c.rf.r1) != 7) {
+        printf("[FAIL] r1=%u, expected 7\n", reg32_read_u32_(&c.rf.r1));
+        return 1;
+    }
+    // 只有 IF 每个周期都要求值; 其余阶段在 NOP 尾巴上都应该被跳过
+    if (a->evals[STAGE_IF] != 40 || a->skips[STAGE_IF] != 0) {
+        printf("[FAIL] IF evals=%lu skips=%lu\n", a->evals[STAGE_IF], a->skips[STAGE_IF]);
+        return 1;
+    }
+    for (int i = STAGE_WB; i < STAGE_IF; i++) {
+        if (a->evals[i] + a->skips[i] != 40 || a->skips[i] < 30) {
+            printf("[FAIL] stage %d evals=%lu skips=%lu\n", i, a->evals[i], a->skips[i]);
+            return 1;
+        }
+    }
+    PASS("activity scheduler skips WB/MEM/EX/ID on a NOP tail");
+    return 0;
+#endif
+}
+
+// 三个线程上的阶段并行求值; 中途换一个 Cpu_core 实例, 线程池要跟着切换
+static int test_threaded_matches_two_pass(void) {
+    printf("=== test_threaded_matches_two_pass ===\n");
+#if !SCCPU_STAGE_THREADS
+    printf("[SKIP] cpu_cycle_threaded only exists with SCCPU_STAGE_THREADS=1\n");
+    return 0;
+#else
+    static Cpu_core ref, fast;
+
+    for (int p = 0; p < 8; p++) {
+        tick_load_pair(&ref, &fast, 0);
+
+        for (int cyc = 0; cyc < 160; cyc++) {
+            cpu_cycle_two_pass(&ref);
+            cpu_cycle_threaded(&fast);
+            if (!same_state(&ref, &fast)) {
+                printf("[FAIL] program %d diverged at cycle %d (pc ref=0x%08X threaded=0x%08X)\n",
+                       p, cyc, reg32_read_u32_(&ref.pc.reg32), reg32_read_u32_(&fast.pc.reg32));
+                cpu_stage_threads_stop();
+                return 1;
+            }
+        }
+    }
+    cpu_stage_threads_stop();
+    PASS("stage-parallel tick matches two-pass tick on 8 random programs");
+    return 0;
+#endif
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_single_eval_matches_two_pass();
+//     rc |= test_activity_matches_two_pass();
+//     rc |= test_single_eval_main_program();
+//     rc |= test_activity_skips_nop_tail();
+//     rc |= test_threaded_matches_two_pass();
+//     if (rc == 0) printf("ALL CPU TICK TESTS PASSED ✅\n");
+//     return rc;
+// }
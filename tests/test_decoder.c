@@ -64,8 +64,8 @@ static inline void make_j(word out, uint32_t opcode6, uint32_t addr26) {
 // ------------------------------------------------------------
 // 断言工具
 // ------------------------------------------------------------
-#define PASS(name) printf("[PASS] %s\n", (name))
-#define FAIL(name, fmt, ...) do { printf("[FAIL] %s: " fmt "\n", (name), ##__VA_ARGS__); } while (0)
+// FAILF 只打印不返回 (common_test.h 的 FAIL 会 return 1), 一个用例里的多项检查都能跑完
+#define FAILF(name, fmt, ...) do { printf("[FAIL] %s: " fmt "\n", (name), ##__VA_ARGS__); } while (0)
 
 static inline int eq_ops(const ops a, const ops b) {
     return (a[0] == b[0]) && (a[1] == b[1]) && (a[2] == b[2]);
@@ -73,14 +73,14 @@ static inline int eq_ops(const ops a, const ops b) {
 
 static inline void assert_bit(const char *name, bit got, bit exp) {
     if (((got) & 1) != ((exp) & 1))
-        FAIL(name, "got=%d exp=%d", (int)got, (int)exp);
+        FAILF(name, "got=%d exp=%d", (int)got, (int)exp);
     else
         PASS(name);
 }
 
 static inline void assert_ops(const char *name, const ops got, const ops exp) {
     if (!eq_ops(got, exp)) {
-        FAIL(name, "got=[%d%d%d] exp=[%d%d%d]",
+        FAILF(name, "got=[%d%d%d] exp=[%d%d%d]",
              got[0], got[1], got[2], exp[0], exp[1], exp[2]);
     } else
         PASS(name);
@@ -205,28 +205,28 @@ static void test_decode_invariants_random(void) {
         Control_signals cs = decode(inst);
 
         if (cs.mem_read && cs.mem_write) {
-            FAIL("INV mem_read && mem_write", "inst=0x%08X", u32_from_word_test(inst));
+            FAILF("INV mem_read && mem_write", "inst=0x%08X", u32_from_word_test(inst));
             return;
         }
         if (cs.branch && cs.jump) {
-            FAIL("INV branch && jump", "inst=0x%08X", u32_from_word_test(inst));
+            FAILF("INV branch && jump", "inst=0x%08X", u32_from_word_test(inst));
             return;
         }
         if (cs.mem_read) {
             if (!cs.reg_write || !cs.data_src_to_reg) {
-                FAIL("INV LW shape", "inst=0x%08X", u32_from_word_test(inst));
+                FAILF("INV LW shape", "inst=0x%08X", u32_from_word_test(inst));
                 return;
             }
         }
         if (cs.mem_write) {
             if (cs.reg_write) {
-                FAIL("INV SW shape", "inst=0x%08X", u32_from_word_test(inst));
+                FAILF("INV SW shape", "inst=0x%08X", u32_from_word_test(inst));
                 return;
             }
         }
         if (cs.branch) {
             if (!eq_ops(cs.ops_, OPS_SUB_)) {
-                FAIL("INV BEQ uses SUB", "inst=0x%08X got_ops=[%d%d%d]",
+                FAILF("INV BEQ uses SUB", "inst=0x%08X got_ops=[%d%d%d]",
                      u32_from_word_test(inst), cs.ops_[0], cs.ops_[1], cs.ops_[2]);
                 return;
             }
@@ -251,11 +251,59 @@ static void test_illegal_rtype_funct_behavior(void) {
     PASS("printed current behavior");
 }
 
+// ------------------------------------------------------------
+// decode_cached 必须与门级 decode 完全一致, 并且统计命中
+// ------------------------------------------------------------
+static void test_decode_cache_matches_decode(void) {
+    printf("\n=== test_decode_cache_matches_decode ===\n");
+    static Decode_cache dc;
+    uint32_t s = 0xDEC0DEu;
+    decode_cache_reset(&dc);
+
+    // 随机指令字 (大部分是非法编码) + 每个都查两次
+    for (int t = 0; t < 2000; t++) {
+        uint32_t v = lcg_next(&s);
+        if (t & 1) v &= 0xFC00003Fu; // 只保留 opcode/funct, 制造重复
+        if (t % 7 == 0) v &= 0x03FFFFC0u; // opcode / funct 全 0: 中间有 1 的 R 型与 NOP 的 reg_write 不同
+        word inst;
+        word_from_u32(v, inst);
+        const uint32_t key = (v >> 26) << 6 | (v & 0x3Fu);
+        if (decode_cache_key(inst) != (key || !v ? key : 1u << 12)) {
+            FAILF("decode_cache_key", "inst=0x%08X key=0x%08X", v, decode_cache_key(inst));
+            return;
+        }
+        const Control_signals ref = decode(inst);
+        for (int k = 0; k < 2; k++) {
+            const Control_signals got = decode_cached(&dc, inst);
+            if (memcmp(&ref, &got, sizeof(Control_signals)) != 0) {
+                FAILF("decode_cached == decode", "inst=0x%08X", v);
+                return;
+            }
+        }
+    }
+    PASS("decode_cached == decode 2000 words");
+
+    decode_cache_reset(&dc);
+    word inst;
+    make_r(inst, 1, 2, 3, 0, FUNCT_ADD);
+    (void) decode_cached(&dc, inst);
+    (void) decode_cached(&dc, inst);
+    (void) decode_cached(&dc, inst);
+    assert_bit("cache miss once", dc.misses == 1, 1);
+    assert_bit("cache hit twice", dc.hits == 2, 1);
+
+    // 寄存器字段不进 tag: 同一 opcode / funct 的另一条指令直接命中
+    make_r(inst, 3, 0, 1, 0, FUNCT_ADD);
+    (void) decode_cached(&dc, inst);
+    assert_bit("same opcode/funct hits", dc.hits == 3, 1);
+}
+
 // int main(void) {
 //     test_decode_rtype();
 //     test_decode_itype();
 //     test_decode_jtype();
 //     test_decode_invariants_random();
 //     test_illegal_rtype_funct_behavior();
+//     test_decode_cache_matches_decode();
 //     return 0;
 // }
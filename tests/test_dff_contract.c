@@ -9,19 +9,6 @@
 #include "../includes/reg.h"
 #include "../includes/utils.h"
 
-#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
-#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
-#define ASSERT_EQ_BIT(name, actual, expected) do { \
-int a__ = ((actual) & 1); \
-int e__ = ((expected) & 1); \
-if (a__ != e__) { \
-printf("[FAIL] %s: got=%d, expected=%d\n", (name), a__, e__); \
-return 1; \
-} else { \
-printf("[PASS] %s\n", (name)); \
-} \
-} while (0)
-
 static int test_dff_commit_dontcare_din(void) {
     printf("=== test_dff_commit_dontcare_din ===\n");
 
@@ -127,11 +114,35 @@ static int test_reg32_commit_dontcare_din(void) {
     return 0;
 }
 
+// 两种 DFF 实现 (d_latch 收敛 / SCCPU_DFF_CLOSED_FORM) 都必须满足同一张真值表
+static int test_dff_update_truth_table(void) {
+    printf("=== test_dff_update_truth_table ===\n");
+    for (int v = 0; v < 16; v++) {
+        const bit master = (v >> 3) & 1, q = (v >> 2) & 1, clk = (v >> 1) & 1, din = v & 1;
+        dff_ d;
+        init_dff(&d);
+        d.master_Q = master;
+        d.Q = q;
+        dff_update(&d, clk, din);
+
+        // clk=0: master <- din, Q 保持; clk=1: master 保持, Q <- master
+        const bit exp_master = clk ? master : din;
+        const bit exp_q = clk ? master : q;
+        if (d.master_Q != exp_master || d.Q != exp_q) {
+            printf("[FAIL] master=%d Q=%d clk=%d din=%d -> master=%d Q=%d, expected %d %d\n",
+                   master, q, clk, din, d.master_Q, d.Q, exp_master, exp_q);
+            return 1;
+        }
+    }
+    PASS("dff_update matches master/slave truth table");
+    return 0;
+}
 
 // int main(void) {
 //     int rc = 0;
 //     rc |= test_dff_commit_dontcare_din();
 //     rc |= test_reg32_commit_dontcare_din();
+//     rc |= test_dff_update_truth_table();
 //     if (rc == 0) printf("ALL DFF CONTRACT TESTS PASSED ✅\n");
 //     return rc;
 // }
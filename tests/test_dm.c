@@ -143,11 +143,12 @@ static int test_basic_rw_and_async_read(void) {
     ASSERT_EQ_U32("read back == DEADBEEF", word_to_u32(rdata), 0xDEADBEEF);
 
     // read should NOT modify memory
-    uint32_t before0 = dm.memory[4];
+    uint32_t before0 = DM_BYTE_(&dm, 4);
     dm.m_read(&dm, addr, rdata);
-    uint32_t after0 = dm.memory[4];
+    uint32_t after0 = DM_BYTE_(&dm, 4);
     ASSERT_EQ_U8("read is non-destructive (byte0)", after0, before0);
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -177,6 +178,7 @@ static int test_write_gating_we_and_clk(void) {
     dm.m_read(&dm, addr, rdata);
     ASSERT_EQ_U32("we=1 clk=1 => write happens", word_to_u32(rdata), 0x12345678);
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -223,6 +225,7 @@ static int test_mask_all_16_patterns(void) {
         ASSERT_EQ_U32(name, got, exp);
     }
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -247,6 +250,7 @@ static int test_mask_zero_is_no_write(void) {
     dm.m_read(&dm, addr, rdata);
     ASSERT_EQ_U32("mask=0000 => unchanged", word_to_u32(rdata), 0xCAFEBABE);
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -256,7 +260,7 @@ static int test_unaligned_policy(void) {
     init_dm_(&dm);
 
     // put known bytes 00 11 22 33 44 55
-    for (int i = 0; i < 6; i++) dm.memory[i] = (uint8_t) (i * 0x11);
+    for (int i = 0; i < 6; i++) dm_poke(&dm, (uint32_t) i, (uint8_t) (i * 0x11));
 
     word addr = {0}, rdata = {0}, wdata = {0};
     bit be_all[4] = {1, 1, 1, 1};
@@ -276,21 +280,22 @@ static int test_unaligned_policy(void) {
     u32_to_word(1, addr);
     u32_to_word(0xAABBCCDD, wdata);
 
-    uint8_t b1 = dm.memory[1], b2 = dm.memory[2], b3 = dm.memory[3], b4 = dm.memory[4];
+    uint8_t b1 = DM_BYTE_(&dm, 1), b2 = DM_BYTE_(&dm, 2), b3 = DM_BYTE_(&dm, 3), b4 = DM_BYTE_(&dm, 4);
     dm.m_write(&dm, addr, wdata, be_all, 1, 1);
 
 #if DM_ALLOW_UNALIGNED
-    ASSERT_EQ_U8("allow: mem[1]==AA", dm.memory[1], 0xAA);
-    ASSERT_EQ_U8("allow: mem[2]==BB", dm.memory[2], 0xBB);
-    ASSERT_EQ_U8("allow: mem[3]==CC", dm.memory[3], 0xCC);
-    ASSERT_EQ_U8("allow: mem[4]==DD", dm.memory[4], 0xDD);
+    ASSERT_EQ_U8("allow: mem[1]==AA", DM_BYTE_(&dm, 1), 0xAA);
+    ASSERT_EQ_U8("allow: mem[2]==BB", DM_BYTE_(&dm, 2), 0xBB);
+    ASSERT_EQ_U8("allow: mem[3]==CC", DM_BYTE_(&dm, 3), 0xCC);
+    ASSERT_EQ_U8("allow: mem[4]==DD", DM_BYTE_(&dm, 4), 0xDD);
 #else
-    ASSERT_EQ_U8("forbid: mem[1] unchanged", dm.memory[1], b1);
-    ASSERT_EQ_U8("forbid: mem[2] unchanged", dm.memory[2], b2);
-    ASSERT_EQ_U8("forbid: mem[3] unchanged", dm.memory[3], b3);
-    ASSERT_EQ_U8("forbid: mem[4] unchanged", dm.memory[4], b4);
+    ASSERT_EQ_U8("forbid: mem[1] unchanged", DM_BYTE_(&dm, 1), b1);
+    ASSERT_EQ_U8("forbid: mem[2] unchanged", DM_BYTE_(&dm, 2), b2);
+    ASSERT_EQ_U8("forbid: mem[3] unchanged", DM_BYTE_(&dm, 3), b3);
+    ASSERT_EQ_U8("forbid: mem[4] unchanged", DM_BYTE_(&dm, 4), b4);
 #endif
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -354,6 +359,7 @@ static int test_fuzz_against_golden_model(void) {
     }
 
     PASS("fuzz matched golden model");
+    dm_release(&dm);
     return 0;
 }
 
@@ -31,17 +31,17 @@ static inline void pack_decode_signals_word(word out,
                                             bit branch, bit jump,
                                             const ops alu_ops) {
     zero_word(out);
-    out[INST_WORD(31)] = reg_dst;
-    out[INST_WORD(30)] = alu_src;
-    out[INST_WORD(29)] = data_src_to_reg;
-    out[INST_WORD(28)] = reg_write;
-    out[INST_WORD(27)] = mem_read;
-    out[INST_WORD(26)] = mem_write;
-    out[INST_WORD(25)] = branch;
-    out[INST_WORD(24)] = jump;
-    out[INST_WORD(23)] = alu_ops[0];
-    out[INST_WORD(22)] = alu_ops[1];
-    out[INST_WORD(21)] = alu_ops[2];
+    WORD_SET(out, INST_WORD(31), reg_dst);
+    WORD_SET(out, INST_WORD(30), alu_src);
+    WORD_SET(out, INST_WORD(29), data_src_to_reg);
+    WORD_SET(out, INST_WORD(28), reg_write);
+    WORD_SET(out, INST_WORD(27), mem_read);
+    WORD_SET(out, INST_WORD(26), mem_write);
+    WORD_SET(out, INST_WORD(25), branch);
+    WORD_SET(out, INST_WORD(24), jump);
+    WORD_SET(out, INST_WORD(23), alu_ops[0]);
+    WORD_SET(out, INST_WORD(22), alu_ops[1]);
+    WORD_SET(out, INST_WORD(21), alu_ops[2]);
 }
 
 static inline void idex_load_minimal(Id_ex_regs *idex,
@@ -50,14 +50,14 @@ static inline void idex_load_minimal(Id_ex_regs *idex,
                                      uint32_t imm_ext,
                                      uint32_t rs_idx, uint32_t rt_idx, uint32_t rd_idx,
                                      uint32_t pc_plus4) {
-    // decode_signals 是 reg32_，直接写入对应的 32bit 图样
-    reg32_write_u32(&idex->decode_signals, decode_bits_u32);
+    // decode_signals 是 Reg11_，取 32bit 图样的 bit31..bit21
+    reg11_write_u32(&idex->decode_signals, decode_bits_u32 >> 21);
     reg32_write_u32(&idex->read_data1, rdata1);
     reg32_write_u32(&idex->read_data2, rdata2);
     reg32_write_u32(&idex->imm_ext, imm_ext);
-    reg32_write_u32(&idex->rs_idx, rs_idx);
-    reg32_write_u32(&idex->rt_idx, rt_idx);
-    reg32_write_u32(&idex->rd_idx, rd_idx);
+    reg2_write_u32(&idex->rs_idx, rs_idx);
+    reg2_write_u32(&idex->rt_idx, rt_idx);
+    reg2_write_u32(&idex->rd_idx, rd_idx);
     reg32_write_u32(&idex->pc_plus4, pc_plus4);
 }
 
@@ -79,20 +79,20 @@ static int test_exmem_rtype_add_basic(void) {
     Ex_mem_regs exmem;
 
 
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
-    init_reg32(&exmem.mem_single);
-    init_reg32(&exmem.wb_single);
+    init_reg2(&exmem.mem_single);
+    init_reg2(&exmem.wb_single);
     init_reg32(&exmem.alu_result);
     init_reg32(&exmem.write_data);
-    init_reg32(&exmem.write_reg_idx);
+    init_reg2(&exmem.write_reg_idx);
 
 
     word sigw;
@@ -125,7 +125,7 @@ static int test_exmem_rtype_add_basic(void) {
 
     uint32_t alu_res = reg32_read_u32(&exmem.alu_result);
     uint32_t wdata = reg32_read_u32(&exmem.write_data);
-    uint32_t widx = reg32_read_u32(&exmem.write_reg_idx);
+    uint32_t widx = reg2_read_u32_(&exmem.write_reg_idx);
 
     ASSERT_EQ_U32("alu_result == 12", alu_res, 12);
     ASSERT_EQ_U32("write_data == RT(7)", wdata, 7);
@@ -142,20 +142,20 @@ static int test_exmem_itype_addi_imm_mux(void) {
 
     Id_ex_regs idex;
     Ex_mem_regs exmem;
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
-    init_reg32(&exmem.mem_single);
-    init_reg32(&exmem.wb_single);
+    init_reg2(&exmem.mem_single);
+    init_reg2(&exmem.wb_single);
     init_reg32(&exmem.alu_result);
     init_reg32(&exmem.write_data);
-    init_reg32(&exmem.write_reg_idx);
+    init_reg2(&exmem.write_reg_idx);
 
 
     word sigw;
@@ -180,7 +180,7 @@ static int test_exmem_itype_addi_imm_mux(void) {
     exmem_tick(&idex, &exmem, pc_src, branch_target, /*ex_flush*/0, &ov);
 
     ASSERT_EQ_U32("alu_result == 1009", reg32_read_u32(&exmem.alu_result), 1009);
-    ASSERT_EQ_U32("write_reg_idx == RT(2)", reg32_read_u32(&exmem.write_reg_idx), 2);
+    ASSERT_EQ_U32("write_reg_idx == RT(2)", reg2_read_u32_(&exmem.write_reg_idx), 2);
 
     return 0;
 }
@@ -195,20 +195,20 @@ static int test_exmem_branch_taken_pc_feedback(void) {
 
     Id_ex_regs idex;
     Ex_mem_regs exmem;
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
-    init_reg32(&exmem.mem_single);
-    init_reg32(&exmem.wb_single);
+    init_reg2(&exmem.mem_single);
+    init_reg2(&exmem.wb_single);
     init_reg32(&exmem.alu_result);
     init_reg32(&exmem.write_data);
-    init_reg32(&exmem.write_reg_idx);
+    init_reg2(&exmem.write_reg_idx);
 
 
     word sigw;
@@ -253,20 +253,20 @@ static int test_exmem_branch_not_taken(void) {
 
     Id_ex_regs idex;
     Ex_mem_regs exmem;
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
-    init_reg32(&exmem.mem_single);
-    init_reg32(&exmem.wb_single);
+    init_reg2(&exmem.mem_single);
+    init_reg2(&exmem.wb_single);
     init_reg32(&exmem.alu_result);
     init_reg32(&exmem.write_data);
-    init_reg32(&exmem.write_reg_idx);
+    init_reg2(&exmem.write_reg_idx);
 
 
     word sigw;
@@ -303,20 +303,20 @@ static int test_exmem_flush_bubble(void) {
 
     Id_ex_regs idex;
     Ex_mem_regs exmem;
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
-    init_reg32(&exmem.mem_single);
-    init_reg32(&exmem.wb_single);
+    init_reg2(&exmem.mem_single);
+    init_reg2(&exmem.wb_single);
     init_reg32(&exmem.alu_result);
     init_reg32(&exmem.write_data);
-    init_reg32(&exmem.write_reg_idx);
+    init_reg2(&exmem.write_reg_idx);
 
 
     // 构造一个“本来会写寄存器+可能分支”的指令，然后 flush 掉
@@ -347,11 +347,11 @@ static int test_exmem_flush_bubble(void) {
     // 2) EX/MEM 锁存结果应全清零（你代码里都 mux 到 WORD_ZERO 了）
     ASSERT_EQ_U32("alu_result==0", reg32_read_u32(&exmem.alu_result), 0);
     ASSERT_EQ_U32("write_data==0", reg32_read_u32(&exmem.write_data), 0);
-    ASSERT_EQ_U32("write_reg_idx==0", reg32_read_u32(&exmem.write_reg_idx), 0);
+    ASSERT_EQ_U32("write_reg_idx==0", reg2_read_u32_(&exmem.write_reg_idx), 0);
 
     // mem_single / wb_single 你布局可能在高位，这里做“整体为0”的强断言最安全
-    ASSERT_EQ_U32("mem_single==0", reg32_read_u32(&exmem.mem_single), 0);
-    ASSERT_EQ_U32("wb_single==0", reg32_read_u32(&exmem.wb_single), 0);
+    ASSERT_EQ_U32("mem_single==0", reg2_read_u32_(&exmem.mem_single), 0);
+    ASSERT_EQ_U32("wb_single==0", reg2_read_u32_(&exmem.wb_single), 0);
 
     return 0;
 }
@@ -80,8 +80,9 @@ typedef struct cs_expect_t {
 
 static inline cs_expect_t unpack_cs(const Id_ex_regs *idex) {
     cs_expect_t e;
+    // Reg11_ 还原成 32bit 图样 (bit31..bit21)
     word w = {0};
-    read_reg32((Reg32_ *) &idex->decode_signals, w);
+    word_from_u32(reg11_read_u32_(&idex->decode_signals) << 21, w);
 
     e.reg_dst = BITN(w, 31);
     e.alu_src = BITN(w, 30);
@@ -138,9 +139,9 @@ static inline void idex_tick(
 ) {
     Id_ex_write write = {id_ex_write, id_ex_flush};
     // clk=0
-    id_ex_regs_step(idex, ifid, rf, &write, 0);
+    id_ex_regs_step(idex, ifid, rf, &write, NULL, 0);
     // clk=1
-    id_ex_regs_step(idex, ifid, rf, &write, 1);
+    id_ex_regs_step(idex, ifid, rf, &write, NULL, 1);
 }
 
 // -------------------------
@@ -173,14 +174,14 @@ static int test_idex_imm_signext(void) {
     init_reg32(&rf.r1);
     init_reg32(&rf.r2);
     init_reg32(&rf.r3);
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
     // regfile 随便给点值，不影响 imm_ext
     rf_load(&rf, 0x11111111, 0x22222222, 0x33333333, 0x44444444);
@@ -219,14 +220,14 @@ static int test_idex_control_signals_types(void) {
     init_reg32(&rf.r1);
     init_reg32(&rf.r2);
     init_reg32(&rf.r3);
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
     rf_load(&rf, 0x00000000, 0x11111111, 0x22222222, 0x33333333);
 
@@ -352,14 +353,14 @@ static int test_idex_random_reg_select(int cases) {
     init_reg32(&rf.r1);
     init_reg32(&rf.r2);
     init_reg32(&rf.r3);
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
     const uint32_t rv[4] = {
         0x11111111u, 0x22222222u, 0x33333333u, 0x44444444u
@@ -380,9 +381,9 @@ static int test_idex_random_reg_select(int cases) {
 
         uint32_t got_rs = reg32_read_u32(&idex.read_data1);
         uint32_t got_rt = reg32_read_u32(&idex.read_data2);
-        uint32_t got_rs_idx = reg32_read_u32(&idex.rs_idx) & 0x3u;
-        uint32_t got_rt_idx = reg32_read_u32(&idex.rt_idx) & 0x3u;
-        uint32_t got_rd_idx = reg32_read_u32(&idex.rd_idx) & 0x3u;
+        uint32_t got_rs_idx = reg2_read_u32_(&idex.rs_idx) & 0x3u;
+        uint32_t got_rt_idx = reg2_read_u32_(&idex.rt_idx) & 0x3u;
+        uint32_t got_rd_idx = reg2_read_u32_(&idex.rd_idx) & 0x3u;
 
         if (got_rs != rv[rs]) {
             printf("[FAIL] case=%d RS data mismatch: rs=%u got=0x%08X exp=0x%08X\n",
@@ -420,14 +421,14 @@ static int test_idex_stall_hold(void) {
     init_reg32(&rf.r1);
     init_reg32(&rf.r2);
     init_reg32(&rf.r3);
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
     rf_load(&rf, 0xAAAAAAAAu, 0xBBBBBBBBu, 0xCCCCCCCCu, 0xDDDDDDDDu);
 
@@ -436,7 +437,7 @@ static int test_idex_stall_hold(void) {
     ifid_load(&ifid, inst1, 0x10);
     idex_tick(&idex, &ifid, &rf, 1, 0);
 
-    uint32_t snap_cs = reg32_read_u32(&idex.decode_signals);
+    uint32_t snap_cs = reg11_read_u32_(&idex.decode_signals);
     uint32_t snap_r1 = reg32_read_u32(&idex.read_data1);
     uint32_t snap_r2 = reg32_read_u32(&idex.read_data2);
     uint32_t snap_imm = reg32_read_u32(&idex.imm_ext);
@@ -446,7 +447,7 @@ static int test_idex_stall_hold(void) {
     ifid_load(&ifid, inst2, 0x14);
     idex_tick(&idex, &ifid, &rf, /*write*/0, /*flush*/0);
 
-    ASSERT_EQ_U32("cs hold", reg32_read_u32(&idex.decode_signals), snap_cs);
+    ASSERT_EQ_U32("cs hold", reg11_read_u32_(&idex.decode_signals), snap_cs);
     ASSERT_EQ_U32("r1 hold", reg32_read_u32(&idex.read_data1), snap_r1);
     ASSERT_EQ_U32("r2 hold", reg32_read_u32(&idex.read_data2), snap_r2);
     ASSERT_EQ_U32("imm hold", reg32_read_u32(&idex.imm_ext), snap_imm);
@@ -469,14 +470,14 @@ static int test_idex_flush_bubble(void) {
     init_reg32(&rf.r1);
     init_reg32(&rf.r2);
     init_reg32(&rf.r3);
-    init_reg32(&idex.decode_signals);
+    init_reg11(&idex.decode_signals);
     init_reg32(&idex.imm_ext);
     init_reg32(&idex.pc_plus4);
     init_reg32(&idex.read_data1);
     init_reg32(&idex.read_data2);
-    init_reg32(&idex.rs_idx);
-    init_reg32(&idex.rt_idx);
-    init_reg32(&idex.rd_idx);
+    init_reg2(&idex.rs_idx);
+    init_reg2(&idex.rt_idx);
+    init_reg2(&idex.rd_idx);
 
     rf_load(&rf, 0x11111111u, 0x22222222u, 0x33333333u, 0x44444444u);
 
@@ -490,13 +491,13 @@ static int test_idex_flush_bubble(void) {
     ifid_load(&ifid, inst2, 0x104);
     idex_tick(&idex, &ifid, &rf, /*write*/0, /*flush*/1);
 
-    ASSERT_EQ_U32("decode_signals bubble == 0", reg32_read_u32(&idex.decode_signals), 0u);
+    ASSERT_EQ_U32("decode_signals bubble == 0", reg11_read_u32_(&idex.decode_signals), 0u);
     ASSERT_EQ_U32("read_data1 bubble == 0", reg32_read_u32(&idex.read_data1), 0u);
     ASSERT_EQ_U32("read_data2 bubble == 0", reg32_read_u32(&idex.read_data2), 0u);
     ASSERT_EQ_U32("imm_ext bubble == 0", reg32_read_u32(&idex.imm_ext), 0u);
-    ASSERT_EQ_U32("rs_idx bubble == 0", reg32_read_u32(&idex.rs_idx) & 3u, 0u);
-    ASSERT_EQ_U32("rt_idx bubble == 0", reg32_read_u32(&idex.rt_idx) & 3u, 0u);
-    ASSERT_EQ_U32("rd_idx bubble == 0", reg32_read_u32(&idex.rd_idx) & 3u, 0u);
+    ASSERT_EQ_U32("rs_idx bubble == 0", reg2_read_u32_(&idex.rs_idx) & 3u, 0u);
+    ASSERT_EQ_U32("rt_idx bubble == 0", reg2_read_u32_(&idex.rt_idx) & 3u, 0u);
+    ASSERT_EQ_U32("rd_idx bubble == 0", reg2_read_u32_(&idex.rd_idx) & 3u, 0u);
 
     // pc_plus4 策略：你当前是“即使 flush 也照常锁存 pc_plus4”
     // 这里给个严格断言：pc_plus4 == ifid.pc_plus4 (0x104)
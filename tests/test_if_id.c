@@ -105,6 +105,7 @@ static int test_plus4_basic(void) {
     ASSERT_EQ_U32("PC after 2nd tick == 8", pc_u, 8);
     ASSERT_EQ_U32("IF/ID.instr == im[1]", inst_u, 0x22222222);
     ASSERT_EQ_U32("IF/ID.pc_plus4 == 8", pc4_u, 8);
+    im_release(&im);
 }
 
 // ------------------------------------------------------------
@@ -155,6 +156,7 @@ static int test_stall_pc_and_ifid_hold(void) {
     ASSERT_EQ_U32("PC hold when pc_write=0", pc_u1, pc_u0);
     ASSERT_EQ_U32("IF/ID.instr hold when if_id_write=0", inst_u1, inst_u0);
     ASSERT_EQ_U32("IF/ID.pc_plus4 hold when if_id_write=0", pc4_u1, pc4_u0);
+    im_release(&im);
 }
 
 // ------------------------------------------------------------
@@ -204,6 +206,7 @@ static int test_flush_inject_nop(void) {
 
     // 目前你代码大概率会让 pc4_u 保持旧值（这条测试会提醒你改）
     printf("    [INFO] pc_plus4 after flush = 0x%08X (decide desired policy and assert it)\n", (unsigned) pc4_u);
+    im_release(&im);
 }
 
 
@@ -253,6 +256,7 @@ static int test_flush_inject_nop_strict(void) {
     ASSERT_EQ_U32("IF/ID.instr == NOP", inst_u, 0);
     ASSERT_EQ_U32("IF/ID.pc_plus4 == old_pc+4 (12)", pc4_u, 12);
     ASSERT_EQ_U32("PC after flush tick == 12", pc_after, 12);
+    im_release(&im);
 }
 
 // int main(void) {
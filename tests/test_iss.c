@@ -0,0 +1,201 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_iss.c
+// ISS 与门级流水线在无冒险的程序上架构状态一致; 中途在两者之间搬运状态不改变结果
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/iss.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#define ISS_PROGRAM_INSTS 40 // 每条后面跟 3 个 NOP, 加上结尾的自循环不超过 IM_SIZE
+#define ISS_RTL_CYCLES 400
+
+static uint64_t iss_rng_state = 0xA0761D6478BD642Full;
+
+static uint32_t iss_rng(void) {
+    iss_rng_state ^= iss_rng_state << 13;
+    iss_rng_state ^= iss_rng_state >> 7;
+    iss_rng_state ^= iss_rng_state << 17;
+    return (uint32_t) iss_rng_state;
+}
+
+// 随机程序: 每条指令后面 3 个 NOP (流水线没有前递), BEQ 只向前跳, 最后是 BEQ R0,R0,-1 自循环; 返回自循环的地址
+static uint32_t iss_rand_program(uint32_t *prog) {
+    int n = 0;
+    for (int k = 0; k < ISS_PROGRAM_INSTS; k++) {
+        const uint8_t a = iss_rng() & 3, b = iss_rng() & 3, d = iss_rng() & 3;
+        uint32_t inst;
+        switch (iss_rng() % 12) {
+            case 0: inst = enc_r(a, b, d, 0, FUNCT_ADD);
+                break;
+            case 1: inst = enc_r(a, b, d, 0, FUNCT_SUB);
+                break;
+            case 2: inst = enc_r(a, b, d, 0, FUNCT_AND);
+                break;
+            case 3: inst = enc_r(a, b, d, 0, FUNCT_OR);
+                break;
+            case 4: inst = enc_r(a, b, d, 0, FUNCT_SLT);
+                break;
+            case 5: inst = enc_r(a, b, d, 0, 0x26); // 未知 funct
+                break;
+            case 6:
+            case 7: inst = enc_addi(b, a, (int16_t) (iss_rng() % 200 - 100));
+                break;
+            case 8: inst = enc_i(OP_LW, a, b, (int16_t) ((iss_rng() % 64) * 4));
+                break;
+            case 9: inst = enc_i(OP_SW, a, b, (int16_t) ((iss_rng() % 64) * 4));
+                break;
+            case 10: inst = enc_j(OP_J, iss_rng() & 0xFF);
+                break;
+            default: {
+                // 目标不越过结尾的自循环
+                const int room = ISS_PROGRAM_INSTS * 4 - n - 1;
+                inst = enc_beq(a, b, (int16_t) (iss_rng() % (room < 8 ? room + 1 : 8)));
+                break;
+            }
+        }
+        prog[n++] = inst;
+        prog[n++] = 0;
+        prog[n++] = 0;
+        prog[n++] = 0;
+    }
+    prog[n] = enc_beq(0, 0, -1);
+    return (uint32_t) n * 4;
+}
+
+static int iss_same(const Iss *a, const Iss *b) {
+    return memcmp(a->r, b->r, sizeof(a->r)) == 0 && a->pc == b->pc && memcmp(a->dm, b->dm, sizeof(a->dm)) == 0;
+}
+
+static int test_iss_main_program(void) {
+    printf("=== test_iss_main_program ===\n");
+    static Iss s;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 100), 0, 0, 0
+    };
+    iss_init(&s);
+    iss_load_program(&s, program, sizeof(program) / sizeof(program[0]));
+    iss_run(&s, 20);
+    if (s.r[3] != 30 || s.r[2] != 30 || iss_dm_read_(&s, 100) != 30) FAIL("ISS main program: R3 / R2 / DM[100] != 30");
+    if (s.pc != 80 || s.instret != 20) FAIL("ISS main program: pc / instret");
+    PASS("ISS runs the main.c program to R3 = 30");
+    return 0;
+}
+
+// 整段在门级上跑完, 排空后与 ISS 比较
+static int test_iss_matches_rtl(void) {
+    printf("=== test_iss_matches_rtl ===\n");
+    static uint32_t prog[IM_SIZE];
+    static Iss ref, got;
+    static Cpu_core cpu;
+    for (int p = 0; p < 16; p++) {
+        memset(prog, 0, sizeof(prog));
+        const uint32_t halt = iss_rand_program(prog);
+        iss_init(&ref);
+        iss_load_program(&ref, prog, IM_SIZE);
+        for (int i = 0; i < 64; i++) ref.dm[i * 4 + 3] = (uint8_t) iss_rng();
+        got = ref;
+        iss_run(&ref, ISS_RTL_CYCLES);
+
+        cpu_release(&cpu); // 上一轮写时复制的私有副本
+        init_cpu_c(&cpu);
+        iss_to_cpu(&got, &cpu);
+        for (int cyc = 0; cyc < ISS_RTL_CYCLES; cyc++) cpu_step(&cpu);
+        iss_from_cpu(&got, &cpu);
+        if (ref.pc != halt || !iss_same(&ref, &got)) {
+            printf("[FAIL] program %d: pc iss=0x%08X rtl=0x%08X halt=0x%08X, R iss=%08X %08X %08X %08X rtl=%08X %08X %08X %08X\n",
+                   p, ref.pc, got.pc, halt, ref.r[0], ref.r[1], ref.r[2], ref.r[3], got.r[0], got.r[1], got.r[2],
+                   got.r[3]);
+            return 1;
+        }
+    }
+    PASS("ISS and RTL reach the same architectural state on 16 random programs");
+    return 0;
+}
+
+// ISS 快进 -> 门级跑一段 (可能停在分支半途) -> 排空读回 -> ISS 跑完, 与纯 ISS 一致
+static int test_iss_transfer_round_trip(void) {
+    printf("=== test_iss_transfer_round_trip ===\n");
+    static uint32_t prog[IM_SIZE];
+    static Iss ref, hyb;
+    static Cpu_core cpu;
+    for (int p = 0; p < 32; p++) {
+        memset(prog, 0, sizeof(prog));
+        iss_rand_program(prog);
+        iss_init(&ref);
+        iss_load_program(&ref, prog, IM_SIZE);
+        for (int i = 0; i < 64; i++) ref.dm[i * 4 + 3] = (uint8_t) iss_rng();
+        hyb = ref;
+        iss_run(&ref, ISS_RTL_CYCLES);
+
+        iss_run(&hyb, iss_rng() % 120);
+        cpu_release(&cpu); // 上一轮写时复制的私有副本
+        init_cpu_c(&cpu);
+        iss_to_cpu(&hyb, &cpu);
+        const int cycles = (int) (iss_rng() % 60);
+        for (int cyc = 0; cyc < cycles; cyc++) cpu_step(&cpu);
+        iss_from_cpu(&hyb, &cpu);
+        // 排空之后流水线可以接着跑
+        for (int cyc = 0; cyc < 8; cyc++) cpu_step(&cpu);
+        iss_from_cpu(&hyb, &cpu);
+        iss_run(&hyb, ISS_RTL_CYCLES);
+        if (!iss_same(&ref, &hyb)) {
+            printf("[FAIL] program %d (%d RTL cycles): pc ref=0x%08X hybrid=0x%08X\n", p, cycles, ref.pc, hyb.pc);
+            return 1;
+        }
+    }
+    PASS("ISS -> RTL -> ISS state transfer matches a pure ISS run on 32 random programs");
+    return 0;
+}
+
+// iss_exec_arch 按 isa.h 执行 J / BEQ, 与 iss_exec (跟着 RTL) 不同的地方记成已知偏差
+static int test_iss_arch_reference(void) {
+    printf("=== test_iss_arch_reference ===\n");
+    static Iss rtl, arch;
+    Iss_effect fx;
+    // R1 - R0 = 1: 最高字节为 0, RTL 跳, isa.h 不跳
+    iss_init(&rtl);
+    rtl.r[1] = 1;
+    rtl.im[0] = enc_beq(1, 0, 3);
+    arch = rtl;
+    iss_exec(&rtl, &fx);
+    if (rtl.pc != 16 || fx.deviation != ISS_DEV_NONE) FAIL("RTL BEQ: top byte zero should branch, no deviation");
+    iss_exec_arch(&arch, &fx);
+    if (arch.pc != 4 || fx.deviation != ISS_DEV_BEQ_TOP_BYTE || fx.rtl_next_pc != 16)
+        FAIL("arch BEQ: rs != rt must fall through and flag beq_top_byte");
+    // 相等时两边都跳, 不算偏差
+    iss_init(&arch);
+    arch.r[1] = arch.r[2] = 0x12345678;
+    arch.im[0] = enc_beq(1, 2, 3);
+    iss_exec_arch(&arch, &fx);
+    if (arch.pc != 16 || fx.deviation != ISS_DEV_NONE) FAIL("arch BEQ: rs == rt should branch without deviation");
+    // J: RTL 顺序执行, isa.h 跳到 (PC+4)[31:28] | addr << 2
+    iss_init(&rtl);
+    rtl.pc = 8;
+    rtl.im[2] = enc_j(OP_J, 0x40);
+    arch = rtl;
+    iss_exec(&rtl, &fx);
+    if (rtl.pc != 12) FAIL("RTL J should fall through");
+    iss_exec_arch(&arch, &fx);
+    if (arch.pc != 0x100 || fx.deviation != ISS_DEV_J_IGNORED || fx.rtl_next_pc != 12)
+        FAIL("arch J should jump to 0x100 and flag j_ignored");
+    PASS("iss_exec_arch: full 32-bit BEQ, J redirects, RTL next pc recorded as a known deviation");
+    return 0;
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_iss_main_program();
+//     rc |= test_iss_matches_rtl();
+//     rc |= test_iss_transfer_round_trip();
+//     rc |= test_iss_arch_reference();
+//     if (rc == 0) printf("ALL ISS TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -0,0 +1,71 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_lanes.c
+// bit-sliced 构建: 每个 lane 跑不同的随机程序 (BEQ 在一部分 lane 成立, IM 按各 lane 的 PC 分散读取),
+// 每个周期把每个 lane 的全部流水线寄存器 / PC / regfile / DM 与标量 cpu_step 比较
+// 只在 SCCPU_LANES > 1 下有内容, 需要与 SCCPU_LANES=1 编译的 lanes_ref.c 链接 (目标 sccpu_lanes_test)
+#include <stdio.h>
+
+#include "../includes/lanes.h"
+#include "../includes/netlist_cpu.h"
+#include "lanes_ref.h"
+
+#if SCCPU_LANES > 1
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#define LANES_TEST_CYCLES 400
+
+static int test_lanes_match_scalar(void) {
+    printf("=== test_lanes_match_scalar (%d lanes) ===\n", SCCPU_LANES);
+    static Cpu_core c;
+    static uint32_t prog[IM_SIZE];
+    static uint8_t dm[DEFAULT_SIZE], want_dm[DEFAULT_SIZE];
+    uint32_t want[NL_CPU_REG_NUM];
+    int pc_split = 0, lanes_taken = 0;
+    init_cpu_c(&c);
+    for (int lane = 0; lane < SCCPU_LANES; lane++) {
+        lanes_ref_load(lane, 0x9E3779B97F4A7C15ull * (uint64_t) (lane + 1), prog, IM_SIZE, dm, DEFAULT_SIZE);
+        cpu_lane_load_program(&c, lane, prog, IM_SIZE);
+        cpu_lane_load_dm(&c, lane, dm, DEFAULT_SIZE);
+    }
+    for (int cyc = 0; cyc < LANES_TEST_CYCLES; cyc++) {
+        cpu_step(&c);
+        int taken = 0;
+        for (int lane = 0; lane < SCCPU_LANES; lane++) {
+            lanes_ref_step(lane);
+            lanes_ref_regs(lane, want);
+            for (int r = 0; r < NL_CPU_REG_NUM; r++) {
+                const Nl_cpu_reg *reg = &NL_CPU_REGS_[r];
+                const bit *q = nl_cpu_q_(&c, reg);
+                uint32_t got = 0;
+                if (reg->width == WORD_SIZE) got = u32_from_word_lane(q, lane);
+                else for (int i = 0; i < reg->width; i++) got = got << 1 | (uint32_t) LANE_GET(q[i], lane);
+                if (got != want[r]) {
+                    printf("[FAIL] cycle %d lane %d %s: got 0x%08X, scalar 0x%08X\n", cyc, lane, reg->name, got,
+                           want[r]);
+                    return 1;
+                }
+            }
+            lanes_ref_dm(lane, want_dm, DEFAULT_SIZE);
+            if (memcmp(c.dm.memory[lane], want_dm, DEFAULT_SIZE) != 0) {
+                printf("[FAIL] cycle %d lane %d: DM differs from scalar\n", cyc, lane);
+                return 1;
+            }
+            taken += LANE_GET(c.wire_if_id_ctrl.if_id_flush, lane);
+        }
+        // 同一个周期里有的 lane BEQ 成立有的不成立, 各 lane 的 PC 不再相同
+        if (taken > 0 && taken < SCCPU_LANES) lanes_taken++;
+        for (int lane = 1; lane < SCCPU_LANES && !pc_split; lane++) {
+            pc_split = cpu_lane_read_pc(&c, lane) != cpu_lane_read_pc(&c, 0);
+        }
+    }
+    if (!lanes_taken || !pc_split) FAIL("random programs never diverged across lanes");
+    PASS("every lane matches scalar cpu_step each cycle (registers, PC, regfile, DM)");
+    return 0;
+}
+#endif
+
+// int main(void) {
+//     return test_lanes_match_scalar();
+// }
@@ -15,9 +15,9 @@
 
 // ------------------------------------------------------------
 // 本测试假设以下位约定：
-//   ex_mem.mem_single.bit30 = mem_write
-//   mem_wb.wb_single.bit31  = reg_write
-//   mem_wb.wb_single.bit30  = mem_to_reg (data_src_to_reg)
+//   ex_mem.mem_single.bit0 = mem_write   (Reg2_, 数值右对齐)
+//   mem_wb.wb_single.bit1  = reg_write
+//   mem_wb.wb_single.bit0  = mem_to_reg (data_src_to_reg)
 //
 // DM 策略：禁止非对齐 (addr & 3 != 0 => read/write return 1, 且不改内存)
 // ------------------------------------------------------------
@@ -43,11 +43,11 @@ static inline void exmem_set_u32(Ex_mem_regs *exm,
                                 uint32_t write_data,
                                 uint32_t write_reg_idx)
 {
-    reg32_write_u32_local(&exm->mem_single, mem_single);
-    reg32_write_u32_local(&exm->wb_single, wb_single);
+    reg2_write_u32(&exm->mem_single, mem_single);
+    reg2_write_u32(&exm->wb_single, wb_single);
     reg32_write_u32_local(&exm->alu_result, alu_result);
     reg32_write_u32_local(&exm->write_data, write_data);
-    reg32_write_u32_local(&exm->write_reg_idx, write_reg_idx);
+    reg2_write_u32(&exm->write_reg_idx, write_reg_idx);
 }
 
 static inline uint32_t dm_read_u32_local(Dm_ *dm, uint32_t addr_u32, bit *err) {
@@ -98,7 +98,7 @@ static int test_penetrate_and_latch(void) {
     // mem_single: mem_write=0（bit30=0）
     // wb_single: reg_write=1(bit31=1), mem_to_reg=1(bit30=1)
     const uint32_t mem_single = 0u;
-    const uint32_t wb_single  = (1u<<31) | (1u<<30);
+    const uint32_t wb_single  = (1u<<1) | (1u<<0);
 
     exmem_set_u32(&exm,
                   mem_single,
@@ -110,7 +110,7 @@ static int test_penetrate_and_latch(void) {
     memwb_tick(&exm, &mw, &dm, mask_all);
 
     ASSERT_EQ_U32("mw.wb_single latched",
-                 reg32_read_u32_local(&mw.wb_single),
+                 reg2_read_u32_(&mw.wb_single),
                  wb_single);
 
     ASSERT_EQ_U32("mw.alu_result latched",
@@ -118,13 +118,14 @@ static int test_penetrate_and_latch(void) {
                  0x00000040);
 
     ASSERT_EQ_U32("mw.write_reg_idx latched",
-                 reg32_read_u32_local(&mw.write_reg_idx),
+                 reg2_read_u32_(&mw.write_reg_idx),
                  0x00000002);
 
     ASSERT_EQ_U32("mw.mem_read_data latched from DM",
                  reg32_read_u32_local(&mw.mem_read_data),
                  0x11223344);
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -147,7 +148,7 @@ static int test_store_gating_and_disable(void) {
     // (A) mem_write=1，但 clk=0 不应写
     // 这里我们直接调用 mem_wb_regs_step 分相测试（不是 memwb_tick）
     exmem_set_u32(&exm,
-                  (1u<<30),      // mem_single.bit30=1 mem_write
+                  (1u<<0),       // mem_single.bit0=1 mem_write
                   0u,
                   addr,
                   0xAABBCCDD,
@@ -179,6 +180,7 @@ static int test_store_gating_and_disable(void) {
     uint32_t v2 = dm_read_u32_local(&dm, addr, &err);
     ASSERT_EQ_U32("mem_write=0 => store must NOT happen", v2, 0xAABBCCDD);
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -232,7 +234,7 @@ static int test_store_byte_masks(void) {
         };
 
         exmem_set_u32(&exm,
-                      (1u<<30), // mem_write=1
+                      (1u<<0), // mem_write=1
                       0u,
                       addr,
                       newv,
@@ -249,6 +251,7 @@ static int test_store_byte_masks(void) {
         ASSERT_EQ_U32(msg, got, exp);
     }
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -276,7 +279,7 @@ static int test_unaligned_forbidden_policy(void) {
 
     // 尝试对齐+1 写（应失败且不改内存）
     exmem_set_u32(&exm,
-                  (1u<<30),  // mem_write=1
+                  (1u<<0),  // mem_write=1
                   0u,
                   base + 1,  // unaligned
                   0xAABBCCDD,
@@ -299,6 +302,7 @@ static int test_unaligned_forbidden_policy(void) {
                  reg32_read_u32_local(&mw.mem_read_data),
                  0u);
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -321,7 +325,7 @@ static int test_last_word_boundary(void) {
 
     // store last word
     exmem_set_u32(&exm,
-                  (1u<<30),
+                  (1u<<0),
                   0u,
                   addr,
                   0xCAFEBABE,
@@ -339,6 +343,7 @@ static int test_last_word_boundary(void) {
     ASSERT_EQ_BIT("oob read err=1", err, 1);
     ASSERT_EQ_U32("oob read returns 0", oob, 0u);
 
+    dm_release(&dm);
     return 0;
 }
 
@@ -0,0 +1,259 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_netlist.c
+// 网表捕获只能在 bit[32] + 闭式 DFF 下编译, 本文件自己打开 SCCPU_NETLIST
+#define SCCPU_NETLIST 1
+#define SCCPU_DFF_CLOSED_FORM 1
+#include <stdio.h>
+
+#include "../includes/netlist_cpu.h"
+#include "../includes/netlist_par.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+static uint64_t nl_rng_state = 0xD1B54A32D192ED03ull;
+
+static uint32_t nl_rng(void) {
+    nl_rng_state ^= nl_rng_state << 13;
+    nl_rng_state ^= nl_rng_state >> 7;
+    nl_rng_state ^= nl_rng_state << 17;
+    return (uint32_t) nl_rng_state;
+}
+
+static uint32_t nl_rand_inst(void) {
+    const uint8_t a = nl_rng() & 3, b = nl_rng() & 3, d = nl_rng() & 3;
+    switch (nl_rng() % 10) {
+        case 0: return 0;
+        case 1: return enc_r(a, b, d, 0, FUNCT_ADD);
+        case 2: return enc_r(a, b, d, 0, FUNCT_SUB);
+        case 3: return enc_r(a, b, d, 0, FUNCT_AND);
+        case 4: return enc_r(a, b, d, 0, FUNCT_OR);
+        case 5: return enc_r(a, b, d, 0, FUNCT_SLT);
+        case 6: return enc_addi(a, b, (int16_t) (nl_rng() % 200 - 100));
+        case 7: return enc_i(OP_LW, b, a, (int16_t) ((nl_rng() % 64) * 4));
+        case 8: return enc_i(OP_SW, b, a, (int16_t) ((nl_rng() % 64) * 4));
+        default: return enc_beq(a, b, (int16_t) (nl_rng() % 6));
+    }
+}
+
+static Netlist ref_nl, opt_nl;
+static Nl_cpu_sim ref_sim, opt_sim;
+static uint8_t ref_val[NL_MAX_NODES], opt_val[NL_MAX_NODES];
+static Nl_par par;
+static uint8_t par_part_of_node[NL_MAX_NODES], par_part_of_port[NL_MAX_PORTS];
+
+static int test_netlist_passes_simplify(void) {
+    printf("=== test_netlist_passes_simplify ===\n");
+    nl_reset(&netlist_);
+    const bit x = nl_input_(), y = nl_input_();
+    const bit o1 = AND(x, BIT_1); // -> x
+    const bit o2 = OR(AND(x, NOT(x)), y); // -> y
+    const bit o3 = NOT(NOT(y)); // -> y
+    const bit o4 = AND(x, y);
+    const bit o5 = AND(y, x); // CSE -> o4
+    (void) OR(x, y); // 没有输出, 删除
+    const bit hold = nl_dff_(BIT_0); // D 端是自己: 永远是初值
+    nl_dff_connect_(hold, hold);
+    const bit o6 = OR(hold, x); // -> x
+    const bit outs[6] = {o1, o2, o3, o4, o5, o6};
+    for (int i = 0; i < 6; i++) nl_name_(outs[i], "o", i, 6, 1);
+
+    nl_optimize(&netlist_, 0);
+    const Nl_stats s = nl_stats(&netlist_);
+    if (s.gates != 1 || s.ops[NL_DFF] != 0 || s.ops[NL_INPUT] != 2) {
+        printf("[FAIL] gates=%u dff=%u inputs=%u, expected 1 / 0 / 2\n", s.gates, s.ops[NL_DFF], s.ops[NL_INPUT]);
+        return 1;
+    }
+    const Nl_name *n = netlist_.names;
+    if (n[0].node != n[5].node || n[1].node != n[2].node || n[3].node != n[4].node
+        || netlist_.nodes[n[0].node].op != NL_INPUT || netlist_.nodes[n[1].node].op != NL_INPUT
+        || netlist_.nodes[n[3].node].op != NL_AND) {
+        FAIL("outputs not merged as expected");
+    }
+    if (netlist_.n_levels != 2) {
+        printf("[FAIL] levels=%u, expected 2\n", netlist_.n_levels);
+        return 1;
+    }
+    PASS("const-prop / CSE / DCE / constant DFF reduce 8 gates + 1 DFF to one AND");
+    return 0;
+}
+
+// 捕获 decode(), 按 ISA 表检查 11 根控制线, 并与未优化的网表逐输出比较
+static int test_netlist_decoder(void) {
+    printf("=== test_netlist_decoder ===\n");
+    nl_reset(&netlist_);
+    word instr;
+    for (int i = 0; i < WORD_SIZE; i++) instr[i] = nl_input_();
+    const Control_signals cs = decode(instr);
+    const bit out[11] = {
+        cs.reg_dst, cs.alu_src, cs.data_src_to_reg, cs.reg_write, cs.mem_read, cs.mem_write, cs.branch, cs.jump,
+        cs.ops_[0], cs.ops_[1], cs.ops_[2]
+    };
+    for (int i = 0; i < 11; i++) nl_name_(out[i], "decode", i, 11, 1);
+    ref_nl = netlist_;
+    opt_nl = netlist_;
+    nl_optimize(&opt_nl, 0);
+
+    // 高位起: reg_dst alu_src data_src_to_reg reg_write mem_read mem_write branch jump ops[0..2]
+    const struct {
+        uint32_t inst;
+        uint32_t signals;
+    } table[] = {
+        {enc_r(1, 2, 3, 0, FUNCT_ADD), 0x484u},
+        {enc_r(1, 2, 3, 0, FUNCT_SUB), 0x485u},
+        {enc_r(1, 2, 3, 0, FUNCT_AND), 0x480u},
+        {enc_r(1, 2, 3, 0, FUNCT_OR), 0x481u},
+        {enc_r(1, 2, 3, 0, FUNCT_SLT), 0x486u},
+        {enc_addi(1, 2, -5), 0x284u},
+        {enc_i(OP_LW, 2, 1, 8), 0x3C4u},
+        {enc_i(OP_SW, 2, 1, 8), 0x224u},
+        {enc_beq(1, 2, 3), 0x015u},
+        {enc_j(OP_J, 100), 0x008u},
+        {0, 0x400u}, // NOP: R-Type 但不写回
+    };
+    int fail = 0;
+    for (size_t t = 0; t < sizeof(table) / sizeof(table[0]); t++) {
+        for (int i = 0; i < WORD_SIZE; i++) opt_val[2 + i] = (uint8_t) ((table[t].inst >> (WORD_SIZE - 1 - i)) & 1u);
+        nl_eval(&opt_nl, opt_val, NULL, NULL);
+        const uint32_t got = nl_read_named(&opt_nl, opt_val, "decode");
+        if (got != table[t].signals) {
+            printf("[FAIL] inst=0x%08X signals=0x%03X, expected 0x%03X\n", table[t].inst, got, table[t].signals);
+            fail = 1;
+        }
+    }
+    if (fail) return 1;
+
+    for (int k = 0; k < 4096; k++) {
+        const uint32_t v = k < 1024 ? (uint32_t) k << 22 | (nl_rng() & 0x3F) : nl_rng();
+        for (int i = 0; i < WORD_SIZE; i++) {
+            ref_val[2 + i] = opt_val[2 + i] = (uint8_t) ((v >> (WORD_SIZE - 1 - i)) & 1u);
+        }
+        nl_eval(&ref_nl, ref_val, NULL, NULL);
+        nl_eval(&opt_nl, opt_val, NULL, NULL);
+        if (nl_read_named(&ref_nl, ref_val, "decode") != nl_read_named(&opt_nl, opt_val, "decode")) {
+            printf("[FAIL] inst=0x%08X optimized decoder differs from captured one\n", v);
+            return 1;
+        }
+    }
+    const Nl_stats before = nl_stats(&ref_nl), after = nl_stats(&opt_nl);
+    printf("       decode gates %u -> %u\n", before.gates, after.gates);
+    PASS("captured decoder matches the ISA table, optimized netlist is equivalent");
+    return 0;
+}
+
+static int test_netlist_cpu_program(void) {
+    printf("=== test_netlist_cpu_program ===\n");
+    nl_capture_cpu(cpu_cycle_single_eval);
+    nl_optimize(&netlist_, 1);
+    if (netlist_.overflow) FAIL("netlist capacity exceeded");
+    const uint32_t prog[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 100),
+    };
+    nl_cpu_sim_init(&opt_sim, &netlist_);
+    nl_cpu_sim_load_program(&opt_sim, prog, sizeof(prog) / sizeof(prog[0]));
+    for (int cyc = 0; cyc < 24; cyc++) nl_cpu_sim_tick(&opt_sim);
+    const uint32_t r2 = nl_cpu_sim_reg(&opt_sim, "rf.r2"), r3 = nl_cpu_sim_reg(&opt_sim, "rf.r3");
+    if (r2 != 30 || r3 != 30 || opt_sim.dm[103] != 30) {
+        printf("[FAIL] r2=%u r3=%u dm[100]=%u\n", r2, r3, opt_sim.dm[103]);
+        return 1;
+    }
+    PASS("optimized CPU netlist runs ADDI/ADD/SW/LW program");
+    return 0;
+}
+
+// 原样捕获的 two-pass 网表 vs 优化后的 single-eval 网表: 所有寄存器和 DM 逐周期一致
+static int test_netlist_optimized_matches_captured(void) {
+    printf("=== test_netlist_optimized_matches_captured ===\n");
+    nl_capture_cpu(cpu_cycle_two_pass);
+    ref_nl = netlist_;
+    nl_capture_cpu(cpu_cycle_single_eval);
+    nl_optimize(&netlist_, 1);
+    opt_nl = netlist_;
+
+    for (int p = 0; p < 16; p++) {
+        nl_cpu_sim_init(&ref_sim, &ref_nl);
+        nl_cpu_sim_init(&opt_sim, &opt_nl);
+        for (int i = 0; i < 200; i++) ref_sim.im[i] = opt_sim.im[i] = nl_rand_inst();
+        for (int i = 0; i < 64; i++) ref_sim.dm[i * 4 + 3] = opt_sim.dm[i * 4 + 3] = (uint8_t) nl_rng();
+        for (int cyc = 0; cyc < 160; cyc++) {
+            nl_cpu_sim_tick(&ref_sim);
+            nl_cpu_sim_tick(&opt_sim);
+            for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+                const char *name = NL_CPU_REGS_[k].name;
+                if (nl_cpu_sim_reg(&ref_sim, name) != nl_cpu_sim_reg(&opt_sim, name)) {
+                    printf("[FAIL] program %d cycle %d: %s captured=0x%08X optimized=0x%08X\n", p, cyc, name,
+                           nl_cpu_sim_reg(&ref_sim, name), nl_cpu_sim_reg(&opt_sim, name));
+                    return 1;
+                }
+            }
+            if (memcmp(ref_sim.dm, opt_sim.dm, sizeof(ref_sim.dm)) != 0) {
+                printf("[FAIL] program %d cycle %d: DM differs\n", p, cyc);
+                return 1;
+            }
+        }
+    }
+    const Nl_stats before = nl_stats(&ref_nl), after = nl_stats(&opt_nl);
+    printf("       cpu gates %u -> %u, %u levels\n", before.gates, after.gates, after.levels);
+    PASS("optimized netlist matches captured two-pass netlist on 16 random programs");
+    return 0;
+}
+
+// 按阶段分区、多线程求值 vs 串行 nl_eval / nl_commit: 所有寄存器和 DM 逐周期一致
+static int test_netlist_partitioned_matches_serial(void) {
+    printf("=== test_netlist_partitioned_matches_serial ===\n");
+    nl_capture_cpu(cpu_cycle_single_eval);
+    nl_optimize(&netlist_, 1);
+    opt_nl = netlist_;
+    const int n_parts = nl_cpu_stage_partition(&opt_nl, par_part_of_node, par_part_of_port);
+
+    for (int p = 0; p < 6; p++) {
+        const int n_threads = 1 + p % 3;
+        nl_cpu_sim_init(&ref_sim, &opt_nl);
+        nl_cpu_sim_init(&opt_sim, &opt_nl); // 只用它的 IM / DM
+        for (int i = 0; i < 200; i++) ref_sim.im[i] = opt_sim.im[i] = nl_rand_inst();
+        for (int i = 0; i < 64; i++) ref_sim.dm[i * 4 + 3] = opt_sim.dm[i * 4 + 3] = (uint8_t) nl_rng();
+        if (nl_par_init(&par, &opt_nl, n_parts, par_part_of_node, par_part_of_port, n_threads, nl_cpu_mem_read_,
+                        nl_cpu_mem_write_, &opt_sim) != 0) FAIL("nl_par_init failed");
+        for (int cyc = 0; cyc < 120; cyc++) {
+            nl_cpu_sim_tick(&ref_sim);
+            nl_par_run(&par, 1);
+            for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+                const char *name = NL_CPU_REGS_[k].name;
+                const uint32_t a = nl_cpu_sim_reg(&ref_sim, name), b = nl_read_named(&opt_nl, par.state, name);
+                if (a != b) {
+                    printf("[FAIL] %d threads, program %d cycle %d: %s serial=0x%08X partitioned=0x%08X\n",
+                           n_threads, p, cyc, name, a, b);
+                    nl_par_stop(&par);
+                    return 1;
+                }
+            }
+            if (memcmp(ref_sim.dm, opt_sim.dm, sizeof(ref_sim.dm)) != 0) {
+                printf("[FAIL] %d threads, program %d cycle %d: DM differs\n", n_threads, p, cyc);
+                nl_par_stop(&par);
+                return 1;
+            }
+        }
+        nl_par_stop(&par);
+    }
+    const Nl_par_stats s = nl_par_stats(&par);
+    printf("       %d stage cones on %d threads: duplication %.2fx, ideal speedup %.2fx\n", n_parts,
+           par.n_threads, s.duplication, s.ideal_speedup);
+    PASS("partitioned netlist matches serial nl_eval on 1-3 threads");
+    return 0;
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_netlist_passes_simplify();
+//     rc |= test_netlist_decoder();
+//     rc |= test_netlist_cpu_program();
+//     rc |= test_netlist_optimized_matches_captured();
+//     rc |= test_netlist_partitioned_matches_serial();
+//     if (rc == 0) printf("ALL NETLIST TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -72,8 +72,8 @@ static void print_pipeline_state(const char *tag, Cpu_t *cpu) {
     // ID/EX Stage
     idex_rd1_v = reg32_read_u32(&cpu->idex.read_data1);
     idex_rd2_v = reg32_read_u32(&cpu->idex.read_data2);
-    idex_rs_idx_v = reg32_read_u32(&cpu->idex.rs_idx) & 3;
-    idex_rt_idx_v = reg32_read_u32(&cpu->idex.rt_idx) & 3;
+    idex_rs_idx_v = reg2_read_u32_(&cpu->idex.rs_idx) & 3;
+    idex_rt_idx_v = reg2_read_u32_(&cpu->idex.rt_idx) & 3;
 
     // EX/MEM Stage
     exmem_alu_v = reg32_read_u32(&cpu->exmem.alu_result);
@@ -105,7 +105,7 @@ static inline void hazard_comb_c(Cpu_t *c, const pc_ops pc_src, const word branc
     // 把 EX 的 pc_src/branch_target wire “立即”连接到 IF 的 pc_ops
     // connect wire if_id ops line
     for (int i = 0; i < WORD_SIZE; ++i) {
-        c->pc_ops.branch_target_wire[i] = branch_target[i];
+        WORD_SET(c->pc_ops.branch_target_wire, i, WORD_GET(branch_target, i));
     }
     // c->ifid_write 看起来是被"储存"了
     // 因为 branch_taken 是被实时计算出来的 也就是说 在 step2 阶段 branch_taken 也是会被计算的
@@ -139,7 +139,7 @@ static inline void cpu_phase(Cpu_t *c, const Im_t *im, bit clk) {
 
     c->id_ex_write.id_ex_write = id_ex_write;
     // // Reads from IF/ID.Q
-    id_ex_regs_step(&c->idex, &c->ifid, &c->rf, &c->id_ex_write, clk);
+    id_ex_regs_step(&c->idex, &c->ifid, &c->rf, &c->id_ex_write, NULL, clk);
 
     c->ifid_write.pc_write = pc_write;
     c->ifid_write.if_id_write = if_id_write;
@@ -221,6 +221,7 @@ static int test_parallelism_branch_feedback(void) {
     ASSERT_EQ_U32("cycle2 IF/ID.instr == NOP", reg32_read_u32(&cpu.ifid.instr), 0);
     printf("--- Cycle 2 OK ---\n");
 
+    im_release(&im);
     return 0;
 }
 
@@ -0,0 +1,173 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_perf.c
+// 性能计数器: main.c 程序的各项计数; 随机程序的退休数 / 指令构成 / 分支与对拍器和 ISS 一致; LW 读计数器区
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/cosim.h"
+#if SCCPU_PERF_COUNTERS
+#include "../includes/perf.h"
+#endif
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#if SCCPU_PERF_COUNTERS
+static uint64_t perf_rng_state = 0x3C6EF372FE94F82Bull;
+
+static void perf_test_load(Cpu_core *c, const uint32_t *program, const size_t len) {
+    init_cpu_c(c);
+    im_load(&c->im, program, len);
+}
+
+// ISS 那边的类别, 与 perf_classify_ 对同一条指令的结果相同
+static int perf_test_class(const uint32_t inst) {
+    switch (inst >> 26) {
+        case OP_R_TYPE:
+            if (inst == 0) return PERF_OP_NOP;
+            switch (inst & 0x3F) {
+                case FUNCT_ADD: return PERF_OP_ADD;
+                case FUNCT_SUB: return PERF_OP_SUB;
+                case FUNCT_OR: return PERF_OP_OR;
+                case FUNCT_SLT: return PERF_OP_SLT;
+                default: return PERF_OP_AND;
+            }
+        case OP_ADDI: return PERF_OP_ADDI;
+        case OP_LW: return PERF_OP_LW;
+        case OP_SW: return PERF_OP_SW;
+        case OP_BEQ: return PERF_OP_BEQ;
+        case OP_J: return PERF_OP_J;
+        default: return PERF_BUBBLES;
+    }
+}
+#endif
+
+// main.c 的程序跑 20 个周期: 前 4 个周期 WB 是气泡, 之后每个周期退休一条 (其中 12 条是 NOP)
+static int test_perf_main_program(void) {
+    printf("=== test_perf_main_program ===\n");
+#if !SCCPU_PERF_COUNTERS
+    printf("[SKIP] Cpu_core.perf only exists with SCCPU_PERF_COUNTERS=1\n");
+    return 0;
+#else
+    static Cpu_core c;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 100), 0, 0, 0
+    };
+    perf_test_load(&c, program, sizeof(program) / sizeof(program[0]));
+    for (int cyc = 0; cyc < 20; cyc++) {
+        cpu_step(&c);
+    }
+    if (perf_get(&c, PERF_CYCLES) != 20 || perf_get(&c, PERF_INSTRUCTIONS) != 16 || perf_get(&c, PERF_BUBBLES) != 4)
+        FAIL("20 cycles = 16 instructions + 4 bubbles");
+    if (perf_get(&c, PERF_OP_NOP) != 12 || perf_get(&c, PERF_OP_ADDI) != 2 || perf_get(&c, PERF_OP_ADD) != 1
+        || perf_get(&c, PERF_OP_SW) != 1 || perf_get(&c, PERF_OP_LW) != 0)
+        FAIL("mix: 12 nop / 2 addi / 1 add / 1 sw, the lw is still in flight");
+    if (perf_get(&c, PERF_REG_WRITES) != 3 || perf_get(&c, PERF_FLUSHES) != 0) FAIL("3 register writes, no flushes");
+    if (perf_cpi(&c) != 1.25) FAIL("CPI != 1.25");
+    cpu_release(&c);
+    PASS("cycles / instructions / bubbles / mix / CPI of the main.c program");
+    return 0;
+#endif
+}
+
+// 随机程序 (无冒险): 退休数与对拍器相同; 构成与 ISS 执行的前 N 条相同; 经过 EX 的 BEQ 成立 / 不成立的次数相同
+static int test_perf_matches_iss(void) {
+    printf("=== test_perf_matches_iss ===\n");
+#if !SCCPU_PERF_COUNTERS
+    printf("[SKIP] Cpu_core.perf only exists with SCCPU_PERF_COUNTERS=1\n");
+    return 0;
+#else
+    static Cpu_core c;
+    static Cosim k;
+    static Iss ref;
+    static uint32_t prog[IM_SIZE];
+    for (int round = 0; round < 8; round++) {
+        memset(prog, 0, sizeof(prog));
+        cosim_random_program(prog, 60, 3, &perf_rng_state);
+        perf_test_load(&c, prog, IM_SIZE);
+        cosim_init(&k, &c);
+        iss_read_cpu(&ref, &c);
+        const int cycles = 100 + 40 * round;
+        for (int cyc = 0; cyc < cycles; cyc++) {
+            if (cosim_step(&k, &c)) FAIL("cosim diverged on a hazard-free program");
+            }
+        if (perf_get(&c, PERF_INSTRUCTIONS) != k.retired) FAIL("instructions != instructions retired by cosim");
+        if (perf_get(&c, PERF_CYCLES) != perf_get(&c, PERF_INSTRUCTIONS) + perf_get(&c, PERF_BUBBLES))
+            FAIL("cycles != instructions + bubbles");
+        // MEM / WB 里的两条已经过了 EX, 分支已经数过, 还没退休
+        const uint64_t past_ex = k.retired + (c.perf.mem != PERF_BUBBLES) + (c.perf.wb != PERF_BUBBLES);
+        uint64_t mix[PERF_NUM] = {0}, taken = 0, not_taken = 0, writes = 0;
+        for (uint64_t i = 0; i < past_ex; i++) {
+            const uint32_t pc = ref.pc, inst = pc / 4 < IM_SIZE ? ref.im[pc / 4] : 0;
+            if (perf_test_class(inst) == PERF_OP_BEQ) {
+                // 按条件算, 不看 next PC: 偏移 0 的 BEQ 成立时也冲刷
+                if (iss_beq_taken_rtl_(ref.r[inst >> 21 & 3], ref.r[inst >> 16 & 3])) taken++;
+                else not_taken++;
+            }
+            Iss_effect fx;
+            iss_exec(&ref, &fx);
+            if (i >= k.retired) continue;
+            mix[perf_test_class(inst)]++;
+            writes += fx.reg_write;
+        }
+        for (int e = PERF_OP_NOP; e < PERF_NUM; e++) {
+            if (perf_get(&c, (Perf_event) e) != mix[e]) {
+                printf("[FAIL] round %d: %s = %lu, ISS executed %lu\n", round, PERF_NAMES_[e],
+                       perf_get(&c, (Perf_event) e), mix[e]);
+                return 1;
+            }
+        }
+        if (perf_get(&c, PERF_REG_WRITES) != writes) FAIL("register writes != ISS register writes");
+        if (perf_get(&c, PERF_BRANCH_TAKEN) != taken || perf_get(&c, PERF_BRANCH_NOT_TAKEN) != not_taken)
+            FAIL("branches taken / not taken != ISS");
+        if (perf_get(&c, PERF_FLUSHES) != taken) FAIL("every taken branch flushes once");
+        cpu_release(&c);
+    }
+    PASS("8 random programs: retired count, mix, register writes and branches match cosim / ISS");
+    return 0;
+#endif
+}
+
+// LW 读计数器区: 这条 LW 在 MEM 的周期开始时的 cycles / instructions, 高 32 位是 0; 区外照旧读 DM
+static int test_perf_mmio(void) {
+    printf("=== test_perf_mmio ===\n");
+#if !SCCPU_PERF_COUNTERS
+    printf("[SKIP] Cpu_core.perf only exists with SCCPU_PERF_COUNTERS=1\n");
+    return 0;
+#else
+    static Cpu_core c;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 5), 0, 0, 0,
+        enc_i(OP_LW, 0, 1, PERF_MMIO_BASE + 8 * PERF_CYCLES), // 周期 4 取指, 周期 7 在 MEM
+        enc_i(OP_LW, 0, 2, PERF_MMIO_BASE + 8 * PERF_INSTRUCTIONS),
+        enc_i(OP_LW, 0, 3, PERF_MMIO_BASE + 8 * PERF_CYCLES + 4),
+        enc_i(OP_LW, 0, 0, 8), 0, 0, 0, 0
+    };
+    perf_test_load(&c, program, sizeof(program) / sizeof(program[0]));
+    dm_poke(&c.dm, 11, 0x5A);
+    for (int cyc = 0; cyc < 16; cyc++) {
+        cpu_step(&c);
+    }
+    if (reg32_read_u32_(&c.rf.r1) != 7) FAIL("LW of cycles: expected 7 (value at the start of its MEM cycle)");
+    if (reg32_read_u32_(&c.rf.r2) != 4) FAIL("LW of instructions: expected 8 cycles - 4 bubbles = 4");
+    if (reg32_read_u32_(&c.rf.r3) != 0) FAIL("high word of cycles should be 0");
+    if (reg32_read_u32_(&c.rf.r0) != 0x5A) FAIL("LW below the counter region should still read DM");
+    cpu_release(&c);
+    PASS("LW reads cycles / instructions from the counter region, other addresses read DM");
+    return 0;
+#endif
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_perf_main_program();
+//     rc |= test_perf_matches_iss();
+//     rc |= test_perf_mmio();
+//     if (rc == 0) printf("ALL PERF TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -0,0 +1,195 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_pipeview.c
+// 流水线时间线: 每条指令逐级前进一个周期; 成立的 BEQ 冲掉 IF / ID 里的两条, 下一条从目标取; 日志可以解析回来
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/pipeview.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#define PIPEVIEW_TEST_FILE(x) "sccpu_test_pipeview_" x
+#define PV_TEST_MAX 64
+
+// 从 Kanata 日志里读回来的一条指令
+typedef struct pv_test_inst {
+    int seen;
+    uint32_t pc;
+    char text[48];
+    long start[PV_STAGE_NUM]; // 进入每一级的周期, -1 -> 没进过
+    long end; // R 的周期, -1 -> 没有
+    int flushed;
+} Pv_test_inst;
+
+static int pv_test_stage(const char *name) {
+    for (int k = 0; k < PV_STAGE_NUM; k++) {
+        if (strcmp(name, PV_STAGE_NAMES_[k]) == 0) return k;
+    }
+    return -1;
+}
+
+// 解析日志; 返回指令条数, 格式不对返回 -1
+static int pv_test_parse(const char *path, Pv_test_inst *insts) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[128], name[16];
+    long cycle = 0, n = -1;
+    unsigned long id, x;
+    int type, bad = 0;
+    memset(insts, 0, sizeof(Pv_test_inst) * PV_TEST_MAX);
+    if (!fgets(line, sizeof(line), f) || strcmp(line, "Kanata\t0004\n") != 0) bad = 1;
+    while (!bad && fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "C=\t%ld", &cycle) == 1) continue;
+        if (sscanf(line, "C\t%lu", &x) == 1) {
+            cycle += (long) x;
+        } else if (sscanf(line, "I\t%lu\t%lu\t%d", &id, &x, &type) == 3) {
+            if (id >= PV_TEST_MAX || insts[id].seen) bad = 1;
+            else {
+                insts[id].seen = 1;
+                insts[id].end = -1;
+                for (int k = 0; k < PV_STAGE_NUM; k++) insts[id].start[k] = -1;
+                if ((long) id > n) n = (long) id;
+            }
+        } else if (sscanf(line, "L\t%lu\t0\t%lX:", &id, &x) == 2) {
+            if (id >= PV_TEST_MAX || !insts[id].seen) bad = 1;
+            else {
+                insts[id].pc = (uint32_t) x;
+                snprintf(insts[id].text, sizeof(insts[id].text), "%s", strchr(line, ':') + 2);
+                insts[id].text[strcspn(insts[id].text, "\n")] = 0;
+            }
+        } else if (sscanf(line, "S\t%lu\t0\t%15s", &id, name) == 2) {
+            if (id >= PV_TEST_MAX || !insts[id].seen || pv_test_stage(name) < 0) bad = 1;
+            else insts[id].start[pv_test_stage(name)] = cycle;
+        } else if (sscanf(line, "E\t%lu\t0\t%15s", &id, name) == 2) {
+            if (id >= PV_TEST_MAX || !insts[id].seen || pv_test_stage(name) < 0) bad = 1;
+        } else if (sscanf(line, "R\t%lu\t%lu\t%d", &id, &x, &type) == 3) {
+            if (id >= PV_TEST_MAX || !insts[id].seen || insts[id].end >= 0) bad = 1;
+            else {
+                insts[id].end = cycle;
+                insts[id].flushed = type;
+            }
+        } else {
+            bad = 1;
+        }
+    }
+    fclose(f);
+    return bad ? -1 : (int) (n + 1);
+}
+
+static int pv_test_run(const uint32_t *program, const size_t len, const int cycles, Pipeview *p) {
+    static Cpu_core c;
+    init_cpu_c(&c);
+    im_load(&c.im, program, len);
+    if (pipeview_open(p, PIPEVIEW_TEST_FILE("run.kanata"), &c) != 0) return 1;
+    for (int cyc = 0; cyc < cycles; cyc++) {
+        cpu_step(&c);
+        pipeview_record(p, &c);
+    }
+    cpu_release(&c);
+    return pipeview_close(p);
+}
+
+// main.c 的程序: 没有冒险, 第 i 条在周期 i 取指, 之后每个周期前进一级, i + 5 时退休
+static int test_pipeview_main_program(void) {
+    printf("=== test_pipeview_main_program ===\n");
+    static Pipeview p;
+    static Pv_test_inst insts[PV_TEST_MAX];
+    const uint32_t program[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 100), 0, 0, 0
+    };
+    if (pv_test_run(program, sizeof(program) / sizeof(program[0]), 20, &p) != 0) FAIL("cannot write timeline");
+    const int n = pv_test_parse(PIPEVIEW_TEST_FILE("run.kanata"), insts);
+    if (n != 20 || p.fetched != 20 || p.retired != 16 || p.flushed != 0) FAIL("20 fetched / 16 retired / 0 flushed");
+    for (int i = 0; i < n; i++) {
+        if (insts[i].pc != (uint32_t) i * 4) FAIL("instruction i not fetched from 4 * i");
+        for (int k = 0; k < PV_STAGE_NUM; k++) {
+            if (i + k < 20 && insts[i].start[k] != i + k) FAIL("instruction i not in stage k at cycle i + k");
+        }
+        if (insts[i].end != (i < 16 ? i + 5 : -1) || insts[i].flushed) FAIL("instruction i not retired at i + 5");
+    }
+    if (strcmp(insts[8].text, "add r3, r1, r2") != 0 || strcmp(insts[12].text, "sw r3, 100(r0)") != 0)
+        FAIL("labels");
+    remove(PIPEVIEW_TEST_FILE("run.kanata"));
+    PASS("every instruction advances one stage per cycle and retires 5 cycles after fetch");
+    return 0;
+}
+
+// 0x04 的 BEQ 在周期 3 的 EX 算出跳转: 周期 3 在 ID (0x08) 和 IF (0x0C) 的两条被冲掉, 周期 4 从 0x14 取指
+static int test_pipeview_branch_flush(void) {
+    printf("=== test_pipeview_branch_flush ===\n");
+    static Pipeview p;
+    static Pv_test_inst insts[PV_TEST_MAX];
+    const uint32_t program[] = {enc_addi(1, 0, 10), enc_beq(0, 0, 3)};
+    if (pv_test_run(program, 2, 10, &p) != 0) FAIL("cannot write timeline");
+    const int n = pv_test_parse(PIPEVIEW_TEST_FILE("run.kanata"), insts);
+    if (n != 10 || p.flushed != 2) FAIL("10 fetched / 2 flushed");
+    if (!insts[2].flushed || insts[2].pc != 0x08 || insts[2].start[PV_ID] != 3 || insts[2].start[PV_EX] >= 0
+        || insts[2].end != 4)
+        FAIL("0x08 should be flushed out of ID at the end of cycle 3");
+    if (!insts[3].flushed || insts[3].pc != 0x0C || insts[3].start[PV_IF] != 3 || insts[3].start[PV_ID] >= 0
+        || insts[3].end != 4)
+        FAIL("0x0C should be flushed out of IF at the end of cycle 3");
+    if (insts[4].pc != 0x14 || insts[4].start[PV_IF] != 4) FAIL("branch target 0x14 not fetched in cycle 4");
+    if (insts[1].flushed || insts[1].end != 6 || strcmp(insts[1].text, "beq r0, r0, 3") != 0)
+        FAIL("the BEQ itself should retire");
+    remove(PIPEVIEW_TEST_FILE("run.kanata"));
+    PASS("taken BEQ flushes the two younger instructions and fetch resumes at the target");
+    return 0;
+}
+
+// SCCPU_PIPEVIEW 时 cpu_step 推进各自挂上的时间线: 两个核交替推进, 各自的日志只有自己的指令, 没挂的核不写
+static int test_pipeview_per_core(void) {
+    printf("=== test_pipeview_per_core ===\n");
+#if !SCCPU_PIPEVIEW
+    printf("[SKIP] Cpu_core.pipeview only exists with SCCPU_PIPEVIEW=1\n");
+    return 0;
+#else
+    static Cpu_core a, b, idle;
+    static Pipeview pa, pb;
+    static Pv_test_inst insts[PV_TEST_MAX];
+    const uint32_t branch[] = {enc_addi(1, 0, 10), enc_beq(0, 0, 3)};
+    init_cpu_c(&a);
+    init_cpu_c(&b);
+    init_cpu_c(&idle);
+    im_load(&b.im, branch, 2);
+    if (pipeview_open(&pa, PIPEVIEW_TEST_FILE("a.kanata"), &a) != 0
+        || pipeview_open(&pb, PIPEVIEW_TEST_FILE("b.kanata"), &b) != 0) FAIL("cannot write timelines");
+    pipeview_attach(&a, &pa);
+    pipeview_attach(&b, &pb);
+    for (int cyc = 0; cyc < 20; cyc++) {
+        cpu_step(&a);
+        if (cyc < 10) cpu_step(&b);
+        cpu_step(&idle);
+    }
+    if (pipeview_close(&pa) != 0 || pipeview_close(&pb) != 0) FAIL("write error");
+    if (pv_test_parse(PIPEVIEW_TEST_FILE("a.kanata"), insts) != 20 || pa.fetched != 20 || pa.flushed != 0)
+        FAIL("core a's timeline picked up another core's cycles");
+    if (pv_test_parse(PIPEVIEW_TEST_FILE("b.kanata"), insts) != 10 || pb.flushed != 2 || insts[4].pc != 0x14)
+        FAIL("core b's timeline does not show its own branch flush");
+    if (idle.pipeview) FAIL("a core without a timeline got one");
+    init_cpu_c(&a);
+    if (a.pipeview) FAIL("init_cpu_c kept the timeline attached");
+    cpu_release(&a);
+    cpu_release(&b);
+    cpu_release(&idle);
+    remove(PIPEVIEW_TEST_FILE("a.kanata"));
+    remove(PIPEVIEW_TEST_FILE("b.kanata"));
+    PASS("interleaved cores write their own timelines; unattached cores write none");
+    return 0;
+#endif
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_pipeview_main_program();
+//     rc |= test_pipeview_branch_flush();
+//     rc |= test_pipeview_per_core();
+//     if (rc == 0) printf("ALL PIPEVIEW TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -0,0 +1,129 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_rewind.c
+// 后退 N 个周期得到的状态与正向运行时那个周期的状态相同; 内存固定, 超出范围的后退被拒绝
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/cosim.h"
+#include "../includes/checkpoint.h"
+#include "../includes/rewind.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#define REWIND_TEST_CYCLES 600
+
+static uint64_t rewind_rng_state = 0xD1B54A32D192ED03ull;
+
+static uint32_t rewind_rng(void) {
+    rewind_rng_state ^= rewind_rng_state << 13;
+    rewind_rng_state ^= rewind_rng_state >> 7;
+    rewind_rng_state ^= rewind_rng_state << 17;
+    return (uint32_t) rewind_rng_state;
+}
+
+// 正向跑一遍记下每个周期的完整状态, 然后随机前后移动, 每次都与记录比较
+static int test_rewind_matches_history(void) {
+    printf("=== test_rewind_matches_history ===\n");
+    static Cpu_core c;
+    static Rewind r;
+    static uint8_t hist[REWIND_TEST_CYCLES + 1][CPU_CKPT_MAX_BYTES], cur[CPU_CKPT_MAX_BYTES];
+    const size_t n = cpu_checkpoint_size();
+    cosim_load_random(&c, 60, 1, 0, &rewind_rng_state);
+    rewind_init(&r, &c, REWIND_TEST_CYCLES);
+    cpu_checkpoint_pack(&c, hist[0]);
+    for (int cyc = 1; cyc <= REWIND_TEST_CYCLES; cyc++) {
+        rewind_step(&r, &c);
+        cpu_checkpoint_pack(&c, hist[cyc]);
+    }
+    for (int k = 0; k < 40; k++) {
+        const uint64_t back = rewind_rng() % (c.cycle_count + 1);
+        const int64_t replayed = rewind_back(&r, &c, back);
+        if (replayed < 0 || (uint64_t) replayed >= r.interval) FAIL("rewind_back within the horizon failed");
+        cpu_checkpoint_pack(&c, cur);
+        if (memcmp(cur, hist[c.cycle_count], n) != 0) {
+            printf("[FAIL] state after stepping back %lu cycles to cycle %lu differs\n", back, c.cycle_count);
+            return 1;
+        }
+        // 再往前跑一段, 重新走到的周期也要一致
+        const uint64_t fwd = rewind_rng() % (REWIND_TEST_CYCLES - c.cycle_count + 1);
+        for (uint64_t i = 0; i < fwd; i++) rewind_step(&r, &c);
+        cpu_checkpoint_pack(&c, cur);
+        if (memcmp(cur, hist[c.cycle_count], n) != 0) FAIL("forward run after rewinding left the original history");
+    }
+    PASS("40 random backward / forward moves reproduce the recorded states");
+    return 0;
+}
+
+static int test_rewind_bounded(void) {
+    printf("=== test_rewind_bounded ===\n");
+    static Cpu_core c;
+    static Rewind r;
+    static uint8_t before[CPU_CKPT_MAX_BYTES], after[CPU_CKPT_MAX_BYTES];
+    const uint64_t horizon = 300;
+    cosim_load_random(&c, 60, 1, 0, &rewind_rng_state);
+    rewind_init(&r, &c, horizon);
+    for (int cyc = 0; cyc < 5000; cyc++) rewind_step(&r, &c);
+    if (r.count != REWIND_SLOTS) FAIL("ring not full after a long run");
+    if (c.cycle_count - rewind_oldest(&r) < horizon) FAIL("reach is shorter than the requested horizon");
+    cpu_checkpoint_pack(&c, before);
+    if (rewind_back(&r, &c, 2000) != -1) FAIL("stepping back past the oldest snapshot was accepted");
+    if (rewind_back(&r, &c, c.cycle_count + 1) != -1) FAIL("stepping back before cycle 0 was accepted");
+    cpu_checkpoint_pack(&c, after);
+    if (memcmp(before, after, cpu_checkpoint_size()) != 0) FAIL("rejected rewind modified the core");
+    if (rewind_back(&r, &c, horizon) < 0 || c.cycle_count != 5000 - horizon) FAIL("stepping back by the horizon failed");
+    PASS("fixed-size ring covers the horizon and rejects older targets");
+    return 0;
+}
+
+#if SCCPU_PERF_COUNTERS
+static int perf_same(const Perf_counters *a, const Perf_counters *b) {
+    return memcmp(a->v, b->v, sizeof(a->v)) == 0 && a->id_valid == b->id_valid && a->ex == b->ex
+           && a->mem == b->mem && a->wb == b->wb && a->wb_reg_write == b->wb_reg_write;
+}
+#endif
+
+// 后退之后的计数器与正向跑到那个周期时相同, 重放的周期不重复计数
+static int test_rewind_perf_counters(void) {
+    printf("=== test_rewind_perf_counters ===\n");
+#if !SCCPU_PERF_COUNTERS
+    printf("[SKIP] Cpu_core.perf only exists with SCCPU_PERF_COUNTERS=1\n");
+    return 0;
+#else
+    static Cpu_core c;
+    static Rewind r;
+    static Perf_counters hist[REWIND_TEST_CYCLES + 1];
+    cosim_load_random(&c, 60, 1, 0, &rewind_rng_state);
+    rewind_init(&r, &c, REWIND_TEST_CYCLES);
+    hist[0] = c.perf;
+    for (int cyc = 1; cyc <= REWIND_TEST_CYCLES; cyc++) {
+        rewind_step(&r, &c);
+        hist[cyc] = c.perf;
+    }
+    for (int k = 0; k < 40; k++) {
+        const uint64_t back = rewind_rng() % (c.cycle_count + 1);
+        if (rewind_back(&r, &c, back) < 0) FAIL("rewind_back within the horizon failed");
+        if (!perf_same(&c.perf, &hist[c.cycle_count])) {
+            printf("[FAIL] counters after stepping back to cycle %lu differ (cycles=%lu, expected %lu)\n",
+                   c.cycle_count, c.perf.v[PERF_CYCLES], hist[c.cycle_count].v[PERF_CYCLES]);
+            return 1;
+        }
+        const uint64_t fwd = rewind_rng() % (REWIND_TEST_CYCLES - c.cycle_count + 1);
+        for (uint64_t i = 0; i < fwd; i++) rewind_step(&r, &c);
+        if (!perf_same(&c.perf, &hist[c.cycle_count]))
+            FAIL("counters after running forward again differ");
+    }
+    PASS("perf counters follow 40 random backward / forward moves");
+    return 0;
+#endif
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_rewind_matches_history();
+//     rc |= test_rewind_bounded();
+//     rc |= test_rewind_perf_counters();
+//     if (rc == 0) printf("ALL REWIND TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -0,0 +1,109 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_shared_images.c
+// 相同的作业在批量运行里只保留一份镜像; SCCPU_SHARED_IMAGES=1 时多个 Cpu_core 共享 IM / DM 镜像,
+// 写 DM 只复制被写的页, 不影响镜像和其他核
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/batch.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+// main.c 的程序: R3 = 10 + 20, SW R3 -> DM[100], LW R2 <- DM[8]
+#define SHARED_MAIN_LEN 20
+static uint32_t shared_main_program[SHARED_MAIN_LEN];
+
+static void shared_build_main(void) {
+    const uint32_t program[SHARED_MAIN_LEN] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 8), 0, 0, 0
+    };
+    memcpy(shared_main_program, program, sizeof(program));
+}
+
+static uint32_t shared_dm_u32(const Dm_ *dm, const int addr) {
+    static uint8_t m[DEFAULT_SIZE];
+    dm_copy_out(dm, m);
+    return (uint32_t) m[addr] << 24 | (uint32_t) m[addr + 1] << 16 | (uint32_t) m[addr + 2] << 8 | (uint32_t) m[addr + 3];
+}
+
+// 8 个作业只有 2 种 (程序, DM) 组合: 去重后 2 个镜像, 结果与预装一致
+static int test_shared_batch_dedup(void) {
+    printf("=== test_shared_batch_dedup ===\n");
+    static Batch b;
+    static uint8_t dm[DEFAULT_SIZE];
+    dm[8] = 0xDE, dm[9] = 0xAD, dm[10] = 0xBE, dm[11] = 0xEF; // 大端
+    shared_build_main();
+    batch_init(&b);
+    for (int k = 0; k < 8; k++) {
+        char name[16];
+        snprintf(name, sizeof(name), "job%d", k);
+        batch_add(&b, name, shared_main_program, SHARED_MAIN_LEN, k & 1 ? dm : NULL, (uint64_t) (30 + k));
+    }
+    if (b.n_images != 2 || b.jobs[0].image == b.jobs[1].image || b.jobs[0].image != b.jobs[6].image)
+        FAIL("identical jobs not deduplicated into 2 images");
+    batch_run(&b, 3);
+    for (int k = 0; k < 8; k++) {
+        const Batch_job *j = &b.jobs[k];
+        if (!j->done || j->r[3] != 30 || j->r[2] != (k & 1 ? 0xDEADBEEF : 0)) {
+            printf("[FAIL] job %s: R3 = %u, R2 = 0x%08X\n", j->name, j->r[3], j->r[2]);
+            return 1;
+        }
+#if SCCPU_SHARED_IMAGES
+        if (j->dm_pages != 1) FAIL("SW to DM[100] should copy exactly one page");
+#endif
+    }
+    batch_free(&b);
+    PASS("8 jobs share 2 images and still see their own DM preload");
+    return 0;
+}
+
+#if SCCPU_SHARED_IMAGES
+// 两个核挂同一对镜像: 一个写 DM 之后, 另一个和镜像本身都不变
+static int test_shared_copy_on_write(void) {
+    printf("=== test_shared_copy_on_write ===\n");
+    static Im_image im;
+    static Dm_image dm;
+    static Cpu_core a, b;
+    shared_build_main();
+    im_image_load(&im, shared_main_program, SHARED_MAIN_LEN);
+    memset(&dm, 0, sizeof(dm));
+    dm.memory[11] = 0x5A;
+    init_cpu_c(&a);
+    init_cpu_c(&b);
+    im_attach(&a.im, &im);
+    im_attach(&b.im, &im);
+    dm_attach(&a.dm, &dm);
+    dm_attach(&b.dm, &dm);
+    for (int cyc = 0; cyc < 30; cyc++) cpu_step(&a);
+    if (reg32_read_u32_(&a.rf.r3) != 30 || reg32_read_u32_(&a.rf.r2) != 0x5A) FAIL("core a: R3 != 30 or R2 != DM[8]");
+    if (shared_dm_u32(&a.dm, 100) != 30) FAIL("core a does not see its own store");
+    if (dm_private_pages(&a.dm) != 1 || dm_private_pages(&b.dm) != 0) FAIL("private page count");
+    if (shared_dm_u32(&b.dm, 100) != 0 || dm.memory[100] != 0) FAIL("store leaked into the image or the other core");
+    for (int cyc = 0; cyc < 30; cyc++) cpu_step(&b);
+    if (reg32_read_u32_(&b.rf.r3) != 30 || shared_dm_u32(&b.dm, 100) != 30) FAIL("core b after its own run");
+    if (a.dm.page[100 / DM_PAGE_SIZE] == b.dm.page[100 / DM_PAGE_SIZE]) FAIL("both cores write the same page");
+    if (a.dm.page[1] != dm.memory + DM_PAGE_SIZE || b.dm.page[DM_PAGES - 1] != dm.memory + DEFAULT_SIZE - DM_PAGE_SIZE)
+        FAIL("untouched page no longer shared");
+    dm_release(&a.dm);
+    dm_release(&b.dm);
+    if (dm_private_pages(&a.dm) != 0 || dm_private_pages(&b.dm) != 0) FAIL("dm_release left private pages");
+    PASS("a store copies one page; the image and the other core are unchanged");
+    return 0;
+}
+#endif
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_shared_batch_dedup();
+// #if SCCPU_SHARED_IMAGES
+//     rc |= test_shared_copy_on_write();
+// #endif
+//     if (rc == 0) printf("ALL SHARED IMAGE TESTS PASSED ✅\n");
+//     return rc;
+// }
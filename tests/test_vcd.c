@@ -0,0 +1,133 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_vcd.c
+// VCD 文件的层次 / 变量定义; main.c 程序的最终值; 只写变化; 分支冲刷在 if_id_flush 上可见
+#include <stdio.h>
+
+#include "common_test.h"
+#include "../includes/vcd.h"
+
+#define PASS(msg) do { printf("[PASS] %s\n", (msg)); } while (0)
+#define FAIL(msg) do { printf("[FAIL] %s\n", (msg)); return 1; } while (0)
+
+#define VCD_TEST_FILE(x) "sccpu_test_vcd_" x
+
+// 在 VCD 文件里找名字为 scope.var 的变量的标识; 找不到返回 -1
+static int vcd_find_id(const char *path, const char *scope, const char *var, char id[8]) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[256], cur[64] = "", name[64], ident[8];
+    int found = -1;
+    while (fgets(line, sizeof(line), f) && strncmp(line, "$enddefinitions", 15) != 0) {
+        if (sscanf(line, "$scope module %63s $end", name) == 1) snprintf(cur, sizeof(cur), "%s", name);
+        if (sscanf(line, "$var %*s %*d %7s %63s $end", ident, name) == 2 && strcmp(cur, scope) == 0
+            && strcmp(name, var) == 0) {
+            snprintf(id, 8, "%s", ident);
+            found = 0;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+// 统计 $enddefinitions 之后的值行数, 并记下标识为 id 的信号最后的值 / 是否出现过 want
+static int vcd_scan_values(const char *path, const char *id, char last[40], const char *want, int *seen) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[256];
+    int defs = 1, n = 0;
+    last[0] = 0;
+    *seen = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\n")] = 0;
+        if (defs) {
+            defs = strncmp(line, "$enddefinitions", 15) != 0;
+            continue;
+        }
+        if (line[0] == '#' || line[0] == '$') continue;
+        n++;
+        const char *sp = strchr(line, ' ');
+        const char *val_id = line[0] == 'b' ? (sp ? sp + 1 : "") : line + 1;
+        if (strcmp(val_id, id) != 0) continue;
+        if (line[0] == 'b') snprintf(last, 40, "%.*s", (int) (sp - line), line);
+        else snprintf(last, 40, "%c", line[0]);
+        if (strcmp(last, want) == 0) *seen = 1;
+    }
+    fclose(f);
+    return n;
+}
+
+// main.c 的程序跑 60 个周期: rf.r3 最后是 30, 写出的值行数就是 changes, 不到逐周期全写的 1/4
+// (前 24 个周期程序还在流水线里; 之后的 NOP 尾巴只有 PC 那一串在变)
+static int test_vcd_main_program(void) {
+    printf("=== test_vcd_main_program ===\n");
+    static Cpu_core c;
+    static Vcd v;
+    const uint32_t program[] = {
+        enc_addi(1, 0, 10), 0, 0, 0,
+        enc_addi(2, 0, 20), 0, 0, 0,
+        enc_r(1, 2, 3, 0, FUNCT_ADD), 0, 0, 0,
+        enc_i(OP_SW, 0, 3, 100), 0, 0, 0,
+        enc_i(OP_LW, 0, 2, 8), 0, 0, 0
+    };
+    init_cpu_c(&c);
+    im_load(&c.im, program, sizeof(program) / sizeof(program[0]));
+    if (vcd_open(&v, VCD_TEST_FILE("main.vcd")) != 0) FAIL("cannot open VCD file");
+    for (int cyc = 0; cyc < 60; cyc++) {
+        cpu_step(&c);
+        vcd_sample(&v, &c);
+    }
+    if (vcd_close(&v) != 0) FAIL("write error");
+
+    char r3[8], pc[8], flush[8], last[40];
+    int seen;
+    if (vcd_find_id(VCD_TEST_FILE("main.vcd"), "rf", "r3", r3) != 0) FAIL("cpu.rf.r3 not declared");
+    if (vcd_find_id(VCD_TEST_FILE("main.vcd"), "pc", "reg32", pc) != 0) FAIL("cpu.pc.reg32 not declared");
+    if (vcd_find_id(VCD_TEST_FILE("main.vcd"), "if_id_ctrl", "if_id_flush", flush) != 0)
+        FAIL("cpu.wires.if_id_ctrl.if_id_flush not declared");
+    // 阶段导线只在驱动它们的周期模式下导出
+    if ((vcd_find_id(VCD_TEST_FILE("main.vcd"), "if", "pc_plus4", last) == 0) != (VCD_WIRES == NL_CPU_WIRE_NUM))
+        FAIL("cpu.wires.if.pc_plus4 declared iff the cycle mode drives it");
+    const int n = vcd_scan_values(VCD_TEST_FILE("main.vcd"), r3, last, "b11110", &seen);
+    if (strcmp(last, "b11110") != 0) FAIL("last value of rf.r3 is not 30");
+    if (n != (int) v.changes) FAIL("value lines != changes");
+    if (v.samples != 60 || v.changes >= (uint64_t) VCD_SIGNALS * 60 / 4) FAIL("change-only output is not compact");
+    remove(VCD_TEST_FILE("main.vcd"));
+    cpu_release(&c);
+    PASS("rf.r3 ends at 30 and only changed values are written");
+    return 0;
+}
+
+// 成立的 BEQ 冲刷 IF/ID: if_id_flush 先出现 1 又回到 0
+static int test_vcd_branch_flush(void) {
+    printf("=== test_vcd_branch_flush ===\n");
+    static Cpu_core c;
+    static Vcd v;
+    init_cpu_c(&c);
+    im_store(&c.im, 0, enc_addi(1, 0, 10));
+    im_store(&c.im, 4, enc_beq(0, 0, 3));
+    if (vcd_open(&v, VCD_TEST_FILE("beq.vcd")) != 0) FAIL("cannot open VCD file");
+    for (int cyc = 0; cyc < 20; cyc++) {
+        cpu_step(&c);
+        vcd_sample(&v, &c);
+    }
+    if (vcd_close(&v) != 0) FAIL("write error");
+    char flush[8], last[40];
+    int seen;
+    if (vcd_find_id(VCD_TEST_FILE("beq.vcd"), "if_id_ctrl", "if_id_flush", flush) != 0)
+        FAIL("if_id_flush not declared");
+    vcd_scan_values(VCD_TEST_FILE("beq.vcd"), flush, last, "1", &seen);
+    if (!seen || strcmp(last, "0") != 0) FAIL("if_id_flush did not pulse for the taken BEQ");
+    remove(VCD_TEST_FILE("beq.vcd"));
+    cpu_release(&c);
+    PASS("taken BEQ shows a pulse on wires.if_id_ctrl.if_id_flush");
+    return 0;
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_vcd_main_program();
+//     rc |= test_vcd_branch_flush();
+//     if (rc == 0) printf("ALL VCD TESTS PASSED ✅\n");
+//     return rc;
+// }
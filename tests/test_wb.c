@@ -19,10 +19,10 @@ static inline void mw_set_u32(Mem_wb_regs *mw,
                              uint32_t alu_result,
                              uint32_t write_reg_idx)
 {
-    reg32_write_u32(&mw->wb_single, wb_single);
+    reg2_write_u32(&mw->wb_single, wb_single);
     reg32_write_u32(&mw->mem_read_data, mem_read_data);
     reg32_write_u32(&mw->alu_result, alu_result);
-    reg32_write_u32(&mw->write_reg_idx, write_reg_idx);
+    reg2_write_u32(&mw->write_reg_idx, write_reg_idx);
 }
 
 static inline uint32_t rf_read_idx(Reg324file_ *rf, int idx) {
@@ -43,12 +43,12 @@ static inline void rf_write_idx_force(Reg324file_ *rf, int idx, uint32_t v) {
     }
 }
 
-// wb_single 位约定：bit31=reg_write, bit30=mem_to_reg
+// wb_single 位约定：bit1=reg_write, bit0=mem_to_reg
 static inline uint32_t mk_wb_single(bit reg_write, bit mem_to_reg) {
-    return ((uint32_t)(reg_write & 1) << 31) | ((uint32_t)(mem_to_reg & 1) << 30);
+    return ((uint32_t)(reg_write & 1) << 1) | ((uint32_t)(mem_to_reg & 1) << 0);
 }
 
-// write_reg_idx 约定：只用低2位（bit1..bit0），其余位无所谓
+// write_reg_idx 约定：只有低2位（bit1..bit0）
 static inline uint32_t mk_idx_u32(uint32_t idx2) {
     return (idx2 & 3u);
 }
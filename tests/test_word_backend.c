@@ -0,0 +1,178 @@
+//
+// Created by wenshen on 2026/10/17.
+// test_word_backend.c
+// 只通过 WORD_GET/WORD_SET/u32_to_word 访问 word, bit 数组与 packed 两种后端都可以编译
+#include <stdio.h>
+#include <stdint.h>
+
+#include "../includes/common.h"
+#include "../includes/mux.h"
+#include "../includes/alu.h"
+#include "../includes/isa.h"
+#include "../includes/utils.h"
+
+#ifndef ASSERT_EQ_U32
+#define ASSERT_EQ_U32(name, actual, expected) do { \
+if ((uint32_t)(actual) != (uint32_t)(expected)) { \
+printf("[FAIL] %s: got=0x%08X (%u), expected=0x%08X (%u)\n", \
+(name), (uint32_t)(actual), (uint32_t)(actual), (uint32_t)(expected), (uint32_t)(expected)); \
+return 1; \
+} else { \
+printf("[PASS] %s\n", (name)); \
+} \
+} while (0)
+#endif
+
+static uint32_t wb_rng_state = 0x1234ABCDu;
+
+static uint32_t wb_rng(void) {
+    wb_rng_state ^= wb_rng_state << 13;
+    wb_rng_state ^= wb_rng_state >> 17;
+    wb_rng_state ^= wb_rng_state << 5;
+    return wb_rng_state;
+}
+
+static int test_word_bit_order(void) {
+    printf("=== test_word_bit_order ===\n");
+    word w = {0};
+    u32_to_word(0x80000001u, w);
+    ASSERT_EQ_U32("word[0] is MSB", WORD_GET(w, 0), 1);
+    ASSERT_EQ_U32("INST_BIT(w,0) is LSB", INST_BIT(w, 0), 1);
+    ASSERT_EQ_U32("INST_BIT(w,1)", INST_BIT(w, 1), 0);
+
+    WORD_SET(w, INST_WORD(4), 1);
+    WORD_SET(w, INST_WORD(31), 0);
+    ASSERT_EQ_U32("WORD_SET round trip", word_to_u32(w), 0x00000011u);
+    ASSERT_EQ_U32("u32_from_word", u32_from_word(w), 0x00000011u);
+
+    word s = {0};
+    u32_to_word(0x40000003u, w);
+    word_lshift2(w, s);
+    ASSERT_EQ_U32("word_lshift2", word_to_u32(s), 0x0000000Cu);
+    return 0;
+}
+
+static int test_word_gates_and_mux(void) {
+    printf("=== test_word_gates_and_mux ===\n");
+    for (int it = 0; it < 1000; ++it) {
+        const uint32_t a = wb_rng(), b = wb_rng();
+        word wa, wb_, out;
+        u32_to_word(a, wa);
+        u32_to_word(b, wb_);
+
+        word_and_(wa, wb_, out);
+        if (word_to_u32(out) != (a & b)) ASSERT_EQ_U32("word_and_", word_to_u32(out), a & b);
+        word_or_(wa, wb_, out);
+        if (word_to_u32(out) != (a | b)) ASSERT_EQ_U32("word_or_", word_to_u32(out), a | b);
+        word_xor_(wa, wb_, out);
+        if (word_to_u32(out) != (a ^ b)) ASSERT_EQ_U32("word_xor_", word_to_u32(out), a ^ b);
+        word_not_(wa, out);
+        if (word_to_u32(out) != ~a) ASSERT_EQ_U32("word_not_", word_to_u32(out), ~a);
+
+        word_mux_2_1(wa, wb_, 0, out);
+        if (word_to_u32(out) != a) ASSERT_EQ_U32("word_mux_2_1 sel=0", word_to_u32(out), a);
+        word_mux_2_1(wa, wb_, 1, out);
+        if (word_to_u32(out) != b) ASSERT_EQ_U32("word_mux_2_1 sel=1", word_to_u32(out), b);
+        // 输出与输入同一根总线
+        word_mux_2_1(wa, wb_, 1, wa);
+        if (word_to_u32(wa) != b) ASSERT_EQ_U32("word_mux_2_1 aliased", word_to_u32(wa), b);
+    }
+    word z = {0};
+    ASSERT_EQ_U32("word_any_(0)", word_any_(z), 0);
+    WORD_SET(z, 17, 1);
+    ASSERT_EQ_U32("word_any_(bit)", word_any_(z), 1);
+    ASSERT_EQ_U32("nop_(NOP)", nop_(NOP), 1);
+    printf("[PASS] word gates / mux random 1000 ✅\n");
+    return 0;
+}
+
+static int test_word_alu_vs_golden(void) {
+    printf("=== test_word_alu_vs_golden ===\n");
+    for (int it = 0; it < 20000; ++it) {
+        uint32_t a = wb_rng(), b = wb_rng();
+        if (it % 5 == 0) b = a;
+        if (it % 7 == 0) a = 0x7FFFFFFFu;
+        if (it % 11 == 0) b = 0x80000000u;
+
+        word wa, wb_, out;
+        u32_to_word(a, wa);
+        u32_to_word(b, wb_);
+        bit ov = 0;
+
+        word_alu_(wa, wb_, out, OPS_ADD_, &ov);
+        const uint64_t add = (uint64_t) a + b;
+        if (word_to_u32(out) != (uint32_t) add) ASSERT_EQ_U32("ADD", word_to_u32(out), (uint32_t) add);
+        if (ov != (bit) (add >> 32)) ASSERT_EQ_U32("ADD carry", ov, add >> 32);
+
+        word_alu_(wa, wb_, out, OPS_SUB_, &ov);
+        if (word_to_u32(out) != a - b) ASSERT_EQ_U32("SUB", word_to_u32(out), a - b);
+        // 减法器 carry = NOT(borrow)
+        if (ov != (bit) (a >= b)) ASSERT_EQ_U32("SUB carry", ov, a >= b);
+
+        word_alu_(wa, wb_, out, OPS_SLT_, &ov);
+        if (word_to_u32(out) != (uint32_t) ((int32_t) a < (int32_t) b))
+            ASSERT_EQ_U32("SLT", word_to_u32(out), (int32_t) a < (int32_t) b);
+
+        word_alu_(wa, wb_, out, OPS_AND_, &ov);
+        if (word_to_u32(out) != (a & b) || ov) ASSERT_EQ_U32("AND", word_to_u32(out), a & b);
+        word_alu_(wa, wb_, out, OPS_OR_, &ov);
+        if (word_to_u32(out) != (a | b) || ov) ASSERT_EQ_U32("OR", word_to_u32(out), a | b);
+        word_alu_(wa, wb_, out, OPS_XOR_, &ov);
+        if (word_to_u32(out) != (a ^ b) || ov) ASSERT_EQ_U32("XOR", word_to_u32(out), a ^ b);
+        word_alu_(wa, wb_, out, OPS_NOR_, &ov);
+        if (word_to_u32(out) != ~(a | b) || ov) ASSERT_EQ_U32("NOR", word_to_u32(out), ~(a | b));
+        word_alu_(wa, wb_, out, OPS_NULL_, &ov);
+        if (word_to_u32(out) != 0 || ov) ASSERT_EQ_U32("NULL", word_to_u32(out), 0);
+    }
+    printf("[PASS] word_alu_ random 20000 x 8 ops ✅\n");
+    return 0;
+}
+
+// adder.h 的四种进位网络 (与 SCCPU_ADDER 无关, 全部都测)
+static int test_prefix_adders_vs_golden(void) {
+    printf("=== test_prefix_adders_vs_golden ===\n");
+    for (int k = 0; k < ADDER_NUM; k++) {
+        const Prefix_adder *adder = &PREFIX_ADDERS_[k];
+        for (int it = 0; it < 5000; ++it) {
+            uint32_t a = wb_rng(), b = wb_rng();
+            if (it % 7 == 0) b = ~a; // 进位一路传到底
+            const bit cin = (bit) (it & 1);
+
+            word wa, wb_, sum;
+            u32_to_word(a, wa);
+            u32_to_word(b, wb_);
+            bit carry_into_msb = 0, cout = 0;
+            word_prefix_add_(adder, wa, wb_, cin, sum, &carry_into_msb, &cout);
+
+            const uint64_t full = (uint64_t) a + b + cin;
+            const uint32_t low31 = (a & 0x7FFFFFFFu) + (b & 0x7FFFFFFFu) + cin;
+            if (word_to_u32(sum) != (uint32_t) full) ASSERT_EQ_U32(adder->name, word_to_u32(sum), (uint32_t) full);
+            if (cout != (bit) (full >> 32)) ASSERT_EQ_U32("cout", cout, full >> 32);
+            if (carry_into_msb != (bit) (low31 >> 31)) ASSERT_EQ_U32("carry into msb", carry_into_msb, low31 >> 31);
+        }
+    }
+    printf("[PASS] ripple / cla4 / kogge-stone / brent-kung random 5000 adds\n");
+
+    const Adder_stats rc = adder_stats(&PREFIX_ADDERS_[ADDER_RIPPLE]);
+    const Adder_stats ks = adder_stats(&PREFIX_ADDERS_[ADDER_KOGGE_STONE]);
+    const Adder_stats bk = adder_stats(&PREFIX_ADDERS_[ADDER_BRENT_KUNG]);
+    // ripple: 预处理 66 + 31 个节点 (不需要 P) + 求和 32; 进位链 cin 折叠 3 级 + 31 个节点 * 2 级
+    ASSERT_EQ_U32("ripple gates", rc.gates, 66 + 31 * 2 + 32);
+    ASSERT_EQ_U32("ripple depth", rc.depth, 3 + 31 * 2);
+    ASSERT_EQ_U32("kogge-stone levels", ks.levels, 5);
+    ASSERT_EQ_U32("kogge-stone depth", ks.depth, 3 + 5 * 2);
+    ASSERT_EQ_U32("brent-kung levels", bk.levels, 9);
+    ASSERT_EQ_U32("brent-kung smaller than kogge-stone", bk.gates < ks.gates, 1);
+    ASSERT_EQ_U32("brent-kung deeper than kogge-stone", bk.depth > ks.depth, 1);
+    return 0;
+}
+
+// int main(void) {
+//     int rc = 0;
+//     rc |= test_word_bit_order();
+//     rc |= test_word_gates_and_mux();
+//     rc |= test_word_alu_vs_golden();
+//     rc |= test_prefix_adders_vs_golden();
+//     if (rc == 0) printf("ALL WORD BACKEND TESTS PASSED ✅\n");
+//     return rc;
+// }
@@ -0,0 +1,49 @@
+//
+// Created by wenshen on 2026/10/17.
+// 加法器报告: 各进位网络的门数 / 逻辑深度 / 整字求值层数, 以及在当前 word 后端下的实测耗时
+// 构建: 默认 bit 后端; -DSCCPU_PACKED_WORD=1 看 packed 后端
+#include <stdio.h>
+#include <time.h>
+#include "../includes/alu.h"
+#include "../includes/utils.h"
+
+#define ITERS 200000
+
+int main(void) {
+    printf("=== SCCPU adders (%s word, SCCPU_ADDER=%s) ===\n",
+           SCCPU_PACKED_WORD ? "packed" : "bit", PREFIX_ADDERS_[SCCPU_ADDER].name);
+    printf("%-12s %6s %6s %7s %10s\n", "adder", "gates", "depth", "levels", "ns/add");
+
+    word a, b, sum;
+    uint32_t x = 0x12345678u;
+    volatile uint32_t sink = 0;
+    for (int k = 0; k < ADDER_NUM; k++) {
+        const Prefix_adder *adder = &PREFIX_ADDERS_[k];
+        const Adder_stats s = adder_stats(adder);
+
+        const clock_t t0 = clock();
+        for (int i = 0; i < ITERS; i++) {
+            x = x * 1664525u + 1013904223u;
+            u32_to_word(x, a);
+            u32_to_word(~x >> 1, b);
+            bit carry_into_msb = BIT_0, cout = BIT_0;
+            word_prefix_add_(adder, a, b, BIT_0, sum, &carry_into_msb, &cout);
+            sink += u32_from_word(sum);
+        }
+        const double ns = (double) (clock() - t0) / CLOCKS_PER_SEC * 1e9 / ITERS;
+        printf("%-12s %6d %6d %7d %10.1f\n", adder->name, s.gates, s.depth, s.levels, ns);
+    }
+
+    // word_alu_ 是整个 ALU (ADD/SUB/SLT 共用的加法器 + 逻辑运算 + 选择)
+    const clock_t t0 = clock();
+    for (int i = 0; i < ITERS; i++) {
+        x = x * 1664525u + 1013904223u;
+        u32_to_word(x, a);
+        u32_to_word(~x >> 1, b);
+        bit overflow = BIT_0;
+        word_alu_(a, b, sum, OPS_ADD_, &overflow);
+        sink += u32_from_word(sum);
+    }
+    printf("word_alu_ ADD: %.1f ns\n", (double) (clock() - t0) / CLOCKS_PER_SEC * 1e9 / ITERS);
+    return 0;
+}
@@ -0,0 +1,113 @@
+//
+// Created by wenshen on 2026/10/17.
+// 批量运行: 按清单把作业分给一组线程, 结果写成 CSV / JSON
+// 用法: sccpu_batch [manifest | demo] [threads] [csv file] [json file]   (默认 demo / 核数 / 不写 / 不写)
+// demo: 4 个循环程序 (迭代次数不同) x 16 个周期预算 = 64 个作业, 只有 4 个镜像;
+// 先单线程再多线程, 比较两次的结果并打印加速比; 用 SCCPU_SHARED_IMAGES=1 编译时 (sccpu_batch_shared) 作业共享镜像
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../includes/batch.h"
+
+#define DEMO_PROGRAMS 4
+#define DEMO_JOBS 64
+#define DEMO_CYCLES 2000
+
+static uint32_t prog[IM_SIZE];
+static int prog_len;
+
+// 流水线没有前递: 每条指令后面补 3 个 NOP; 返回这条指令的下标
+static int emit(const uint32_t inst) {
+    const int at = prog_len;
+    prog[prog_len++] = inst;
+    for (int i = 0; i < 3; i++) prog[prog_len++] = 0;
+    return at;
+}
+
+// 与 sccpu_iss 相同: R1 = 1..n, R3 += R1, 每次把 R3 存到 R0 指向的 DM 并 R0 += 4; 结束后停在自循环
+static void build_program(const int n) {
+    memset(prog, 0, sizeof(prog));
+    prog_len = 0;
+    emit(enc_addi(1, 0, 0));
+    emit(enc_addi(2, 0, (int16_t) n));
+    emit(enc_addi(3, 0, 0));
+    const int loop = emit(enc_addi(1, 1, 1));
+    emit(enc_r(3, 1, 3, 0, FUNCT_ADD));
+    emit(enc_i(OP_SW, 0, 3, 0));
+    emit(enc_addi(0, 0, 4));
+    const int exit_beq = emit(0);
+    const int back = emit(0);
+    const int halt = prog_len;
+    prog[prog_len++] = enc_beq(0, 0, -1);
+    prog[exit_beq] = enc_beq(1, 2, (int16_t) (halt - exit_beq - 1));
+    prog[back] = enc_beq(0, 0, (int16_t) (loop - back - 1));
+}
+
+static int write_results(const Batch *b, const char *csv, const char *json) {
+    if (csv) {
+        FILE *f = fopen(csv, "w");
+        if (!f) return 1;
+        batch_write_csv(b, f);
+        fclose(f);
+        printf("wrote %s\n", csv);
+    }
+    if (json) {
+        FILE *f = fopen(json, "w");
+        if (!f) return 1;
+        batch_write_json(b, f);
+        fclose(f);
+        printf("wrote %s\n", json);
+    }
+    return 0;
+}
+
+int main(const int argc, char **argv) {
+    const char *manifest = argc > 1 ? argv[1] : "demo";
+    const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    const int threads = argc > 2 ? atoi(argv[2]) : (int) (cores > 0 ? cores : 1);
+    const char *csv = argc > 3 ? argv[3] : NULL;
+    const char *json = argc > 4 ? argv[4] : NULL;
+    static Batch b, serial;
+
+    batch_init(&b);
+    if (strcmp(manifest, "demo") != 0) {
+        if (batch_load_manifest(&b, manifest) != 0) return 1;
+        if (batch_run(&b, threads) != 0) printf("[BATCH] could not start all %d threads\n", threads);
+        batch_report(&b);
+        const int rc = write_results(&b, csv, json);
+        batch_free(&b);
+        return rc;
+    }
+
+    for (int p = 0; p < DEMO_PROGRAMS; p++) {
+        const int iterations = 25 << p;
+        build_program(iterations);
+        for (int k = 0; k < DEMO_JOBS / DEMO_PROGRAMS; k++) {
+            char name[32];
+            snprintf(name, sizeof(name), "loop%d_%02d", iterations, k);
+            batch_add(&b, name, prog, (size_t) prog_len, NULL, (uint64_t) DEMO_CYCLES * (k + 1) / 4);
+        }
+    }
+    if (batch_clone(&serial, &b) != 0) {
+        printf("[BATCH] out of memory\n");
+        return 1;
+    }
+    printf("=== SCCPU batch demo (%d jobs over %d program images, %d..%d cycles) ===\n", b.n_jobs, b.n_images,
+           DEMO_CYCLES / 4, DEMO_CYCLES * (DEMO_JOBS / DEMO_PROGRAMS) / 4);
+    batch_run(&serial, 1);
+    batch_report(&serial);
+    if (batch_run(&b, threads) != 0) printf("[BATCH] could not start all %d threads\n", threads);
+    batch_report(&b);
+    int same = 1;
+    for (int i = 0; i < b.n_jobs; i++) {
+        const Batch_job *x = &b.jobs[i], *y = &serial.jobs[i];
+        same &= x->done && memcmp(x->r, y->r, sizeof(x->r)) == 0 && x->pc == y->pc
+                && x->cycle_count == y->cycle_count && x->dm_digest == y->dm_digest;
+    }
+    printf("speedup %.2fx on %d threads\n", (double) serial.wall_ns / (double) b.wall_ns, b.n_threads);
+    printf(same ? "PARALLEL RESULTS MATCH SERIAL RUN ✅\n" : "PARALLEL RESULTS DIFFER FROM SERIAL RUN\n");
+    const int rc = write_results(&b, csv, json) || !same;
+    batch_free(&b);
+    batch_free(&serial);
+    return rc;
+}
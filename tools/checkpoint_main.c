@@ -0,0 +1,86 @@
+//
+// Created by wenshen on 2026/10/17.
+// checkpoint: 随机程序跑到一半存档, 打印文件大小和 pack / unpack / save / load 的耗时,
+// 再从文件恢复接着跑, 与没停过的那次比较; 最后打印 rewind 快照的大小 / 耗时和一次后退的重放代价
+// 用法: sccpu_checkpoint [cycles before save] [cycles after restore] [file]   (默认 5000 / 5000 / sccpu.ckpt)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../includes/cosim.h"
+#include "../includes/checkpoint.h"
+#include "../includes/rewind.h"
+
+#define REPEAT 2000
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+int main(const int argc, char **argv) {
+    const int before = argc > 1 ? atoi(argv[1]) : 5000;
+    const int after = argc > 2 ? atoi(argv[2]) : 5000;
+    const char *path = argc > 3 ? argv[3] : "sccpu.ckpt";
+    static Cpu_core cpu, restored;
+    static uint8_t buf[CPU_CKPT_MAX_BYTES], ka[CPU_CKPT_MAX_BYTES], kb[CPU_CKPT_MAX_BYTES];
+    uint64_t rng = 0x243F6A8885A308D3ull;
+
+    cosim_load_random(&cpu, 60, 1, 0, &rng);
+    for (int cyc = 0; cyc < before; cyc++) cpu_step(&cpu);
+
+    const size_t n = cpu_checkpoint_size();
+    printf("=== SCCPU checkpoint (%zu bytes: %zu state bits + IM %d B + DM %d B) ===\n", n, cpu_ckpt_state_bits_(),
+           IM_SIZE * 4, DEFAULT_SIZE);
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < REPEAT; i++) cpu_checkpoint_pack(&cpu, buf);
+    const double pack_ns = (double) (now_ns() - t0) / REPEAT;
+    t0 = now_ns();
+    for (int i = 0; i < REPEAT; i++) cpu_checkpoint_unpack(&restored, buf, n);
+    const double unpack_ns = (double) (now_ns() - t0) / REPEAT;
+    t0 = now_ns();
+    if (cpu_checkpoint_save(&cpu, path) != CPU_CKPT_OK) {
+        printf("cannot write %s\n", path);
+        return 1;
+    }
+    const double save_ns = (double) (now_ns() - t0);
+    init_cpu_c(&restored);
+    t0 = now_ns();
+    const int rc = cpu_checkpoint_load(&restored, path);
+    const double load_ns = (double) (now_ns() - t0);
+    if (rc != CPU_CKPT_OK) {
+        printf("cannot load %s (error %d)\n", path, rc);
+        return 1;
+    }
+    printf("pack   : %8.2f us\n", pack_ns / 1e3);
+    printf("unpack : %8.2f us\n", unpack_ns / 1e3);
+    printf("save   : %8.2f us (%s)\n", save_ns / 1e3, path);
+    printf("load   : %8.2f us\n", load_ns / 1e3);
+
+    for (int cyc = 0; cyc < after; cyc++) {
+        cpu_step(&cpu);
+        cpu_step(&restored);
+    }
+    cpu_checkpoint_pack(&cpu, ka);
+    cpu_checkpoint_pack(&restored, kb);
+    const int same = memcmp(ka, kb, n) == 0;
+    printf("cycle %lu: ", restored.cycle_count);
+    printf(same ? "RESTORED RUN MATCHES UNINTERRUPTED RUN ✅\n" : "RESTORED RUN DIFFERS\n");
+
+    // rewind: 能后退 after 个周期
+    static Rewind r;
+    static Rewind_snap snap;
+    rewind_init(&r, &cpu, (uint64_t) after);
+    t0 = now_ns();
+    for (int i = 0; i < REPEAT; i++) rewind_snap_take_(&snap, &cpu);
+    const double snap_ns = (double) (now_ns() - t0) / REPEAT;
+    for (int cyc = 0; cyc < after; cyc++) rewind_step(&r, &cpu);
+    t0 = now_ns();
+    const int back = after * 2 / 3;
+    const int64_t replayed = rewind_back(&r, &cpu, (uint64_t) back);
+    const double back_ns = (double) (now_ns() - t0);
+    printf("rewind : %d slots x %zu B = %zu B, K = %lu, snapshot %.2f us, back %d cycles replayed %ld in %.2f us\n",
+           REWIND_SLOTS, sizeof(Rewind_snap), rewind_bytes(), r.interval, snap_ns / 1e3, back, replayed,
+           back_ns / 1e3);
+    return !same;
+}
@@ -0,0 +1,385 @@
+//
+// Created by wenshen on 2026/10/17.
+// 编译仿真生成器: 捕获整个 CPU, 优化之后按层输出一个直线型 C 函数 compiled_cpu_cycle_(Compiled_cpu *s)
+// 构建: -DSCCPU_NETLIST=1 -DSCCPU_DFF_CLOSED_FORM=1 (目标 sccpu_netlist_codegen), 用法: sccpu_netlist_codegen <out.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../includes/netlist_cpu.h"
+
+/**
+ * 每个节点放在某个 uint32_t 变量的某一位 (槽位):
+ *  寄存器的 Q    -> q<k> (= s->reg[k]) 的逻辑位
+ *  读端口的输出  -> m<p> 的逻辑位
+ *  门            -> 同一层里能一起算的门打包成一个 w<g>, 位置跟着 "主输入" (位置较高的那个输入) 走
+ *
+ * 一组门的形状 (key) 相同:
+ *  对齐:  op(A 的第 i 位, B 的第 i - d 位)   -> w = A op (B << d)
+ *  广播:  op(A 的第 i 位, 固定的节点 x)      -> w = A op -(X >> pos & 1)
+ * 每层分三轮贪心, 每次先取成员最多的 key:
+ *  1. 严格: A / B 各来自一个变量, 直接整字运算
+ *  2. 收集: 只要求形状相同, A / B 从多个变量里移位拼起来 (前缀加法器里已经算完的低位留在前面层的变量里,
+ *     不收集的话向量会一路碎成单个位); 摊到每个门不超过 3 条指令才采用, 多花的指令换来后面的层能整字运算
+ *  3. 剩下的门按严格 key 单独算
+ * 非成员位置上是无关的垃圾值: 读的人只看成员位置, 只有拼接时才需要掩码 (注释里给出成员位置, 方便对照)
+ */
+#define CG_MAX_WORDS (NL_MAX_NODES / 4)
+#define CG_ALIGNED 0
+#define CG_BCAST 1
+#define CG_ANY (-1)
+
+typedef struct cg_key {
+    uint8_t op;
+    uint8_t kind;
+    int a_word; // 主输入所在的变量, 收集时为 CG_ANY
+    int b; // 对齐: 另一个输入所在的变量 (收集时为 CG_ANY); 广播: 固定输入的节点
+    int d; // 对齐: 主输入的位置 - 另一个输入的位置
+} Cg_key;
+
+typedef struct cg_cand {
+    uint32_t gate;
+    uint32_t primary; // 主输入节点
+    uint32_t other; // 对齐时的另一个输入
+    Cg_key key;
+} Cg_cand;
+
+static const char *mem_name[] = {"im", "dm"};
+static int slot_word[NL_MAX_NODES];
+static int8_t slot_pos[NL_MAX_NODES];
+static char word_name[CG_MAX_WORDS][12];
+static uint8_t word_used[CG_MAX_WORDS]; // 被读过的变量; 只为读过的寄存器生成 q<k>
+static int n_words;
+static Cg_cand cands[NL_MAX_NODES * 3];
+static uint8_t assigned[NL_MAX_NODES];
+static int word_ops;
+
+static int new_word(const char *prefix, const int idx) {
+    snprintf(word_name[n_words], sizeof(word_name[0]), "%s%d", prefix, idx);
+    word_used[n_words] = 0;
+    return n_words++;
+}
+
+// 第 pos 位的值 (0 / 1)
+static void emit_bit(FILE *f, const uint32_t n) {
+    if (n <= 1) fprintf(f, "%uu", n);
+    else {
+        fprintf(f, "(%s >> %d & 1u)", word_name[slot_word[n]], slot_pos[n]);
+        word_used[slot_word[n]] = 1;
+    }
+}
+
+/**
+ * 把 nodes[i] 搬到第 target[i] 位: 来自同一个变量、平移量相同的位合并成一次 (W >> s) & mask
+ * exact = 0 且只有一个来源时不加掩码; 返回来源个数 (f 为 NULL 时只统计)
+ */
+static int emit_gather(FILE *f, const uint32_t *nodes, const int *target, const int n, const int exact) {
+    uint8_t done[WORD_SIZE] = {0};
+    uint32_t ones = 0;
+    int sources = 0;
+    for (int i = 0; i < n; i++) {
+        if (nodes[i] <= 1) {
+            ones |= nodes[i] << target[i];
+            done[i] = 1;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (done[i]) continue;
+        const int w = slot_word[nodes[i]], sh = slot_pos[nodes[i]] - target[i];
+        uint32_t mask = 0, rest = 0;
+        for (int j = i; j < n; j++) {
+            if (done[j]) continue;
+            if (slot_word[nodes[j]] != w || slot_pos[nodes[j]] - target[j] != sh) {
+                rest = 1;
+                continue;
+            }
+            mask |= 1u << target[j];
+            done[j] = 1;
+        }
+        const int masked = exact || rest || sources > 0 || ones;
+        if (f != NULL) {
+            fprintf(f, "%s", sources ? " | " : "");
+            if (masked) fprintf(f, "(");
+            if (sh > 0) fprintf(f, "%s >> %d", word_name[w], sh);
+            else if (sh < 0) fprintf(f, "%s << %d", word_name[w], -sh);
+            else fprintf(f, "%s", word_name[w]);
+            if (masked) fprintf(f, " & 0x%Xu)", mask);
+            word_used[w] = 1;
+        }
+        sources++;
+    }
+    if (f != NULL && (ones || sources == 0)) fprintf(f, "%s0x%Xu", sources ? " | " : "", ones);
+    return sources;
+}
+
+// nodes[0] 放在最高位 (width - 1)
+static void emit_pack(FILE *f, const uint32_t *nodes, const int width) {
+    int target[WORD_SIZE];
+    for (int i = 0; i < width; i++) target[i] = width - 1 - i;
+    emit_gather(f, nodes, target, width, 1);
+}
+
+// 名字 -> 各位的节点 (q[0] 在前); 没有捕获到的位当常量 0
+static void named_nodes(const Netlist *nl, const char *name, uint32_t *nodes, const int width) {
+    for (int i = 0; i < width; i++) nodes[i] = 0;
+    for (uint32_t i = 0; i < nl->n_names; i++) {
+        if (strcmp(nl->names[i].name, name) == 0) nodes[nl->names[i].index] = nl->names[i].node;
+    }
+}
+
+static int add_cands(const Netlist *nl, const uint32_t g, int n, const int relaxed) {
+    const Nl_node *x = &nl->nodes[g];
+    if (x->op == NL_NOT) {
+        cands[n++] = (Cg_cand){g, x->a, 0, {x->op, CG_ALIGNED, relaxed ? CG_ANY : slot_word[x->a], CG_ANY, 0}};
+        return n;
+    }
+    uint32_t a = x->a, b = x->b;
+    if (slot_pos[a] < slot_pos[b] || (slot_pos[a] == slot_pos[b] && slot_word[a] > slot_word[b])) {
+        a = x->b;
+        b = x->a;
+    }
+    cands[n++] = (Cg_cand){
+        g, a, b, {
+            x->op, CG_ALIGNED, relaxed ? CG_ANY : slot_word[a], relaxed ? CG_ANY : slot_word[b],
+            slot_pos[a] - slot_pos[b]
+        }
+    };
+    cands[n++] = (Cg_cand){g, x->a, x->b, {x->op, CG_BCAST, relaxed ? CG_ANY : slot_word[x->a], (int) x->b, 0}};
+    cands[n++] = (Cg_cand){g, x->b, x->a, {x->op, CG_BCAST, relaxed ? CG_ANY : slot_word[x->b], (int) x->a, 0}};
+    return n;
+}
+
+static int key_cmp(const void *x, const void *y) {
+    const Cg_key *a = &((const Cg_cand *) x)->key, *b = &((const Cg_cand *) y)->key;
+    if (a->op != b->op) return a->op - b->op;
+    if (a->kind != b->kind) return a->kind - b->kind;
+    if (a->a_word != b->a_word) return a->a_word < b->a_word ? -1 : 1;
+    if (a->b != b->b) return a->b < b->b ? -1 : 1;
+    return a->d - b->d;
+}
+
+/**
+ * cands[lo, hi) 的 key 相同: 取出还没分配、主输入位置不冲突的门
+ * 收集轮里拼接代价摊到每个门超过 3 条指令时放弃, 返回 0
+ */
+static int emit_group(FILE *f, const int lo, const int hi, const int relaxed) {
+    const Cg_key *key = &cands[lo].key;
+    uint32_t prim[WORD_SIZE], other[WORD_SIZE], taken = 0;
+    int member[WORD_SIZE], target[WORD_SIZE], n = 0;
+    for (int c = lo; c < hi; c++) {
+        const int p = slot_pos[cands[c].primary];
+        if (assigned[cands[c].gate] || ((taken >> p) & 1u)) continue;
+        taken |= 1u << p;
+        member[n] = c;
+        prim[n] = cands[c].primary;
+        other[n] = cands[c].other;
+        target[n++] = p;
+    }
+    const int aligned = key->op != NL_NOT && key->kind == CG_ALIGNED;
+    if (relaxed) {
+        const int sa = emit_gather(NULL, prim, target, n, 0), sb = aligned ? emit_gather(NULL, other, target, n, 0) : 0;
+        const int ops = 1 + (sa > 1 ? 3 * sa - 1 : 1) + (sb > 1 ? 3 * sb - 1 : sb);
+        if (ops > 3 * n) return 0;
+    }
+    const int w = new_word("w", n_words);
+    for (int i = 0; i < n; i++) {
+        const uint32_t g = cands[member[i]].gate;
+        assigned[g] = 1;
+        slot_word[g] = w;
+        slot_pos[g] = (int8_t) target[i];
+    }
+    fprintf(f, "    const uint32_t %s = ", word_name[w]);
+    word_ops++;
+    if (key->op == NL_NOT) fprintf(f, "~");
+    const int wrap_a = emit_gather(NULL, prim, target, n, 0) > 1;
+    if (wrap_a) fprintf(f, "(");
+    emit_gather(f, prim, target, n, 0);
+    if (wrap_a) fprintf(f, ")");
+    if (key->op != NL_NOT) {
+        fprintf(f, " %s ", key->op == NL_AND ? "&" : "|");
+        if (key->kind == CG_BCAST) {
+            fprintf(f, "-");
+            emit_bit(f, (uint32_t) key->b);
+        } else {
+            const int wrap_b = emit_gather(NULL, other, target, n, 0) > 1;
+            if (wrap_b) fprintf(f, "(");
+            emit_gather(f, other, target, n, 0);
+            if (wrap_b) fprintf(f, ")");
+        }
+    }
+    uint32_t mask = 0;
+    for (int i = 0; i < n; i++) mask |= 1u << target[i];
+    fprintf(f, "; // 0x%X\n", mask);
+    return 1;
+}
+
+// 一轮贪心: 候选按 key 排序, 反复取 "未分配成员最多" 的一段打包; 成员少于 min_count 的 key 留给下一轮
+static void pack_round(FILE *f, const Netlist *nl, const uint32_t lo, const uint32_t hi, const int relaxed,
+                       const int min_count) {
+    static uint8_t rejected[NL_MAX_NODES * 3];
+    int nc = 0;
+    for (uint32_t i = lo; i < hi; i++) {
+        if (nl_is_gate_(nl->nodes[i].op) && !assigned[i]) nc = add_cands(nl, i, nc, relaxed);
+    }
+    qsort(cands, (size_t) nc, sizeof(Cg_cand), key_cmp);
+    memset(rejected, 0, (size_t) nc);
+    for (;;) {
+        int best = -1, best_end = 0, best_count = min_count - 1;
+        for (int c = 0; c < nc;) {
+            int e = c, n = 0;
+            while (e < nc && key_cmp(&cands[c], &cands[e]) == 0) n += !assigned[cands[e++].gate];
+            if (!rejected[c] && n > best_count) {
+                best_count = n;
+                best = c;
+                best_end = e;
+            }
+            c = e;
+        }
+        if (best < 0) break;
+        if (!emit_group(f, best, best_end, relaxed)) rejected[best] = 1;
+    }
+}
+
+static void emit_level_gates(FILE *f, const Netlist *nl, const uint32_t lo, const uint32_t hi) {
+    for (uint32_t i = lo; i < hi; i++) assigned[i] = 0;
+    pack_round(f, nl, lo, hi, 0, 2);
+    pack_round(f, nl, lo, hi, 1, 2);
+    pack_round(f, nl, lo, hi, 0, 1);
+}
+
+static int emit(FILE *out, const Netlist *nl) {
+    const Nl_stats st = nl_stats(nl);
+    // 函数体先写到临时文件, 知道哪些寄存器被读过之后再补上 q<k> 的声明
+    FILE *f = tmpfile();
+    if (f == NULL) {
+        perror("[codegen] tmpfile");
+        return 1;
+    }
+    uint32_t nodes[WORD_SIZE];
+
+    n_words = 0;
+    word_ops = 0;
+    for (uint32_t i = 0; i < nl->n_nodes; i++) slot_word[i] = -1;
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const int w = new_word("q", k);
+        named_nodes(nl, NL_CPU_REGS_[k].name, nodes, NL_CPU_REGS_[k].width);
+        for (int i = 0; i < NL_CPU_REGS_[k].width; i++) {
+            if (nl->nodes[nodes[i]].op != NL_DFF) continue;
+            slot_word[nodes[i]] = w;
+            slot_pos[nodes[i]] = (int8_t) (NL_CPU_REGS_[k].width - 1 - i);
+        }
+    }
+    for (uint32_t i = 2; i < nl->n_nodes; i++) {
+        if (nl->nodes[i].op == NL_DFF && slot_word[i] < 0) {
+            fprintf(stderr, "[codegen] DFF n%u has no register name\n", i);
+            fclose(f);
+            return 1;
+        }
+        if (nl->nodes[i].op == NL_INPUT) {
+            fprintf(stderr, "[codegen] unexpected input node n%u\n", i);
+            fclose(f);
+            return 1;
+        }
+    }
+
+    const int port_base = n_words;
+    uint8_t port_done[NL_MAX_PORTS] = {0};
+    for (uint32_t p = 0; p < nl->n_ports; p++) new_word("m", (int) p);
+    for (uint32_t l = 1; l < nl->n_levels; l++) {
+        const uint32_t lo = nl->level_start[l], hi = nl->level_start[l + 1];
+        fprintf(f, "    // level %u\n", l);
+        // 读端口的地址都在前面的层, 先读出来
+        for (uint32_t i = lo; i < hi; i++) {
+            const Nl_node *x = &nl->nodes[i];
+            if (x->op != NL_MEM_RD) continue;
+            if (!port_done[x->a]) {
+                const Nl_port *p = &nl->ports[x->a];
+                fprintf(f, "    const uint32_t m%u = compiled_%s_read_(s, ", x->a, mem_name[p->mem]);
+                emit_pack(f, p->addr, WORD_SIZE);
+                fprintf(f, ");\n");
+                port_done[x->a] = 1;
+            }
+            slot_word[i] = port_base + (int) x->a;
+            slot_pos[i] = (int8_t) (WORD_SIZE - 1 - x->b);
+        }
+        emit_level_gates(f, nl, lo, hi);
+    }
+
+    // 时钟沿: 先写存储器, 再更新寄存器 (与 nl_commit 相同)
+    fprintf(f, "    // clock edge\n");
+    for (uint32_t p = 0; p < nl->n_ports; p++) {
+        const Nl_port *port = &nl->ports[p];
+        if (!port->write) continue;
+        fprintf(f, "    if (");
+        emit_bit(f, port->we);
+        fprintf(f, ") compiled_%s_write_(s, ", mem_name[port->mem]);
+        emit_pack(f, port->addr, WORD_SIZE);
+        fprintf(f, ",\n        ");
+        emit_pack(f, port->data, WORD_SIZE);
+        const uint32_t be[4] = {port->be[3], port->be[2], port->be[1], port->be[0]};
+        fprintf(f, ",\n        ");
+        emit_pack(f, be, 4);
+        fprintf(f, ");\n");
+    }
+    named_nodes(nl, "wire_pc_src", nodes, 2);
+    fprintf(f, "    s->wire_pc_src = ");
+    emit_pack(f, nodes, 2);
+    fprintf(f, ";\n");
+    named_nodes(nl, "wire_branch_target", nodes, WORD_SIZE);
+    fprintf(f, "    s->wire_branch_target = ");
+    emit_pack(f, nodes, WORD_SIZE);
+    fprintf(f, ";\n");
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *reg = &NL_CPU_REGS_[k];
+        named_nodes(nl, reg->name, nodes, reg->width);
+        // DFF 的下一个状态是 D 端; 被常量化的位保持常量
+        for (int i = 0; i < reg->width; i++) {
+            if (nl->nodes[nodes[i]].op == NL_DFF) nodes[i] = nl->nodes[nodes[i]].a;
+        }
+        fprintf(f, "    r[%d] = ", k);
+        emit_pack(f, nodes, reg->width);
+        fprintf(f, ";\n");
+    }
+
+    fprintf(out, "//\n// Generated by sccpu_netlist_codegen, do not edit.\n//\n\n");
+    fprintf(out, "#ifndef SCCPU_COMPILED_CPU_GEN_H\n#define SCCPU_COMPILED_CPU_GEN_H\n\n");
+    fprintf(out, "static inline void compiled_cpu_cycle_(Compiled_cpu *s) {\n");
+    fprintf(out, "    uint32_t *r = s->reg;\n");
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        // 被优化成常量的寄存器 (如 R0) 没人读, 不声明, 免得 -Wunused-variable
+        if (!word_used[k]) continue;
+        fprintf(out, "    const uint32_t q%d = r[%d]; // %s\n", k, k, NL_CPU_REGS_[k].name);
+    }
+    rewind(f);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) fwrite(buf, 1, n, out);
+    fclose(f);
+    fprintf(out, "}\n\n");
+    fprintf(out, "#define COMPILED_CPU_GATES %u\n#define COMPILED_CPU_WORD_OPS %d\n", st.gates, word_ops);
+    fprintf(out, "#define COMPILED_CPU_DFFS %u\n#define COMPILED_CPU_LEVELS %u\n\n", st.ops[NL_DFF], st.levels);
+    fprintf(out, "#endif //SCCPU_COMPILED_CPU_GEN_H\n");
+    return 0;
+}
+
+int main(const int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <compiled_cpu_gen.h>\n", argv[0]);
+        return 2;
+    }
+    nl_capture_cpu(cpu_cycle_single_eval);
+    // 所有流水线寄存器都保留, 生成的代码可以与 cpu_step 逐周期对拍
+    nl_optimize(&netlist_, 1);
+    if (netlist_.overflow) {
+        fprintf(stderr, "[codegen] netlist capacity exceeded\n");
+        return 1;
+    }
+    FILE *f = fopen(argv[1], "w");
+    if (f == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    const int rc = emit(f, &netlist_);
+    fclose(f);
+    nl_print_stats("[codegen] cpu", &netlist_);
+    printf("[codegen] %d gates packed into %d word operations\n", nl_stats(&netlist_).gates, word_ops);
+    return rc;
+}
@@ -0,0 +1,106 @@
+//
+// Created by wenshen on 2026/10/17.
+// 分区并行报告: CPU 网表按流水线阶段切成 5 个锥, 在 1..5 个线程上跑, 与串行 nl_eval / nl_commit 比较
+// 打印每个锥的门数、重复计算、理想加速比, 以及实测的加速比 / 并行效率和纯屏障开销
+// 构建: -DSCCPU_NETLIST=1 -DSCCPU_DFF_CLOSED_FORM=1 (目标 sccpu_netlist_par)
+#include <stdio.h>
+#include <unistd.h>
+#include "../includes/netlist_cpu.h"
+#include "../includes/netlist_par.h"
+
+#define CYCLES 20000
+
+static const char *STAGE_NAMES_[STAGE_NUM] = {"WB", "MEM", "EX", "ID", "IF"};
+
+static Netlist cpu_nl, empty_nl;
+static Nl_cpu_sim sim;
+static Nl_par par;
+static uint8_t part_of_node[NL_MAX_NODES], part_of_port[NL_MAX_PORTS];
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t) rng_state;
+}
+
+static void load_random(Nl_cpu_sim *s) {
+    nl_cpu_sim_init(s, &cpu_nl);
+    for (int i = 0; i < IM_SIZE; i++) {
+        const uint8_t a = rng() & 3, b = rng() & 3, d = rng() & 3;
+        switch (rng() % 4) {
+            case 0: s->im[i] = enc_r(a, b, d, 0, FUNCT_ADD);
+                break;
+            case 1: s->im[i] = enc_addi(a, b, (int16_t) (rng() % 200 - 100));
+                break;
+            case 2: s->im[i] = enc_i(OP_LW, b, a, (int16_t) ((rng() % 64) * 4));
+                break;
+            default: s->im[i] = enc_i(OP_SW, b, a, (int16_t) ((rng() % 64) * 4));
+                break;
+        }
+    }
+}
+
+int main(void) {
+    nl_capture_cpu(cpu_cycle_single_eval);
+    nl_optimize(&netlist_, 1);
+    if (netlist_.overflow) {
+        printf("[netlist] capacity exceeded\n");
+        return 1;
+    }
+    cpu_nl = netlist_;
+    const int n_parts = nl_cpu_stage_partition(&cpu_nl, part_of_node, part_of_port);
+    const Nl_stats st = nl_stats(&cpu_nl);
+    printf("=== SCCPU partitioned netlist (%u gates, %u DFFs, %u levels, %d cycles) ===\n", st.gates, st.ops[NL_DFF],
+           st.levels, CYCLES);
+
+    // 1. 串行参考
+    load_random(&sim);
+    uint64_t t0 = nl_par_now_ns_();
+    for (int cyc = 0; cyc < CYCLES; cyc++) nl_cpu_sim_tick(&sim);
+    const double serial = (double) (nl_par_now_ns_() - t0) / CYCLES;
+    printf("serial nl_eval/nl_commit : %8.1f ns/cycle (%ld online cores)\n", serial, sysconf(_SC_NPROCESSORS_ONLN));
+
+    // 2. 每个阶段单独的锥
+    if (nl_par_init(&par, &cpu_nl, n_parts, part_of_node, part_of_port, 1, NULL, NULL, NULL) != 0) return 1;
+    printf("stage cones:");
+    for (int p = 0; p < n_parts; p++) printf(" %s=%u", STAGE_NAMES_[p], par.part_gates[p]);
+    printf("\n");
+    nl_par_stop(&par);
+
+    // 3. 1..5 个线程
+    printf("%-8s %10s %10s %8s %8s %8s %10s %10s\n", "threads", "ns/cycle", "barrier", "speedup", "effic.",
+           "dup.", "ideal", "busy max");
+    double one = 0; // 1 个线程的耗时, 加速比 / 效率都相对它算 (与串行求值器的差别只在遍历方式)
+    for (int n = 1; n <= n_parts; n++) {
+        // 纯屏障: 空网表, 每个周期同样两次屏障
+        nl_reset(&empty_nl);
+        if (nl_par_init(&par, &empty_nl, n, part_of_node, part_of_port, n, NULL, NULL, NULL) != 0) return 1;
+        t0 = nl_par_now_ns_();
+        nl_par_run(&par, CYCLES);
+        const double barrier = (double) (nl_par_now_ns_() - t0) / CYCLES;
+        nl_par_stop(&par);
+
+        load_random(&sim);
+        if (nl_par_init(&par, &cpu_nl, n_parts, part_of_node, part_of_port, n, nl_cpu_mem_read_, nl_cpu_mem_write_,
+                        &sim) != 0) return 1;
+        t0 = nl_par_now_ns_();
+        nl_par_run(&par, CYCLES);
+        const double wall = (double) (nl_par_now_ns_() - t0) / CYCLES;
+        nl_par_stop(&par);
+        if (n == 1) one = wall;
+
+        const Nl_par_stats s = nl_par_stats(&par);
+        uint64_t busy = 0;
+        for (int t = 0; t < par.n_threads; t++) {
+            if (par.th[t].busy_ns > busy) busy = par.th[t].busy_ns;
+        }
+        printf("%-8d %10.1f %10.1f %7.2fx %7.0f%% %7.2fx %9.2fx %10.1f\n", n, wall, barrier, one / wall,
+               100.0 * one / wall / n, s.duplication, s.ideal_speedup, (double) busy / CYCLES);
+    }
+    printf("speedup = 1-thread time / time; effic. = speedup / threads; dup. = gates evaluated by all threads / netlist gates;\n"
+           "ideal = netlist gates / largest thread cone; busy max = slowest thread's eval+commit time\n");
+    return 0;
+}
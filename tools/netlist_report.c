@@ -0,0 +1,81 @@
+//
+// Created by wenshen on 2026/10/17.
+// 网表报告: 把 decode / word_alu_ / 整个 CPU 捕获成门级网表, 逐个 pass 打印规模, 看原始电路里有多少冗余
+// 构建: -DSCCPU_NETLIST=1 -DSCCPU_DFF_CLOSED_FORM=1 (目标 sccpu_netlist_report), 可再加 -DSCCPU_ADDER=...
+#include <stdio.h>
+#include "../includes/netlist_cpu.h"
+
+static Netlist tmp_;
+
+static void run_passes(const char *title, const int keep_named) {
+    printf("--- %s ---\n", title);
+    nl_print_stats("captured", &netlist_);
+    printf("  const-prop removed %6d\n", nl_const_prop(&netlist_));
+    printf("  cse        removed %6d\n", nl_cse(&netlist_));
+    printf("  dce        removed %6d\n", nl_dce(&netlist_, keep_named));
+    nl_optimize(&netlist_, keep_named);
+    nl_print_stats("optimized", &netlist_);
+}
+
+static void capture_decoder(void) {
+    nl_reset(&netlist_);
+    word instr;
+    for (int i = 0; i < WORD_SIZE; i++) instr[i] = nl_input_();
+    const Control_signals cs = decode(instr);
+    const bit out[11] = {
+        cs.reg_dst, cs.alu_src, cs.data_src_to_reg, cs.reg_write, cs.mem_read, cs.mem_write, cs.branch, cs.jump,
+        cs.ops_[0], cs.ops_[1], cs.ops_[2]
+    };
+    for (int i = 0; i < 11; i++) nl_name_(out[i], "decode", i, 11, 1);
+}
+
+static void capture_alu(void) {
+    nl_reset(&netlist_);
+    word a, b, ret;
+    ops op;
+    for (int i = 0; i < WORD_SIZE; i++) a[i] = nl_input_();
+    for (int i = 0; i < WORD_SIZE; i++) b[i] = nl_input_();
+    for (int i = 0; i < 3; i++) op[i] = nl_input_();
+    bit overflow = BIT_0;
+    word_alu_(a, b, ret, op, &overflow);
+    for (int i = 0; i < WORD_SIZE; i++) nl_name_(ret[i], "alu", i, WORD_SIZE, 1);
+    nl_name_(overflow, "overflow", 0, 1, 1);
+}
+
+// 可观测输出只算 PC / regfile / DM 写口时, 哪些流水线寄存器位没人读
+static void report_dead_state(void) {
+    tmp_ = netlist_;
+    nl_optimize(&tmp_, 0);
+    nl_print_stats("architectural outputs only", &tmp_);
+    for (int k = 0; k < NL_CPU_REG_NUM; k++) {
+        const Nl_cpu_reg *r = &NL_CPU_REGS_[k];
+        int alive = 0;
+        for (uint32_t i = 0; i < tmp_.n_names; i++) {
+            alive += tmp_.nodes[tmp_.names[i].node].op == NL_DFF && strcmp(tmp_.names[i].name, r->name) == 0;
+        }
+        if (alive < r->width) printf("  dead/constant DFF bits: %-22s %2d of %2d\n", r->name, r->width - alive, r->width);
+    }
+}
+
+int main(void) {
+    printf("=== SCCPU netlist (SCCPU_ADDER=%s) ===\n", PREFIX_ADDERS_[SCCPU_ADDER].name);
+
+    capture_decoder();
+    run_passes("decode()", 1);
+
+    capture_alu();
+    run_passes("word_alu_()", 1);
+
+    nl_capture_cpu(cpu_cycle_single_eval);
+    run_passes("cpu (cpu_cycle_single_eval)", 1);
+
+    nl_capture_cpu(cpu_cycle_two_pass);
+    run_passes("cpu (cpu_cycle_two_pass)", 1);
+    report_dead_state();
+
+    if (netlist_.overflow || tmp_.overflow) {
+        printf("[netlist] capacity exceeded (NL_MAX_NODES / NL_MAX_NAMES / NL_MAX_PORTS / NL_MAX_LEVELS)\n");
+        return 1;
+    }
+    return 0;
+}
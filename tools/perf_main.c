@@ -0,0 +1,81 @@
+//
+// Created by wenshen on 2026/10/17.
+// 性能计数器: 循环程序和随机程序各跑到停机 (PC 到了结尾的自循环, 最多 N 个周期), 打印 CPI、
+// 每千条指令的事件数和指令构成; 循环程序停机前用 LW 从计数器区读出 cycles / instructions 存进 DM
+// 用法: sccpu_perf [max_cycles]   (默认 100000)
+#include <stdio.h>
+#include <stdlib.h>
+#include "../includes/cosim.h"
+
+static uint32_t prog[IM_SIZE];
+static int prog_len;
+static Cpu_core cpu;
+
+// 流水线没有前递: 每条指令后面补 3 个 NOP; 返回这条指令的下标
+static int emit(const uint32_t inst) {
+    const int at = prog_len;
+    prog[prog_len++] = inst;
+    for (int i = 0; i < 3; i++) prog[prog_len++] = 0;
+    return at;
+}
+
+// 与 sccpu_iss 相同: R1 = 1..n, R3 += R1, 每次把 R3 存到 R0 指向的 DM 并 R0 += 4;
+// 退出循环后把计数器区的 cycles / instructions 读进 R1 / R2, 存到 DM[0] / DM[4], 然后停在自循环;
+// 返回自循环的地址
+static uint32_t build_program(const int n) {
+    memset(prog, 0, sizeof(prog));
+    prog_len = 0;
+    emit(enc_addi(1, 0, 0));
+    emit(enc_addi(2, 0, (int16_t) n));
+    emit(enc_addi(3, 0, 0));
+    const int loop = emit(enc_addi(1, 1, 1));
+    emit(enc_r(3, 1, 3, 0, FUNCT_ADD));
+    emit(enc_i(OP_SW, 0, 3, 0));
+    emit(enc_addi(0, 0, 4));
+    const int exit_beq = emit(0);
+    const int back = emit(0);
+    const int done = prog_len;
+    emit(enc_r(1, 2, 3, 0, FUNCT_SUB)); // R1 == R2, R3 = 0 作基址
+    emit(enc_i(OP_LW, 3, 1, PERF_MMIO_BASE + 8 * PERF_CYCLES));
+    emit(enc_i(OP_LW, 3, 2, PERF_MMIO_BASE + 8 * PERF_INSTRUCTIONS));
+    emit(enc_i(OP_SW, 3, 1, 0));
+    emit(enc_i(OP_SW, 3, 2, 4));
+    const int halt = prog_len;
+    prog[prog_len++] = enc_beq(0, 0, -1);
+    prog[exit_beq] = enc_beq(1, 2, (int16_t) (done - exit_beq - 1));
+    prog[back] = enc_beq(0, 0, (int16_t) (loop - back - 1));
+    return (uint32_t) halt * 4;
+}
+
+// 跑到 PC 取到自循环为止 (自循环本身和还在流水线里的指令不计), 最多 max_cycles 个周期
+static void run(const char *name, const uint32_t halt, const long max_cycles) {
+    cpu_release(&cpu);
+    init_cpu_c(&cpu);
+    im_load(&cpu.im, prog, IM_SIZE);
+    long cyc = 0;
+    while (cyc < max_cycles && reg32_read_u32_(&cpu.pc.reg32) != halt) {
+        cpu_step(&cpu);
+        cyc++;
+    }
+    printf("=== %s: %s after %ld cycles ===\n", name, cyc < max_cycles ? "halted" : "still running", cyc);
+    perf_report(&cpu, stdout);
+}
+
+int main(const int argc, char **argv) {
+    const long max_cycles = argc > 1 ? atol(argv[1]) : 100000;
+    uint64_t rng = 0xA54FF53A5F1D36F1ull;
+    if (max_cycles < 1) return 1;
+
+    run("loop, 100 iterations", build_program(100), max_cycles);
+    uint8_t dm[DEFAULT_SIZE];
+    dm_copy_out(&cpu.dm, dm);
+    const uint32_t lw_cycles = (uint32_t) dm[0] << 24 | (uint32_t) dm[1] << 16 | (uint32_t) dm[2] << 8 | dm[3];
+    const uint32_t lw_insts = (uint32_t) dm[4] << 24 | (uint32_t) dm[5] << 16 | (uint32_t) dm[6] << 8 | dm[7];
+    printf("       read by the program via LW: cycles %u, instructions %u (CPI %.3f up to that point)\n",
+           lw_cycles, lw_insts, lw_insts ? (double) lw_cycles / lw_insts : 0.0);
+
+    memset(prog, 0, sizeof(prog));
+    const uint32_t halt = cosim_random_program(prog, 60, 3, &rng); // 60 * 4 + 1 条, 放得进 IM
+    run("random, 60 instructions + 3 NOPs each", halt, max_cycles);
+    return 0;
+}
@@ -0,0 +1,91 @@
+//
+// Created by wenshen on 2026/10/17.
+// 流水线时间线: 循环程序跑 N 个周期, 写出 Konata 能打开的日志; 打印取指 / 退休 / 冲掉的指令数,
+// 退休指令里 NOP 的个数 (没有前递时补的气泡), 以及与不记录时相比每周期多花的时间
+// 用法: sccpu_pipeview [cycles] [file]   (默认 2000 / sccpu.kanata)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../includes/pipeview.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static uint32_t prog[IM_SIZE];
+static int prog_len;
+static Cpu_core cpu;
+static Pipeview pv;
+
+// 流水线没有前递: 每条指令后面补 3 个 NOP; 返回这条指令的下标
+static int emit(const uint32_t inst) {
+    const int at = prog_len;
+    prog[prog_len++] = inst;
+    for (int i = 0; i < 3; i++) prog[prog_len++] = 0;
+    return at;
+}
+
+// 与 sccpu_iss 相同: R1 = 1..n, R3 += R1, 每次把 R3 存到 R0 指向的 DM 并 R0 += 4; 结束后停在自循环
+static void build_program(const int n) {
+    memset(prog, 0, sizeof(prog));
+    prog_len = 0;
+    emit(enc_addi(1, 0, 0));
+    emit(enc_addi(2, 0, (int16_t) n));
+    emit(enc_addi(3, 0, 0));
+    const int loop = emit(enc_addi(1, 1, 1));
+    emit(enc_r(3, 1, 3, 0, FUNCT_ADD));
+    emit(enc_i(OP_SW, 0, 3, 0));
+    emit(enc_addi(0, 0, 4));
+    const int exit_beq = emit(0);
+    const int back = emit(0);
+    const int halt = prog_len;
+    prog[prog_len++] = enc_beq(0, 0, -1);
+    prog[exit_beq] = enc_beq(1, 2, (int16_t) (halt - exit_beq - 1));
+    prog[back] = enc_beq(0, 0, (int16_t) (loop - back - 1));
+}
+
+static void load(void) {
+    cpu_release(&cpu);
+    init_cpu_c(&cpu);
+    im_load(&cpu.im, prog, IM_SIZE);
+}
+
+int main(const int argc, char **argv) {
+    const long cycles = argc > 1 ? atol(argv[1]) : 2000;
+    const char *path = argc > 2 ? argv[2] : "sccpu.kanata";
+    if (cycles < 1) return 1;
+    build_program(50);
+
+    load();
+    uint64_t t0 = now_ns();
+    for (long cyc = 0; cyc < cycles; cyc++) cpu_step(&cpu);
+    const double base = (double) (now_ns() - t0) / (double) cycles;
+
+    load();
+    if (pipeview_open(&pv, path, &cpu) != 0) {
+        printf("cannot write %s\n", path);
+        return 1;
+    }
+    t0 = now_ns();
+    for (long cyc = 0; cyc < cycles; cyc++) {
+        cpu_step(&cpu);
+        pipeview_record(&pv, &cpu);
+    }
+    const double traced = (double) (now_ns() - t0) / (double) cycles;
+    const long bytes = ftell(pv.f);
+    if (pipeview_close(&pv) != 0) {
+        printf("write error on %s\n", path);
+        return 1;
+    }
+    printf("=== SCCPU pipeline timeline (%ld cycles) ===\n", cycles);
+    printf("file    : %s, %ld bytes (open it in Konata)\n", path, bytes);
+    printf("insts   : %lu fetched, %lu retired, %lu flushed (2 per taken branch)\n", pv.fetched, pv.retired,
+           pv.flushed);
+    printf("useful  : %lu of %lu retired are NOP padding, %.2f useful instructions per cycle\n", pv.nops, pv.retired,
+           (double) (pv.retired - pv.nops) / (double) cycles);
+    printf("time    : %.1f ns/cycle without timeline, %.1f ns/cycle with timeline (+%.1f)\n", base, traced,
+           traced - base);
+    return 0;
+}
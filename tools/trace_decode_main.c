@@ -0,0 +1,38 @@
+//
+// Created by wenshen on 2026/10/17.
+// 把 sccpu_trace_record 写的跟踪流还原成 cpu_dump 格式的文本或 CSV (stdout), 统计打印到 stderr
+// 用法: sccpu_trace_decode <file> [text | csv] [first cycle] [last cycle]   (默认 text / 全部)
+#include <stdio.h>
+#include <stdlib.h>
+#include "../includes/trace_stream.h"
+
+int main(const int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file> [text | csv] [first cycle] [last cycle]\n", argv[0]);
+        return 1;
+    }
+    const int csv = argc > 2 && strcmp(argv[2], "csv") == 0;
+    const uint64_t first = argc > 3 ? strtoull(argv[3], NULL, 10) : 0;
+    const uint64_t last = argc > 4 ? strtoull(argv[4], NULL, 10) : UINT64_MAX;
+    static Trace_stream_reader r;
+    if (trace_stream_read_open(&r, argv[1]) != 0) {
+        fprintf(stderr, "%s: not a trace stream (version %u)\n", argv[1], TRACE_STREAM_VERSION);
+        return 1;
+    }
+    if (csv) trace_csv_header(stdout, r.cats);
+    Trace_ev ev[TRACE_CAT_NUM];
+    uint64_t cycles = 0, text = 0;
+    int n;
+    while ((n = trace_stream_read(&r, ev)) > 0) {
+        cycles++;
+        if (r.cycle < first || r.cycle > last) continue;
+        if (csv) trace_csv_row(stdout, ev, n);
+        else text += (uint64_t) trace_print_cycle_(stdout, r.cycle, ev, n);
+    }
+    trace_stream_read_close(&r);
+    if (n < 0) fprintf(stderr, "%s: truncated or corrupt after cycle %lu\n", argv[1], r.cycle);
+    fprintf(stderr, "%lu cycles, %lu bytes of stream", cycles, r.bytes);
+    if (text) fprintf(stderr, ", %lu bytes of text (%.1fx)", text, (double) text / (double) r.bytes);
+    fprintf(stderr, "\n");
+    return n < 0;
+}
@@ -0,0 +1,61 @@
+//
+// Created by wenshen on 2026/10/17.
+// 跟踪的代价: 同一个随机程序分别 不记录 / 每周期记进跟踪环 (摘要 / 全部类别) / 每周期 cpu_dump 格式化 (写到 /dev/null),
+// 打印每周期耗时, 最后从环里打印最后 2 个周期
+// 用法: sccpu_trace_bench [cycles]   (默认 20000)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../includes/cosim.h"
+#include "../includes/trace.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static uint32_t prog[IM_SIZE];
+static Cpu_core cpu;
+static Trace_ring ring;
+
+// mode: 0 不记录, 1 摘要, 2 全部类别, 3 cpu_dump 格式的文本
+static double run(const int mode, const int cycles, FILE *sink) {
+    cpu_release(&cpu);
+    init_cpu_c(&cpu);
+    im_load(&cpu.im, prog, IM_SIZE);
+    trace_init(&ring, TRACE_CATS_ALL);
+    Trace_ev ev[TRACE_CAT_NUM];
+    const uint64_t t0 = now_ns();
+    for (int cyc = 0; cyc < cycles; cyc++) {
+        cpu_step(&cpu);
+        if (mode == 1) trace_record(&ring, &cpu, TRACE_CATS_SUMMARY);
+        if (mode == 2) trace_record(&ring, &cpu, TRACE_CATS_ALL);
+        if (mode == 3) {
+            for (int k = 0; k < TRACE_CAT_NUM; k++) trace_capture_(&cpu, (Trace_cat) k, &ev[k]);
+            trace_print_cycle_(sink, cpu.cycle_count, ev, TRACE_CAT_NUM);
+        }
+    }
+    return (double) (now_ns() - t0) / cycles;
+}
+
+int main(const int argc, char **argv) {
+    const int cycles = argc > 1 ? atoi(argv[1]) : 20000;
+    uint64_t rng = 0x452821E638D01377ull;
+    FILE *sink = fopen("/dev/null", "w");
+    if (!sink || cycles < 1) return 1;
+    cosim_random_program(prog, 60, 3, &rng);
+    printf("=== SCCPU trace cost (%d cycles, ring of %d events x %zu B) ===\n", cycles, SCCPU_TRACE_EVENTS,
+           sizeof(Trace_ev));
+    const double base = run(0, cycles, sink);
+    const double summary = run(1, cycles, sink);
+    const double full = run(2, cycles, sink);
+    const double text = run(3, cycles, sink);
+    printf("no trace          : %8.1f ns/cycle\n", base);
+    printf("ring, IF + regs   : %8.1f ns/cycle (+%.1f)\n", summary, summary - base);
+    printf("ring, all stages  : %8.1f ns/cycle (+%.1f)\n", full, full - base);
+    printf("cpu_dump text     : %8.1f ns/cycle (+%.1f, to /dev/null)\n", text, text - base);
+    fclose(sink);
+    trace_print_last(&ring, stdout, 2);
+    return 0;
+}
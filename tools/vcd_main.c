@@ -0,0 +1,88 @@
+//
+// Created by wenshen on 2026/10/17.
+// VCD 波形: 循环程序跑 N 个周期, 每个周期把变了的寄存器 / 导线写进 VCD 文件 (GTKWave 可直接打开);
+// 打印文件大小、值变化数、每周期字节数, 以及与不记录时相比每周期多花的时间
+// 用法: sccpu_vcd [cycles] [file]   (默认 100000 / sccpu.vcd)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../includes/vcd.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static uint32_t prog[IM_SIZE];
+static int prog_len;
+static Cpu_core cpu;
+static Vcd vcd;
+
+// 流水线没有前递: 每条指令后面补 3 个 NOP; 返回这条指令的下标
+static int emit(const uint32_t inst) {
+    const int at = prog_len;
+    prog[prog_len++] = inst;
+    for (int i = 0; i < 3; i++) prog[prog_len++] = 0;
+    return at;
+}
+
+// 与 sccpu_iss 相同: R1 = 1..n, R3 += R1, 每次把 R3 存到 R0 指向的 DM 并 R0 += 4; 结束后停在自循环
+static void build_program(const int n) {
+    memset(prog, 0, sizeof(prog));
+    prog_len = 0;
+    emit(enc_addi(1, 0, 0));
+    emit(enc_addi(2, 0, (int16_t) n));
+    emit(enc_addi(3, 0, 0));
+    const int loop = emit(enc_addi(1, 1, 1));
+    emit(enc_r(3, 1, 3, 0, FUNCT_ADD));
+    emit(enc_i(OP_SW, 0, 3, 0));
+    emit(enc_addi(0, 0, 4));
+    const int exit_beq = emit(0);
+    const int back = emit(0);
+    const int halt = prog_len;
+    prog[prog_len++] = enc_beq(0, 0, -1);
+    prog[exit_beq] = enc_beq(1, 2, (int16_t) (halt - exit_beq - 1));
+    prog[back] = enc_beq(0, 0, (int16_t) (loop - back - 1));
+}
+
+static void load(void) {
+    cpu_release(&cpu);
+    init_cpu_c(&cpu);
+    im_load(&cpu.im, prog, IM_SIZE);
+}
+
+int main(const int argc, char **argv) {
+    const long cycles = argc > 1 ? atol(argv[1]) : 100000;
+    const char *path = argc > 2 ? argv[2] : "sccpu.vcd";
+    if (cycles < 1) return 1;
+    build_program(1000);
+
+    load();
+    uint64_t t0 = now_ns();
+    for (long cyc = 0; cyc < cycles; cyc++) cpu_step(&cpu);
+    const double base = (double) (now_ns() - t0) / (double) cycles;
+
+    load();
+    if (vcd_open(&vcd, path) != 0) {
+        printf("cannot write %s\n", path);
+        return 1;
+    }
+    t0 = now_ns();
+    for (long cyc = 0; cyc < cycles; cyc++) {
+        cpu_step(&cpu);
+        vcd_sample(&vcd, &cpu);
+    }
+    const double traced = (double) (now_ns() - t0) / (double) cycles;
+    const long bytes = ftell(vcd.f);
+    if (vcd_close(&vcd) != 0) {
+        printf("write error on %s\n", path);
+        return 1;
+    }
+    printf("=== SCCPU VCD (%ld cycles, %d signals) ===\n", cycles, VCD_SIGNALS);
+    printf("file    : %s, %ld bytes, %.2f bytes/cycle\n", path, bytes, (double) bytes / (double) cycles);
+    printf("changes : %lu (%.2f per cycle, %.1f%% of signals x cycles)\n", vcd.changes,
+           (double) vcd.changes / (double) cycles, 100.0 * (double) vcd.changes / ((double) VCD_SIGNALS * cycles));
+    printf("time    : %.1f ns/cycle without VCD, %.1f ns/cycle with VCD (+%.1f)\n", base, traced, traced - base);
+    return 0;
+}